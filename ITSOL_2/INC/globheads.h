@@ -175,6 +175,18 @@ typedef struct _SPre {
   arms ARMS;           /* struct for a block preconditioner */
   int (*precon) (double *, double *, struct _SPre*); 
 } SPre, *SPreptr;
+
+typedef struct _FgmrWork {
+/*--------------------------------------------------------------------
+| work arrays of fgmr, which can be reused across calls with the same
+| n and im to avoid the allocation in each solve.
+|--------------------------------------------------------------------*/
+  int n;               /* dimension of the system                 */
+  int im;              /* dimension of the Krylov subspace        */
+  double *vv;          /* Arnoldi basis, [im+1][n]                */
+  double *z;           /* preconditioned vectors, [im][n]         */
+  double *hh;          /* Hessenberg matrix and rotations         */
+} FgmrWork, *FgmrWorkptr;
   
 
 #endif  /* __VBLOCK_HEADER_H__ */
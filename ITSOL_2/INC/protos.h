@@ -240,6 +240,11 @@ extern int ilut( csptr csmat, iluptr lu, int lfil, double tol,
 		 FILE *fp );
 extern   int fgmr(SMatptr Amat, SPreptr lu, double *rhs, double *sol, double tol,
 	   int im, int *itmax, FILE *fits ); 
+extern int fgmrWork(SMatptr Amat, SPreptr lu, double *rhs, double *sol,
+		    double tol, int im, int *itmax, FILE *fits,
+		    FgmrWorkptr work);
+extern int setupFgmrWork(FgmrWorkptr work, int n, int im);
+extern int cleanFgmrWork(FgmrWorkptr work);
 extern int arms2(csptr Amat, int *ipar, double *droptol, int *lfil, 
 	  double tolind, arms PreMat, FILE *ft) ;
 extern int condestLU( iluptr, FILE *);
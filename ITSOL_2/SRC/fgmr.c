@@ -7,9 +7,87 @@
 
 #define  epsmac  1.0e-16
 
+int setupFgmrWork(FgmrWorkptr work, int n, int im)
+{
+/*----------------------------------------------------------------------
+| Allocate the work arrays of fgmrWork for dimension n and Krylov
+| subspace dimension im. If work already holds arrays of the same
+| sizes, they are kept as is, so that repeated calls are free.
+|----------------------------------------------------------------------
+| on entry:
+|==========
+| ( work )  =  Pointer to a FgmrWork struct, either zeroed or set up
+|              by a previous call.
+|     n     =  size of the system
+|     im    =  Krylov subspace dimension
+|
+| On return:
+|===========
+|
+|  work->n, work->im, work->vv, work->z, work->hh
+|
+| integer value returned:
+|             0   --> successful return.
+|----------------------------------------------------------------------*/
+  int im1 = im+1;
+  if (work->vv != NULL && work->n == n && work->im == im)
+    return 0;
+  cleanFgmrWork(work);
+  work->n = n;
+  work->im = im;
+  work->vv = (double *)Malloc(im1*n*sizeof(double), "setupFgmrWork:vv");
+  work->z  = (double *)Malloc(im*n*sizeof(double), "setupFgmrWork:z");
+  work->hh = (double *)Malloc((im1*(im+3))*sizeof(double), "setupFgmrWork:hh");
+  return 0;
+}
+/*---------------------------------------------------------------------
+|     end of setupFgmrWork
+|--------------------------------------------------------------------*/
+
+int cleanFgmrWork(FgmrWorkptr work)
+{
+/*----------------------------------------------------------------------
+| Free up memory allocated for the work arrays of fgmrWork. The struct
+| itself is not freed and can be set up again.
+|----------------------------------------------------------------------
+| on entry:
+|==========
+| ( work )  =  Pointer to a FgmrWork struct.
+|--------------------------------------------------------------------*/
+  if (work == NULL) return 0;
+  if (work->vv) free(work->vv);
+  if (work->z) free(work->z);
+  if (work->hh) free(work->hh);
+  work->vv = work->z = work->hh = NULL;
+  work->n = work->im = 0;
+  return 0;
+}
+/*---------------------------------------------------------------------
+|     end of cleanFgmrWork
+|--------------------------------------------------------------------*/
+
 int fgmr(SMatptr Amat, SPreptr lu, double *rhs, double *sol, 
          double tol, int im, int *itmax, FILE *fits) { 
 /*----------------------------------------------------------------------
+| Same as fgmrWork, but allocates and frees the work arrays in each
+| call. Use fgmrWork with a persistent FgmrWork struct for repeated
+| solves of the same size.
++---------------------------------------------------------------------*/
+  FgmrWork work;
+  int retval;
+  work.n = work.im = 0;
+  work.vv = work.z = work.hh = NULL;
+  setupFgmrWork(&work, Amat->n, im);
+  retval = fgmrWork(Amat, lu, rhs, sol, tol, im, itmax, fits, &work);
+  cleanFgmrWork(&work);
+  return (retval);
+}
+/*-----------------end of fgmr -----------------------------------*/
+
+int fgmrWork(SMatptr Amat, SPreptr lu, double *rhs, double *sol, 
+             double tol, int im, int *itmax, FILE *fits,
+             FgmrWorkptr work) { 
+/*----------------------------------------------------------------------
 |                 *** Preconditioned FGMRES ***                  
 +-----------------------------------------------------------------------
 | This is a simple version of the ARMS preconditioned FGMRES algorithm. 
@@ -30,6 +108,8 @@ int fgmr(SMatptr Amat, SPreptr lu, double *rhs, double *sol,
 | (itmax) = max number of iterations allowed. 
 | fits    = NULL: no output
 |        != NULL: file handle to output " resid vs time and its" 
+| work    = work arrays set up by setupFgmrWork(work, n, im). They are
+|           overwritten but not freed, so they can be reused.
 |
 | on return:
 |---------- 
@@ -39,7 +119,7 @@ int fgmr(SMatptr Amat, SPreptr lu, double *rhs, double *sol,
 | itmax   = has changed. It now contains the number of steps required
 |           to converge -- 
 +-----------------------------------------------------------------------
-| internal work arrays:
+| work arrays (in work):
 |----------       
 | vv      = work array of length [im+1][n] (used to store the Arnoldi
 |           basis)
@@ -55,10 +135,11 @@ int fgmr(SMatptr Amat, SPreptr lu, double *rhs, double *sol,
   double *hh, *c, *s, *rs, t;
   double negt, beta, eps1=0, gam, *vv, *z; 
   im1 = im+1;
-  vv = (double *)Malloc(im1*n*sizeof(double), "fgmres:vv");
-  z  = (double *)Malloc(im*n*sizeof(double), "fgmres:z");
-  im1 = im+1;
-  hh = (double *)Malloc((im1*(im+3))*sizeof(double), "fgmres:hh");
+  if (work->n != n || work->im != im)
+    setupFgmrWork(work, n, im);
+  vv = work->vv;
+  z  = work->z;
+  hh = work->hh;
   c  = hh+im1*im ; s  = c+im1;  rs = s+im1;
 /*-------------------- outer loop starts here */
   retval = 0;
@@ -166,9 +247,6 @@ int fgmr(SMatptr Amat, SPreptr lu, double *rhs, double *sol,
   } 
 /*-------------------- prepare to return */
   *itmax = its; 
-  free(vv);
-  free(z);
-  free(hh);
   return (retval); 
 }
-/*-----------------end of fgmr -----------------------------------*/
+/*-----------------end of fgmrWork -------------------------------*/
@@ -1,4 +1,4 @@
-function [x, flag, iter, resids, times] = bicgstabMILU(varargin)
+function [x, flag, iter, resids, times, work] = bicgstabMILU(varargin)
 % bicgstabMILU BiCGSTAB with MILU as right preconditioner
 %
 %    x = bicgstabMILU(A, b) solves a sparse linear system using ILUPACK's
@@ -61,7 +61,12 @@ function [x, flag, iter, resids, times] = bicgstabMILU(varargin)
 %   'droptols' [droptol*0.1]: Threshold for dropping small entries from the
 %    Schur complement. Recommended value is one order smaller than droptol.
 %
-%   'nthreads' [1]: Maximal number of threads to use
+%   'nthreads' [1]: Maximal number of threads to use in the matrix-vector
+%    products and in the level-scheduled triangular solves of MILU
+%
+%   'work' [none]: Workspace of the Krylov solver returned by a previous
+%    call. Reusing it in repeated solves of the same size avoids
+%    reallocating the buffers of BiCGSTAB.
 %
 %    [x, flag] = bicgstabMILU(...) returns a convergence flag.
 %    flag  0 - solution found to tolerance
@@ -78,6 +83,9 @@ function [x, flag, iter, resids, times] = bicgstabMILU(varargin)
 %    [x, flag, iter, resids, times] = bicgstabMILU(...) returns the setup
 %    time (times(1)) and solve time (times(2)) in seconds.
 %
+%    [x, flag, iter, resids, times, work] = bicgstabMILU(...) returns the
+%    workspace of the Krylov solver, to be passed back using 'work'.
+%
 %  See also bicgstabMILU
 
 if nargin == 0
@@ -108,6 +116,7 @@ rtol = 1.e-6;
 maxit = int32(500);
 x0 = cast([], class(b));
 nthreads = int32(1);
+work = [];
 
 params_start = nargin;
 for i = next_index+1:nargin
@@ -144,6 +153,8 @@ for i = params_start:2:length(varargin)-1
             verbose = int32(varargin{i+1});
         case 'nthreads'
             nthreads = int32(varargin{i+1});
+        case 'work'
+            work = varargin{i+1};
         case 'ordering'
             options.ordering = varargin{i+1};
         case 'droptol'
@@ -164,6 +175,9 @@ if ~isfield(options, 'droptolS')
     options.droptolS = options.droptol * 0.1;
 end
 
+% Compute level schedules for multithreaded triangular solves
+options.levelsched = nthreads > 1;
+
 compiled = exist(['bicgstabMILU_kernel.' mexext], 'file');
 
 if verbose
@@ -196,8 +210,13 @@ if verbose
 end
 
 tic;
-[x, flag, iter, resids] = bicgstabMILU_kernel(A, b, M, ...
-    rtol, maxit, x0, verbose, nthreads);
+if isempty(work)
+    [x, flag, iter, resids, work] = bicgstabMILU_kernel(A, b, M, ...
+        rtol, maxit, x0, verbose, nthreads);
+else
+    [x, flag, iter, resids, work] = bicgstabMILU_kernel(A, b, M, ...
+        rtol, maxit, x0, verbose, nthreads, work);
+end
 
 times(2) = toc;
 
@@ -235,4 +254,11 @@ function test %#ok<DEFNU>
 %!         'maxit', 100);
 %! assert(norm(b - A*x) <= rtol * norm(b))
 
+%!test
+%! [x, flag, iter, resids, times, work] = bicgstabMILU(A, b, 'rtol', rtol, ...
+%!         'maxit', 100);
+%! [x, flag, iter, resids] = bicgstabMILU(A, 2 * b, 'rtol', rtol, ...
+%!         'maxit', 100, 'work', work);
+%! assert(norm(2 * b - A*x) <= 2 * rtol * norm(b))
+
 end
@@ -1,4 +1,4 @@
-function [x, flag, iter, resids, times] = gmresMILU(varargin)
+function [x, flag, iter, resids, times, work, precond] = gmresMILU(varargin)
 % gmresMILU GMRES with MILU as right preconditioner
 %
 %    x = gmresMILU(A, b) solves a sparse linear system using ILUPACK's
@@ -61,6 +61,14 @@ function [x, flag, iter, resids, times] = gmresMILU(varargin)
 %          'CGS' - classical Gram-Schmidt (faster in parallel but less stable)
 %          'MGS' - modified Gram-Schmidt (slower in parallel but more stable)
 %          'HO'  - Householder (slowest but the most stable)
+%          'PIPE' - pipelined classical Gram-Schmidt, which overlaps the
+%                  inner products with the matrix-vector product (fewest
+%                  synchronizations for many threads and large restart)
+%          'SSTEP' - s-step classical Gram-Schmidt, which orthogonalizes
+%                  blocks of four basis vectors at a time using
+%                  matrix-matrix operations (fewest synchronizations
+%                  overall but less stable for ill-conditioned systems)
+%          Only 'MGS' supports complex systems.
 %
 %   'matching' [1]: whether to use maximum weight matching.
 %
@@ -89,10 +97,40 @@ function [x, flag, iter, resids, times] = gmresMILU(varargin)
 %    Use 0 for unlimited (recommended).
 %
 %   'mixedprecision' [0]: require the computation of ILU in single precision.
+%    The compiled kernels then read the factors in single precision but
+%    perform all arithmetic in double precision.
 %
 %   'elbow' [10]: elbow space for the ILU. ILUPACK may overwrite this parameter at runtime.
 %
-%   'nthreads' [1]: Maximal number of threads to use
+%   'nthreads' [1]: Maximal number of threads to use in the matrix-vector
+%    products and in the level-scheduled triangular solves of MILU. If the
+%    kernel is compiled, it is also the number of threads that factor the
+%    subdomains of the nested-dissection partitioned factorization of large
+%    nonsymmetric matrices (see MILUfactor).
+%
+%   'work' [none]: Workspace of the Krylov solver returned by a previous
+%    call. Reusing it in repeated solves of the same size avoids
+%    reallocating the Krylov subspaces and other buffers.
+%
+%   'precond' [none]: Preconditioner returned by a previous call for a
+%    matrix with the same size, e.g., in a Newton iteration. Its factors
+%    are reused without refactoring A, unless GMRES fails to converge
+%    with them, in which case A is refactored and GMRES continues from the
+%    current solution. The kernel is selected again for the current 'orth'
+%    and number of right-hand sides. The level schedules of the factors
+%    are those of the call that computed them, so a reused precond applies
+%    the preconditioner sequentially if that call used one thread.
+%
+%   'adjoint' [0]: whether to solve the adjoint system A'*x = b instead.
+%    A is factored as usual, and the transpose of its preconditioner is
+%    applied using MILUsolve_transpose (see gmresMILU_adjoint), so the
+%    same 'precond' can be reused for A*x = b and A'*x = b. 'orth' is
+%    ignored, and multiple right-hand sides are solved one at a time.
+%
+%   'refresh' [2]: Factor by which the iteration count with a reused
+%    'precond' may exceed that of the call which computed it. Beyond it,
+%    the returned precond is marked stale, so that the next call
+%    refactors the matrix.
 %
 %    [x, flag] = gmresMILU(...) returns a convergence flag.
 %    flag: 0 - converged to the desired tolerance TOL within MAXIT iterations.
@@ -107,6 +145,32 @@ function [x, flag, iter, resids, times] = gmresMILU(varargin)
 %    [x, flag, iter, resids, times] = gmresMILU(...) returns the setup
 %    time (times(1)) and solve time (times(2)) in seconds.
 %
+%    [x, flag, iter, resids, times, work] = gmresMILU(...) returns the
+%    workspace of the Krylov solver, to be passed back using 'work'.
+%
+%    [x, flag, iter, resids, times, work, precond] = gmresMILU(...) returns
+%    the preconditioner, to be passed back using 'precond'. Its field
+%    refreshed indicates whether A was refactored in a call that reused a
+%    previous precond, and iter0 is the iteration count of the call that
+%    computed the factorization. If A was refactored after the reused
+%    precond failed, the solve started from the lagged iterate, so iter0
+%    is at least that of the previous precond. precond.M is empty if it
+%    became stale.
+%
+%    X = gmresMILU(A, B, ...) with an n-by-k matrix B solves for all the
+%    right-hand sides simultaneously using block GMRES, so that each
+%    iteration performs a single pass of the matrix-vector product and of
+%    the preconditioner for all columns. In this case, restart and maxit
+%    refer to block iterations, 'orth' is ignored, and resids is an
+%    iter-by-k matrix.
+%
+%    A and b may be complex. The preconditioner is then complex, and
+%    Hermitian if 'ishermitian' is set or A is detected as such. Complex
+%    systems are supported only with 'orth' = 'MGS', whose kernel is
+%    compiled for them (gmresMILU_MGS_complex). Multiple right-hand sides
+%    are then solved one at a time by the uncompiled kernel with ILUPACK's
+%    preconditioner.
+%
 %  See also bicgstabMILU
 
 if nargin == 0
@@ -139,6 +203,10 @@ restart = int32(30);
 x0 = cast([], class(b));
 nthreads = int32(1);
 orth = 'MGS';
+work = [];
+precond = [];
+refresh = 2;
+adjoint = false;
 
 params_start = nargin;
 for i = next_index+1:nargin
@@ -171,7 +239,7 @@ end
 
 % Process argument-value pairs to update arguments
 options = struct('ordering', 'amd', 'droptol', 0.001, 'condest', 5, ...
-    'issymmetric', -1, 'ishermitian', 0, 'isdefinite', 0);
+    'issymmetric', -1, 'ishermitian', 0, 'isdefinite', 0, 'nthreads', 1);
 for i = params_start:2:length(varargin)-1
     switch lower(varargin{i})
         case {'maxit', 'maxiter'}
@@ -212,7 +280,15 @@ for i = params_start:2:length(varargin)-1
         case 'mixedprecision'
             options.mixedprecision = double(varargin{i+1});
         case 'nthreads'
-            nthreads = int32(varargin{i+1});
+            nthreads = int32(max(varargin{i+1}, 1));
+        case 'work'
+            work = varargin{i+1};
+        case 'precond'
+            precond = varargin{i+1};
+        case 'refresh'
+            refresh = double(varargin{i+1});
+        case 'adjoint'
+            adjoint = logical(varargin{i+1});
         otherwise
             error('Unknown tuning parameter "%s"', varargin{i});
     end
@@ -222,15 +298,151 @@ if ~isfield(options, 'droptolS')
     options.droptolS = options.droptol * 0.1;
 end
 
-kernel = ['gmresMILU_', orth];
-kernel_func = eval(['@' kernel]);
+if (~isreal(A.val) || ~isreal(b)) && ~adjoint && ~strcmpi(orth, 'MGS')
+    error('gmresMILU:ComplexOrth', ...
+        'Complex systems are supported only with orth = ''MGS''.');
+end
 
-compiled = exist([kernel '.' mexext], 'file');
+% Compute level schedules for multithreaded triangular solves
+options.levelsched = nthreads > 1;
+
+if adjoint
+    kernel0 = 'gmresMILU_adjoint';
+elseif size(b, 2) > 1
+    kernel0 = 'gmresMILU_block';
+else
+    kernel0 = ['gmresMILU_', orth];
+end
+
+compiled0 = exist([kernel0 '.' mexext], 'file');
+if compiled0
+    % The partitioned factorization is applied only by MILUsolve
+    options.nthreads = nthreads;
+end
 
 if options.issymmetric == -1
     options.issymmetric = issymmetric(crs_2sparse(A));
 end
 
+% The kernels are called with A' in the adjoint mode, while its
+% preconditioner is computed from A
+if adjoint
+    Ak = crs_matrix(crs_2sparse(A)');
+else
+    Ak = A;
+end
+
+times = zeros(2, 1);
+lagged = ~isempty(precond) && ~isempty(precond.M);
+if lagged
+    % Select the kernel for the current 'orth', number of right-hand sides
+    % and 'adjoint', which may differ from those of the previous call. The
+    % factors of A are shared by A*x = b and A'*x = b. Refactor if the
+    % compiled kernel of the factors is not available
+    if precond.compiled
+        [precond.kernel, precond.compiled] = select_kernel(precond.M, kernel0);
+        lagged = precond.compiled ~= 0;
+    else
+        precond.kernel = noncompiled_kernel(kernel0, orth);
+    end
+end
+if lagged
+    % Reuse the preconditioner returned by a previous call
+    M = precond.M;
+    kernel = precond.kernel;
+    kernel_func = eval(['@' kernel]);
+    compiled = precond.compiled;
+    if verbose
+        fprintf(1, 'Reusing the ILU factorization of a previous call.\n');
+    end
+else
+    [M, kernel, compiled, times(1)] = factor_milu(varargin(1:next_index-1), ...
+        A, options, kernel0, orth, verbose);
+    kernel_func = eval(['@' kernel]);
+end
+
+if verbose
+    fprintf(1, 'Starting Krylov solver ...\n');
+end
+
+tic;
+[x, flag, iter, resids, work] = solve_milu(kernel_func, compiled, Ak, b, M, ...
+    restart, rtol, maxit, x0, verbose, nthreads, work);
+times(2) = toc;
+
+refreshed = false;
+iter_lagged = int32(0);
+if lagged && flag
+    % The lagged preconditioner failed, so refactor and continue from x
+    if verbose
+        fprintf(1, 'GMRES with the lagged preconditioner did not converge. Refactoring...\n');
+    end
+    if ~compiled && nargout > 6
+        % The new preconditioner replaces precond in the output
+        M = ILUdelete(M);
+    end
+    [M, kernel, compiled, t] = factor_milu(varargin(1:next_index-1), ...
+        A, options, kernel0, orth, verbose);
+    times(1) = times(1) + t;
+    kernel_func = eval(['@' kernel]);
+
+    tic;
+    iter_lagged = iter;
+    [x, flag, iter, resids2, work] = solve_milu(kernel_func, compiled, Ak, b, M, ...
+        restart, rtol, maxit, x, verbose, nthreads, work);
+    times(2) = times(2) + toc;
+    resids = [resids; resids2];
+    iter = iter_lagged + iter;
+    refreshed = true;
+end
+
+if verbose
+    if flag == 0
+        fprintf(1, 'Finished solve in %d iterations and %.2f seconds.\n', iter, times(2));
+        if ~compiled && exist('OCTAVE_VERSION', 'builtin')
+            warning('The solve step used uncomplied GMRES, so its timing is inaccurate.');
+        end
+    elseif flag == 3
+        fprintf(1, 'GMRES stagnated after %d iterations and %.4g seconds.\n', iter, times(2));
+    else
+        fprintf(1, 'GMRES failed to converge after %d iterations and %.4g seconds.\n', iter, times(2));
+    end
+end
+
+if nargout > 6
+    if ~lagged || refreshed
+        % Return the new preconditioner for lagging in subsequent calls
+        if refreshed
+            % The warm-started solve understates the baseline iteration count
+            iter0 = max(iter - iter_lagged, precond.iter0);
+        else
+            iter0 = iter;
+        end
+        precond = struct('M', {M}, 'kernel', kernel, 'compiled', compiled, ...
+            'iter0', iter0, 'refreshed', refreshed);
+    else
+        precond.refreshed = false;
+        if iter > refresh * precond.iter0
+            % Converged slowly, so the next call will refactor
+            if verbose
+                fprintf(1, 'The lagged preconditioner is stale and will be refreshed.\n');
+            end
+            if ~compiled
+                M = ILUdelete(M); %#ok<NASGU>
+            end
+            precond.M = [];
+        end
+    end
+elseif ~compiled && (~lagged || refreshed)
+    M = ILUdelete(M); %#ok<NASGU>
+end
+
+end
+
+function [M, kernel, compiled, runtime] = factor_milu(args, A, options, ...
+    kernel, orth, verbose)
+% Perform the ILU factorization and select the kernel for its result
+
 if verbose
     if options.issymmetric
         if options.isdefinite
@@ -244,13 +456,29 @@ if verbose
     fprintf(1, ['Performing ', version ,' ILU factorization...\n']);
 end
 
-% Perform ILU factorization
-times = zeros(2, 1);
-[M, newoptions, prec, times(1)] = MILUfactor(varargin{1:next_index-1}, options);
+if options.nthreads > 1
+    % Allow the partitioned factorization, which MILUfactor performs only
+    % if the preconditioner of ILUPACK is not requested
+    tic;
+    [M, newoptions] = MILUfactor(args{:}, options);
+    runtime = toc;
+    prec = [];
+else
+    [M, newoptions, prec, runtime] = MILUfactor(args{:}, options);
+end
+compiled = 0;
+if ~isempty(M)
+    [kernel, compiled] = select_kernel(M, kernel);
+end
+if ~compiled && isempty(prec)
+    % The uncompiled kernels apply the preconditioner of ILUPACK
+    options.nthreads = 1;
+    [M, newoptions, prec, t] = MILUfactor(args{:}, options);
+    runtime = runtime + t;
+end
 if isempty(M) || ~compiled
     M = prec;
-    kernel = ['gmresMILU_', orth, '_noncompiled'];
-    kernel_func = eval(['@' kernel]);
+    kernel = noncompiled_kernel(kernel, orth);
     compiled = 0;
 end
 
@@ -265,34 +493,96 @@ if verbose
         fprintf(1, '%.1f%% of nnz are in E and F.\n', ...
             newoptions.nnz_offdiag/newoptions.nnz_total*100);
     end
-    fprintf(1, 'Finished ILU factorization in %.4g seconds \n', times(1));
+    fprintf(1, 'Finished ILU factorization in %.4g seconds \n', runtime);
 end
 
-if verbose
-    fprintf(1, 'Starting Krylov solver ...\n');
 end
 
-tic;
-[x, flag, iter, resids] = kernel_func(A, b, M, ...
-    restart, rtol, maxit, x0, verbose, nthreads);
-times(2) = toc;
+function [kernel, compiled] = select_kernel(M, kernel)
+% Select the compiled kernel for the MILU factors in M, or return zero in
+% compiled if it is not available
 
-if verbose
-    if flag == 0
-        fprintf(1, 'Finished solve in %d iterations and %.2f seconds.\n', iter, times(2));
-        if ~compiled && exist('OCTAVE_VERSION', 'builtin')
-            warning('The solve step used uncomplied GMRES, so its timing is inaccurate.');
-        end
-    elseif flag == 3
-        fprintf(1, 'GMRES stagnated after %d iterations and %.4g seconds.\n', iter, times(2));
+if isfield(M, 'hermitian')
+    % Use the kernel compiled for complex factors, which exists only for
+    % modified Gram-Schmidt
+    if ~isequal(kernel, 'gmresMILU_MGS')
+        compiled = 0;
+        return;
+    end
+    kernel = 'gmresMILU_MGS_complex';
+elseif isa(M(1).L.val, 'single')
+    % Use the kernel compiled for single-precision factors
+    kernel = [kernel, '_mixed'];
+end
+compiled = exist([kernel '.' mexext], 'file');
+
+end
+
+function kernel = noncompiled_kernel(kernel, orth)
+% Select the uncompiled kernel, which applies the preconditioner of ILUPACK
+
+if isequal(kernel, 'gmresMILU_adjoint')
+    % The uncompiled adjoint kernel applies ILUhsol
+    kernel = 'gmresMILU_adjoint_noncompiled';
+elseif exist(['gmresMILU_', orth, '_noncompiled'], 'file')
+    kernel = ['gmresMILU_', orth, '_noncompiled'];
+else
+    kernel = ['gmresMILU_', orth];
+end
+
+end
+
+function [x, flag, iter, resids, work] = solve_milu(kernel_func, compiled, ...
+    A, b, M, restart, rtol, maxit, x0, verbose, nthreads, work)
+% Call the kernel for one or more right-hand sides
+
+if size(b, 2) > 1 && (~compiled || isempty(strfind(func2str(kernel_func), '_block')))
+    % Without the compiled block kernel, solve one column at a time
+    [x, flag, iter, resids] = gmres_columnwise(kernel_func, A, b, M, ...
+        restart, rtol, maxit, x0, verbose, nthreads);
+elseif size(b, 2) > 1
+    % The block kernel does not use a workspace
+    [x, flag, iter, resids] = kernel_func(A, b, M, ...
+        restart, rtol, maxit, x0, verbose, nthreads);
+elseif isempty(work)
+    [x, flag, iter, resids, work] = kernel_func(A, b, M, ...
+        restart, rtol, maxit, x0, verbose, nthreads);
+else
+    [x, flag, iter, resids, work] = kernel_func(A, b, M, ...
+        restart, rtol, maxit, x0, verbose, nthreads, work);
+end
+
+end
+
+function [x, flag, iter, resids] = gmres_columnwise(kernel_func, A, b, M, ...
+    restart, rtol, maxit, x0, verbose, nthreads)
+% Solve for multiple right-hand sides one column at a time
+
+x = zeros(size(b));
+flag = int32(0);
+iter = int32(0);
+resids = cell(1, size(b, 2));
+for j = 1:size(b, 2)
+    if isempty(x0)
+        x0j = x0;
     else
-        fprintf(1, 'GMRES failed to converge after %d iterations and %.4g seconds.\n', iter, times(2));
+        x0j = x0(:, j);
     end
+    [x(:, j), flagj, iterj, resids{j}] = kernel_func(A, b(:, j), M, ...
+        restart, rtol, maxit, x0j, verbose, nthreads);
+    flag = max(flag, flagj);
+    iter = max(iter, iterj);
 end
 
-if ~compiled
-    M = ILUdelete(M); %#ok<NASGU>
+% Pad residual histories into an iter-by-k matrix
+for j = 1:size(b, 2)
+    if isempty(resids{j})
+        resids{j} = zeros(iter, 1);
+    else
+        resids{j}(end+1:iter, 1) = resids{j}(end);
+    end
 end
+resids = [resids{:}];
 
 end
 
@@ -324,4 +614,70 @@ function test %#ok<DEFNU>
 %!         'maxit', 100, 'orth', 'HO');
 %! assert(norm(b - A*x) <= rtol * norm(b))
 
+%!test
+%! [x, flag, iter, resids] = gmresMILU(A, b, 'rtol', rtol, ...
+%!         'maxit', 100, 'orth', 'PIPE');
+%! assert(norm(b - A*x) <= rtol * norm(b))
+
+%!test
+%! [x, flag, iter, resids] = gmresMILU(A, b, 'rtol', rtol, ...
+%!         'maxit', 100, 'orth', 'SSTEP');
+%! assert(norm(b - A*x) <= rtol * norm(b))
+
+%!test
+%! [x, flag, iter, resids, times, work] = gmresMILU(A, b, 'rtol', rtol, ...
+%!         'maxit', 100);
+%! [x, flag, iter, resids] = gmresMILU(A, 2 * b, 'rtol', rtol, ...
+%!         'maxit', 100, 'work', work);
+%! assert(norm(2 * b - A*x) <= 2 * rtol * norm(b))
+
+%!test
+%! B = [b, A * ones(size(b)), rand(size(b))];
+%! [X, flag, iter, resids] = gmresMILU(A, B, 'rtol', rtol, 'maxit', 100);
+%! for j = 1:size(B, 2)
+%!     assert(norm(B(:, j) - A*X(:, j)) <= rtol * norm(B(:, j)))
+%! end
+
+%!test
+%! [x, flag, iter, resids, times, work, precond] = gmresMILU(A, b, ...
+%!         'rtol', rtol, 'maxit', 100);
+%! assert(~precond.refreshed && precond.iter0 == iter)
+%! A2 = A + 0.01 * spdiags(diag(A), 0, size(A, 1), size(A, 1));
+%! [x, flag, iter, resids, times, work, precond] = gmresMILU(A2, b, ...
+%!         'rtol', rtol, 'maxit', 100, 'precond', precond);
+%! assert(times(1) == 0 || precond.refreshed)
+%! assert(norm(b - A2*x) <= rtol * norm(b))
+
+%!test
+%! % Without the compiled kernel, the factorization is sequential and the
+%! % uncompiled kernel applies the preconditioner of ILUPACK
+%! [x, flag, iter, resids, times, work, precond] = gmresMILU(A, b, ...
+%!         'rtol', rtol, 'maxit', 100, 'nthreads', 2);
+%! assert(norm(b - A*x) <= rtol * norm(b))
+%! if ~exist(['gmresMILU_MGS.' mexext], 'file')
+%!     assert(~precond.compiled)
+%!     assert(strcmp(precond.kernel, 'gmresMILU_MGS_noncompiled'))
+%! end
+%! ILUdelete(precond.M);
+
+%!test
+%! [x, flag, iter, resids, times, work, precond] = gmresMILU(A, b, ...
+%!         'rtol', rtol, 'maxit', 100);
+%! [x, flag] = gmresMILU(A, b, 'rtol', rtol, 'maxit', 100, ...
+%!         'adjoint', 1, 'precond', precond);
+%! assert(flag == 0)
+%! assert(norm(b - A'*x) <= rtol * norm(b))
+
+%!test
+%! % Shifted Laplacian with absorption, as in a Helmholtz problem
+%! A = delsq(numgrid('S', 52));
+%! n = size(A, 1);
+%! A = A - 0.5 * speye(n) + 0.1i * speye(n);
+%! b = A * complex(ones(n, 1), 1);
+%! [x, flag] = gmresMILU(A, b, 'rtol', 1.e-8, 'maxit', 100);
+%! assert(flag == 0 && norm(b - A*x) <= 1.e-8 * norm(b))
+%! [x, flag] = gmresMILU(A, b, 'rtol', 1.e-8, 'maxit', 100, ...
+%!         'issymmetric', 0);
+%! assert(flag == 0 && norm(b - A*x) <= 1.e-8 * norm(b))
+
 end
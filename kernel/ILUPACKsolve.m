@@ -1,4 +1,4 @@
-function [x, flag, iter, times] = ILUPACKsolve(varargin)
+function [x, flag, iter, times, precond] = ILUPACKsolve(varargin)
 % Solves a sparse system using GMRES with Multilevel ILU as right preconditioner
 %
 % Syntax:
@@ -29,8 +29,33 @@ function [x, flag, iter, times] = ILUPACKsolve(varargin)
 %    x = ILUPACKsolve(rowptr, colind, vals, b, restart, rtol, maxit, x0, opts)
 %    allows you to specify additional options for ILUPACK.
 %
+%    x = ILUPACKsolve(A, b, restart, rtol, maxit, x0, opts, precond)
+%    x = ILUPACKsolve(rowptr, colind, vals, b, restart, rtol, maxit, x0, opts, precond)
+%    reuses the preconditioner returned by a previous call for a matrix
+%    of the same size, e.g., in a Newton iteration, instead of factoring
+%    A. If the solver does not converge with it, A is refactored and the
+%    solve continues from the current solution.
+%
+%    x = ILUPACKsolve(A, b, restart, rtol, maxit, x0, opts, precond, refresh)
+%    x = ILUPACKsolve(rowptr, colind, vals, b, restart, rtol, maxit, x0, opts, precond, refresh)
+%    specifies the factor by which the iteration count with a reused
+%    precond may exceed that of the call which computed it, as the
+%    'refresh' parameter of gmresMILU. Use [] to preserve precond.refresh,
+%    which is 2 for a new precond.
+%
 %    [x, flag, iter, times] = ILUPACKsolve(...) returns the iteration
 %      counts and runtimes.
+%
+%    [x, flag, iter, times, precond] = ILUPACKsolve(...) also returns the
+%      preconditioner, to be passed back as the precond argument. Its
+%      field refreshed indicates whether A was refactored in a call that
+%      reused a previous precond, and iter0 is the iteration count of the
+%      call that computed the factorization. If A was refactored after the
+%      reused precond failed, the solve started from the lagged iterate,
+%      so iter0 is at least that of the previous precond. If the iteration
+%      count of a call that reused precond exceeds precond.refresh times
+%      iter0, then precond.PREC is deleted and set to [], so that the next
+%      call refactors A. Use ILUdelete(precond.PREC) to free it.
 
 if nargin == 0
     help ILUPACKsolve
@@ -54,31 +79,34 @@ else
     b = varargin{next_index};
 end
 
-% Perform ILU factorization
-times = zeros(2, 1);
-tic;
-[~, options, PREC] = MILUfactor(varargin{1:next_index-1}, varargin{next_index+5:end});
-times(1) = toc;
-
-if nargin >= next_index + 1 && ~isempty(varargin{next_index+1})
-    options.nrestart = cast(varargin{next_index+1}, class(options.nrestart));
+if nargin >= next_index + 6
+    precond = varargin{next_index+6};
 else
-    options.nrestart = cast(30, class(options.nrestart));
+    precond = [];
 end
 
-if nargin >= next_index + 2 && ~isempty(varargin{next_index+2})
-    options.restol = cast(varargin{next_index+2}, class(options.restol));
+if nargin >= next_index + 7 && ~isempty(varargin{next_index+7})
+    refresh = double(varargin{next_index+7});
+elseif ~isempty(precond) && isfield(precond, 'refresh')
+    refresh = precond.refresh;
 else
-    options.restol = cast(1.e-5, class(options.restol));
+    refresh = 2;
 end
 
-options.restol = options.restol / norm(PREC(1).rowscal);
-
-if nargin >= next_index + 3 && ~isempty(varargin{next_index+3})
-    options.maxit = cast(varargin{next_index+3}, class(options.maxit));
+% Perform ILU factorization, unless reusing the preconditioner of a
+% previous call
+times = zeros(2, 1);
+lagged = ~isempty(precond) && ~isempty(precond.PREC);
+if lagged
+    PREC = precond.PREC;
+    factor_options = precond.options;
 else
-    options.maxit = cast(10000, class(options.maxit));
+    tic;
+    [~, factor_options, PREC] = MILUfactor(varargin{1:next_index-1}, ...
+        varargin{next_index+5:min(end, next_index+5)});
+    times(1) = toc;
 end
+options = solver_options(factor_options, PREC, varargin, next_index);
 
 if nargin >= next_index + 4 && ~isempty(varargin{next_index+4})
     x0 = varargin{next_index+4};
@@ -86,14 +114,6 @@ else
     x0 = cast([], class(b));
 end
 
-if nargin >= next_index + 5 && ~isempty(varargin{next_index+5})
-    opts = varargin{next_index+5};
-    names = fieldnames(opts);
-    for i = 1:length(names)
-        options.(names(i)) = cast(opts.(names(i)), class(options.(names(i))));
-    end
-end
-
 if nargout < 4
     fprintf(1, 'Finished setup in %.1f seconds \n', times(1));
 end
@@ -105,8 +125,27 @@ else
     [x, options] = ILUsolver(A, PREC, options, b, x0);
 end
 times(2) = toc;
+iter = options.niter;
 
-PREC = ILUdelete(PREC); %#ok<NASGU>
+refreshed = false;
+if lagged && options.niter >= options.maxit
+    % The lagged preconditioner failed, so refactor and continue from x
+    if nargout > 4
+        % The new preconditioner replaces precond in the output
+        PREC = ILUdelete(PREC);
+    end
+    tic;
+    [~, factor_options, PREC] = MILUfactor(varargin{1:next_index-1}, ...
+        varargin{next_index+5:min(end, next_index+5)});
+    times(1) = toc;
+    options = solver_options(factor_options, PREC, varargin, next_index);
+
+    tic;
+    [x, options] = ILUsolver(A, PREC, options, b, x);
+    times(2) = times(2) + toc;
+    iter = iter + options.niter;
+    refreshed = true;
+end
 
 if options.niter >= options.maxit
     % Reached max number of iterations
@@ -115,10 +154,66 @@ else
     flag = int32(0);
 end
 
-iter = options.niter;
-
 if nargout < 4
-    fprintf(1, 'Finished solve in %d iterations and %.1f seconds.\n', options.niter, times(2));
+    fprintf(1, 'Finished solve in %d iterations and %.1f seconds.\n', iter, times(2));
+end
+
+if nargout > 4
+    if ~lagged || refreshed
+        % Return the new preconditioner for lagging in subsequent calls
+        if refreshed
+            % The warm-started solve understates the baseline iteration count
+            iter0 = max(options.niter, precond.iter0);
+        else
+            iter0 = options.niter;
+        end
+        precond = struct('PREC', {PREC}, 'options', factor_options, ...
+            'iter0', iter0, 'refresh', refresh, 'refreshed', refreshed);
+    else
+        precond.refresh = refresh;
+        precond.refreshed = false;
+        if iter > refresh * precond.iter0
+            % Converged slowly, so the next call will refactor
+            PREC = ILUdelete(PREC); %#ok<NASGU>
+            precond.PREC = [];
+        end
+    end
+elseif ~lagged || refreshed
+    PREC = ILUdelete(PREC); %#ok<NASGU>
+end
+
+end
+
+function options = solver_options(options, PREC, args, next_index)
+% Set the options of ILUsolver from the positional arguments
+
+nargs = length(args);
+if nargs >= next_index + 1 && ~isempty(args{next_index+1})
+    options.nrestart = cast(args{next_index+1}, class(options.nrestart));
+else
+    options.nrestart = cast(30, class(options.nrestart));
+end
+
+if nargs >= next_index + 2 && ~isempty(args{next_index+2})
+    options.restol = cast(args{next_index+2}, class(options.restol));
+else
+    options.restol = cast(1.e-5, class(options.restol));
+end
+
+options.restol = options.restol / norm(PREC(1).rowscal);
+
+if nargs >= next_index + 3 && ~isempty(args{next_index+3})
+    options.maxit = cast(args{next_index+3}, class(options.maxit));
+else
+    options.maxit = cast(10000, class(options.maxit));
+end
+
+if nargs >= next_index + 5 && ~isempty(args{next_index+5})
+    opts = args{next_index+5};
+    names = fieldnames(opts);
+    for i = 1:length(names)
+        options.(names{i}) = cast(opts.(names{i}), class(options.(names{i})));
+    end
 end
 
 end
@@ -140,4 +235,15 @@ function test %#ok<DEFNU>
 %! x = ILUPACKsolve(A, b, 30, rtol, 100);
 %! assert(norm(b - A*x) < rtol * norm(b))
 
+%!test
+%! [x, flag, iter, times, precond] = ILUPACKsolve(A, b, 30, rtol, 100);
+%! assert(~precond.refreshed && precond.iter0 == iter)
+%! [x, flag, iter, times, precond] = ILUPACKsolve(A, 2 * b, 30, rtol, ...
+%!         100, [], [], precond);
+%! assert(times(1) == 0 && ~precond.refreshed)
+%! assert(norm(2 * b - A*x) < 2 * rtol * norm(b))
+%! if ~isempty(precond.PREC)
+%!     precond.PREC = ILUdelete(precond.PREC);
+%! end
+
 end
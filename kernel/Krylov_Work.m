@@ -0,0 +1,17 @@
+function type = Krylov_Work
+% Data type definition for workspace of Krylov kernels
+
+type = coder.typeof(...
+    struct('Q', m2c_mat, ...
+    'Z', m2c_mat, ...
+    'P', m2c_mat, ...
+    'R', m2c_mat, ...
+    'J', m2c_mat, ...
+    'y', m2c_vec, ...
+    'u', m2c_vec, ...
+    'v', m2c_vec, ...
+    'w', m2c_vec, ...
+    'y1', m2c_vec, ...
+    'y2', m2c_vec, ...
+    'Aq', crs_matrix, ...
+    'qinv', m2c_intvec));
@@ -0,0 +1,19 @@
+function type = Krylov_ZWork
+% Data type definition for workspace of Krylov kernels for complex systems
+
+zmat = coder.typeof(complex(0), [inf, inf]);
+
+type = coder.typeof(...
+    struct('Q', zmat, ...
+    'Z', zmat, ...
+    'P', zmat, ...
+    'R', zmat, ...
+    'J', zmat, ...
+    'y', MILU_zvec, ...
+    'u', MILU_zvec, ...
+    'v', MILU_zvec, ...
+    'w', MILU_zvec, ...
+    'y1', MILU_zvec, ...
+    'y2', MILU_zvec, ...
+    'Aq', MILU_zcrs, ...
+    'qinv', m2c_intvec));
@@ -0,0 +1,76 @@
+function work = Krylov_createWork(n, restart, nE, work)
+%Krylov_createWork Create or resize the workspace of the Krylov kernels
+%
+%   work = Krylov_createWork(n, restart, nE)
+%   allocates the buffers of gmresMILU_HO, gmresMILU_MGS, gmresMILU_CGS,
+%   gmresMILU_PIPE, gmresMILU_SSTEP, bicgstabMILU_kernel, pcgMILU_kernel
+%   and sqmrMILU_kernel for a system of size n with the given restart
+%   (restart+1 for gmresMILU_SSTEP, 2 for bicgstabMILU_kernel and
+%   sqmrMILU_kernel, and 1 for pcgMILU_kernel), where nE is
+%   M(1).negE.nrows.
+%
+%   work = Krylov_createWork(n, restart, nE, work)
+%   reuses the buffers in work and reallocates only those whose sizes
+%   differ. When the workspace is passed to the kernels repeatedly for
+%   systems of the same size and sparsity, no buffer is reallocated. The
+%   fields Aq and qinv hold the output of MILU_permuteA. The buffers keep
+%   their class, so a complex workspace (see Krylov_ZWork) stays complex.
+%
+% See also: Krylov_Work, gmresMILU, bicgstabMILU, pcgMILU, sqmrMILU
+
+%#codegen -args {int32(0), int32(0), int32(0), Krylov_Work}
+%#codegen Krylov_createWork_3args -args {int32(0), int32(0), int32(0)}
+
+if nargin < 4
+    work = struct('Q', zeros(n, restart), ...
+        'Z', zeros(n, restart), ...
+        'P', zeros(0, 0), ...
+        'R', zeros(restart, restart), ...
+        'J', zeros(2, restart), ...
+        'y', zeros(restart+1, 1), ...
+        'u', zeros(n, 1), ...
+        'v', zeros(n, 1), ...
+        'w', zeros(n, 1), ...
+        'y1', zeros(n, 1), ...
+        'y2', zeros(nE, 1), ...
+        'Aq', crs_matrix(0, 0), ...
+        'qinv', zeros(0, 1, 'int32'));
+    coder.varsize('work.Q', 'work.Z', 'work.P', 'work.R', 'work.J', 'work.y', ...
+        'work.u', 'work.v', 'work.w', 'work.y1', 'work.y2', 'work.qinv');
+else
+    work.Q = resize_buffer(work.Q, n, restart);
+    work.Z = resize_buffer(work.Z, n, restart);
+    work.R = resize_buffer(work.R, restart, restart);
+    work.J = resize_buffer(work.J, int32(2), restart);
+    work.y = resize_buffer(work.y, restart+1, int32(1));
+    work.u = resize_buffer(work.u, n, int32(1));
+    work.v = resize_buffer(work.v, n, int32(1));
+    work.w = resize_buffer(work.w, n, int32(1));
+    work.y1 = resize_buffer(work.y1, n, int32(1));
+    work.y2 = resize_buffer(work.y2, nE, int32(1));
+    % work.P is resized by gmresMILU_PIPE, and work.Aq and work.qinv
+    % are resized by MILU_permuteA
+end
+
+end
+
+function buf = resize_buffer(buf, m, k)
+% Reallocate buf only if its size is not m-by-k
+
+if size(buf, 1) ~= m || size(buf, 2) ~= k
+    buf = zeros(m, k, 'like', buf);
+end
+
+end
+
+function test %#ok<DEFNU>
+%!test
+%! work = Krylov_createWork(int32(10), int32(4), int32(3));
+%! assert(isequal(size(work.Q), [10 4]) && isequal(size(work.y2), [3 1]));
+%! work.Q(1) = 1;
+%! work = Krylov_createWork(int32(10), int32(4), int32(3), work);
+%! assert(work.Q(1) == 1);
+%! work = Krylov_createWork(int32(20), int32(4), int32(3), work);
+%! assert(isequal(size(work.Q), [20 4]) && work.Q(1) == 0);
+
+end
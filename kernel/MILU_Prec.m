@@ -6,9 +6,18 @@ type = coder.typeof(...
     'q', m2c_intvec, ...
     'rowscal', m2c_vec, ...
     'colscal', m2c_vec, ...
+    'prowscal', m2c_vec, ...
+    'qcolscal', m2c_vec, ...
     'L', ccs_matrix, ...
     'U', ccs_matrix, ...
     'd', m2c_vec, ...
+    'doff', m2c_vec, ...
     'negE', crs_matrix, ...
-    'negF', crs_matrix), ...
-    [inf, 1]);
\ No newline at end of file
+    'negF', crs_matrix, ...
+    'Lrow', crs_matrix, ...
+    'Urow', crs_matrix, ...
+    'Llev_ptr', m2c_intvec, ...
+    'Llev_ind', m2c_intvec, ...
+    'Ulev_ptr', m2c_intvec, ...
+    'Ulev_ind', m2c_intvec), ...
+    [inf, 1]);
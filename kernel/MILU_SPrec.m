@@ -0,0 +1,35 @@
+function type = MILU_SPrec
+% Data type definition for preconditioner with single-precision values
+
+svec = coder.typeof(single(0), [inf, 1]);
+sccs = coder.typeof(struct('col_ptr', m2c_intvec, ...
+    'row_ind', m2c_intvec, ...
+    'val', svec, ...
+    'nrows', int32(0), ...
+    'ncols', int32(0)));
+scrs = coder.typeof(struct('row_ptr', m2c_intvec, ...
+    'col_ind', m2c_intvec, ...
+    'val', svec, ...
+    'nrows', int32(0), ...
+    'ncols', int32(0)));
+
+type = coder.typeof(...
+    struct('p', m2c_intvec, ...
+    'q', m2c_intvec, ...
+    'rowscal', svec, ...
+    'colscal', svec, ...
+    'prowscal', svec, ...
+    'qcolscal', svec, ...
+    'L', sccs, ...
+    'U', sccs, ...
+    'd', svec, ...
+    'doff', svec, ...
+    'negE', scrs, ...
+    'negF', scrs, ...
+    'Lrow', scrs, ...
+    'Urow', scrs, ...
+    'Llev_ptr', m2c_intvec, ...
+    'Llev_ind', m2c_intvec, ...
+    'Ulev_ptr', m2c_intvec, ...
+    'Ulev_ind', m2c_intvec), ...
+    [inf, 1]);
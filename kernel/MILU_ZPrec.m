@@ -0,0 +1,32 @@
+function type = MILU_ZPrec
+% Data type definition for preconditioner with complex values. The scaling
+% vectors are real, and hermitian indicates whether U = L' (conjugate
+% transpose) or U = L.' (transpose) for the levels storing only L.
+
+zccs = coder.typeof(struct('col_ptr', m2c_intvec, ...
+    'row_ind', m2c_intvec, ...
+    'val', MILU_zvec, ...
+    'nrows', int32(0), ...
+    'ncols', int32(0)));
+
+type = coder.typeof(...
+    struct('p', m2c_intvec, ...
+    'q', m2c_intvec, ...
+    'rowscal', m2c_vec, ...
+    'colscal', m2c_vec, ...
+    'prowscal', m2c_vec, ...
+    'qcolscal', m2c_vec, ...
+    'L', zccs, ...
+    'U', zccs, ...
+    'd', MILU_zvec, ...
+    'doff', MILU_zvec, ...
+    'negE', MILU_zcrs, ...
+    'negF', MILU_zcrs, ...
+    'Lrow', MILU_zcrs, ...
+    'Urow', MILU_zcrs, ...
+    'Llev_ptr', m2c_intvec, ...
+    'Llev_ind', m2c_intvec, ...
+    'Ulev_ptr', m2c_intvec, ...
+    'Ulev_ind', m2c_intvec, ...
+    'hermitian', false), ...
+    [inf, 1]);
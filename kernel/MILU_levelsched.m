@@ -0,0 +1,99 @@
+function [lev_ptr, lev_ind] = MILU_levelsched(T, isupper)
+%MILU_levelsched Compute wavefronts of a strictly triangular factor
+%
+%   [lev_ptr, lev_ind] = MILU_levelsched(T, isupper)
+%   T is a strictly lower (isupper=false) or strictly upper (isupper=true)
+%   triangular matrix in CCS format, as stored in M(i).L and M(i).U by
+%   MILUfactor. The rows lev_ind(lev_ptr(k):lev_ptr(k+1)-1) form the kth
+%   wavefront: they depend only on rows in wavefronts 1 to k-1, so they
+%   can be solved concurrently in the level-scheduled path of MILUsolve.
+%
+% See also: MILUfactor, MILUsolve
+
+%#codegen -args {ccs_matrix, false}
+
+n = T.ncols;
+
+% Compute the wavefront of each row. Before row j is finalized, lev(j)
+% holds the maximum wavefront of the rows it depends on.
+lev = zeros(n, 1, 'int32');
+nlevs = int32(0);
+if isupper
+    for j = n:-1:1
+        lev(j) = lev(j) + 1;
+        if lev(j) > nlevs
+            nlevs = lev(j);
+        end
+        for k = T.col_ptr(j):T.col_ptr(j+1)-1
+            i = T.row_ind(k);
+            if lev(i) < lev(j)
+                lev(i) = lev(j);
+            end
+        end
+    end
+else
+    for j = 1:n
+        lev(j) = lev(j) + 1;
+        if lev(j) > nlevs
+            nlevs = lev(j);
+        end
+        for k = T.col_ptr(j):T.col_ptr(j+1)-1
+            i = T.row_ind(k);
+            if lev(i) < lev(j)
+                lev(i) = lev(j);
+            end
+        end
+    end
+end
+
+% Bucket the rows by wavefront, preserving their natural order within
+% each wavefront for locality
+lev_ptr = zeros(nlevs+1, 1, 'int32');
+lev_ptr(1) = 1;
+for i = 1:n
+    lev_ptr(lev(i)+1) = lev_ptr(lev(i)+1) + 1;
+end
+for k = 1:nlevs
+    lev_ptr(k+1) = lev_ptr(k+1) + lev_ptr(k);
+end
+
+lev_ind = zeros(n, 1, 'int32');
+for i = 1:n
+    lev_ind(lev_ptr(lev(i))) = i;
+    lev_ptr(lev(i)) = lev_ptr(lev(i)) + 1;
+end
+
+% Restore the starting positions
+for k = nlevs:-1:1
+    lev_ptr(k+1) = lev_ptr(k);
+end
+lev_ptr(1) = 1;
+
+end
+
+function test %#ok<DEFNU>
+%!test
+%! n = 20;
+%! L = tril(sprand(n, n, 0.2), -1);
+%! [lev_ptr, lev_ind] = MILU_levelsched(ccs_createFromSparse(L), false);
+%! assert(isequal(sort(lev_ind), int32(1:n)'));
+%! lev(lev_ind) = 0;
+%! for k = 1:length(lev_ptr)-1
+%!     lev(lev_ind(lev_ptr(k):lev_ptr(k+1)-1)) = k;
+%! end
+%! [I, J] = find(L);
+%! assert(all(lev(I) > lev(J)));
+
+%!test
+%! n = 20;
+%! U = triu(sprand(n, n, 0.2), 1);
+%! [lev_ptr, lev_ind] = MILU_levelsched(ccs_createFromSparse(U), true);
+%! assert(isequal(sort(lev_ind), int32(1:n)'));
+%! lev(lev_ind) = 0;
+%! for k = 1:length(lev_ptr)-1
+%!     lev(lev_ind(lev_ptr(k):lev_ptr(k+1)-1)) = k;
+%! end
+%! [I, J] = find(U);
+%! assert(all(lev(I) > lev(J)));
+
+end
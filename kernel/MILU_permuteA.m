@@ -0,0 +1,44 @@
+function [Aq, qinv] = MILU_permuteA(A, M, Aq, qinv)
+%MILU_permuteA Fold the column permutation and scaling of M into A
+%
+%   Aq = MILU_permuteA(A, M)
+%   returns a copy of the CRS matrix A with its columns permuted and
+%   scaled by the first level of M, so that A * MILU_unpermute(M, z)
+%   is equal to Aq * z for a vector z in the permuted space of the first
+%   level. It allows MILUsolve_prodAx to skip the final permutation of
+%   the preconditioner solve.
+%
+%   [Aq, qinv] = MILU_permuteA(A, M, Aq, qinv)
+%   overwrites Aq and the buffer qinv in place if their sizes match A,
+%   as done with the workspace of the Krylov kernels.
+%
+% See also: MILUsolve_prodAx, MILU_unpermute, Krylov_createWork
+
+%#codegen -args {crs_matrix, MILU_Prec, crs_matrix, m2c_intvec}
+%#codegen MILU_permuteA_2args -args {crs_matrix, MILU_Prec}
+
+n = M(1).L.nrows + M(1).negE.nrows;
+
+% Inverse of the column permutation
+if nargin < 4 || numel(qinv) ~= n
+    qinv = zeros(n, 1, 'int32');
+end
+for i = 1:n
+    qinv(M(1).q(i)) = i;
+end
+
+if nargin < 3 || numel(Aq.row_ptr) ~= numel(A.row_ptr) || ...
+        numel(Aq.col_ind) ~= numel(A.col_ind)
+    Aq = A;
+else
+    Aq.nrows = A.nrows;
+    Aq.ncols = A.ncols;
+    for i = 1:int32(numel(A.row_ptr))
+        Aq.row_ptr(i) = A.row_ptr(i);
+    end
+end
+for j = 1:int32(numel(A.col_ind))
+    k = A.col_ind(j);
+    Aq.col_ind(j) = qinv(k);
+    Aq.val(j) = A.val(j) * double(M(1).colscal(k));
+end
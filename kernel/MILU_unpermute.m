@@ -0,0 +1,18 @@
+function x = MILU_unpermute(M, z, x)
+%MILU_unpermute Map a vector from the permuted space of M and add to x
+%
+%   x = MILU_unpermute(M, z, x)
+%   computes x = x + Q * diag(colscal) * z, where Q and colscal are the
+%   column permutation and scaling of the first level of M. It maps a
+%   solution returned by MILUsolve(..., true) back to the original space.
+%
+% See also: MILUsolve_prodAx, MILU_permuteA
+
+%#codegen -args {MILU_Prec, m2c_vec, m2c_vec}
+
+n = M(1).L.nrows + M(1).negE.nrows;
+
+for i = 1:n
+    k = M(1).q(i);
+    x(k) = x(k) + z(i) * double(M(1).qcolscal(i));
+end
@@ -0,0 +1,8 @@
+function type = MILU_zcrs
+% Data type definition for complex sparse matrix in CRS format
+
+type = coder.typeof(struct('row_ptr', m2c_intvec, ...
+    'col_ind', m2c_intvec, ...
+    'val', MILU_zvec, ...
+    'nrows', int32(0), ...
+    'ncols', int32(0)));
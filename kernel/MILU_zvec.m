@@ -0,0 +1,4 @@
+function type = MILU_zvec
+% Data type definition for complex column vector of variable size
+
+type = coder.typeof(complex(0), [inf, 1]);
@@ -18,6 +18,61 @@ function [M, options, prec, runtime] = MILUfactor(varargin)
 %
 %    [M, options, prec] = MILUfactor(...) returns an options structure in
 %    addition to the preconditioner.
+%
+%    If opts.mixedprecision is nonzero, then all the values in M are
+%    stored in single precision (see MILU_SPrec), which halves the memory
+%    traffic of MILUsolve. Use MILUsolve_mixed to apply it in compiled code.
+%
+%    If opts.levelsched is nonzero, then each sparse level of M also stores
+%    row-oriented copies of L and U together with their wavefronts, which
+%    allows MILUsolve to perform the triangular solves using multiple
+%    threads. This increases the storage of L and U by a factor of two.
+%
+%    For real nonsymmetric matrices, M is converted directly from the
+%    factors stored by ILUPACK using the compiled DGNLilupack2milu if it
+%    is available, which avoids forming intermediate sparse matrices. If
+%    prec is not requested, then ILUPACK does not export its factors into
+%    MATLAB at all, and the nonzeros in options are counted by the
+%    converter.
+%
+%    For symmetric matrices, only L is stored, and M(i).U and M(i).Urow are
+%    empty (0-by-0), in which case MILUsolve applies U = L' implicitly.
+%    This halves the storage of the factors.
+%
+%    For complex matrices, the values of M are complex and its scaling
+%    vectors are real (see MILU_ZPrec). Each level also stores whether the
+%    matrix is Hermitian, in which case U = L' is the conjugate transpose
+%    of L, and otherwise U = L.' for complex symmetric matrices. M can be
+%    applied in compiled code using MILUsolve_complex. opts.mixedprecision
+%    is not supported in M for complex matrices.
+%
+%    For symmetric indefinite matrices, the diagonal D of each level may
+%    have 2-by-2 pivots. Their off-diagonal entries are stored in M(i).doff,
+%    which is empty if all the pivots are 1-by-1.
+%
+%    Each level of M also stores its scaling vectors in the permuted order,
+%    i.e., prowscal = rowscal(p) and qcolscal = colscal(q), so that the
+%    permutation passes of MILUsolve access only one vector at random.
+%
+%    If opts.nthreads is greater than 1 and prec is not requested, then a
+%    real nonsymmetric matrix with at least 1000*nthreads rows is
+%    partitioned by nested dissection (see partitionmetisn) into
+%    independent subdomains and separators. The subdomains are factored by
+%    ILUPACK, with its matching, condition estimation and inverse-based
+%    dropping, in parallel using up to nthreads OpenMP threads (see
+%    DGNLilupackparts). Their first levels form the first level of M,
+%    which is block diagonal, and the rows and columns that ILUPACK
+%    deferred in the subdomains join the separators in the approximate
+%    Schur complement, which is factored by ILUPACK in the subsequent
+%    levels. The independent subdomains also benefit the level-scheduled
+%    triangular solves of MILUsolve. ILUPACK has no preconditioner for
+%    this factorization, so if prec is requested, or if ILUPACK fails for
+%    any subdomain, then A is factored by ILUPACK as a whole.
+%
+%    ILUPACK itself is always called with nthreads = 1, because its
+%    partitioned factorization (PREC.ompparts) exists only for SPD
+%    matrices and cannot be represented by M. opts.nthreads is returned
+%    unchanged in options.
 
 if nargin == 0
     help MILUfactor
@@ -53,19 +108,64 @@ else
     options = ILUinit(A);
 end
 
+% Whether to compute level schedules for parallel triangular solves
+levelsched = isfield(options, 'levelsched') && options.levelsched;
+
+% The threads are used by milu_partitioned instead of ILUPACK, whose
+% partitioned factorization (PREC.ompparts) is not supported by MILU_Prec
+nthreads = double(options.nthreads);
+options.nthreads = 1;
+
+% The partitioned factorization has no ILUPACK preconditioner, so it is
+% used only if prec is not requested
+symmetric = isfield(options, 'issymmetric') && options.issymmetric || ...
+    ~isfield(options, 'issymmetric') && norm(A - A', 1) == 0;
+if nthreads > 1 && nargout < 3 && size(A, 1) >= 1000 * nthreads && ...
+        isreal(A) && ~symmetric && ...
+        exist('partitionilupackmetisn', 'file') == 3 && ...
+        exist('DGNLilupackparts', 'file') == 3
+    if nargin >= next_index && ~isempty(varargin{next_index})
+        opts = varargin{next_index};
+    else
+        opts = struct();
+    end
+    [M, newoptions, runtime] = milu_partitioned(A, opts, options, nthreads);
+    if ~isempty(M)
+        options = newoptions;
+        return;
+    end
+end
+
+% The converter reads the factors of a real nonsymmetric matrix through
+% PREC(1).ptr, so ILUPACK need not export them unless prec is requested
+convertible = isfield(options, 'coarsereduce') && options.coarsereduce && ...
+    ~options.mixedprecision && exist('DGNLilupack2milu', 'file') == 3;
+
 %% Perform ILU factorization
 tic
-[prec, options] = ILUfactor(A, options);
+[prec, options] = ILUfactor(A, options, convertible && nargout < 3);
 runtime = toc;
+options.nthreads = cast(nthreads, class(options.nthreads));
 
 nnz_total = 0;
 nnz_offdiag = 0;  % nonzeros in off-diagonal blocks (i.e., E and F)
-encountered_block_diag = 0;
+
+% Convert the factors of a real nonsymmetric matrix directly from the
+% DAMGlevelmat list using the compiled converter if it is available
+converted = convertible && ~isempty(prec) && prec(1).isreal && ...
+    ~prec(1).issymmetric && ~prec(1).issingle;
 
 %% Compute M(i).q and change M(i).U to incorporate D
-M = repmat(struct(), length(prec), 1);
+if converted
+    [M, nnz_total, nnz_offdiag] = DGNLilupack2milu(prec, levelsched);
+    nnz_total = nnz_total - nnz_offdiag;
+else
+    M = repmat(struct(), length(prec), 1);
+end
 for i = 1:length(prec)
-    if isempty(prec(i).U)
+    if converted
+        % The nonzeros were counted by DGNLilupack2milu
+    elseif isempty(prec(i).U)
         nnz_total = nnz_total + 2*nnz(prec(i).L) - nnz(prec(i).D);
         nnz_offdiag = nnz_offdiag  + 2*nnz(prec(i).E);
     else
@@ -73,19 +173,19 @@ for i = 1:length(prec)
         nnz_offdiag = nnz_offdiag + nnz(prec(i).E) + nnz(prec(i).F);
     end
     
-    if nnz(prec(i).D) ~= prec(i).nB
-        encountered_block_diag = 1;
-    end
-    if encountered_block_diag
-        continue;
-    end
-    
-    M(i).p = int32(prec(i).p(:));
-    M(i).q(prec(i).invq) = int32(1:prec(i).n);
-    M(i).q = M(i).q(:);
+    if ~converted
+        M(i).p = int32(prec(i).p(:));
+        M(i).q(prec(i).invq) = int32(1:prec(i).n);
+        M(i).q = M(i).q(:);
 
-    M(i).rowscal = prec(i).rowscal(:);
-    M(i).colscal = prec(i).colscal(:);
+        % The scaling factors are real also for complex matrices
+        M(i).rowscal = real(prec(i).rowscal(:));
+        M(i).colscal = real(prec(i).colscal(:));
+        % Scaling factors in the permuted order, so that MILUsolve accesses
+        % only one vector at random locations when permuting
+        M(i).prowscal = M(i).rowscal(M(i).p);
+        M(i).qcolscal = M(i).colscal(M(i).q);
+    end
     
     if isequal(M(i).p, M(i).q) && isequal(M(i).rowscal, M(i).colscal)
         fprintf(1, 'Note: Level %d uses symmetric reordering and scaling for a nonsymmetric block.\n', i);
@@ -95,10 +195,28 @@ for i = 1:length(prec)
         fprintf(1, 'Note: Level %d uses symmetric scaling but nonsymmetric reordering.\n', i);
     end
 
-    if ~issparse(prec(i).L)
+    if converted
+        % Only the wavefronts remain to be computed
+        if levelsched && ~isempty(M(i).d)
+            [M(i).Llev_ptr, M(i).Llev_ind] = MILU_levelsched(M(i).L, false);
+            [M(i).Ulev_ptr, M(i).Ulev_ind] = MILU_levelsched(M(i).U, true);
+        end
+        continue;
+    end
+
+    % Off-diagonal entries of the 2-by-2 pivots of symmetric indefinite
+    % matrices, with doff(j) = D(j+1, j) for a pivot in rows j and j+1
+    doff = [full(diag(prec(i).D, -1)); 0];
+    if ~any(doff)
+        doff = zeros(0, 1);
+    end
+
+    if ~issparse(prec(i).L) && isempty(doff)
         % Save L and U into U as a dense matrix
-        if isempty(prec(i).U)
+        if isempty(prec(i).U) && prec(i).ishermitian
             LU = tril(prec(i).L, -1) + prec(i).D * prec(i).L';
+        elseif isempty(prec(i).U)
+            LU = tril(prec(i).L, -1) + prec(i).D * prec(i).L.';
         else
             LU = tril(prec(i).L, -1) + prec(i).D * prec(i).U;
         end
@@ -106,22 +224,65 @@ for i = 1:length(prec)
         M(i).U = ccs_matrix(prec(i).nB, prec(i).nB);
         M(i).U.val = LU(:);
         M(i).d = zeros(0, 1);
+        M(i).doff = zeros(0, 1);
+        Ls = [];
     else
         % Extract strictly lower and upper triangular parts of L and U
         % Store transpose to allow parallelism
-        M(i).L = ccs_createFromSparse(tril(prec(i).L, -1) / prec(i).D);
+        if isempty(doff)
+            Ls = tril(prec(i).L, -1) / prec(i).D;
+        else
+            % L has 2-by-2 diagonal blocks, and L/D is unit-lower
+            Ls = sparse(tril(prec(i).L / prec(i).D, -1));
+        end
+        M(i).L = ccs_createFromSparse(Ls);
         if isempty(prec(i).U)
-            M(i).U = ccs_createFromSparse((tril(prec(i).L, -1) / prec(i).D)');
+            % U = L' (or L.' for complex symmetric matrices) is applied
+            % implicitly by traversing L by columns
+            Us = [];
+            M(i).U = ccs_matrix(0, 0);
+        else
+            Us = sparse(triu(prec(i).D \ prec(i).U, 1));
+            M(i).U = ccs_createFromSparse(Us);
+        end
+        M(i).d = full(diag(prec(i).D));
+        M(i).doff = doff;
+    end
+
+    if levelsched && ~isempty(Ls)
+        % Row-oriented copies of L and U and their wavefronts
+        M(i).Lrow = crs_createFromSparse(Ls);
+        [M(i).Llev_ptr, M(i).Llev_ind] = MILU_levelsched(M(i).L, false);
+        if isempty(Us)
+            % The rows of L' are the columns of L, and vice versa
+            M(i).Urow = crs_matrix(0, 0);
+            [M(i).Ulev_ptr, M(i).Ulev_ind] = MILU_levelsched( ...
+                ccs_createFromSparse(Ls'), true);
         else
-            M(i).U = ccs_createFromSparse(triu(prec(i).D \ prec(i).U, 1));
+            M(i).Urow = crs_createFromSparse(Us);
+            [M(i).Ulev_ptr, M(i).Ulev_ind] = MILU_levelsched(M(i).U, true);
         end
-        M(i).d = diag(prec(i).D);
+    else
+        M(i).Lrow = crs_matrix(0, 0);
+        M(i).Urow = crs_matrix(0, 0);
+        M(i).Llev_ptr = zeros(0, 1, 'int32');
+        M(i).Llev_ind = zeros(0, 1, 'int32');
+        M(i).Ulev_ptr = zeros(0, 1, 'int32');
+        M(i).Ulev_ind = zeros(0, 1, 'int32');
     end
     
     M(i).negE = crs_createFromSparse(-prec(i).E);
     M(i).negF = crs_createFromSparse(-prec(i).F);
 end
 
+if ~isempty(prec) && ~prec(1).isreal
+    % Keep all the values complex, as required by MILU_ZPrec
+    M = milu_complex(M, logical(prec(1).ishermitian));
+elseif options.mixedprecision
+    % Store factors in single precision; MILUsolve accumulates in double
+    M = milu_single(M);
+end
+
 options.nnz_offdiag = nnz_offdiag;
 options.nnz_total = nnz_total + nnz_offdiag;
 
@@ -129,13 +290,210 @@ if nargout < 3
     prec = ILUdelete(prec);
 end
 
-if encountered_block_diag
-    warning('Encountered 2x2 diagonal blocks in ILU. Cannot convert PREC.');
+end
+
+
+function M = milu_single(M)
+% Convert the values in M into single precision
+
+for i = 1:length(M)
+    M(i).rowscal = single(M(i).rowscal);
+    M(i).colscal = single(M(i).colscal);
+    M(i).prowscal = single(M(i).prowscal);
+    M(i).qcolscal = single(M(i).qcolscal);
+    M(i).d = single(M(i).d);
+    M(i).doff = single(M(i).doff);
+    M(i).L.val = single(M(i).L.val);
+    M(i).U.val = single(M(i).U.val);
+    M(i).negE.val = single(M(i).negE.val);
+    M(i).negF.val = single(M(i).negF.val);
+    M(i).Lrow.val = single(M(i).Lrow.val);
+    M(i).Urow.val = single(M(i).Urow.val);
+end
+
+end
+
+function M = milu_complex(M, hermitian)
+% Convert the values in M into complex, and mark whether M is Hermitian
+
+for i = 1:length(M)
+    M(i).d = complex(M(i).d);
+    M(i).doff = complex(M(i).doff);
+    M(i).L.val = complex(M(i).L.val);
+    M(i).U.val = complex(M(i).U.val);
+    M(i).negE.val = complex(M(i).negE.val);
+    M(i).negF.val = complex(M(i).negF.val);
+    M(i).Lrow.val = complex(M(i).Lrow.val);
+    M(i).Urow.val = complex(M(i).Urow.val);
+    M(i).hermitian = hermitian;
+end
+
+end
+
+function [M, options, runtime] = milu_partitioned(A, opts, options, nthreads)
+% Factor A using a nested-dissection partitioning into subdomains, which
+% are factored independently by ILUPACK using up to nthreads threads.
+%
+% The leaves of the binary tree returned by partitionmetisn are ordered
+% first. Since they are coupled only through the separators, the leading
+% block B of the first level is block diagonal, and its diagonal blocks
+% are the first levels of the ILUPACK factorizations of the subdomains,
+% which DGNLilupackparts computes in parallel. The rows and columns that
+% ILUPACK deferred follow the separators, and the Schur complement
+% S = C - E * inv(B) * F of both is factored by MILUfactor, whose levels
+% follow the first level in M. Level scheduling of the first level exposes
+% at least one independent row per subdomain in each wavefront. M is empty
+% if ILUPACK failed for any subdomain.
+
+tic;
+n = size(A, 1);
+levelsched = isfield(options, 'levelsched') && options.levelsched;
+
+% Row and column scaling to unit maximum norm, which ILUPACK refines
+% within the subdomains
+rowscal = 1 ./ full(max(abs(A), [], 2));
+rowscal(~isfinite(rowscal)) = 1;
+A = spdiags(rowscal, 0, n, n) * A;
+colscal = 1 ./ full(max(abs(A), [], 1))';
+colscal(~isfinite(colscal)) = 1;
+A = A * spdiags(colscal, 0, n, n);
+
+% Nested dissection of the symmetrized graph, in which the parent nodes
+% of the tree are separators that follow their children
+[pnd, rangtab, treetab] = partitionmetisn(abs(A) + abs(A'), ...
+    nthreads * options.loadbalancefactor);
+nnodes = length(rangtab) - 1;
+parents = treetab(1:nnodes);
+isleaf = true(nnodes, 1);
+isleaf(parents(parents > 0)) = false;
+
+interior = cell(0, 1);
+for k = find(isleaf)'
+    if rangtab(k+1) > rangtab(k)
+        interior{end+1, 1} = pnd(rangtab(k):rangtab(k+1)-1)'; %#ok<AGROW>
+    end
+end
+separators = zeros(0, 1);
+for k = find(~isleaf)'
+    separators = [separators; pnd(rangtab(k):rangtab(k+1)-1)']; %#ok<AGROW>
+end
+nparts = length(interior);
+
+% Factor the subdomains by ILUPACK using up to nthreads threads
+As = cell(nparts, 1);
+for k = 1:nparts
+    As{k} = A(interior{k}, interior{k});
+end
+[parts, info] = DGNLilupackparts(As, options, nthreads);
+clear As;
+if nparts == 0 || any(info)
     M = [];
+    runtime = toc;
+    return;
+end
+
+% The rows and columns factored in the subdomains come first, and the
+% separators and the rows and columns deferred by ILUPACK follow them
+pB = cell(nparts, 1);
+qB = cell(nparts, 1);
+pC = cell(nparts, 1);
+qC = cell(nparts, 1);
+subrowscal = ones(n, 1);
+subcolscal = ones(n, 1);
+for k = 1:nparts
+    I = interior{k};
+    nBk = length(parts(k).d);
+    pk = I(parts(k).p);
+    qk = I(parts(k).q);
+    pB{k} = pk(1:nBk);
+    qB{k} = qk(1:nBk);
+    pC{k} = pk(nBk+1:end);
+    qC{k} = qk(nBk+1:end);
+    subrowscal(I) = parts(k).rowscal;
+    subcolscal(I) = parts(k).colscal;
+end
+p = [vertcat(pB{:}); separators; vertcat(pC{:})];
+q = [vertcat(qB{:}); separators; vertcat(qC{:})];
+rowscal = rowscal .* subrowscal;
+colscal = colscal .* subcolscal;
+A = spdiags(subrowscal, 0, n, n) * A * spdiags(subcolscal, 0, n, n);
+
+Ls = blkdiag(parts.L);
+Us = blkdiag(parts.U);
+d = vertcat(parts.d);
+nB = length(d);
+nC = n - nB;
+
+E = A(p(nB+1:n), q(1:nB));
+F = A(p(1:nB), q(nB+1:n));
+S = A(p(nB+1:n), q(nB+1:n));
+if nC > 0 && nnz(F)
+    X = (Us + speye(nB)) \ (spdiags(1 ./ d, 0, nB, nB) * ...
+        ((Ls + speye(nB)) \ F));
+    S = S - E * X;
+    clear X;
+
+    % Drop small entries in S relative to the maximum of their rows
+    [i, j, v] = find(S);
+    rownorm = full(max(abs(S), [], 2));
+    keep = abs(v) >= options.droptolS * rownorm(i) | i == j;
+    S = sparse(i(keep), j(keep), v(keep), nC, nC);
+end
+
+M1.p = int32(p);
+M1.q = int32(q);
+M1.rowscal = rowscal;
+M1.colscal = colscal;
+M1.prowscal = rowscal(p);
+M1.qcolscal = colscal(q);
+M1.L = ccs_createFromSparse(Ls);
+M1.U = ccs_createFromSparse(Us);
+M1.d = d;
+M1.doff = zeros(0, 1);
+if levelsched
+    M1.Lrow = crs_createFromSparse(Ls);
+    M1.Urow = crs_createFromSparse(Us);
+    [M1.Llev_ptr, M1.Llev_ind] = MILU_levelsched(M1.L, false);
+    [M1.Ulev_ptr, M1.Ulev_ind] = MILU_levelsched(M1.U, true);
+else
+    M1.Lrow = crs_matrix(0, 0);
+    M1.Urow = crs_matrix(0, 0);
+    M1.Llev_ptr = zeros(0, 1, 'int32');
+    M1.Llev_ind = zeros(0, 1, 'int32');
+    M1.Ulev_ptr = zeros(0, 1, 'int32');
+    M1.Ulev_ind = zeros(0, 1, 'int32');
+end
+M1.negE = crs_createFromSparse(-E);
+M1.negF = crs_createFromSparse(-F);
+
+nnz_first = nnz(Ls) + nnz(Us) + nB;
+nnz_offdiag = nnz(E) + nnz(F);
+
+if nC > 0
+    % Factor the Schur complement sequentially
+    opts = rmfield(opts, intersect(fieldnames(opts), {'tv', 'ind'}));
+    opts.nthreads = 1;
+    opts.mixedprecision = 0;
+    opts.levelsched = levelsched;
+    [MS, optionsS] = MILUfactor(S, opts);
+    M = [orderfields(M1, MS(1)); MS(:)];
+    nnz_first = nnz_first + optionsS.nnz_total;
+else
+    M = M1;
 end
 
+if options.mixedprecision
+    M = milu_single(M);
 end
 
+options.nnz_offdiag = nnz_offdiag;
+options.nnz_total = nnz_first + nnz_offdiag;
+options.elbow = options.nnz_total / nnz(A);
+options.nthreads = nthreads;
+
+runtime = toc;
+
+end
 
 function test %#ok<DEFNU>
 %!test
@@ -156,6 +514,8 @@ function test %#ok<DEFNU>
 %!
 %! scaledA = diag(M(1).rowscal)*A*diag(M(1).colscal);
 %! scaledA = scaledA(M(1).p, M(1).q);
+%! assert(isequal(M(1).prowscal, M(1).rowscal(M(1).p)));
+%! assert(isequal(M(1).qcolscal, M(1).colscal(M(1).q)));
 %! 
 %! if length(M)==1
 %!     fprintf(1, 'M has one structure.\n');
@@ -177,4 +537,57 @@ function test %#ok<DEFNU>
 %!
 %! prec = ILUdelete(prec);
 
+%!test
+%! n = 200;
+%! A = sprand(n, n, 0.02) + 10 * speye(n);
+%! b = A * ones(n, 1);
+%!
+%! [M, options, prec] = MILUfactor(A, struct('droptol', 0.001, 'levelsched', 1));
+%! if exist('DGNLilupack2milu', 'file') == 3
+%!     [M2, nnz_total, nnz_offdiag] = DGNLilupack2milu(prec, 1);
+%!     assert(isequal(M2(1).p, M(1).p) && isequal(M2(1).q, M(1).q));
+%!
+%!     % The nonzeros counted from the exported factors
+%!     nnz_ref = 0;
+%!     nnz_offdiag_ref = 0;
+%!     for i = 1:length(prec)
+%!         nnz_ref = nnz_ref + nnz(prec(i).L) + nnz(prec(i).U) - nnz(prec(i).D);
+%!         nnz_offdiag_ref = nnz_offdiag_ref + nnz(prec(i).E) + nnz(prec(i).F);
+%!     end
+%!     assert(nnz_offdiag == nnz_offdiag_ref);
+%!     assert(nnz_total == nnz_ref + nnz_offdiag_ref);
+%!     assert(options.nnz_total == nnz_total);
+%!
+%!     % Without prec, the factors are not exported, but M is the same
+%!     [M3, options3] = MILUfactor(A, struct('droptol', 0.001, 'levelsched', 1));
+%!     assert(isequal(M3, M));
+%!     assert(options3.nnz_total == nnz_total);
+%! end
+%! assert(norm(MILUsolve(M, b) - ILUsol(prec, b)) < 1.e-8 * norm(b));
+%! prec = ILUdelete(prec);
+
+%!test
+%! if exist('partitionilupackmetisn', 'file') == 3 && ...
+%!         exist('DGNLilupackparts', 'file') == 3
+%!     A = delsq(numgrid('S', 102));
+%!     A = A + 0.5 * tril(A, -1);
+%!     n = size(A, 1);
+%!     b = A * ones(n, 1);
+%!
+%!     [M, options] = MILUfactor(A, struct('droptol', 0.001, 'nthreads', 4, ...
+%!         'levelsched', 1));
+%!     assert(options.nthreads == 4);
+%!     assert(M(1).L.nrows + M(1).negE.nrows == n);
+%!     assert(isequal(sort(M(1).p), (1:n)') && isequal(sort(M(1).q), (1:n)'));
+%!     [x, flag] = gmres(A, b, 30, 1.e-8, 10, @(v) MILUsolve(M, v));
+%!     assert(flag == 0);
+%!
+%!     % The preconditioner of ILUPACK is computed if it is requested
+%!     [M, options, prec] = MILUfactor(A, struct('droptol', 0.001, ...
+%!         'nthreads', 4));
+%!     assert(~isempty(prec) && options.nthreads == 4);
+%!     assert(norm(MILUsolve(M, b) - ILUsol(prec, b)) < 1.e-8 * norm(b));
+%!     prec = ILUdelete(prec);
+%! end
+
 end
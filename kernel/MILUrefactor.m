@@ -0,0 +1,113 @@
+function [M, options, runtime] = MILUrefactor(M0, A, opts)
+%MILUrefactor Refactor a matrix with the same sparsity pattern
+%
+%    M = MILUrefactor(M0, A) computes the multilevel-ILU factorization of
+%    A reusing the permutations and scaling of the first level of M0,
+%    which was returned by MILUfactor for a matrix with the same sparsity
+%    pattern and similar values, such as a Jacobian in a Newton iteration
+%    or a time-stepping loop. Matrix A can be in MATLAB's built-in sparse
+%    format or in CRS format created using crs_matrix.
+%
+%    M = MILUrefactor(M0, A, opts) specifies the options as in MILUfactor.
+%    opts.matching and opts.ordering are ignored.
+%
+%    [M, options, runtime] = MILUrefactor(...) also returns the options
+%    structure and the time spent in the factorization.
+%
+%    A is permuted and scaled as in the first level of M0, and the result
+%    is factored without maximum weight matching and reordering, which
+%    typically take a large fraction of the setup time of MILUfactor.
+%    The subsequent levels of M are computed from the new values. Since no
+%    ILUPACK preconditioner of A itself is formed, M must be applied using
+%    MILUsolve.
+%
+%    ILUPACK repeats its ordering on every coarser level and cannot
+%    restrict it to the first level. Hence, the Schur complements of the
+%    coarse levels are also factored without matching and fill-reducing
+%    ordering, and M may have more fill and need more iterations than
+%    MILUfactor(A, opts). Call MILUfactor instead if the coarse levels are
+%    large compared to the first level.
+%
+% See also: MILUfactor, MILUsolve
+
+if nargin < 2
+    help MILUrefactor
+    return;
+end
+
+if isstruct(A)
+    A = crs_2sparse(A.row_ptr, A.col_ind, A.val);
+end
+if nargin < 3 || isempty(opts)
+    opts = struct();
+end
+
+n = size(A, 1);
+if length(M0(1).p) ~= n
+    error('MILUrefactor:SizeMismatch', 'The size of A does not match M0.');
+end
+
+% Permute and scale A as in the first level of M0
+p = double(M0(1).p);
+q = double(M0(1).q);
+prowscal = double(M0(1).prowscal);
+qcolscal = double(M0(1).qcolscal);
+As = spdiags(prowscal, 0, n, n) * A(p, q) * spdiags(qcolscal, 0, n, n);
+
+% Factor the permuted matrix without the symbolic analysis
+opts.matching = 0;
+opts.ordering = '';
+[M, options, ~, runtime] = MILUfactor(As, opts);
+
+% Compose the permutations and scaling of the first level
+p1 = double(M(1).p);
+q1 = double(M(1).q);
+rowscal = zeros(n, 1);
+colscal = zeros(n, 1);
+rowscal(p) = prowscal .* double(M(1).rowscal);
+colscal(q) = qcolscal .* double(M(1).colscal);
+
+M(1).p = int32(p(p1));
+M(1).q = int32(q(q1));
+M(1).rowscal = cast(rowscal, class(M(1).rowscal));
+M(1).colscal = cast(colscal, class(M(1).colscal));
+M(1).prowscal = M(1).rowscal(M(1).p);
+M(1).qcolscal = M(1).colscal(M(1).q);
+
+end
+
+function test %#ok<DEFNU>
+%!test
+%! n = 200;
+%! A = sprand(n, n, 0.02) + 10 * speye(n);
+%! b = A * ones(n, 1);
+%!
+%! M0 = MILUfactor(A, struct('droptol', 0.001));
+%! [i, j, v] = find(A);
+%! A2 = sparse(i, j, v .* (1 + 0.1 * rand(size(v))), n, n);
+%! b2 = A2 * ones(n, 1);
+%!
+%! [M, options] = MILUrefactor(M0, A2, struct('droptol', 0.001));
+%! assert(isequal(sort(M(1).p), int32(1:n)'));
+%! assert(isequal(M(1).prowscal, M(1).rowscal(M(1).p)));
+%! [x, flag, ~, iter] = gmres(A2, b2, 30, 1.e-8, 10, @(v) MILUsolve(M, v));
+%! assert(flag == 0);
+%! assert(norm(x - ones(n, 1)) < 1.e-6 * sqrt(n));
+%!
+%! % Compare with a fresh factorization of A2
+%! [M2, options2] = MILUfactor(A2, struct('droptol', 0.001));
+%! [~, flag2, ~, iter2] = gmres(A2, b2, 30, 1.e-8, 10, @(v) MILUsolve(M2, v));
+%! assert(flag2 == 0);
+%! assert(options.nnz_total <= 2 * options2.nnz_total);
+%! assert((iter(1)-1)*30 + iter(2) <= 2 * ((iter2(1)-1)*30 + iter2(2)) + 5);
+
+%!test
+%! n = 200;
+%! A = sprand(n, n, 0.02) + 10 * speye(n);
+%! b = A * ones(n, 1);
+%!
+%! M0 = MILUfactor(A, struct('droptol', 0.001));
+%! M = MILUrefactor(M0, crs_matrix(A));
+%! assert(norm(A * MILUsolve(M, b) - b) < 1.e-2 * norm(b));
+
+end
@@ -1,4 +1,4 @@
-function [b, y1, y2] = MILUsolve(M, b, y1, y2)
+function [b, y1, y2] = MILUsolve(M, b, y1, y2, nthreads, permuted, transposed)
 %MILUsolve computes M\b, where M is the preconditioner
 %   b = MILUsolve(M, b)
 %   M is a structure containing the multilevel ILU factorization of A.
@@ -6,71 +6,158 @@ function [b, y1, y2] = MILUsolve(M, b, y1, y2)
 %   [b, y1, y2] = MILUsolve(M, b, y1, y2)
 %   where y1 and y2 are size n buffers.
 %
+%   [b, y1, y2] = MILUsolve(M, b, y1, y2, nthreads)
+%   uses up to nthreads threads for the triangular solves in the levels
+%   for which MILUfactor computed level schedules (see opts.levelsched),
+%   and for the scaling, permutation and coupling passes in the levels
+%   with at least 10000 rows.
+%
+%   [b, y1, y2] = MILUsolve(M, b, y1, y2, nthreads, true)
+%   omits the final permutation and column scaling in the first level of
+%   M, i.e., b is returned in the permuted space of the first level. It is
+%   used by MILUsolve_prodAx and can be mapped back using MILU_unpermute.
+%
+%   [b, y1, y2] = MILUsolve(M, b, y1, y2, nthreads, false, true)
+%   computes M.'\b using the same factors. It is used by
+%   MILUsolve_transpose, which also handles the conjugation for complex M.
+%
+%   M may also store its values in single precision (see MILU_SPrec),
+%   in which case all the arithmetic is still performed in double
+%   precision. The compiled version of this case is MILUsolve_mixed.
+%
+%   M may also be complex (see MILU_ZPrec), in which case b, y1 and y2
+%   must be complex. For the levels storing only L, M(i).hermitian
+%   selects whether U = L' or U = L.' is applied. The compiled version of
+%   this case is MILUsolve_complex.
+%
 %   At each level of M, L * U is equal to 
 %   the nB-b-nB leadng block of
 %     P * diag(rowscal) * A * diag(colcale) * Q
 %   In the coarsest level, if the matrix is nearly dense, then 
 %   tril(L, -1) + U are stored together as a dense matrix in U.val
 
-%#codegen -args {MILU_Prec, m2c_vec, m2c_vec, m2c_vec}
+%#codegen -args {MILU_Prec, m2c_vec, m2c_vec, m2c_vec, int32(0)}
+%#codegen MILUsolve_4args -args {MILU_Prec, m2c_vec, m2c_vec, m2c_vec}
 %#codegen MILUsolve_2args -args {MILU_Prec, m2c_vec}
 
 zero = coder.ignoreConst(int32(0));
 one = coder.ignoreConst(int32(1));
 
 if nargin<3
-    y1 = zeros(max(M(1).L.nrows, M(1).negE.nrows), 1);
+    y1 = zeros(max(M(1).L.nrows, M(1).negE.nrows), 1, 'like', b);
 end
 if nargin<4
-    y2 = zeros(M(1).negE.nrows, 1);
+    y2 = zeros(M(1).negE.nrows, 1, 'like', b);
+end
+if nargin<5
+    nthreads = int32(1);
+end
+if nargin<6
+    permuted = false;
+end
+if nargin<7
+    transposed = false;
 end
 
-[b, y1, y2] = solve_milu(M, one, b, zero, y1, y2);
+if transposed
+    [b, y1, y2] = solve_milu_transpose(M, one, b, zero, y1, y2, nthreads);
+else
+    [b, y1, y2] = solve_milu(M, one, b, zero, y1, y2, nthreads, permuted);
+end
 
 end
 
-function [b, y1, y2] = solve_milu(M, lvl, b, offset, y1, y2)
+function [b, y1, y2] = solve_milu(M, lvl, b, offset, y1, y2, nthreads, permuted)
 coder.inline('never');
 
 nB = M(lvl).L.nrows;
 n = nB + M(lvl).negE.nrows;
 
-% Rescale and permute first block of b
-for i = 1:nB
-    k = M(lvl).p(i);
-    y1(i) = M(lvl).rowscal(k) .* b(k + offset);
+% Rescale and permute b into y1 and y2. Small coarse levels are not
+% worth the overhead of a parallel region and stay serial.
+par = nthreads > 1 && n >= MILUsolve_ompmin;
+if par
+    %#omp parallel default(shared) num_threads(nthreads)
+    [b, y1, y2] = permute_rowscal(M(lvl).p, M(lvl).prowscal, b, offset, ...
+        y1, y2, nB, n);
+else
+    [b, y1, y2] = permute_rowscal(M(lvl).p, M(lvl).prowscal, b, offset, ...
+        y1, y2, nB, n);
 end
-% Rescale and permute second block of b
-for i = (nB + 1):n
-    k = M(lvl).p(i);
-    y2(i-nB) = M(lvl).rowscal(k) .* b(k + offset);
+
+if isempty(M(lvl).L.val) && numel(M(lvl).U.val) == n * n
+    % L is empty and U is a dense matrix storing result from dgetrf
+    y1 = solve_dense_lu(M(lvl).U.val, y1, nB);
+else
+    y1 = solve_ldu(M(lvl), y1, nthreads);
 end
 
 if n > nB
+    y2 = crs_Axpy_mixed(M(lvl).negE, y1, y2, nthreads);
+    for i = 1:n-nB
+        b(offset + nB + i) = y2(i);
+    end
+
+    [b, y1, y2] = solve_milu(M, lvl+1, b, offset + nB, y1, y2, nthreads, false);
+
     for i = 1:nB
-        b(offset + i) = y1(i);
+        y1(i) = b(offset + i);
+    end
+    for i = 1:n-nB
+        y2(i) = b(offset + nB + i);
     end
+
+    y1 = crs_Axpy_mixed(M(lvl).negF, y2, y1, nthreads);
+    y1 = solve_ldu(M(lvl), y1, nthreads);
+end
+
+% Rescale and permute solution vector, or leave it in the permuted space
+% of this level if permuted is true
+if par
+    %#omp parallel default(shared) num_threads(nthreads)
+    b = unpermute_colscal(M(lvl).q, M(lvl).qcolscal, y1, y2, b, offset, ...
+        nB, n, permuted);
+else
+    b = unpermute_colscal(M(lvl).q, M(lvl).qcolscal, y1, y2, b, offset, ...
+        nB, n, permuted);
+end
+
+end
+
+function [b, y1, y2] = solve_milu_transpose(M, lvl, b, offset, y1, y2, nthreads)
+% Solve with the transpose of the levels starting from lvl. The roles of
+% the row and column permutations and scalings are swapped, and so are
+% the roles of negE and negF, which are applied as negF.' and negE.'.
+coder.inline('never');
+
+nB = M(lvl).L.nrows;
+n = nB + M(lvl).negE.nrows;
+
+% Rescale and permute b by the columns into y1 and y2
+par = nthreads > 1 && n >= MILUsolve_ompmin;
+if par
+    %#omp parallel default(shared) num_threads(nthreads)
+    [b, y1, y2] = permute_rowscal(M(lvl).q, M(lvl).qcolscal, b, offset, ...
+        y1, y2, nB, n);
+else
+    [b, y1, y2] = permute_rowscal(M(lvl).q, M(lvl).qcolscal, b, offset, ...
+        y1, y2, nB, n);
 end
 
 if isempty(M(lvl).L.val) && numel(M(lvl).U.val) == n * n
-    % L is empty and U is a dense matrix storing result from dgetrf
-    y1 = solve_getrs(M(lvl).U.val, y1, nB);
+    y1 = solve_dense_lu_transpose(M(lvl).U.val, y1, nB);
 else
-    % It only accesses the first nB entries
-    y1 = ccs_solve_utril(M(lvl).L, y1);
-    for i = 1:nB
-        y1(i) = y1(i) / M(lvl).d(i);
-    end
-    y1 = ccs_solve_utriu(M(lvl).U, y1);
+    y1 = solve_ldu_transpose(M(lvl), y1, nthreads);
 end
 
 if n > nB
-    y2 = crs_Axpy(M(lvl).negE, y1, y2);
+    y2 = crs_Atxpy_mixed(M(lvl).negF, y1, y2);
     for i = 1:n-nB
         b(offset + nB + i) = y2(i);
     end
 
-    [b, y1, y2] = solve_milu(M, lvl+1, b, offset + nB, y1, y2);
+    [b, y1, y2] = solve_milu_transpose(M, lvl+1, b, offset + nB, y1, y2, ...
+        nthreads);
 
     for i = 1:nB
         y1(i) = b(offset + i);
@@ -79,22 +166,427 @@ if n > nB
         y2(i) = b(offset + nB + i);
     end
 
-    y1 = crs_Axpy(M(lvl).negF, y2, y1);
-    y1 = ccs_solve_utril(M(lvl).L, y1);
-    for i = 1:nB
-        y1(i) = y1(i) / M(lvl).d(i);
+    y1 = crs_Atxpy_mixed(M(lvl).negE, y2, y1);
+    y1 = solve_ldu_transpose(M(lvl), y1, nthreads);
+end
+
+% Rescale and permute the solution by the rows
+if par
+    %#omp parallel default(shared) num_threads(nthreads)
+    b = unpermute_colscal(M(lvl).p, M(lvl).prowscal, y1, y2, b, offset, ...
+        nB, n, false);
+else
+    b = unpermute_colscal(M(lvl).p, M(lvl).prowscal, y1, y2, b, offset, ...
+        nB, n, false);
+end
+
+end
+
+function nmin = MILUsolve_ompmin
+% Minimum number of rows of a level, or of negE and negF, for which the
+% streaming passes in solve_milu are performed with multiple threads
+
+nmin = int32(10000);
+
+end
+
+function [b, y1, y2] = permute_rowscal(p, prowscal, b, offset, y1, y2, nB, n)
+% Rescale and permute b(offset+1:offset+n) into y1(1:nB) and y2(1:n-nB),
+% where prowscal = rowscal(p), and copy y1 back into b(offset+1:offset+nB)
+% if n > nB. It may be called either by all threads in a team or by a
+% single thread.
+coder.inline('never');
+
+[istart, iend] = OMP_local_chunk(n);
+for i = istart:iend
+    if i <= nB
+        y1(i) = double(prowscal(i)) .* b(p(i) + offset);
+    else
+        y2(i-nB) = double(prowscal(i)) .* b(p(i) + offset);
+    end
+end
+
+if n > nB
+    %#omp barrier
+    [istart, iend] = OMP_local_chunk(nB);
+    for i = istart:iend
+        b(offset + i) = y1(i);
+    end
+end
+
+end
+
+function b = unpermute_colscal(q, qcolscal, y1, y2, b, offset, nB, n, permuted)
+% Rescale and permute y1(1:nB) and y2(1:n-nB) into b(offset+1:offset+n),
+% where qcolscal = colscal(q), or copy them without permutation if
+% permuted is true. It may be called either by all threads in a team or
+% by a single thread.
+coder.inline('never');
+
+[istart, iend] = OMP_local_chunk(n);
+if permuted
+    for i = istart:iend
+        if i <= nB
+            b(offset + i) = y1(i);
+        else
+            b(offset + i) = y2(i-nB);
+        end
+    end
+else
+    for i = istart:iend
+        if i <= nB
+            b(q(i) + offset) = y1(i) * double(qcolscal(i));
+        else
+            b(q(i) + offset) = y2(i-nB) * double(qcolscal(i));
+        end
+    end
+end
+
+end
+
+function y = solve_ldu(Mlvl, y, nthreads)
+% Solve with the sparse unit-triangular factors and diagonal of a level.
+% It only accesses the first nB entries of y.
+
+nB = Mlvl.L.nrows;
+
+% For symmetric levels, U is empty and U = L' is applied implicitly,
+% which is the transpose without conjugation unless M is Hermitian
+symmetric = Mlvl.U.nrows == 0;
+hermitian = false;
+if isfield(Mlvl, 'hermitian')
+    hermitian = Mlvl.hermitian;
+end
+
+if nthreads > 1 && ~isempty(Mlvl.Llev_ptr)
+    if symmetric
+        % The rows of L' are stored as the columns of L
+        %#omp parallel default(shared) num_threads(nthreads)
+        y = solve_ldu_levsched(Mlvl.Lrow.row_ptr, Mlvl.Lrow.col_ind, ...
+            Mlvl.Lrow.val, Mlvl.Llev_ptr, Mlvl.Llev_ind, Mlvl.d, Mlvl.doff, ...
+            Mlvl.L.col_ptr, Mlvl.L.row_ind, Mlvl.L.val, ...
+            Mlvl.Ulev_ptr, Mlvl.Ulev_ind, y, nB, hermitian);
+    else
+        %#omp parallel default(shared) num_threads(nthreads)
+        y = solve_ldu_levsched(Mlvl.Lrow.row_ptr, Mlvl.Lrow.col_ind, ...
+            Mlvl.Lrow.val, Mlvl.Llev_ptr, Mlvl.Llev_ind, Mlvl.d, Mlvl.doff, ...
+            Mlvl.Urow.row_ptr, Mlvl.Urow.col_ind, Mlvl.Urow.val, ...
+            Mlvl.Ulev_ptr, Mlvl.Ulev_ind, y, nB, false);
+    end
+else
+    y = solve_ccs_utril(Mlvl.L, y);
+    y = solve_diag(Mlvl.d, Mlvl.doff, y, int32(1), nB, hermitian);
+    if symmetric
+        y = solve_ccs_utril_transpose(Mlvl.L, y, hermitian);
+    else
+        y = solve_ccs_utriu(Mlvl.U, y);
+    end
+end
+
+end
+
+function y = solve_ldu_transpose(Mlvl, y, nthreads)
+% Solve with the transpose of the factors of a level, traversing L and U
+% by columns as the rows of L.' and U.'
+
+if Mlvl.U.nrows == 0
+    % Symmetric levels are their own transposes, and Hermitian levels are
+    % the conjugates of their transposes
+    hermitian = false;
+    if isfield(Mlvl, 'hermitian')
+        hermitian = Mlvl.hermitian;
+    end
+    if hermitian && ~isreal(y)
+        y = conj(solve_ldu(Mlvl, conj(y), nthreads));
+    else
+        y = solve_ldu(Mlvl, y, nthreads);
+    end
+elseif nthreads > 1 && ~isempty(Mlvl.Llev_ptr)
+    % The wavefronts of U and L in reverse order are valid for U.' and L.'
+    %#omp parallel default(shared) num_threads(nthreads)
+    y = solve_ldu_levsched_transpose(Mlvl.U.col_ptr, Mlvl.U.row_ind, ...
+        Mlvl.U.val, Mlvl.Ulev_ptr, Mlvl.Ulev_ind, Mlvl.d, Mlvl.doff, ...
+        Mlvl.L.col_ptr, Mlvl.L.row_ind, Mlvl.L.val, ...
+        Mlvl.Llev_ptr, Mlvl.Llev_ind, y, Mlvl.L.nrows);
+else
+    y = solve_ccs_utriu_transpose(Mlvl.U, y);
+    y = solve_diag(Mlvl.d, Mlvl.doff, y, int32(1), Mlvl.L.nrows, false);
+    y = solve_ccs_utril_transpose(Mlvl.L, y, false);
+end
+
+end
+
+function y = solve_diag(d, doff, y, istart, iend, hermitian)
+% Solve with the diagonal in rows istart to iend, where doff contains the
+% off-diagonal entries of the 2-by-2 pivots or is empty. A 2-by-2 pivot
+% in rows j and j+1 is solved by the owner of row j. The pivots are
+% Hermitian if hermitian is true, and symmetric otherwise.
+
+if isempty(doff)
+    for i = istart:iend
+        y(i) = y(i) / double(d(i));
+    end
+    return;
+end
+
+for i = istart:iend
+    if doff(i) ~= 0
+        % Solve [d(i) a12; doff(i) d(i+1)] \ y(i:i+1)
+        a11 = double(d(i));
+        a21 = double(doff(i));
+        a22 = double(d(i+1));
+        a12 = a21;
+        if ~isreal(a21) && hermitian
+            a12 = conj(a21);
+        end
+        delta = a11 * a22 - a12 * a21;
+        t = y(i);
+        y(i) = (a22 * t - a12 * y(i+1)) / delta;
+        y(i+1) = (a11 * y(i+1) - a21 * t) / delta;
+    elseif i == 1 || doff(i-1) == 0
+        y(i) = y(i) / double(d(i));
     end
-    y1 = ccs_solve_utriu(M(lvl).U, y1);
 end
 
-% Rescale and permute solution vector
-for i = 1:nB
-    k = M(lvl).q(i);
-    b(k + offset) = y1(i) * M(lvl).colscal(k);
 end
-for i = (nB + 1):n
-    k = M(lvl).q(i);
-    b(k + offset) = y2(i-nB) * M(lvl).colscal(k);
+
+function y = solve_ccs_utril(L, y)
+% Forward substitution with a unit-lower-triangular matrix in CCS format
+
+for j = 1:L.ncols
+    for k = L.col_ptr(j):L.col_ptr(j+1)-1
+        i = L.row_ind(k);
+        y(i) = y(i) - double(L.val(k)) * y(j);
+    end
+end
+
+end
+
+function y = solve_ccs_utriu(U, y)
+% Backward substitution with a unit-upper-triangular matrix in CCS format
+
+for j = U.ncols:-1:1
+    for k = U.col_ptr(j):U.col_ptr(j+1)-1
+        i = U.row_ind(k);
+        y(i) = y(i) - double(U.val(k)) * y(j);
+    end
+end
+
+end
+
+function y = solve_ccs_utril_transpose(L, y, hermitian)
+% Backward substitution with the transpose of a unit-lower-triangular
+% matrix in CCS format, i.e., with the columns of L as the rows of L'.
+% The values are conjugated if L is complex and hermitian is true.
+
+if ~isreal(L.val) && hermitian
+    for j = L.ncols:-1:1
+        t = y(j);
+        for k = L.col_ptr(j):L.col_ptr(j+1)-1
+            t = t - conj(L.val(k)) * y(L.row_ind(k));
+        end
+        y(j) = t;
+    end
+    return;
+end
+
+for j = L.ncols:-1:1
+    t = y(j);
+    for k = L.col_ptr(j):L.col_ptr(j+1)-1
+        t = t - double(L.val(k)) * y(L.row_ind(k));
+    end
+    y(j) = t;
+end
+
+end
+
+function y = solve_ccs_utriu_transpose(U, y)
+% Forward substitution with the transpose of a unit-upper-triangular
+% matrix in CCS format, i.e., with the columns of U as the rows of U.'
+
+for j = 1:U.ncols
+    t = y(j);
+    for k = U.col_ptr(j):U.col_ptr(j+1)-1
+        t = t - double(U.val(k)) * y(U.row_ind(k));
+    end
+    y(j) = t;
+end
+
+end
+
+function y = solve_dense_lu(LU, y, n)
+% Solve with the dense LU factorization without pivoting stored in LU
+
+for j = 1:n
+    for i = j+1:n
+        y(i) = y(i) - double(LU(i + (j-1)*n)) * y(j);
+    end
+end
+
+for j = n:-1:1
+    y(j) = y(j) / double(LU(j + (j-1)*n));
+    for i = 1:j-1
+        y(i) = y(i) - double(LU(i + (j-1)*n)) * y(j);
+    end
+end
+
+end
+
+function y = solve_dense_lu_transpose(LU, y, n)
+% Solve with the transpose of the dense LU factorization stored in LU
+
+for j = 1:n
+    t = y(j);
+    for i = 1:j-1
+        t = t - double(LU(i + (j-1)*n)) * y(i);
+    end
+    y(j) = t / double(LU(j + (j-1)*n));
+end
+
+for j = n:-1:1
+    t = y(j);
+    for i = j+1:n
+        t = t - double(LU(i + (j-1)*n)) * y(i);
+    end
+    y(j) = t;
+end
+
+end
+
+function y = crs_Axpy_mixed(A, x, y, nthreads)
+% Compute y = y + A*x, where A may store its values in single precision
+
+if size(y, 1) < A.nrows
+    m2c_error('crs_Axpy:BufferTooSmal', 'Buffer space for output y is too small.');
+end
+
+if nthreads > 1 && A.nrows >= MILUsolve_ompmin
+    %#omp parallel default(shared) num_threads(nthreads)
+    y = crs_Axpy_kernel(A.row_ptr, A.col_ind, A.val, x, y, A.nrows);
+else
+    y = crs_Axpy_kernel(A.row_ptr, A.col_ind, A.val, x, y, A.nrows);
+end
+
+end
+
+function y = crs_Axpy_kernel(row_ptr, col_ind, val, x, y, nrows)
+% Rows are distributed among the threads in a team, if any.
+coder.inline('never');
+
+[istart, iend] = OMP_local_chunk(nrows);
+for i = istart:iend
+    t = y(i);
+    for j = row_ptr(i):row_ptr(i+1)-1
+        t = t + double(val(j)) * x(col_ind(j));
+    end
+    y(i) = t;
+end
+
+end
+
+function y = crs_Atxpy_mixed(A, x, y)
+% Compute y = y + A.'*x, where A may store its values in single precision.
+% The rows of A are scattered into y, so it is performed serially.
+
+if size(y, 1) < A.ncols
+    m2c_error('crs_Atxpy:BufferTooSmal', 'Buffer space for output y is too small.');
+end
+
+for i = 1:A.nrows
+    t = x(i);
+    for j = A.row_ptr(i):A.row_ptr(i+1)-1
+        k = A.col_ind(j);
+        y(k) = y(k) + double(A.val(j)) * t;
+    end
+end
+
+end
+
+function y = solve_ldu_levsched(Lrow_ptr, Lcol_ind, Lval, Llev_ptr, ...
+    Llev_ind, d, doff, Urow_ptr, Ucol_ind, Uval, Ulev_ptr, Ulev_ind, y, nB, ...
+    hermitian)
+% Level-scheduled forward and backward substitution. Rows within a
+% wavefront are independent and are distributed among the threads, with
+% a barrier between consecutive wavefronts. If hermitian is true, then
+% the pivots are Hermitian and Uval is conjugated, which is used when
+% the columns of L are passed as the rows of U.
+coder.inline('never');
+
+y = solve_utri_levsched(Lrow_ptr, Lcol_ind, Lval, Llev_ptr, Llev_ind, y, ...
+    false);
+
+[istart, iend] = OMP_local_chunk(nB);
+y = solve_diag(d, doff, y, istart, iend, hermitian);
+%#omp barrier
+
+y = solve_utri_levsched(Urow_ptr, Ucol_ind, Uval, Ulev_ptr, Ulev_ind, y, ...
+    hermitian);
+
+end
+
+function y = solve_ldu_levsched_transpose(Ucol_ptr, Urow_ind, Uval, ...
+    Ulev_ptr, Ulev_ind, d, doff, Lcol_ptr, Lrow_ind, Lval, Llev_ptr, ...
+    Llev_ind, y, nB)
+% Level-scheduled substitution with U.', the diagonal and L.', where the
+% columns of U and L are the rows of their transposes.
+coder.inline('never');
+
+y = solve_ccs_utri_levsched(Ucol_ptr, Urow_ind, Uval, Ulev_ptr, Ulev_ind, y);
+
+[istart, iend] = OMP_local_chunk(nB);
+y = solve_diag(d, doff, y, istart, iend, false);
+%#omp barrier
+
+y = solve_ccs_utri_levsched(Lcol_ptr, Lrow_ind, Lval, Llev_ptr, Llev_ind, y);
+
+end
+
+function y = solve_ccs_utri_levsched(col_ptr, row_ind, val, lev_ptr, lev_ind, y)
+% Substitution with the transpose of a unit-triangular matrix in CCS
+% format, traversing the wavefronts of the matrix in reverse order. Since
+% the rows in a wavefront depend only on earlier wavefronts, the columns in
+% a wavefront depend only on later ones in the transpose. It must be
+% called by all threads in a team.
+
+for k = int32(numel(lev_ptr))-1:-1:1
+    [istart, iend] = OMP_local_chunk(lev_ptr(k+1) - lev_ptr(k));
+    for ii = lev_ptr(k)+istart-1:lev_ptr(k)+iend-1
+        j = lev_ind(ii);
+        t = y(j);
+        for i = col_ptr(j):col_ptr(j+1)-1
+            t = t - double(val(i)) * y(row_ind(i));
+        end
+        y(j) = t;
+    end
+    %#omp barrier
+end
+
+end
+
+function y = solve_utri_levsched(row_ptr, col_ind, val, lev_ptr, lev_ind, ...
+    y, conjugate)
+% Substitution with a unit-triangular matrix in CRS format in the order
+% given by its wavefronts. It must be called by all threads in a team.
+% The values are conjugated if val is complex and conjugate is true.
+
+conjugate = conjugate && ~isreal(val);
+for k = 1:int32(numel(lev_ptr))-1
+    [istart, iend] = OMP_local_chunk(lev_ptr(k+1) - lev_ptr(k));
+    for ii = lev_ptr(k)+istart-1:lev_ptr(k)+iend-1
+        i = lev_ind(ii);
+        t = y(i);
+        if conjugate
+            for j = row_ptr(i):row_ptr(i+1)-1
+                t = t - conj(val(j)) * y(col_ind(j));
+            end
+        else
+            for j = row_ptr(i):row_ptr(i+1)-1
+                t = t - double(val(j)) * y(col_ind(j));
+            end
+        end
+        y(i) = t;
+    end
+    %#omp barrier
 end
 
 end
@@ -121,6 +613,108 @@ function test %#ok<DEFNU>
 %! assert(norm(x - x_ref) < 1.e-8);
 %! prec = ILUdelete(prec);
 
+%!test
+%! n = 100;
+%! A = sprand(n, n, 0.05) + 10 * speye(n);
+%! b = A * ones(n, 1);
+%!
+%! M = MILUfactor(A, struct('droptol', 0.001, 'levelsched', 1));
+%! x_ref = MILUsolve(M, b);
+%! x = MILUsolve(M, b, zeros(n, 1), zeros(n, 1), int32(4));
+%! assert(norm(x - x_ref) < 1.e-10 * norm(x_ref));
+
+%!test
+%! n = 30000;
+%! A = sprand(n, n, 1.e-4) + 10 * speye(n);
+%! b = A * ones(n, 1);
+%!
+%! M = MILUfactor(A, struct('droptol', 0.001));
+%! x_ref = MILUsolve(M, b);
+%! x = MILUsolve(M, b, zeros(n, 1), zeros(n, 1), int32(4));
+%! assert(norm(x - x_ref) < 1.e-10 * norm(x_ref));
+
+%!test
+%! n = 100;
+%! A = sprand(n, n, 0.05) + 10 * speye(n);
+%! b = A * ones(n, 1);
+%!
+%! Ms = MILUfactor(A, struct('droptol', 0.001, 'mixedprecision', 1));
+%! assert(isa(Ms(1).L.val, 'single'));
+%!
+%! % The same factors with their values cast to double
+%! M = Ms;
+%! for i = 1:length(M)
+%!     for f = fieldnames(M)'
+%!         v = M(i).(f{1});
+%!         if isstruct(v)
+%!             v.val = double(v.val);
+%!         elseif isfloat(v)
+%!             v = double(v);
+%!         end
+%!         M(i).(f{1}) = v;
+%!     end
+%! end
+%! x_ref = MILUsolve(M, b);
+%! x = MILUsolve_mixed(Ms, b);
+%! assert(isa(x, 'double'));
+%! % The compiled kernel accumulates in double, while the uncompiled one
+%! % rounds the products with single values to single
+%! if exist(['MILUsolve_mixed.' mexext], 'file')
+%!     assert(norm(x - x_ref) < 1.e-12 * norm(x_ref));
+%! else
+%!     assert(norm(x - x_ref) < 1.e-5 * norm(x_ref));
+%! end
+
+%!test
+%! n = 200;
+%! K = sprand(n, n, 0.02) + 1i * sprand(n, n, 0.02);
+%! b = complex(ones(n, 1), 1);
+%!
+%! % Complex nonsymmetric, Hermitian and complex symmetric matrices
+%! As = {K + 10 * speye(n), K + K' + 10 * speye(n), K + K.' + 10 * speye(n)};
+%! for k = 1:3
+%!     A = As{k};
+%!     [M, ~, prec] = MILUfactor(A, struct('droptol', 0.001, 'levelsched', 1));
+%!     assert(~isreal(M(1).d) && M(1).hermitian == (k == 2));
+%!     x_ref = ILUsol(prec, b);
+%!     x = MILUsolve(M, b);
+%!     assert(norm(x - x_ref) < 1.e-8 * norm(x_ref));
+%!     x = MILUsolve(M, b, complex(zeros(n, 1)), complex(zeros(n, 1)), int32(4));
+%!     assert(norm(x - x_ref) < 1.e-8 * norm(x_ref));
+%!     prec = ILUdelete(prec);
+%! end
+
+%!test
+%! n = 100;
+%! m = 30;
+%! K = sprand(n, n, 0.05);
+%! K = K + K' + 10 * speye(n);
+%! B = sprand(m, n, 0.1) + [speye(m), sparse(m, n-m)];
+%! A = [K, B'; B, sparse(m, m)];
+%! b = A * ones(n+m, 1);
+%!
+%! [M, ~, prec] = MILUfactor(A, struct('droptol', 0.001));
+%! % The zero block requires 2-by-2 pivots, which are stored in M(i).doff
+%! assert(any(arrayfun(@(m) ~isempty(m.doff), M)));
+%! x_ref = ILUsol(prec, b);
+%! x = MILUsolve(M, b);
+%! assert(norm(x - x_ref) < 1.e-8 * norm(x_ref));
+%! prec = ILUdelete(prec);
+
+%!test
+%! n = 200;
+%! A = sprand(n, n, 0.02);
+%! A = A + A' + 10 * speye(n);
+%! b = A * ones(n, 1);
+%!
+%! [M, ~, prec] = MILUfactor(A, struct('droptol', 0.001, 'levelsched', 1));
+%! x_ref = ILUsol(prec, b);
+%! x = MILUsolve(M, b);
+%! assert(norm(x - x_ref) < 1.e-8 * norm(x_ref));
+%! x = MILUsolve(M, b, zeros(n, 1), zeros(n, 1), int32(4));
+%! assert(norm(x - x_ref) < 1.e-8 * norm(x_ref));
+%! prec = ILUdelete(prec);
+
 %!test
 %!shared A, b, rtol
 %! system('gd-get -O -p 0ByTwsK5_Tl_PemN0QVlYem11Y00 fem2d"*".mat');
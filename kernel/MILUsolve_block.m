@@ -0,0 +1,253 @@
+function [B, Y1, Y2] = MILUsolve_block(M, B, Y1, Y2)
+%MILUsolve_block computes M\B for multiple right-hand sides
+%   B = MILUsolve_block(M, B)
+%   M is a structure containing the multilevel ILU factorization of A,
+%   as returned by MILUfactor, and B is an n-by-k matrix.
+%
+%   [B, Y1, Y2] = MILUsolve_block(M, B, Y1, Y2)
+%   where Y1 and Y2 are k-by-n buffers.
+%
+%   M may store its values in single precision (see MILU_SPrec), in
+%   which case all arithmetic is still performed in double precision.
+%
+%   The result is the same as calling MILUsolve for each column of B, but
+%   the index arrays of L, U, negE and negF are traversed only once for
+%   all the k columns. The work buffers store the right-hand sides of each
+%   row contiguously, so the innermost loops run over the right-hand sides.
+%
+% See also: MILUsolve, MILUfactor
+
+%#codegen -args {MILU_Prec, m2c_mat, m2c_mat, m2c_mat}
+%#codegen MILUsolve_block_2args -args {MILU_Prec, m2c_mat}
+
+zero = coder.ignoreConst(int32(0));
+one = coder.ignoreConst(int32(1));
+
+k = int32(size(B, 2));
+if nargin<3
+    Y1 = zeros(k, max(M(1).L.nrows, M(1).negE.nrows));
+end
+if nargin<4
+    Y2 = zeros(k, M(1).negE.nrows);
+end
+
+[B, Y1, Y2] = solve_milu_block(M, one, B, zero, Y1, Y2, k);
+
+end
+
+function [B, Y1, Y2] = solve_milu_block(M, lvl, B, offset, Y1, Y2, k)
+coder.inline('never');
+
+nB = M(lvl).L.nrows;
+n = nB + M(lvl).negE.nrows;
+
+% Rescale and permute first block of B
+for i = 1:nB
+    p = M(lvl).p(i);
+    s = double(M(lvl).prowscal(i));
+    for r = 1:k
+        Y1(r, i) = s .* B(p + offset, r);
+    end
+end
+% Rescale and permute second block of B
+for i = (nB + 1):n
+    p = M(lvl).p(i);
+    s = double(M(lvl).prowscal(i));
+    for r = 1:k
+        Y2(r, i-nB) = s .* B(p + offset, r);
+    end
+end
+
+if n > nB
+    for r = 1:k
+        for i = 1:nB
+            B(offset + i, r) = Y1(r, i);
+        end
+    end
+end
+
+if isempty(M(lvl).L.val) && numel(M(lvl).U.val) == n * n
+    % L is empty and U is a dense matrix storing result from dgetrf
+    Y1 = solve_getrs_block(M(lvl).U.val, Y1, nB, k);
+else
+    Y1 = solve_ldu_block(M(lvl).L, M(lvl).d, M(lvl).doff, M(lvl).U, Y1, k);
+end
+
+if n > nB
+    Y2 = crs_Axpy_block(M(lvl).negE, Y1, Y2, k);
+    for r = 1:k
+        for i = 1:n-nB
+            B(offset + nB + i, r) = Y2(r, i);
+        end
+    end
+
+    [B, Y1, Y2] = solve_milu_block(M, lvl+1, B, offset + nB, Y1, Y2, k);
+
+    for r = 1:k
+        for i = 1:nB
+            Y1(r, i) = B(offset + i, r);
+        end
+        for i = 1:n-nB
+            Y2(r, i) = B(offset + nB + i, r);
+        end
+    end
+
+    Y1 = crs_Axpy_block(M(lvl).negF, Y2, Y1, k);
+    Y1 = solve_ldu_block(M(lvl).L, M(lvl).d, M(lvl).doff, M(lvl).U, Y1, k);
+end
+
+% Rescale and permute solution vectors
+for i = 1:nB
+    q = M(lvl).q(i);
+    s = double(M(lvl).qcolscal(i));
+    for r = 1:k
+        B(q + offset, r) = Y1(r, i) * s;
+    end
+end
+for i = (nB + 1):n
+    q = M(lvl).q(i);
+    s = double(M(lvl).qcolscal(i));
+    for r = 1:k
+        B(q + offset, r) = Y2(r, i-nB) * s;
+    end
+end
+
+end
+
+function Y = solve_ldu_block(L, d, doff, U, Y, k)
+% Solve with unit-lower L, diagonal d and unit-upper U, both in CCS format.
+% U is empty for symmetric levels, in which case U = L'.
+% doff contains the off-diagonal entries of the 2-by-2 pivots or is empty.
+
+nB = L.nrows;
+
+for j = 1:nB
+    for kk = L.col_ptr(j):L.col_ptr(j+1)-1
+        i = L.row_ind(kk);
+        for r = 1:k
+            Y(r, i) = Y(r, i) - double(L.val(kk)) * Y(r, j);
+        end
+    end
+end
+
+i = int32(1);
+while i <= nB
+    if ~isempty(doff) && doff(i) ~= 0
+        % Solve with the 2-by-2 pivot in rows i and i+1
+        a11 = double(d(i));
+        a21 = double(doff(i));
+        a22 = double(d(i+1));
+        delta = a11 * a22 - a21 * a21;
+        for r = 1:k
+            t = Y(r, i);
+            Y(r, i) = (a22 * t - a21 * Y(r, i+1)) / delta;
+            Y(r, i+1) = (a11 * Y(r, i+1) - a21 * t) / delta;
+        end
+        i = i + 2;
+    else
+        for r = 1:k
+            Y(r, i) = Y(r, i) / double(d(i));
+        end
+        i = i + 1;
+    end
+end
+
+if U.nrows == 0
+    % U = L' for symmetric levels, so the columns of L are the rows of U
+    for j = nB:-1:1
+        for kk = L.col_ptr(j):L.col_ptr(j+1)-1
+            i = L.row_ind(kk);
+            for r = 1:k
+                Y(r, j) = Y(r, j) - double(L.val(kk)) * Y(r, i);
+            end
+        end
+    end
+else
+    for j = nB:-1:1
+        for kk = U.col_ptr(j):U.col_ptr(j+1)-1
+            i = U.row_ind(kk);
+            for r = 1:k
+                Y(r, i) = Y(r, i) - double(U.val(kk)) * Y(r, j);
+            end
+        end
+    end
+end
+
+end
+
+function Y = solve_getrs_block(LU, Y, n, k)
+% Solve with the dense LU factorization without pivoting stored in LU.
+
+for j = 1:n
+    for i = j+1:n
+        for r = 1:k
+            Y(r, i) = Y(r, i) - double(LU(i + (j-1)*n)) * Y(r, j);
+        end
+    end
+end
+
+for j = n:-1:1
+    for r = 1:k
+        Y(r, j) = Y(r, j) / double(LU(j + (j-1)*n));
+    end
+    for i = 1:j-1
+        for r = 1:k
+            Y(r, i) = Y(r, i) - double(LU(i + (j-1)*n)) * Y(r, j);
+        end
+    end
+end
+
+end
+
+function Y = crs_Axpy_block(A, X, Y, k)
+% Compute Y(:, 1:A.nrows) = Y(:, 1:A.nrows) + (A * X')'.
+
+if size(Y, 2) < A.nrows
+    m2c_error('crs_Axpy:BufferTooSmal', 'Buffer space for output y is too small.');
+end
+
+for i = 1:A.nrows
+    for j = A.row_ptr(i):A.row_ptr(i+1)-1
+        c = A.col_ind(j);
+        for r = 1:k
+            Y(r, i) = Y(r, i) + double(A.val(j)) * X(r, c);
+        end
+    end
+end
+
+end
+
+function test %#ok<DEFNU>
+%!test
+%! n = 10;
+%! density = 0.4;
+%! droptol = 0.001;
+%!
+%! for i=1:100
+%!     A = sprand(n, n, density);
+%!     if condest(A) < 1e4
+%!         break;
+%!     end
+%! end
+%! B = A * rand(n, 3);
+%!
+%! M = MILUfactor(A, struct('droptol', droptol));
+%!
+%! X = MILUsolve_block(M, B);
+%! for j = 1:size(B, 2)
+%!     assert(norm(X(:, j) - MILUsolve(M, B(:, j))) < 1.e-10);
+%! end
+
+%!test
+%! n = 200;
+%! A = sprand(n, n, 0.02) + 10 * speye(n);
+%! B = rand(n, 8);
+%!
+%! M = MILUfactor(A, struct('droptol', 0.001));
+%!
+%! X = MILUsolve_block(M, B, zeros(8, n), zeros(8, n));
+%! for j = 1:size(B, 2)
+%!     assert(norm(X(:, j) - MILUsolve(M, B(:, j))) < 1.e-10);
+%! end
+
+end
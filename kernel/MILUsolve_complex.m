@@ -0,0 +1,24 @@
+function [b, y1, y2] = MILUsolve_complex(M, b, y1, y2, nthreads)
+%MILUsolve_complex computes M\b with complex factors in M
+%   b = MILUsolve_complex(M, b)
+%   [b, y1, y2] = MILUsolve_complex(M, b, y1, y2)
+%   [b, y1, y2] = MILUsolve_complex(M, b, y1, y2, nthreads)
+%   is the same as MILUsolve, compiled for the preconditioner returned
+%   by MILUfactor for a complex matrix. b, y1 and y2 are complex.
+%
+% See also: MILUsolve, MILU_ZPrec
+
+%#codegen -args {MILU_ZPrec, MILU_zvec, MILU_zvec, MILU_zvec, int32(0)}
+%#codegen MILUsolve_complex_2args -args {MILU_ZPrec, MILU_zvec}
+
+if nargin<3
+    y1 = complex(zeros(max(M(1).L.nrows, M(1).negE.nrows), 1));
+end
+if nargin<4
+    y2 = complex(zeros(M(1).negE.nrows, 1));
+end
+if nargin<5
+    nthreads = int32(1);
+end
+
+[b, y1, y2] = MILUsolve(M, b, y1, y2, nthreads);
@@ -0,0 +1,25 @@
+function [b, y1, y2] = MILUsolve_mixed(M, b, y1, y2, nthreads)
+%MILUsolve_mixed computes M\b with single-precision factors in M
+%   b = MILUsolve_mixed(M, b)
+%   [b, y1, y2] = MILUsolve_mixed(M, b, y1, y2)
+%   [b, y1, y2] = MILUsolve_mixed(M, b, y1, y2, nthreads)
+%   is the same as MILUsolve, compiled for the preconditioner returned
+%   by MILUfactor with opts.mixedprecision set. The factors are read in
+%   single precision, but b, y1, y2 and all arithmetic are in double.
+%
+% See also: MILUsolve, MILU_SPrec
+
+%#codegen -args {MILU_SPrec, m2c_vec, m2c_vec, m2c_vec, int32(0)}
+%#codegen MILUsolve_mixed_2args -args {MILU_SPrec, m2c_vec}
+
+if nargin<3
+    y1 = zeros(max(M(1).L.nrows, M(1).negE.nrows), 1);
+end
+if nargin<4
+    y2 = zeros(M(1).negE.nrows, 1);
+end
+if nargin<5
+    nthreads = int32(1);
+end
+
+[b, y1, y2] = MILUsolve(M, b, y1, y2, nthreads);
@@ -0,0 +1,32 @@
+function [w, z, y1, y2] = MILUsolve_prodAx(M, Aq, z, w, y1, y2, nthreads)
+%MILUsolve_prodAx Fused preconditioner solve and matrix-vector product
+%
+%   [w, z] = MILUsolve_prodAx(M, Aq, z, w)
+%   [w, z, y1, y2] = MILUsolve_prodAx(M, Aq, z, w, y1, y2, nthreads)
+%   computes z = M\z in the permuted space of the first level of M, and
+%   w = A * MILU_unpermute(M, z, 0), where Aq = MILU_permuteA(A, M).
+%   Since the column permutation and scaling of M are folded into Aq, the
+%   final permutation pass of MILUsolve is skipped, and the product reads
+%   z directly after the solve. y1 and y2 are buffers as in MILUsolve.
+%
+%   The right-preconditioned Krylov kernels store z in their preconditioned
+%   subspace and map the correction back using MILU_unpermute once per
+%   restart cycle.
+%
+% See also: MILUsolve, MILU_permuteA, MILU_unpermute
+
+%#codegen -args {MILU_Prec, crs_matrix, m2c_vec, m2c_vec, m2c_vec,
+%#codegen m2c_vec, int32(0)}
+
+if nargin<5
+    y1 = zeros(max(M(1).L.nrows, M(1).negE.nrows), 1);
+end
+if nargin<6
+    y2 = zeros(M(1).negE.nrows, 1);
+end
+if nargin<7
+    nthreads = int32(1);
+end
+
+[z, y1, y2] = MILUsolve(M, z, y1, y2, nthreads, true);
+w = crs_prodAx(Aq, z, w, nthreads);
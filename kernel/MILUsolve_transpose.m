@@ -0,0 +1,87 @@
+function [b, y1, y2] = MILUsolve_transpose(M, b, y1, y2, nthreads)
+%MILUsolve_transpose computes M'\b, where M is the preconditioner
+%   b = MILUsolve_transpose(M, b)
+%   applies the (conjugate) transpose of the preconditioner returned by
+%   MILUfactor for A, which is a preconditioner of A' that does not
+%   require factoring A'. It is used in adjoint solves, such as those in
+%   gradient-based optimization.
+%
+%   [b, y1, y2] = MILUsolve_transpose(M, b, y1, y2)
+%   [b, y1, y2] = MILUsolve_transpose(M, b, y1, y2, nthreads)
+%   where y1 and y2 are size n buffers, and nthreads is as in MILUsolve.
+%
+%   The factors of M are reused as they are: L and U are traversed by
+%   columns as the rows of L' and U', negE and negF swap their roles, and
+%   so do the row and column permutations and scalings. The wavefronts
+%   computed with opts.levelsched are traversed in reverse order. The
+%   products with negE' and negF' are performed serially.
+%
+%   For complex M (see MILU_ZPrec), M'\b is the conjugate of M.'\conj(b).
+%
+% See also: MILUsolve, MILUfactor, gmresMILU
+
+%#codegen -args {MILU_Prec, m2c_vec, m2c_vec, m2c_vec, int32(0)}
+%#codegen MILUsolve_transpose_2args -args {MILU_Prec, m2c_vec}
+
+if nargin<3
+    y1 = zeros(max(M(1).L.nrows, M(1).negE.nrows), 1, 'like', b);
+end
+if nargin<4
+    y2 = zeros(M(1).negE.nrows, 1, 'like', b);
+end
+if nargin<5
+    nthreads = int32(1);
+end
+
+% Complex factors are marked by their hermitian field
+adjoint = isfield(M, 'hermitian');
+
+if adjoint
+    b = conj(b);
+end
+[b, y1, y2] = MILUsolve(M, b, y1, y2, nthreads, false, true);
+if adjoint
+    b = conj(b);
+end
+
+end
+
+function test %#ok<DEFNU>
+%!test
+%! n = 200;
+%! A = sprand(n, n, 0.02) + 10 * speye(n);
+%! b = A * ones(n, 1);
+%!
+%! [M, ~, prec] = MILUfactor(A, struct('droptol', 0.001, 'levelsched', 1));
+%! x_ref = ILUtsol(prec, b);
+%! x = MILUsolve_transpose(M, b);
+%! assert(norm(x - x_ref) < 1.e-8 * norm(x_ref));
+%! x = MILUsolve_transpose(M, b, zeros(n, 1), zeros(n, 1), int32(4));
+%! assert(norm(x - x_ref) < 1.e-8 * norm(x_ref));
+%! prec = ILUdelete(prec);
+
+%!test
+%! n = 200;
+%! K = sprand(n, n, 0.02);
+%! A = K + K' + 10 * speye(n);
+%! b = A * ones(n, 1);
+%!
+%! M = MILUfactor(A, struct('droptol', 0.001));
+%! x = MILUsolve_transpose(M, b);
+%! assert(norm(x - MILUsolve(M, b)) < 1.e-10 * norm(x));
+
+%!test
+%! n = 200;
+%! K = sprand(n, n, 0.02) + 1i * sprand(n, n, 0.02);
+%! b = complex(ones(n, 1), 1);
+%!
+%! As = {K + 10 * speye(n), K + K' + 10 * speye(n), K + K.' + 10 * speye(n)};
+%! for k = 1:3
+%!     [M, ~, prec] = MILUfactor(As{k}, struct('droptol', 0.001));
+%!     x_ref = ILUhsol(prec, b);
+%!     x = MILUsolve_transpose(M, b);
+%!     assert(norm(x - x_ref) < 1.e-8 * norm(x_ref));
+%!     prec = ILUdelete(prec);
+%! end
+
+end
@@ -1,5 +1,5 @@
-function [x, flag, iter, resids] = bicgstabMILU_kernel(A, b, ...
-    M, rtol, maxit, x0, verbose, nthreads)
+function [x, flag, iter, resids, work] = bicgstabMILU_kernel(A, b, ...
+    M, rtol, maxit, x0, verbose, nthreads, work)
 %bicgstabMILU_kernel Kernel of bicgstabMILU
 %
 %   x = bicgstabMILU_kernel(A, b, prec, rtol, maxit, x0, verbose, nthreads)
@@ -8,15 +8,37 @@ function [x, flag, iter, resids] = bicgstabMILU_kernel(A, b, ...
 %
 %   [x, flag, iter, resids] = bicgstabMILU_kernel(...)
 %
+%   [x, flag, iter, resids, work] = bicgstabMILU_kernel(..., nthreads, work)
+%     reuses the buffers in work, created by Krylov_createWork or
+%     returned by a previous call, so that repeated solves of the same
+%     size do not allocate memory.
+%
 % See also: bicgstabMILU
 
 %#codegen -args {crs_matrix, m2c_vec, MILU_Prec, 0., int32(0),
-%#codegen m2c_vec, int32(0), int32(0)}
+%#codegen m2c_vec, int32(0), int32(0), Krylov_Work}
+%#codegen bicgstabMILU_kernel_8args -args {crs_matrix, m2c_vec, MILU_Prec,
+%#codegen 0., int32(0), m2c_vec, int32(0), int32(0)}
 
 n = int32(size(b, 1));
 flag = int32(0);
 iter = int32(0);
 
+% Buffer spaces. The residual r is stored in work.u, A*p_hat in work.v,
+% the preconditioned vector p_hat in work.w, the direction p and the
+% intermediate residual s in work.Q, and the shadow residual r_tld and
+% the correction to x in the permuted space of M in work.Z.
+if isempty(coder.target)
+    nE = int32(0);
+else
+    nE = M(1).negE.nrows;
+end
+if nargin < 9
+    work = Krylov_createWork(n, int32(2), nE);
+else
+    work = Krylov_createWork(n, int32(2), nE, work);
+end
+
 % If RHS is zero, terminate
 bnrm2 = sqrt(vec_sqnorm2(b));
 if bnrm2 == 0
@@ -32,12 +54,11 @@ else
     x = x0;
 end
 
-% Buffer spaces
-r = zeros(n, 1);
-v = zeros(n, 1);
-p = zeros(n, 1);
 if ~isempty(coder.target)
-    y2 = zeros(M(1).negE.nrows, 1);
+    % Fold the column permutation and scaling of M into A, and accumulate
+    % the correction to x in the permuted space of M
+    [work.Aq, work.qinv] = MILU_permuteA(A, M, work.Aq, work.qinv);
+    work.Z(:, 2) = 0;
 end
 
 if nargout > 3
@@ -46,13 +67,13 @@ end
 
 % Compute the initial residual
 if vec_sqnorm2(x) > 0
-    r = crs_prodAx(A, x, r, nthreads);
-    r = b - r;
+    work.u = crs_prodAx(A, x, work.u, nthreads);
+    work.u = b - work.u;
 else
-    r = b;
+    work.u = b;
 end
 
-resid = sqrt(vec_sqnorm2(r)) / bnrm2;
+resid = sqrt(vec_sqnorm2(work.u)) / bnrm2;
 if resid < rtol
     resids = 0;
     return
@@ -61,36 +82,41 @@ end
 omega = 1.0;
 alpha = 0.0;
 rho_1 = 0.0;
-r_tld = r;
+work.Z(:, 1) = work.u;
 
 flag = int32(0);
 iter = int32(1);
 while true
-    rho = (r_tld' * r); % direction vector
+    rho = (work.Z(:, 1)' * work.u); % direction vector
     if rho == 0.0
         break
     end
 
     if iter > 1
         beta = (rho / rho_1) * (alpha / omega);
-        p = r + beta * (p - omega * v);
+        work.Q(:, 1) = work.u + beta * (work.Q(:, 1) - omega * work.v);
     else
-        p = r;
+        work.Q(:, 1) = work.u;
     end
 
-    % Compute the preconditioned vector and store into v
+    % Compute the preconditioned vector and its product with A in v
     if isempty(coder.target)
-        p_hat = ILUsol(M, p);
+        work.w = ILUsol(M, work.Q(:, 1));
+        work.v = crs_prodAx(A, work.w, work.v, nthreads);
     else
-        p_hat = p;
-        [p_hat, v, y2] = MILUsolve(M, p_hat, v, y2);
+        work.w = work.Q(:, 1);
+        [work.v, work.w, work.y1, work.y2] = MILUsolve_prodAx(M, work.Aq, ...
+            work.w, work.v, work.y1, work.y2, nthreads);
     end
 
-    v = crs_prodAx(A, p_hat, v, nthreads);
-    alpha = rho / (r_tld' * v);
-    x = x + alpha * p_hat;
-    s = r - alpha * v;
-    snrm = sqrt(vec_sqnorm2(s));
+    alpha = rho / (work.Z(:, 1)' * work.v);
+    if isempty(coder.target)
+        x = x + alpha * work.w;
+    else
+        work.Z(:, 2) = work.Z(:, 2) + alpha * work.w;
+    end
+    work.Q(:, 2) = work.u - alpha * work.v;
+    snrm = sqrt(vec_sqnorm2(work.Q(:, 2)));
 
     if snrm < rtol % early convergence check
         resid = snrm / bnrm2;
@@ -98,20 +124,25 @@ while true
         break;
     end
 
-    % Compute the preconditioned vector and store into v
+    % Compute the preconditioned vector and its product with A in v
     if isempty(coder.target)
-        p_hat = ILUsol(M, s);
+        work.w = ILUsol(M, work.Q(:, 2));
+        work.v = crs_prodAx(A, work.w, work.v, nthreads);
     else
-        p_hat = s;
-        [p_hat, v, y2] = MILUsolve(M, p_hat, v, y2);
+        work.w = work.Q(:, 2);
+        [work.v, work.w, work.y1, work.y2] = MILUsolve_prodAx(M, work.Aq, ...
+            work.w, work.v, work.y1, work.y2, nthreads);
     end
 
-    v = crs_prodAx(A, p_hat, v, nthreads);
-    omega = (v' * s) / vec_sqnorm2(v);
-    x = x + omega * p_hat; % update approximation
+    omega = (work.v' * work.Q(:, 2)) / vec_sqnorm2(work.v);
+    if isempty(coder.target)
+        x = x + omega * work.w; % update approximation
+    else
+        work.Z(:, 2) = work.Z(:, 2) + omega * work.w;
+    end
 
-    r = s - omega * v;
-    resid = sqrt(vec_sqnorm2(r)) / bnrm2; % check convergence
+    work.u = work.Q(:, 2) - omega * work.v;
+    resid = sqrt(vec_sqnorm2(work.u)) / bnrm2; % check convergence
     resids(iter) = resid;
 
     if verbose > 1 || verbose > 0 && mod(iter, 30) == 0
@@ -136,6 +167,10 @@ while true
     iter = iter + 1;
 end
 
+if ~isempty(coder.target)
+    x = MILU_unpermute(M, work.Z(:, 2), x);
+end
+
 if nargout > 3
     resids = resids(1:iter);
 end
@@ -1,5 +1,5 @@
-function [x, flag, iter, resids] = gmresMILU_CGS(A, b, ...
-    M, restart, rtol, maxit, x0, verbose, nthreads)
+function [x, flag, iter, resids, work] = gmresMILU_CGS(A, b, ...
+    M, restart, rtol, maxit, x0, verbose, nthreads, work)
 %gmresMILU_CGS Kernel of gmresMILU using classical Gram-Schmidt
 %
 %   x = gmresMILU_CGS(A, b, M, restart, rtol, maxit, x0, verbose, nthreads)
@@ -8,6 +8,11 @@ function [x, flag, iter, resids] = gmresMILU_CGS(A, b, ...
 %
 %   [x, flag, iter, resids] = gmresMILU_CGS(...)
 %
+%   [x, flag, iter, resids, work] = gmresMILU_CGS(..., nthreads, work)
+%     reuses the buffers in work, created by Krylov_createWork or
+%     returned by a previous call, so that repeated solves of the same
+%     size do not allocate memory.
+%
 % See also: gmresMILU, gmresMILU_MGS, gmresMILU_HO
 
 % Note: The algorithm uses the classical Gram-Schmidt orthogonalization.
@@ -15,10 +20,33 @@ function [x, flag, iter, resids] = gmresMILU_CGS(A, b, ...
 % It is also less stable than the Householder algorithm.
 
 %#codegen -args {crs_matrix, m2c_vec, MILU_Prec, int32(0), 0., int32(0),
-%#codegen m2c_vec, int32(0), int32(0)}
+%#codegen m2c_vec, int32(0), int32(0), Krylov_Work}
+%#codegen gmresMILU_CGS_9args -args {crs_matrix, m2c_vec, MILU_Prec,
+%#codegen int32(0), 0., int32(0), m2c_vec, int32(0), int32(0)}
 
 n = int32(size(b, 1));
 
+% Number of inner iterations
+if restart > n
+    restart = n;
+elseif restart <= 0
+    restart = int32(1);
+end
+
+% Buffer spaces, including the local linear system (y and R), the
+% orthogonalized Krylov subspace (Q), the preconditioned subspace (Z)
+% and the Given's rotation vectors (J)
+if isempty(coder.target)
+    nE = int32(0);
+else
+    nE = M(1).negE.nrows;
+end
+if nargin < 10
+    work = Krylov_createWork(n, restart, nE);
+else
+    work = Krylov_createWork(n, restart, nE, work);
+end
+
 % If RHS is zero, terminate
 beta0 = sqrt(vec_sqnorm2(b));
 if beta0 == 0
@@ -29,13 +57,6 @@ if beta0 == 0
     return;
 end
 
-% Number of inner iterations
-if restart > n
-    restart = n;
-elseif restart <= 0
-    restart = int32(1);
-end
-
 % Determine the maximum number of outer iterations
 max_outer_iters = int32(ceil(double(maxit)/double(restart)));
 
@@ -46,23 +67,9 @@ else
     x = x0;
 end
 
-% Local linear system
-y = zeros(restart+1, 1);
-R = zeros(restart, restart);
-
-% Orthognalized Krylov subspace
-Q = zeros(n, restart);
-
-% Preconditioned subspace
-Z = zeros(n, restart);
-
-% Given's rotation vectors
-J = zeros(2, restart);
-
-% Buffer spaces
-v = zeros(n, 1);
 if ~isempty(coder.target)
-    v2 = zeros(M(1).negE.nrows, 1);
+    % Fold the column permutation and scaling of M into A
+    [work.Aq, work.qinv] = MILU_permuteA(A, M, work.Aq, work.qinv);
 end
 
 if nargout > 3
@@ -75,63 +82,65 @@ resid = 1;
 for it_outer = 1:max_outer_iters
     % Compute the initial residual
     if it_outer > 1 || vec_sqnorm2(x) > 0
-        v = crs_prodAx(A, x, v, nthreads);
-        v = b - v;
+        work.v = crs_prodAx(A, x, work.v, nthreads);
+        work.v = b - work.v;
     else
-        v = b;
+        work.v = b;
     end
 
-    beta2 = vec_sqnorm2(v);
+    beta2 = vec_sqnorm2(work.v);
     beta = sqrt(beta2);
 
     % The first Q vector
-    y(1) = beta;
-    Q(:, 1) = v / beta;
+    work.y(1) = beta;
+    work.Q(:, 1) = work.v / beta;
 
     j = int32(1);
     while true
-        w = Q(:, j);
-        % Compute the preconditioned vector and store into v
+        work.w = work.Q(:, j);
+        % Compute the preconditioned vector and its product with A in v
         if isempty(coder.target)
-            w = ILUsol(M, w);
+            work.w = ILUsol(M, work.w);
+            work.v = crs_prodAx(A, work.w, work.v, nthreads);
         else
-            [w, v, v2] = MILUsolve(M, w, v, v2);
+            % Fused kernel, which leaves w in the permuted space of M
+            [work.v, work.w, work.y1, work.y2] = MILUsolve_prodAx(M, work.Aq, ...
+                work.w, work.v, work.y1, work.y2, nthreads);
         end
 
         % Store the preconditioned vector
-        Z(:, j) = w;
-        v = crs_prodAx(A, w, v, nthreads);
+        work.Z(:, j) = work.w;
 
         % Perform classical Gram-Schmidt orthogonalization
-        w = v;
+        work.w = work.v;
         for k = 1:j
-            R(k, j) = w' * Q(:, k);
-            v = v - R(k, j) * Q(:, k);
+            work.R(k, j) = work.w' * work.Q(:, k);
+            work.v = work.v - work.R(k, j) * work.Q(:, k);
         end
 
-        vnorm2 = vec_sqnorm2(v);
+        vnorm2 = vec_sqnorm2(work.v);
         vnorm = sqrt(vnorm2);
         if j < restart
-            Q(:, j+1) = v / vnorm;
+            work.Q(:, j+1) = work.v / vnorm;
         end
 
         %  Apply Given's rotations to R(:,j)
         for colJ = 1:j-1
-            tmpv = R(colJ, j);
-            R(colJ, j) = conj(J(1, colJ)) * R(colJ, j) + conj(J(2, colJ)) * R(colJ+1, j);
-            R(colJ+1, j) = - J(2, colJ) * tmpv + J(1, colJ) * R(colJ+1, j);
+            tmpv = work.R(colJ, j);
+            work.R(colJ, j) = conj(work.J(1, colJ)) * work.R(colJ, j) + conj(work.J(2, colJ)) * work.R(colJ+1, j);
+            work.R(colJ+1, j) = - work.J(2, colJ) * tmpv + work.J(1, colJ) * work.R(colJ+1, j);
         end
 
         %  Compute Given's rotation Jm.
-        rho = sqrt(R(j, j)'*R(j, j)+vnorm2);
-        J(1, j) = R(j, j) ./ rho;
-        J(2, j) = vnorm ./ rho;
-        y(j+1) = - J(2, j) .* y(j);
-        y(j) = conj(J(1, j)) .* y(j);
-        R(j, j) = rho;
+        rho = sqrt(work.R(j, j)'*work.R(j, j)+vnorm2);
+        work.J(1, j) = work.R(j, j) ./ rho;
+        work.J(2, j) = vnorm ./ rho;
+        work.y(j+1) = - work.J(2, j) .* work.y(j);
+        work.y(j) = conj(work.J(1, j)) .* work.y(j);
+        work.R(j, j) = rho;
 
         resid_prev = resid;
-        resid = abs(y(j+1)) / beta0;
+        resid = abs(work.y(j+1)) / beta0;
         if resid >= resid_prev * (1 - 1.e-8)
             flag = int32(3); % stagnated
             break
@@ -161,9 +170,18 @@ for it_outer = 1:max_outer_iters
     end
 
     % Compute correction vector
-    y = backsolve(R, y, j);
-    for i = 1:j
-        x = x + y(i) * Z(:, i);
+    work.y = backsolve(work.R, work.y, j);
+    if isempty(coder.target)
+        for i = 1:j
+            x = x + work.y(i) * work.Z(:, i);
+        end
+    else
+        % Map the correction from the permuted space of M
+        work.v = work.y(1) * work.Z(:, 1);
+        for i = 2:j
+            work.v = work.v + work.y(i) * work.Z(:, i);
+        end
+        x = MILU_unpermute(M, work.v, x);
     end
 
     if resid < rtol || flag
@@ -1,5 +1,5 @@
-function [x, flag, iter, resids] = gmresMILU_HO(A, b, ...
-    M, restart, rtol, maxit, x0, verbose, nthreads)
+function [x, flag, iter, resids, work] = gmresMILU_HO(A, b, ...
+    M, restart, rtol, maxit, x0, verbose, nthreads, work)
 %gmresMILU_HO Kernel of gmresMILU using Householder algorithm
 %
 %   x = gmresMILU_HO(A, b, M, restart, rtol, maxit, x0, verbose, nthreads)
@@ -8,16 +8,44 @@ function [x, flag, iter, resids] = gmresMILU_HO(A, b, ...
 %
 %   [x, flag, iter, resids] = gmresMILU_HO(...)
 %
+%   [x, flag, iter, resids, work] = gmresMILU_HO(..., nthreads, work)
+%     reuses the buffers in work, created by Krylov_createWork or
+%     returned by a previous call, so that repeated solves of the same
+%     size do not allocate memory.
+%
 % See also: gmresMILU, gmresMILU_CGS, gmresMILU_MGS
 
 % Note: The algorithm uses Householder reflectors for orthogonalization.
 % It is more expensive than Gram-Schmidt but is more robust.
 
 %#codegen -args {crs_matrix, m2c_vec, MILU_Prec, int32(0), 0., int32(0),
-%#codegen m2c_vec, int32(0), int32(0)}
+%#codegen m2c_vec, int32(0), int32(0), Krylov_Work}
+%#codegen gmresMILU_HO_9args -args {crs_matrix, m2c_vec, MILU_Prec,
+%#codegen int32(0), 0., int32(0), m2c_vec, int32(0), int32(0)}
 
 n = int32(size(b, 1));
 
+% Number of inner iterations
+if restart > n
+    restart = n;
+elseif restart <= 0
+    restart = int32(1);
+end
+
+% Buffer spaces, including the Householder matrix (Q), the
+% upper-triangular matrix (R), the temporary solution (y), the
+% preconditioned subspace (Z) and the Given's rotation vectors (J)
+if isempty(coder.target)
+    nE = int32(0);
+else
+    nE = M(1).negE.nrows;
+end
+if nargin < 10
+    work = Krylov_createWork(n, restart, nE);
+else
+    work = Krylov_createWork(n, restart, nE, work);
+end
+
 % If RHS is zero, terminate
 beta0 = sqrt(vec_sqnorm2(b));
 if beta0 == 0
@@ -28,13 +56,6 @@ if beta0 == 0
     return;
 end
 
-% Number of inner iterations
-if restart > n
-    restart = n;
-elseif restart <= 0
-    restart = int32(1);
-end
-
 % Determine the maximum number of outer iterations
 max_outer_iters = int32(ceil(double(maxit)/double(restart)));
 
@@ -45,27 +66,14 @@ else
     x = x0;
 end
 
-% Householder matrix or upper-triangular matix
-V = zeros(n, restart);
-R = zeros(restart, restart);
-
-% Temporary solution
-y = zeros(restart+1, 1);
-
-% Preconditioned subspace
-Z = zeros(n, restart);
-
-% Given's rotation vectors
-J = zeros(2, restart);
-
 % Corrections at outer loop
 if nargout > 3
     resids = zeros(maxit, 1);
 end
 
-w = zeros(n, 1);
 if ~isempty(coder.target)
-    y2 = zeros(M(1).negE.nrows, 1);
+    % Fold the column permutation and scaling of M into A
+    [work.Aq, work.qinv] = MILU_permuteA(A, M, work.Aq, work.qinv);
 end
 
 flag = int32(0);
@@ -74,85 +82,88 @@ resid = 1;
 for it_outer = 1:max_outer_iters
     % Compute the initial residual
     if it_outer > 1 || vec_sqnorm2(x) > 0
-        w = crs_prodAx(A, x, w, nthreads);
-        u = b - w;
+        work.w = crs_prodAx(A, x, work.w, nthreads);
+        work.u = b - work.w;
     else
-        u = b;
+        work.u = b;
     end
 
-    beta2 = vec_sqnorm2(u);
+    beta2 = vec_sqnorm2(work.u);
     beta = sqrt(beta2);
 
     % Prepare the first Householder vector
-    if u(1) < 0
+    if work.u(1) < 0
         beta = -beta;
     end
-    updated_norm = sqrt(2*beta2+2*real(u(1))*beta);
-    u(1) = u(1) + beta;
-    u = u / updated_norm;
+    updated_norm = sqrt(2*beta2+2*real(work.u(1))*beta);
+    work.u(1) = work.u(1) + beta;
+    work.u = work.u / updated_norm;
 
     % The first Householder entry
-    y(1) = - beta;
-    V(:, 1) = u;
+    work.y(1) = - beta;
+    work.Q(:, 1) = work.u;
 
     j = int32(1);
     while true
         % Construct the last vector from the Householder reflectors
 
         %  v = Pj*ej = ej - 2*u*u'*ej
-        v = -2 * conj(V(j, j)) * V(:, j);
-        v(j) = v(j) + 1;
+        work.v = -2 * conj(work.Q(j, j)) * work.Q(:, j);
+        work.v(j) = work.v(j) + 1;
         %  v = P1*P2*...Pjm1*(Pj*ej)
         if isempty(coder.target)
             % This is faster when interpreted
             for i = (j - 1): - 1:1
-                v = v - 2 * (V(:, i)' * v) * V(:, i);
+                work.v = work.v - 2 * (work.Q(:, i)' * work.v) * work.Q(:, i);
             end
         else
             % This is faster when compiled
             for i = (j - 1): - 1:1
-                s = conj(V(i, i)) * v(i);
+                s = conj(work.Q(i, i)) * work.v(i);
                 for k = i + 1:n
-                    s = s + conj(V(k, i)) * v(k);
+                    s = s + conj(work.Q(k, i)) * work.v(k);
                 end
                 s = 2 * s;
 
                 for k = i:n
-                    v(k) = v(k) - s * V(k, i);
+                    work.v(k) = work.v(k) - s * work.Q(k, i);
                 end
             end
         end
         %  Explicitly normalize v to reduce the effects of round-off.
-        v = v / sqrt(vec_sqnorm2(v));
+        work.v = work.v / sqrt(vec_sqnorm2(work.v));
 
-        % Store the preconditioned vector
+        % Compute the preconditioned vector and its product with A in w
         if isempty(coder.target)
-            v = ILUsol(M, v);
+            work.v = ILUsol(M, work.v);
+            work.w = crs_prodAx(A, work.v, work.w, nthreads);
         else
-            [v, w, y2] = MILUsolve(M, v, w, y2);
+            % Fused kernel, which leaves v in the permuted space of M
+            [work.w, work.v, work.y1, work.y2] = MILUsolve_prodAx(M, work.Aq, ...
+                work.v, work.w, work.y1, work.y2, nthreads);
         end
 
-        Z(:, j) = v;
-        w = crs_prodAx(A, Z(:, j), w, nthreads);
+        % Store the preconditioned vector
+        work.Z(:, j) = work.v;
 
         % Orthogonalize the Krylov vector
         %  Form Pj*Pj-1*...P1*Av.
         if isempty(coder.target)
             % This is faster when interpreted
             for i = 1:j
-                w = w - 2 * (V(:, i)' * w) * V(:, i);
+                work.w = work.w - 2 * (work.Q(:, i)' * work.w) * work.Q(:, i);
             end
         else
             % This is faster when compiled
             for i = 1:j
-                s = conj(V(i, i)) * w(i);
+                s = conj(work.Q(i, i)) * work.w(i);
                 for k = i + 1:n
-                    s = s + conj(V(k, i)) * w(k);
+                    s = s + conj(work.Q(k, i)) * work.w(k);
                 end
                 s = s * 2;
 
                 for k = i:n
-                    w(k) = w(k) - s * V(k, i);
+                    work.w(k) = work.w(k) - s * work.Q(k, i);
                 end
             end
         end
@@ -160,55 +171,60 @@ for it_outer = 1:max_outer_iters
         % Update the rotators
         % Determine Pj+1.
         if j < n
+            %  Clear stale entries of the next Householder vector in work.
+            if j < restart
+                work.Q(:, j+1) = 0;
+            end
+
             %  Construct u for Householder reflector Pj+1.
-            u(j) = 0;
-            u(j+1) = w(j+1);
-            alpha2 = conj(w(j+1)) * w(j+1);
+            work.u(j) = 0;
+            work.u(j+1) = work.w(j+1);
+            alpha2 = conj(work.w(j+1)) * work.w(j+1);
             for k = j + 2:n
-                u(k) = w(k);
-                alpha2 = alpha2 + conj(w(k)) * w(k);
+                work.u(k) = work.w(k);
+                alpha2 = alpha2 + conj(work.w(k)) * work.w(k);
             end
 
             if alpha2 > 0
                 alpha = sqrt(alpha2);
-                if u(j+1) < 0
+                if work.u(j+1) < 0
                     alpha = -alpha;
                 end
                 if j < restart
-                    updated_norm = sqrt(2*alpha2+2*real(u(j+1))*alpha);
-                    u(j+1) = u(j+1) + alpha;
+                    updated_norm = sqrt(2*alpha2+2*real(work.u(j+1))*alpha);
+                    work.u(j+1) = work.u(j+1) + alpha;
                     for k = j + 1:n
-                        V(k, j+1) = u(k) / updated_norm;
+                        work.Q(k, j+1) = work.u(k) / updated_norm;
                     end
                 end
 
                 %  Apply Pj+1 to v.
-                w(j+2:end) = 0;
-                w(j+1) = - alpha;
+                work.w(j+2:end) = 0;
+                work.w(j+1) = - alpha;
             end
         end
 
         %  Apply Given's rotations to the newly formed v.
         for colJ = 1:j - 1
-            tmpv = w(colJ);
-            w(colJ) = conj(J(1, colJ)) * w(colJ) + conj(J(2, colJ)) * w(colJ+1);
-            w(colJ+1) = - J(2, colJ) * tmpv + J(1, colJ) * w(colJ+1);
+            tmpv = work.w(colJ);
+            work.w(colJ) = conj(work.J(1, colJ)) * work.w(colJ) + conj(work.J(2, colJ)) * work.w(colJ+1);
+            work.w(colJ+1) = - work.J(2, colJ) * tmpv + work.J(1, colJ) * work.w(colJ+1);
         end
 
         %  Compute Given's rotation Jm.
         if j < n
-            rho = sqrt(w(j)'*w(j)+w(j+1)'*w(j+1));
-            J(1, j) = w(j) ./ rho;
-            J(2, j) = w(j+1) ./ rho;
-            y(j+1) = - J(2, j) .* y(j);
-            y(j) = conj(J(1, j)) .* y(j);
-            w(j) = rho;
+            rho = sqrt(work.w(j)'*work.w(j)+work.w(j+1)'*work.w(j+1));
+            work.J(1, j) = work.w(j) ./ rho;
+            work.J(2, j) = work.w(j+1) ./ rho;
+            work.y(j+1) = - work.J(2, j) .* work.y(j);
+            work.y(j) = conj(work.J(1, j)) .* work.y(j);
+            work.w(j) = rho;
         end
 
-        R(1:j, j) = w(1:j);
+        work.R(1:j, j) = work.w(1:j);
 
         resid_prev = resid;
-        resid = abs(y(j+1)) / beta0;
+        resid = abs(work.y(j+1)) / beta0;
         if resid >= resid_prev * (1 - 1.e-8)
             flag = int32(3); % stagnated
             break
@@ -238,9 +254,18 @@ for it_outer = 1:max_outer_iters
     end
 
     % Compute correction vector
-    y = backsolve(R, y, j);
-    for i = 1:j
-        x = x + y(i) * Z(:, i);
+    work.y = backsolve(work.R, work.y, j);
+    if isempty(coder.target)
+        for i = 1:j
+            x = x + work.y(i) * work.Z(:, i);
+        end
+    else
+        % Map the correction from the permuted space of M
+        work.u = work.y(1) * work.Z(:, 1);
+        for i = 2:j
+            work.u = work.u + work.y(i) * work.Z(:, i);
+        end
+        x = MILU_unpermute(M, work.u, x);
     end
 
     if resid < rtol || flag
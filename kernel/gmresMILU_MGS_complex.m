@@ -0,0 +1,47 @@
+function [x, flag, iter, resids, work] = gmresMILU_MGS_complex(A, b, ...
+    M, restart, rtol, maxit, x0, verbose, nthreads, work)
+%gmresMILU_MGS_complex Kernel of gmresMILU using modified Gram-Schmidt
+%  for complex systems
+%
+%   x = gmresMILU_MGS_complex(A, b, M, restart, rtol, maxit, x0, verbose, nthreads)
+%     is the same as gmresMILU_MGS, compiled for a complex CRS matrix A,
+%     a complex right-hand side b, and the preconditioner returned by
+%     MILUfactor for A.
+%
+%   [x, flag, iter, resids] = gmresMILU_MGS_complex(...)
+%   [x, flag, iter, resids, work] = gmresMILU_MGS_complex(..., nthreads, work)
+%     where work is a complex workspace returned by a previous call.
+%
+% See also: gmresMILU, gmresMILU_MGS, MILU_ZPrec, Krylov_ZWork
+
+%#codegen -args {MILU_zcrs, MILU_zvec, MILU_ZPrec, int32(0), 0., int32(0),
+%#codegen MILU_zvec, int32(0), int32(0), Krylov_ZWork}
+%#codegen gmresMILU_MGS_complex_9args -args {MILU_zcrs, MILU_zvec, MILU_ZPrec,
+%#codegen int32(0), 0., int32(0), MILU_zvec, int32(0), int32(0)}
+
+if nargin < 10
+    % gmresMILU_MGS would create a real workspace, so start from an empty
+    % complex one, which is resized by Krylov_createWork
+    work = empty_work();
+end
+[x, flag, iter, resids, work] = gmresMILU_MGS(A, b, ...
+    M, restart, rtol, maxit, x0, verbose, nthreads, work);
+
+end
+
+function work = empty_work
+% Complex workspace with all buffers empty
+
+zmat = complex(zeros(0, 0));
+zvec = complex(zeros(0, 1));
+Aq = crs_matrix(0, 0);
+Aq.val = zvec;
+
+work = struct('Q', zmat, 'Z', zmat, 'P', zmat, 'R', zmat, 'J', zmat, ...
+    'y', zvec, 'u', zvec, 'v', zvec, 'w', zvec, 'y1', zvec, 'y2', zvec, ...
+    'Aq', Aq, 'qinv', zeros(0, 1, 'int32'));
+coder.varsize('work.Q', 'work.Z', 'work.P', 'work.R', 'work.J', 'work.y', ...
+    'work.u', 'work.v', 'work.w', 'work.y1', 'work.y2', 'work.Aq.val', ...
+    'work.qinv');
+
+end
@@ -1,68 +1,85 @@
-function [x, flag, iter, resids] = gmresMILU_MGS_noncompiled(A, b, ...
-    M, restart, rtol, maxit, x0, verbose, nthreads)
-%gmresMILU_MGS Kernel of gmresMILU using modified Gram-Schmidt
+function [x, flag, iter, resids, work] = gmresMILU_MGS_noncompiled(A, b, ...
+    M, restart, rtol, maxit, x0, verbose, nthreads, work, adjoint)
+%gmresMILU_MGS_noncompiled Modified Gram-Schmidt GMRES shared by
+%  gmresMILU_MGS and gmresMILU_adjoint
 %
-%   x = gmresMILU_MGS(A, b, M, restart, rtol, maxit, x0, verbose, nthreads)
-%     when uncompiled, call this kernel function by passing the M
-%     struct returned by MILUfactor
+%   x = gmresMILU_MGS_noncompiled(A, b, M, restart, rtol, maxit, x0, verbose, nthreads)
+%     is the same as gmresMILU_MGS. It is never compiled into a mex
+%     function of its own, so it can be called with the preconditioner of
+%     ILUPACK when gmresMILU_MGS is compiled.
 %
-%   [x, flag, iter, resids] = gmresMILU_MGS(...)
+%   [x, flag, iter, resids] = gmresMILU_MGS_noncompiled(...)
 %
-% See also: gmresMILU, gmresMILU_CGS, gmresMILU_HO
+%   [x, flag, iter, resids, work] = gmresMILU_MGS_noncompiled(..., nthreads, work)
+%     reuses the buffers in work, created by Krylov_createWork or
+%     returned by a previous call, so that repeated solves of the same
+%     size do not allocate memory.
+%
+%   [...] = gmresMILU_MGS_noncompiled(At, ..., nthreads, work, true)
+%     solves the adjoint system A'*x = b, where At is A' and M is the
+%     preconditioner of A, as in gmresMILU_adjoint. M' is applied using
+%     MILUsolve_transpose, or ILUhsol when uncompiled.
+%
+%   A, b and M may be complex.
+%
+% See also: gmresMILU, gmresMILU_MGS, gmresMILU_adjoint
 
 % Note: The algorithm uses the modified Gram-Schmidt orthogonalization.
 % It has less parallelism than classical Gram-Schmidt but is more stable.
 % It is also less stable than the Householder algorithm.
 
-%#codegen -args {crs_matrix, m2c_vec, MILU_Prec, int32(0), 0., int32(0),
-%#codegen m2c_vec, int32(0), int32(0)}
+if nargin < 11
+    adjoint = false;
+end
 
 n = int32(size(b, 1));
 
+% Number of inner iterations
+if restart > n
+    restart = n;
+elseif restart <= 0
+    restart = int32(1);
+end
+
+% Buffer spaces, including the local linear system (y and R), the
+% orthogonalized Krylov subspace (Q), the preconditioned subspace (Z)
+% and the Given's rotation vectors (J)
+if isempty(coder.target)
+    nE = int32(0);
+else
+    nE = M(1).negE.nrows;
+end
+if nargin < 10
+    work = Krylov_createWork(n, restart, nE);
+else
+    work = Krylov_createWork(n, restart, nE, work);
+end
+
 % If RHS is zero, terminate
-beta0 = sqrt(vec_sqnorm2(b));
+beta0 = sqrt(sqnorm2(b));
 if beta0 == 0
-    x = zeros(n, 1);
+    x = zeros(n, 1, 'like', b);
     flag = int32(0);
     iter = int32(0);
     resids = 0;
     return;
 end
 
-% Number of inner iterations
-if restart > n
-    restart = n;
-elseif restart <= 0
-    restart = int32(1);
-end
-
 % Determine the maximum number of outer iterations
 max_outer_iters = int32(ceil(double(maxit)/double(restart)));
 
 % Initialize x
 if isempty(x0)
-    x = zeros(n, 1);
+    x = zeros(n, 1, 'like', b);
 else
     x = x0;
 end
 
-% Local linear system
-y = zeros(restart+1, 1);
-R = zeros(restart, restart);
-
-% Orthognalized Krylov subspace
-Q = zeros(n, restart);
-
-% Preconditioned subspace
-Z = zeros(n, restart);
-
-% Given's rotation vectors
-J = zeros(2, restart);
-
-% Buffer spaces
-v = zeros(n, 1);
-if ~isempty(coder.target)
-    y2 = zeros(M(1).negE.nrows, 1);
+if ~isempty(coder.target) && ~adjoint
+    % Fold the column permutation and scaling of M into A. The adjoint
+    % system does not use Aq, since MILUsolve_transpose applies the
+    % permutations of M'
+    [work.Aq, work.qinv] = MILU_permuteA(A, M, work.Aq, work.qinv);
 end
 
 if nargout > 3
@@ -74,64 +91,74 @@ iter = int32(0);
 resid = 1;
 for it_outer = 1:max_outer_iters
     % Compute the initial residual
-    if it_outer > 1 || vec_sqnorm2(x) > 0
-        v = crs_prodAx(A, x, v, nthreads);
-        v = b - v;
+    if it_outer > 1 || sqnorm2(x) > 0
+        work.v = crs_prodAx(A, x, work.v, nthreads);
+        work.v = b - work.v;
     else
-        v = b;
+        work.v = b;
     end
 
-    beta2 = vec_sqnorm2(v);
+    beta2 = sqnorm2(work.v);
     beta = sqrt(beta2);
 
     % The first Q vector
-    y(1) = beta;
-    Q(:, 1) = v / beta;
+    work.y(1) = beta;
+    work.Q(:, 1) = work.v / beta;
 
     j = int32(1);
     while true
-        w = Q(:, j);
-        % Compute the preconditioned vector and store into v
-        if isempty(coder.target)
-            w = ILUsol(M, w);
+        work.w = work.Q(:, j);
+        % Compute the preconditioned vector and its product with A in v
+        if adjoint
+            if isempty(coder.target)
+                work.w = ILUhsol(M, work.w);
+            else
+                [work.w, work.y1, work.y2] = MILUsolve_transpose(M, work.w, ...
+                    work.y1, work.y2, nthreads);
+            end
+            work.v = crs_prodAx(A, work.w, work.v, nthreads);
+        elseif isempty(coder.target)
+            work.w = ILUsol(M, work.w);
+            work.v = crs_prodAx(A, work.w, work.v, nthreads);
         else
-            [w, v, y2] = MILUsolve(M, w, v, y2);
+            % Fused kernel, which leaves w in the permuted space of M
+            [work.v, work.w, work.y1, work.y2] = MILUsolve_prodAx(M, work.Aq, ...
+                work.w, work.v, work.y1, work.y2, nthreads);
         end
 
         % Store the preconditioned vector
-        Z(:, j) = w;
-        v = crs_prodAx(A, w, v, nthreads);
+        work.Z(:, j) = work.w;
 
         % Perform Gram-Schmidt orthogonalization and store column of R in w
         for k = 1:j
-            w(k) = v' * Q(:, k);
-            v = v - w(k) * Q(:, k);
+            work.w(k) = work.Q(:, k)' * work.v;
+            work.v = work.v - work.w(k) * work.Q(:, k);
         end
 
-        vnorm2 = vec_sqnorm2(v);
+        vnorm2 = sqnorm2(work.v);
         vnorm = sqrt(vnorm2);
         if j < restart
-            Q(:, j+1) = v / vnorm;
+            work.Q(:, j+1) = work.v / vnorm;
         end
 
         %  Apply Given's rotations to w.
         for colJ = 1:j-1
-            tmpv = w(colJ);
-            w(colJ) = conj(J(1, colJ)) * w(colJ) + conj(J(2, colJ)) * w(colJ+1);
-            w(colJ+1) = - J(2, colJ) * tmpv + J(1, colJ) * w(colJ+1);
+            tmpv = work.w(colJ);
+            work.w(colJ) = conj(work.J(1, colJ)) * work.w(colJ) + conj(work.J(2, colJ)) * work.w(colJ+1);
+            work.w(colJ+1) = - work.J(2, colJ) * tmpv + work.J(1, colJ) * work.w(colJ+1);
         end
 
         %  Compute Given's rotation Jm.
-        rho = sqrt(w(j)'*w(j)+vnorm2);
-        J(1, j) = w(j) ./ rho;
-        J(2, j) = vnorm ./ rho;
-        y(j+1) = - J(2, j) .* y(j);
-        y(j) = conj(J(1, j)) .* y(j);
-        w(j) = rho;
-        R(1:j, j) = w(1:j);
+        rho = sqrt(work.w(j)'*work.w(j)+vnorm2);
+        work.J(1, j) = work.w(j) ./ rho;
+        work.J(2, j) = vnorm ./ rho;
+        work.y(j+1) = - work.J(2, j) .* work.y(j);
+        work.y(j) = conj(work.J(1, j)) .* work.y(j);
+        work.w(j) = rho;
+        work.R(1:j, j) = work.w(1:j);
 
         resid_prev = resid;
-        resid = abs(y(j+1)) / beta0;
+        resid = abs(work.y(j+1)) / beta0;
         if resid >= resid_prev * (1 - 1.e-8)
             flag = int32(3); % stagnated
             break
@@ -161,9 +188,18 @@ for it_outer = 1:max_outer_iters
     end
 
     % Compute correction vector
-    y = backsolve(R, y, j);
-    for i = 1:j
-        x = x + y(i) * Z(:, i);
+    work.y = backsolve(work.R, work.y, j);
+    if isempty(coder.target) || adjoint
+        for i = 1:j
+            x = x + work.y(i) * work.Z(:, i);
+        end
+    else
+        % Map the correction from the permuted space of M
+        work.v = work.y(1) * work.Z(:, 1);
+        for i = 2:j
+            work.v = work.v + work.y(i) * work.Z(:, i);
+        end
+        x = MILU_unpermute(M, work.v, x);
     end
 
     if resid < rtol || flag
@@ -180,3 +216,17 @@ if resid <= rtol * (1 + 1.e-8)
 end
 
 end
+
+function s = sqnorm2(v)
+% Squared 2-norm of a real or complex vector
+
+if isreal(v)
+    s = vec_sqnorm2(v);
+else
+    s = 0;
+    for i = 1:int32(numel(v))
+        s = s + real(v(i))^2 + imag(v(i))^2;
+    end
+end
+
+end
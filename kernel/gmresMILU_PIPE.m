@@ -0,0 +1,393 @@
+function [x, flag, iter, resids, work] = gmresMILU_PIPE(A, b, ...
+    M, restart, rtol, maxit, x0, verbose, nthreads, work)
+%gmresMILU_PIPE Kernel of gmresMILU using pipelined Gram-Schmidt
+%
+%   x = gmresMILU_PIPE(A, b, M, restart, rtol, maxit, x0, verbose, nthreads)
+%     when uncompiled, call this kernel function by passing the M
+%     struct returned by MILUfactor
+%
+%   [x, flag, iter, resids] = gmresMILU_PIPE(...)
+%
+%   [x, flag, iter, resids, work] = gmresMILU_PIPE(..., nthreads, work)
+%     reuses the buffers in work, created by Krylov_createWork or
+%     returned by a previous call, so that repeated solves of the same
+%     size do not allocate memory.
+%
+% See also: gmresMILU, gmresMILU_CGS, gmresMILU_MGS, gmresMILU_HO
+
+% Note: The algorithm is a pipelined variant of classical Gram-Schmidt,
+% similar to p(1)-GMRES by Ghysels et al. In addition to the orthonormal
+% basis Q, it keeps Z = A*inv(M)*Q and P = inv(M)*Q. At iteration i, the
+% basis vector Q(:, i) is normalized lazily: the inner products of Z(:, i)
+% with Q and the norm of Q(:, i) are computed in the same
+% parallel region as the matrix-vector product for the next iteration,
+% and the norm is applied one iteration later. This requires a single
+% parallel region for the inner products and the matrix-vector product,
+% and another one for the vector updates, instead of one barrier per
+% inner product. The convergence check lags one iteration behind the
+% matrix-vector product. Without reorthogonalization, it is as stable as
+% classical Gram-Schmidt. Only the matrix-vector product is overlapped
+% with the inner products. The preconditioner is applied before that
+% parallel region, because MILUsolve runs in parallel regions of its own.
+
+%#codegen -args {crs_matrix, m2c_vec, MILU_Prec, int32(0), 0., int32(0),
+%#codegen m2c_vec, int32(0), int32(0), Krylov_Work}
+%#codegen gmresMILU_PIPE_9args -args {crs_matrix, m2c_vec, MILU_Prec,
+%#codegen int32(0), 0., int32(0), m2c_vec, int32(0), int32(0)}
+
+n = int32(size(b, 1));
+
+% Each thread accumulates its partial inner products into its own column
+% of gpart, so at least one thread is needed
+if nthreads < 1
+    nthreads = int32(1);
+end
+
+% Number of inner iterations
+if restart > n
+    restart = n;
+elseif restart <= 0
+    restart = int32(1);
+end
+
+% Buffer spaces, including the orthonormal basis (Q), A*inv(M)*Q (Z),
+% inv(M)*Q (P), the local linear system (y and R) and the Given's
+% rotation vectors (J)
+if isempty(coder.target)
+    nE = int32(0);
+else
+    nE = M(1).negE.nrows;
+end
+if nargin < 10
+    work = Krylov_createWork(n, restart, nE);
+else
+    work = Krylov_createWork(n, restart, nE, work);
+end
+if size(work.P, 1) ~= n || size(work.P, 2) ~= restart
+    work.P = zeros(n, restart);
+end
+
+% If RHS is zero, terminate
+beta0 = sqrt(vec_sqnorm2(b));
+if beta0 == 0
+    x = zeros(n, 1);
+    flag = int32(0);
+    iter = int32(0);
+    resids = 0;
+    return;
+end
+
+% Determine the maximum number of outer iterations
+max_outer_iters = int32(ceil(double(maxit)/double(restart)));
+
+% Initialize x
+if isempty(x0)
+    x = zeros(n, 1);
+else
+    x = x0;
+end
+
+if ~isempty(coder.target)
+    % Fold the column permutation and scaling of M into A
+    [work.Aq, work.qinv] = MILU_permuteA(A, M, work.Aq, work.qinv);
+end
+
+% Inner products of the current iteration and their partial sums
+g = zeros(restart+1, 1);
+gpart = zeros(restart+1, nthreads);
+
+if nargout > 3
+    resids = zeros(maxit, 1);
+end
+
+flag = int32(0);
+iter = int32(0);
+resid = 1;
+for it_outer = 1:max_outer_iters
+    % Compute the initial residual, which is the unnormalized first
+    % basis vector
+    if it_outer > 1 || vec_sqnorm2(x) > 0
+        work.v = crs_prodAx(A, x, work.v, nthreads);
+        work.v = b - work.v;
+    else
+        work.v = b;
+    end
+    work.Q(:, 1) = work.v;
+
+    % Compute its preconditioned vector and its product with A
+    if isempty(coder.target)
+        work.v = ILUsol(M, work.v);
+        work.w = crs_prodAx(A, work.v, work.w, nthreads);
+    else
+        % Fused kernel, which leaves v in the permuted space of M
+        [work.w, work.v, work.y1, work.y2] = MILUsolve_prodAx(M, work.Aq, ...
+            work.v, work.w, work.y1, work.y2, nthreads);
+    end
+    work.P(:, 1) = work.v;
+    work.Z(:, 1) = work.w;
+
+    j = int32(0);
+    i = int32(1);
+    while true
+        if i <= restart
+            % Compute the preconditioned vector and its product with A
+            % for the next iteration in v and w, overlapped with the
+            % inner products of Z(:, i) with Q(:, 1:i) and of Q(:, i)
+            % with itself
+            last = i == restart;
+            if ~last
+                work.v = work.Z(:, i);
+                if isempty(coder.target)
+                    work.v = ILUsol(M, work.v);
+                else
+                    [work.v, work.y1, work.y2] = MILUsolve(M, work.v, ...
+                        work.y1, work.y2, nthreads, true);
+                end
+            end
+            if isempty(coder.target)
+                [work.w, g, gpart] = pipe_prodAx_dots(A, work.v, work.w, ...
+                    work.Q, work.Z, i, ~last, g, gpart, nthreads);
+            else
+                [work.w, g, gpart] = pipe_prodAx_dots(work.Aq, work.v, work.w, ...
+                    work.Q, work.Z, i, ~last, g, gpart, nthreads);
+            end
+            h = sqrt(g(i+1));
+        else
+            % Norm of the last basis vector, which is stored in w
+            h = sqrt(vec_sqnorm2(work.w));
+        end
+
+        if i == 1
+            % The first Q vector
+            if h == 0
+                resid = 0;
+                break;
+            end
+            work.y(1) = h;
+        else
+            % Complete column j of the Hessenberg matrix
+            j = i - 1;
+            [work.R, work.J, work.y] = givens_update(work.R, work.J, work.y, j, h);
+
+            resid_prev = resid;
+            resid = abs(work.y(j+1)) / beta0;
+            if resid >= resid_prev * (1 - 1.e-8)
+                flag = int32(3); % stagnated
+                break
+            elseif iter >= maxit
+                flag = int32(1); % reached maxit
+                break
+            end
+            iter = iter + 1;
+
+            if verbose > 1
+                m2c_printf('At iteration %d, relative residual is %g.\n', iter, resid);
+            end
+
+            % save the residual
+            if nargout > 3
+                resids(iter) = resid;
+            end
+
+            if resid < rtol || j >= restart || h == 0
+                break;
+            end
+        end
+
+        % Normalize the ith basis vector, store the inner products of
+        % Z(:, i) with the normalized basis into R(:, i), and compute
+        % the unnormalized next basis vector
+        for k = 1:i-1
+            g(k) = g(k) / h;
+        end
+        g(i) = g(i) / (h * h);
+        for k = 1:i
+            work.R(k, i) = g(k);
+        end
+        [work.Q, work.P, work.Z, work.w] = pipe_update(work.Q, work.P, ...
+            work.Z, work.v, work.w, g, i, h, i == restart, nthreads);
+
+        i = i + 1;
+    end
+
+    if verbose == 1 || verbose >1 && flag
+        m2c_printf('At iteration %d, relative residual is %g.\n', iter, resid);
+    end
+
+    % Compute correction vector
+    if j > 0
+        work.y = backsolve(work.R, work.y, j);
+        if isempty(coder.target)
+            for k = 1:j
+                x = x + work.y(k) * work.P(:, k);
+            end
+        else
+            % Map the correction from the permuted space of M
+            work.v = work.y(1) * work.P(:, 1);
+            for k = 2:j
+                work.v = work.v + work.y(k) * work.P(:, k);
+            end
+            x = MILU_unpermute(M, work.v, x);
+        end
+    end
+
+    if resid < rtol || flag
+        break;
+    end
+end
+
+if nargout > 3
+    resids = resids(1:iter);
+end
+
+if resid <= rtol * (1 + 1.e-8)
+    flag = int32(0);
+end
+
+end
+
+function [R, J, y] = givens_update(R, J, y, k, h)
+% Apply the previous Given's rotations to column k of the Hessenberg
+% matrix, whose upper part is in R(1:k, k) and subdiagonal entry is h,
+% and compute the kth Given's rotation.
+
+for colJ = 1:k-1
+    tmpv = R(colJ, k);
+    R(colJ, k) = conj(J(1, colJ)) * R(colJ, k) + conj(J(2, colJ)) * R(colJ+1, k);
+    R(colJ+1, k) = - J(2, colJ) * tmpv + J(1, colJ) * R(colJ+1, k);
+end
+
+rho = sqrt(R(k, k)'*R(k, k)+h*h);
+J(1, k) = R(k, k) ./ rho;
+J(2, k) = h ./ rho;
+y(k+1) = - J(2, k) .* y(k);
+y(k) = conj(J(1, k)) .* y(k);
+R(k, k) = rho;
+
+end
+
+function [w, g, gpart] = pipe_prodAx_dots(A, t, w, Q, Z, i, spmv, g, gpart, nthreads)
+% Compute w = A*t if spmv is true, g(1:i) = Q(:, 1:i)'*Z(:, i) and
+% g(i+1) = Q(:, i)'*Q(:, i) within a single parallel region.
+
+if isempty(coder.target)
+    if spmv
+        w = crs_prodAx(A, t, w, nthreads);
+    end
+    g(1:i) = Q(:, 1:i)' * Z(:, i);
+    g(i+1) = Q(:, i)' * Q(:, i);
+else
+    gpart(:) = 0;
+    %#omp parallel default(shared) num_threads(nthreads)
+    [w, gpart] = pipe_prodAx_dots_kernel(A.row_ptr, A.col_ind, A.val, ...
+        t, w, A.nrows, Q, Z, i, spmv, gpart, int32(size(gpart, 2)));
+
+    % Sum up the partial inner products of the threads
+    for k = 1:i+1
+        g(k) = gpart(k, 1);
+        for p = 2:int32(size(gpart, 2))
+            g(k) = g(k) + gpart(k, p);
+        end
+    end
+end
+
+end
+
+function [w, gpart] = pipe_prodAx_dots_kernel(row_ptr, col_ind, val, ...
+    t, w, nrows, Q, Z, i, spmv, gpart, nparts)
+coder.inline('never');
+
+% The rows of w and of the inner products are partitioned among threads,
+% and each thread accumulates its partial inner products into its own
+% column of gpart, so no reduction is needed within the parallel region.
+% The team has at most nparts threads, so that each thread owns at least
+% one column, and the columns without an owner remain zero.
+[p, ~] = OMP_local_chunk(nparts);
+[istart, iend] = OMP_local_chunk(int32(size(Q, 1)));
+
+for k = 1:i
+    s = 0;
+    for r = istart:iend
+        s = s + Q(r, k) * Z(r, i);
+    end
+    gpart(k, p) = s;
+end
+s = 0;
+for r = istart:iend
+    s = s + Q(r, i) * Q(r, i);
+end
+gpart(i+1, p) = s;
+
+if spmv
+    [istart, iend] = OMP_local_chunk(nrows);
+    for r = istart:iend
+        s = 0;
+        for k = row_ptr(r):row_ptr(r+1)-1
+            s = s + val(k) * t(col_ind(k));
+        end
+        w(r) = s;
+    end
+end
+
+end
+
+function [Q, P, Z, w] = pipe_update(Q, P, Z, t, w, g, i, h, last, nthreads)
+% Normalize Q(:, i), P(:, i) and Z(:, i) by h. Then compute the
+% unnormalized next basis vector Q(:, i+1) = Z(:, i) - Q(:, 1:i)*g(1:i),
+% and similarly P(:, i+1) from t/h and Z(:, i+1) from w/h. If last is
+% true, compute the unnormalized next basis vector in w instead.
+
+if isempty(coder.target)
+    Q(:, i) = Q(:, i) / h;
+    P(:, i) = P(:, i) / h;
+    Z(:, i) = Z(:, i) / h;
+    if last
+        w = Z(:, i) - Q(:, 1:i) * g(1:i);
+    else
+        Q(:, i+1) = Z(:, i) - Q(:, 1:i) * g(1:i);
+        P(:, i+1) = t / h - P(:, 1:i) * g(1:i);
+        Z(:, i+1) = w / h - Z(:, 1:i) * g(1:i);
+    end
+else
+    %#omp parallel default(shared) num_threads(nthreads)
+    [Q, P, Z, w] = pipe_update_kernel(Q, P, Z, t, w, g, i, h, last);
+end
+
+end
+
+function [Q, P, Z, w] = pipe_update_kernel(Q, P, Z, t, w, g, i, h, last)
+coder.inline('never');
+
+[istart, iend] = OMP_local_chunk(int32(size(Q, 1)));
+
+for r = istart:iend
+    Q(r, i) = Q(r, i) / h;
+    P(r, i) = P(r, i) / h;
+    Z(r, i) = Z(r, i) / h;
+end
+
+if last
+    for r = istart:iend
+        w(r) = Z(r, i);
+    end
+    for k = 1:i
+        for r = istart:iend
+            w(r) = w(r) - Q(r, k) * g(k);
+        end
+    end
+else
+    for r = istart:iend
+        Q(r, i+1) = Z(r, i);
+        P(r, i+1) = t(r) / h;
+        Z(r, i+1) = w(r) / h;
+    end
+    for k = 1:i
+        for r = istart:iend
+            Q(r, i+1) = Q(r, i+1) - Q(r, k) * g(k);
+            P(r, i+1) = P(r, i+1) - P(r, k) * g(k);
+            Z(r, i+1) = Z(r, i+1) - Z(r, k) * g(k);
+        end
+    end
+end
+
+end
@@ -0,0 +1,26 @@
+function [x, flag, iter, resids, work] = gmresMILU_PIPE_mixed(A, b, ...
+    M, restart, rtol, maxit, x0, verbose, nthreads, work)
+%gmresMILU_PIPE_mixed Kernel of gmresMILU using pipelined Gram-Schmidt
+%  and single-precision MILU factors
+%
+%   x = gmresMILU_PIPE_mixed(A, b, M, restart, rtol, maxit, x0, verbose, nthreads)
+%     is the same as gmresMILU_PIPE, compiled for the preconditioner
+%     returned by MILUfactor with opts.mixedprecision set.
+%
+%   [x, flag, iter, resids] = gmresMILU_PIPE_mixed(...)
+%   [x, flag, iter, resids, work] = gmresMILU_PIPE_mixed(..., nthreads, work)
+%
+% See also: gmresMILU, gmresMILU_PIPE, MILU_SPrec
+
+%#codegen -args {crs_matrix, m2c_vec, MILU_SPrec, int32(0), 0., int32(0),
+%#codegen m2c_vec, int32(0), int32(0), Krylov_Work}
+%#codegen gmresMILU_PIPE_mixed_9args -args {crs_matrix, m2c_vec, MILU_SPrec,
+%#codegen int32(0), 0., int32(0), m2c_vec, int32(0), int32(0)}
+
+if nargin < 10
+    [x, flag, iter, resids, work] = gmresMILU_PIPE(A, b, ...
+        M, restart, rtol, maxit, x0, verbose, nthreads);
+else
+    [x, flag, iter, resids, work] = gmresMILU_PIPE(A, b, ...
+        M, restart, rtol, maxit, x0, verbose, nthreads, work);
+end
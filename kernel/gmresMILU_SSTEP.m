@@ -0,0 +1,290 @@
+function [x, flag, iter, resids, work] = gmresMILU_SSTEP(A, b, ...
+    M, restart, rtol, maxit, x0, verbose, nthreads, work)
+%gmresMILU_SSTEP Kernel of gmresMILU using s-step block Gram-Schmidt
+%
+%   x = gmresMILU_SSTEP(A, b, M, restart, rtol, maxit, x0, verbose, nthreads)
+%     when uncompiled, call this kernel function by passing the M
+%     struct returned by MILUfactor
+%
+%   [x, flag, iter, resids] = gmresMILU_SSTEP(...)
+%
+%   [x, flag, iter, resids, work] = gmresMILU_SSTEP(..., nthreads, work)
+%     reuses the buffers in work, created by Krylov_createWork or
+%     returned by a previous call, so that repeated solves of the same
+%     size do not allocate memory.
+%
+% See also: gmresMILU, gmresMILU_CGS, gmresMILU_MGS, gmresMILU_PIPE
+
+% Note: The algorithm is the s-step (communication-avoiding) GMRES. Each
+% block step generates s vectors of a normalized monomial basis using s
+% preconditioner solves and matrix-vector products, orthogonalizes them
+% against the current basis using block classical Gram-Schmidt applied
+% twice, and orthonormalizes the block with a tall-skinny QR. These are
+% matrix-matrix operations instead of s*j inner products and axpys. The
+% Hessenberg matrix is then recovered from the change of basis. The
+% preconditioned basis is not stored; instead, the preconditioner is
+% applied once more to the correction at each restart. The monomial
+% basis becomes ill-conditioned for large s, so s is kept small.
+
+%#codegen -args {crs_matrix, m2c_vec, MILU_Prec, int32(0), 0., int32(0),
+%#codegen m2c_vec, int32(0), int32(0), Krylov_Work}
+%#codegen gmresMILU_SSTEP_9args -args {crs_matrix, m2c_vec, MILU_Prec,
+%#codegen int32(0), 0., int32(0), m2c_vec, int32(0), int32(0)}
+
+n = int32(size(b, 1));
+
+% Number of inner iterations
+if restart > n
+    restart = n;
+elseif restart <= 0
+    restart = int32(1);
+end
+
+% Number of steps per block
+s = min(int32(4), restart);
+
+% Buffer spaces, including the orthonormal basis (Q), the block of
+% monomial basis vectors (Z), the upper-triangular matrix (R), the local
+% linear system (y) and the Given's rotation vectors (J)
+if isempty(coder.target)
+    nE = int32(0);
+else
+    nE = M(1).negE.nrows;
+end
+if nargin < 10
+    work = Krylov_createWork(n, restart+1, nE);
+else
+    work = Krylov_createWork(n, restart+1, nE, work);
+end
+
+% If RHS is zero, terminate
+beta0 = sqrt(vec_sqnorm2(b));
+if beta0 == 0
+    x = zeros(n, 1);
+    flag = int32(0);
+    iter = int32(0);
+    resids = 0;
+    return;
+end
+
+% Determine the maximum number of outer iterations
+max_outer_iters = int32(ceil(double(maxit)/double(restart)));
+
+% Initialize x
+if isempty(x0)
+    x = zeros(n, 1);
+else
+    x = x0;
+end
+
+if ~isempty(coder.target)
+    % Fold the column permutation and scaling of M into A
+    [work.Aq, work.qinv] = MILU_permuteA(A, M, work.Aq, work.qinv);
+end
+
+% Hessenberg matrix before the Given's rotations, and scaling factors of
+% the monomial basis
+H = zeros(restart+1, restart);
+sigma = zeros(s, 1);
+
+if nargout > 3
+    resids = zeros(maxit, 1);
+end
+
+flag = int32(0);
+iter = int32(0);
+resid = 1;
+for it_outer = 1:max_outer_iters
+    % Compute the initial residual
+    if it_outer > 1 || vec_sqnorm2(x) > 0
+        work.v = crs_prodAx(A, x, work.v, nthreads);
+        work.v = b - work.v;
+    else
+        work.v = b;
+    end
+
+    beta = sqrt(vec_sqnorm2(work.v));
+
+    % The first Q vector
+    work.y(1) = beta;
+    work.Q(:, 1) = work.v / beta;
+
+    nb = int32(0);
+    stop = false;
+    while nb < restart && ~stop
+        j = nb + 1;
+        sc = min(s, restart - nb);
+
+        % Generate the monomial basis from Q(:, j) in Z(:, 1:sc)
+        for k = 1:sc
+            if k == 1
+                work.v = work.Q(:, j);
+            else
+                work.v = work.Z(:, k-1);
+            end
+            if isempty(coder.target)
+                work.v = ILUsol(M, work.v);
+                work.w = crs_prodAx(A, work.v, work.w, nthreads);
+            else
+                [work.w, work.v, work.y1, work.y2] = MILUsolve_prodAx(M, ...
+                    work.Aq, work.v, work.w, work.y1, work.y2, nthreads);
+            end
+            sigma(k) = sqrt(vec_sqnorm2(work.w));
+            work.Z(:, k) = work.w / sigma(k);
+        end
+
+        % Block classical Gram-Schmidt twice against Q(:, 1:j)
+        C = work.Q(:, 1:j)' * work.Z(:, 1:sc);
+        work.Z(:, 1:sc) = work.Z(:, 1:sc) - work.Q(:, 1:j) * C;
+        C2 = work.Q(:, 1:j)' * work.Z(:, 1:sc);
+        work.Z(:, 1:sc) = work.Z(:, 1:sc) - work.Q(:, 1:j) * C2;
+        C = C + C2;
+
+        % Orthonormalize the block
+        [Qb, T] = qr(work.Z(:, 1:sc), 0);
+        work.Q(:, j+1:j+sc) = Qb;
+
+        % Compute the new columns of the Hessenberg matrix
+        [H, sce] = sstep_hessenberg(H, C, T, sigma, j, sc);
+
+        % Apply the Given's rotations column by column
+        for k = 1:sce
+            col = j + k - 1;
+            for i = 1:col
+                work.R(i, col) = H(i, col);
+            end
+            [work.R, work.J, work.y] = givens_update(work.R, work.J, ...
+                work.y, col, H(col+1, col));
+            nb = col;
+
+            resid_prev = resid;
+            resid = abs(work.y(col+1)) / beta0;
+            if resid >= resid_prev * (1 - 1.e-8)
+                flag = int32(3); % stagnated
+                stop = true;
+                break
+            elseif iter >= maxit
+                flag = int32(1); % reached maxit
+                stop = true;
+                break
+            end
+            iter = iter + 1;
+
+            if verbose > 1
+                m2c_printf('At iteration %d, relative residual is %g.\n', iter, resid);
+            end
+
+            % save the residual
+            if nargout > 3
+                resids(iter) = resid;
+            end
+
+            if resid < rtol
+                stop = true;
+                break;
+            end
+        end
+
+        % The basis became linearly dependent within the block
+        if sce < sc
+            break;
+        end
+    end
+
+    if verbose == 1 || verbose >1 && flag
+        m2c_printf('At iteration %d, relative residual is %g.\n', iter, resid);
+    end
+
+    % Compute correction vector, to which the preconditioner is applied
+    if nb > 0
+        work.y = backsolve(work.R, work.y, nb);
+        work.u = work.Q(:, 1:nb) * work.y(1:nb);
+        if isempty(coder.target)
+            x = x + ILUsol(M, work.u);
+        else
+            % Map the correction from the permuted space of M
+            [work.u, work.y1, work.y2] = MILUsolve(M, work.u, ...
+                work.y1, work.y2, nthreads, true);
+            x = MILU_unpermute(M, work.u, x);
+        end
+    end
+
+    if resid < rtol || flag
+        break;
+    end
+end
+
+if nargout > 3
+    resids = resids(1:iter);
+end
+
+if resid <= rtol * (1 + 1.e-8)
+    flag = int32(0);
+end
+
+end
+
+function [H, sce] = sstep_hessenberg(H, C, T, sigma, j, sc)
+% Compute columns j to j+sc-1 of the Hessenberg matrix from a block step.
+%
+% Let V = [Q(:, j), Z] be the monomial basis, so that A*inv(M)*V(:, k) =
+% sigma(k)*V(:, k+1), and V = [Q(:, 1:j), Qb] * Rf, where Rf(j, 1) = 1,
+% Rf(1:j, 2:sc+1) = C and Rf(j+1:j+sc, 2:sc+1) = T. Then the new columns
+% satisfy Hn * Rf(j:j+sc-1, 1:sc) = Rf(:, 2:sc+1) * diag(sigma) -
+% [H(1:j, 1:j-1) * Rf(1:j-1, 1:sc); 0]. sce < sc is returned if the
+% block became linearly dependent, in which case only sce columns are
+% computed.
+
+Rf = zeros(j+sc, sc+1);
+Rf(j, 1) = 1;
+Rf(1:j, 2:sc+1) = C;
+Rf(j+1:j+sc, 2:sc+1) = T;
+
+X = Rf(:, 2:sc+1);
+for k = 1:sc
+    X(:, k) = X(:, k) * sigma(k);
+end
+if j > 1
+    X(1:j, :) = X(1:j, :) - H(1:j, 1:j-1) * Rf(1:j-1, 1:sc);
+end
+
+sce = sc;
+for k = 2:sc
+    if abs(Rf(j+k-1, k)) <= 1.e-14
+        sce = k - 1;
+        break;
+    end
+end
+
+% Solve with the upper-triangular Rf(j:j+sc-1, 1:sc) from the right
+for k = 1:sce
+    for i = 1:j+sc
+        t = X(i, k);
+        for l = 1:k-1
+            t = t - H(i, j+l-1) * Rf(j+l-1, k);
+        end
+        H(i, j+k-1) = t / Rf(j+k-1, k);
+    end
+end
+
+end
+
+function [R, J, y] = givens_update(R, J, y, k, h)
+% Apply the previous Given's rotations to column k of the Hessenberg
+% matrix, whose upper part is in R(1:k, k) and subdiagonal entry is h,
+% and compute the kth Given's rotation.
+
+for colJ = 1:k-1
+    tmpv = R(colJ, k);
+    R(colJ, k) = conj(J(1, colJ)) * R(colJ, k) + conj(J(2, colJ)) * R(colJ+1, k);
+    R(colJ+1, k) = - J(2, colJ) * tmpv + J(1, colJ) * R(colJ+1, k);
+end
+
+rho = sqrt(R(k, k)'*R(k, k)+h*h);
+J(1, k) = R(k, k) ./ rho;
+J(2, k) = h ./ rho;
+y(k+1) = - J(2, k) .* y(k);
+y(k) = conj(J(1, k)) .* y(k);
+R(k, k) = rho;
+
+end
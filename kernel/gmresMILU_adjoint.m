@@ -0,0 +1,31 @@
+function [x, flag, iter, resids, work] = gmresMILU_adjoint(At, b, ...
+    M, restart, rtol, maxit, x0, verbose, nthreads, work)
+%gmresMILU_adjoint Kernel of gmresMILU for the adjoint system A'*x = b
+%
+%   x = gmresMILU_adjoint(At, b, M, restart, rtol, maxit, x0, verbose, nthreads)
+%     solves A'*x = b using modified Gram-Schmidt GMRES, where At is A'
+%     in CRS format and M is the preconditioner of A returned by
+%     MILUfactor. M' is applied as the right preconditioner using
+%     MILUsolve_transpose, so A does not need to be refactored. When
+%     uncompiled, call gmresMILU_adjoint_noncompiled with the
+%     preconditioner of ILUPACK instead.
+%
+%   [x, flag, iter, resids] = gmresMILU_adjoint(...)
+%
+%   [x, flag, iter, resids, work] = gmresMILU_adjoint(..., nthreads, work)
+%     reuses the buffers in work, as in gmresMILU_MGS.
+%
+% See also: gmresMILU, gmresMILU_MGS, gmresMILU_MGS_noncompiled,
+%           MILUsolve_transpose
+
+%#codegen -args {crs_matrix, m2c_vec, MILU_Prec, int32(0), 0., int32(0),
+%#codegen m2c_vec, int32(0), int32(0), Krylov_Work}
+%#codegen gmresMILU_adjoint_9args -args {crs_matrix, m2c_vec, MILU_Prec,
+%#codegen int32(0), 0., int32(0), m2c_vec, int32(0), int32(0)}
+
+if nargin < 10
+    % The buffers are allocated by gmresMILU_MGS_noncompiled
+    work = Krylov_createWork(int32(0), int32(0), int32(0));
+end
+[x, flag, iter, resids, work] = gmresMILU_MGS_noncompiled(At, b, ...
+    M, restart, rtol, maxit, x0, verbose, nthreads, work, true);
@@ -0,0 +1,19 @@
+function [x, flag, iter, resids, work] = gmresMILU_adjoint_noncompiled(At, b, ...
+    M, restart, rtol, maxit, x0, verbose, nthreads, work)
+%gmresMILU_adjoint_noncompiled Uncompiled kernel of gmresMILU for the
+%  adjoint system A'*x = b
+%
+%   x = gmresMILU_adjoint_noncompiled(At, b, M, restart, rtol, maxit, x0, verbose, nthreads)
+%     is the same as gmresMILU_adjoint, where M is the preconditioner of
+%     ILUPACK for A, which is applied using ILUhsol. It can be called when
+%     gmresMILU_adjoint is compiled.
+%
+%   [x, flag, iter, resids, work] = gmresMILU_adjoint_noncompiled(..., nthreads, work)
+%
+% See also: gmresMILU, gmresMILU_adjoint, gmresMILU_MGS_noncompiled
+
+if nargin < 10
+    work = Krylov_createWork(int32(0), int32(0), int32(0));
+end
+[x, flag, iter, resids, work] = gmresMILU_MGS_noncompiled(At, b, ...
+    M, restart, rtol, maxit, x0, verbose, nthreads, work, true);
@@ -0,0 +1,286 @@
+function [X, flag, iter, resids] = gmresMILU_block(A, B, ...
+    M, restart, rtol, maxit, X0, verbose, nthreads)
+%gmresMILU_block Kernel of gmresMILU for multiple right-hand sides
+%
+%   X = gmresMILU_block(A, B, M, restart, rtol, maxit, X0, verbose, nthreads)
+%     solves A*X=B for all the columns of B simultaneously using block
+%     GMRES with MILU as the right preconditioner. Each block iteration
+%     performs one block matrix-vector product and one block
+%     preconditioner solve for all the right-hand sides. When uncompiled,
+%     call this kernel function by passing the PREC struct returned by
+%     MILUfactor.
+%
+%   [X, flag, iter, resids] = gmresMILU_block(...)
+%     iter is the number of block iterations, and resids(i, j) is the
+%     relative residual of the jth right-hand side at block iteration i.
+%
+% See also: gmresMILU, gmresMILU_MGS, MILUsolve_block
+
+% Note: The algorithm uses block Arnoldi with modified Gram-Schmidt
+% orthogonalization, and the band Hessenberg matrix is reduced to upper
+% triangular form using Given's rotations.
+
+%#codegen -args {crs_matrix, m2c_mat, MILU_Prec, int32(0), 0., int32(0),
+%#codegen m2c_mat, int32(0), int32(0)}
+
+n = int32(size(B, 1));
+s = int32(size(B, 2));
+
+% Norms of right-hand sides
+beta0 = zeros(1, s);
+for r = 1:s
+    beta0(r) = sqrt(vec_sqnorm2(B(:, r)));
+end
+
+% If all RHS are zero, terminate
+if ~any(beta0)
+    X = zeros(n, s);
+    flag = int32(0);
+    iter = int32(0);
+    resids = zeros(1, s);
+    return;
+end
+beta0(beta0 == 0) = 1;
+
+% Number of block iterations before restart
+if restart * s > n
+    restart = max(idivide(n, s), int32(1));
+elseif restart <= 0
+    restart = int32(1);
+end
+ms = restart * s;
+
+% Determine the maximum number of outer iterations
+max_outer_iters = int32(ceil(double(maxit)/double(restart)));
+
+% Initialize X
+if isempty(X0)
+    X = zeros(n, s);
+else
+    X = X0;
+end
+
+% Local linear system and upper-triangular matrix
+G = zeros(ms+s, s);
+R = zeros(ms+s, ms);
+
+% Orthognalized block Krylov subspace
+Q = zeros(n, ms+s);
+
+% Preconditioned subspace
+Z = zeros(n, ms);
+
+% Given's rotation vectors. Column c has s rotations.
+Jc = zeros(s, ms);
+Js = zeros(s, ms);
+
+% Buffer spaces
+W = zeros(n, s);
+if ~isempty(coder.target)
+    Y1 = zeros(s, n);
+    Y2 = zeros(s, M(1).negE.nrows);
+end
+
+if nargout > 3
+    resids = zeros(maxit, s);
+end
+
+flag = int32(0);
+iter = int32(0);
+resid = ones(1, s);
+for it_outer = 1:max_outer_iters
+    % Compute the initial residual
+    if it_outer > 1 || vec_sqnorm2(X(:)) > 0
+        W = crs_prodAX(A, X, W, nthreads);
+        W = B - W;
+    else
+        W = B;
+    end
+
+    % Orthogonalize the initial residual into the first block of Q
+    G(:) = 0;
+    for r = 1:s
+        for k = 1:r-1
+            G(k, r) = Q(:, k)' * W(:, r);
+            W(:, r) = W(:, r) - G(k, r) * Q(:, k);
+        end
+        G(r, r) = sqrt(vec_sqnorm2(W(:, r)));
+        if G(r, r) > 1.e-14 * beta0(r)
+            Q(:, r) = W(:, r) / G(r, r);
+        else
+            Q(:, r) = 0;
+        end
+    end
+
+    j = int32(1);
+    while true
+        cols = (j-1)*s+1:j*s;
+
+        % Compute the preconditioned block
+        if isempty(coder.target)
+            W = ILUsol(M, Q(:, cols));
+        else
+            W = Q(:, cols);
+            [W, Y1, Y2] = MILUsolve_block(M, W, Y1, Y2);
+        end
+
+        % Store the preconditioned block
+        Z(:, cols) = W;
+        W = crs_prodAX(A, Z(:, cols), W, nthreads);
+
+        % Perform block Gram-Schmidt orthogonalization and store R
+        for t = 1:s
+            c = cols(t);
+            wnorm = sqrt(vec_sqnorm2(W(:, t)));
+            for k = 1:c+s-1
+                R(k, c) = Q(:, k)' * W(:, t);
+                W(:, t) = W(:, t) - R(k, c) * Q(:, k);
+            end
+            R(c+s, c) = sqrt(vec_sqnorm2(W(:, t)));
+            if R(c+s, c) > 1.e-14 * wnorm
+                Q(:, c+s) = W(:, t) / R(c+s, c);
+            else
+                Q(:, c+s) = 0;
+            end
+        end
+
+        for t = 1:s
+            c = cols(t);
+
+            %  Apply previous Given's rotations to R(:, c)
+            for colJ = 1:c-1
+                for tJ = s:-1:1
+                    k = colJ + tJ - 1;
+                    tmpv = R(k, c);
+                    R(k, c) = Jc(tJ, colJ) * tmpv + Js(tJ, colJ) * R(k+1, c);
+                    R(k+1, c) = - Js(tJ, colJ) * tmpv + Jc(tJ, colJ) * R(k+1, c);
+                end
+            end
+
+            %  Compute Given's rotations to annihilate R(c+1:c+s, c)
+            for tJ = s:-1:1
+                k = c + tJ - 1;
+                rho = sqrt(R(k, c)*R(k, c) + R(k+1, c)*R(k+1, c));
+                if rho == 0
+                    Jc(tJ, c) = 1;
+                    Js(tJ, c) = 0;
+                else
+                    Jc(tJ, c) = R(k, c) / rho;
+                    Js(tJ, c) = R(k+1, c) / rho;
+                end
+                R(k, c) = rho;
+                R(k+1, c) = 0;
+
+                for r = 1:s
+                    tmpv = G(k, r);
+                    G(k, r) = Jc(tJ, c) * tmpv + Js(tJ, c) * G(k+1, r);
+                    G(k+1, r) = - Js(tJ, c) * tmpv + Jc(tJ, c) * G(k+1, r);
+                end
+            end
+        end
+
+        resid_prev = max(resid);
+        for r = 1:s
+            resid(r) = sqrt(vec_sqnorm2(G(j*s+1:j*s+s, r))) / beta0(r);
+        end
+        if max(resid) >= resid_prev * (1 - 1.e-8)
+            flag = int32(3); % stagnated
+            break
+        elseif iter >= maxit
+            flag = int32(1); % reached maxit
+            break
+        end
+        iter = iter + 1;
+
+        if verbose > 1
+            m2c_printf('At iteration %d, max relative residual is %g.\n', iter, max(resid));
+        end
+
+        % save the residuals
+        if nargout > 3
+            resids(iter, :) = resid;
+        end
+
+        if max(resid) < rtol || j >= restart
+            break;
+        end
+        j = j + 1;
+    end
+
+    if verbose == 1 || verbose >1 && flag
+        m2c_printf('At iteration %d, max relative residual is %g.\n', iter, max(resid));
+    end
+
+    % Compute correction vectors
+    G = backsolve_block(R, G, j*s, s);
+    for i = 1:j*s
+        for r = 1:s
+            X(:, r) = X(:, r) + G(i, r) * Z(:, i);
+        end
+    end
+
+    if max(resid) < rtol || flag
+        break;
+    end
+end
+
+if nargout > 3
+    resids = resids(1:iter, :);
+end
+
+if max(resid) <= rtol * (1 + 1.e-8)
+    flag = int32(0);
+end
+
+end
+
+function G = backsolve_block(R, G, m, s)
+% Solve the upper-triangular system R(1:m, 1:m) \ G(1:m, :) in place.
+% Columns corresponding to vanished basis vectors contribute nothing.
+
+for r = 1:s
+    for k = m:-1:1
+        if R(k, k) == 0
+            G(k, r) = 0;
+        else
+            G(k, r) = G(k, r) / R(k, k);
+        end
+        for i = 1:k-1
+            G(i, r) = G(i, r) - R(i, k) * G(k, r);
+        end
+    end
+end
+
+end
+
+function Y = crs_prodAX(A, X, Y, nthreads)
+% Compute Y = A*X for a block of vectors X.
+
+if isempty(coder.target)
+    Y = crs_2sparse(A) * X;
+else
+    %#omp parallel default(shared) num_threads(nthreads)
+    Y = crs_prodAX_kernel(A.row_ptr, A.col_ind, A.val, X, Y, A.nrows);
+end
+
+end
+
+function Y = crs_prodAX_kernel(row_ptr, col_ind, val, X, Y, nrows)
+coder.inline('never');
+
+s = int32(size(X, 2));
+[istart, iend] = OMP_local_chunk(nrows);
+
+for i = istart:iend
+    for r = 1:s
+        Y(i, r) = 0;
+    end
+    for j = row_ptr(i):row_ptr(i+1)-1
+        c = col_ind(j);
+        for r = 1:s
+            Y(i, r) = Y(i, r) + val(j) * X(c, r);
+        end
+    end
+end
+
+end
@@ -0,0 +1,18 @@
+function [X, flag, iter, resids] = gmresMILU_block_mixed(A, B, ...
+    M, restart, rtol, maxit, X0, verbose, nthreads)
+%gmresMILU_block_mixed Kernel of gmresMILU for multiple right-hand sides
+%  and single-precision MILU factors
+%
+%   X = gmresMILU_block_mixed(A, B, M, restart, rtol, maxit, X0, verbose, nthreads)
+%     is the same as gmresMILU_block, compiled for the preconditioner
+%     returned by MILUfactor with opts.mixedprecision set.
+%
+%   [X, flag, iter, resids] = gmresMILU_block_mixed(...)
+%
+% See also: gmresMILU, gmresMILU_block, MILU_SPrec
+
+%#codegen -args {crs_matrix, m2c_mat, MILU_SPrec, int32(0), 0., int32(0),
+%#codegen m2c_mat, int32(0), int32(0)}
+
+[X, flag, iter, resids] = gmresMILU_block(A, B, ...
+    M, restart, rtol, maxit, X0, verbose, nthreads);
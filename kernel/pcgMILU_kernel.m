@@ -0,0 +1,149 @@
+function [x, flag, iter, resids, work] = pcgMILU_kernel(A, b, ...
+    M, rtol, maxit, x0, verbose, nthreads, work)
+%pcgMILU_kernel Kernel of pcgMILU
+%
+%   x = pcgMILU_kernel(A, b, prec, rtol, maxit, x0, verbose, nthreads)
+%     when uncompiled, call this kernel function by passing the prec
+%     struct returned by MILUfactor
+%
+%   [x, flag, iter, resids] = pcgMILU_kernel(...)
+%
+%   [x, flag, iter, resids, work] = pcgMILU_kernel(..., nthreads, work)
+%     reuses the buffers in work, created by Krylov_createWork or
+%     returned by a previous call, so that repeated solves of the same
+%     size do not allocate memory.
+%
+% See also: pcgMILU
+
+% Note: Unlike the right-preconditioned kernels, the inner products of
+% PCG involve the preconditioned residual, so the preconditioner is
+% applied in the original space using MILUsolve, and the permuted matrix
+% of MILU_permuteA is not used.
+
+%#codegen -args {crs_matrix, m2c_vec, MILU_Prec, 0., int32(0),
+%#codegen m2c_vec, int32(0), int32(0), Krylov_Work}
+%#codegen pcgMILU_kernel_8args -args {crs_matrix, m2c_vec, MILU_Prec,
+%#codegen 0., int32(0), m2c_vec, int32(0), int32(0)}
+
+n = int32(size(b, 1));
+flag = int32(0);
+iter = int32(0);
+
+% Buffer spaces. The residual r is stored in work.u, A*p in work.v, the
+% preconditioned residual z in work.w, and the direction p in work.Q.
+if isempty(coder.target)
+    nE = int32(0);
+else
+    nE = M(1).negE.nrows;
+end
+if nargin < 9
+    work = Krylov_createWork(n, int32(1), nE);
+else
+    work = Krylov_createWork(n, int32(1), nE, work);
+end
+
+% If RHS is zero, terminate
+bnrm2 = sqrt(vec_sqnorm2(b));
+if bnrm2 == 0
+    x = zeros(n, 1);
+    resids = 0;
+    return;
+end
+
+% Initialize x
+if isempty(x0)
+    x = zeros(n, 1);
+else
+    x = x0;
+end
+
+if nargout > 3
+    resids = zeros(maxit, 1);
+end
+
+% Compute the initial residual
+if vec_sqnorm2(x) > 0
+    work.u = crs_prodAx(A, x, work.u, nthreads);
+    work.u = b - work.u;
+else
+    work.u = b;
+end
+
+resid = sqrt(vec_sqnorm2(work.u)) / bnrm2;
+if resid < rtol
+    resids = 0;
+    return
+end
+
+rho_1 = 0.0;
+pAp = 1.0;
+
+iter = int32(1);
+while true
+    % Compute the preconditioned residual
+    if isempty(coder.target)
+        work.w = ILUsol(M, work.u);
+    else
+        work.w = work.u;
+        [work.w, work.y1, work.y2] = MILUsolve(M, work.w, ...
+            work.y1, work.y2, nthreads);
+    end
+
+    rho = work.u' * work.w;
+    if rho == 0.0
+        break
+    end
+
+    if iter > 1
+        beta = rho / rho_1;
+        work.Q(:, 1) = work.w + beta * work.Q(:, 1);
+    else
+        work.Q(:, 1) = work.w;
+    end
+
+    work.v = crs_prodAx(A, work.Q(:, 1), work.v, nthreads);
+    pAp = work.Q(:, 1)' * work.v;
+    if pAp <= 0.0 % A or M is not positive definite
+        break
+    end
+
+    alpha = rho / pAp;
+    x = x + alpha * work.Q(:, 1);
+    work.u = work.u - alpha * work.v;
+
+    resid = sqrt(vec_sqnorm2(work.u)) / bnrm2; % check convergence
+    resids(iter) = resid;
+
+    if verbose > 1 || verbose > 0 && mod(iter, 30) == 0
+        m2c_printf('At iteration %d, relative residual is %g.\n', iter, resid);
+    end
+
+    if resid <= rtol
+        break
+    elseif resid > 100 % diverged
+        flag = int32(-3);
+        break
+    end
+    rho_1 = rho;
+
+    if iter >= maxit
+        break
+    end
+    iter = iter + 1;
+end
+
+if nargout > 3
+    resids = resids(1:iter);
+end
+
+if resid <= rtol % converged
+    flag = int32(0);
+elseif pAp <= 0.0 % breakdown
+    flag = int32(-2);
+elseif rho == 0.0
+    flag = int32(-1);
+elseif flag == 0 % no convergence
+    flag = int32(1);
+end
+
+end
@@ -0,0 +1,168 @@
+function [x, flag, iter, resids, work] = sqmrMILU_kernel(A, b, ...
+    M, rtol, maxit, x0, verbose, nthreads, work)
+%sqmrMILU_kernel Kernel of sqmrMILU
+%
+%   x = sqmrMILU_kernel(A, b, prec, rtol, maxit, x0, verbose, nthreads)
+%     when uncompiled, call this kernel function by passing the prec
+%     struct returned by MILUfactor
+%
+%   [x, flag, iter, resids] = sqmrMILU_kernel(...)
+%
+%   [x, flag, iter, resids, work] = sqmrMILU_kernel(..., nthreads, work)
+%     reuses the buffers in work, created by Krylov_createWork or
+%     returned by a previous call, so that repeated solves of the same
+%     size do not allocate memory.
+%
+% See also: sqmrMILU
+
+% Note: The algorithm is the symmetric QMR method of Freund and Nachtigal
+% with a symmetric (possibly indefinite) preconditioner. It uses a single
+% matrix-vector product and preconditioner solve per iteration. The
+% quasi-residual norm is only an upper bound of the residual, so the true
+% residual is updated along with x using the recurrence of A*d.
+
+%#codegen -args {crs_matrix, m2c_vec, MILU_Prec, 0., int32(0),
+%#codegen m2c_vec, int32(0), int32(0), Krylov_Work}
+%#codegen sqmrMILU_kernel_8args -args {crs_matrix, m2c_vec, MILU_Prec,
+%#codegen 0., int32(0), m2c_vec, int32(0), int32(0)}
+
+n = int32(size(b, 1));
+flag = int32(0);
+iter = int32(0);
+
+% Buffer spaces. The Lanczos residual r is stored in work.u, A*q in
+% work.v, the preconditioned residual in work.w, the direction q and the
+% true residual in work.Q, and the correction d to x and A*d in work.Z.
+if isempty(coder.target)
+    nE = int32(0);
+else
+    nE = M(1).negE.nrows;
+end
+if nargin < 9
+    work = Krylov_createWork(n, int32(2), nE);
+else
+    work = Krylov_createWork(n, int32(2), nE, work);
+end
+
+% If RHS is zero, terminate
+bnrm2 = sqrt(vec_sqnorm2(b));
+if bnrm2 == 0
+    x = zeros(n, 1);
+    resids = 0;
+    return;
+end
+
+% Initialize x
+if isempty(x0)
+    x = zeros(n, 1);
+else
+    x = x0;
+end
+
+if nargout > 3
+    resids = zeros(maxit, 1);
+end
+
+% Compute the initial residual
+if vec_sqnorm2(x) > 0
+    work.u = crs_prodAx(A, x, work.u, nthreads);
+    work.u = b - work.u;
+else
+    work.u = b;
+end
+
+tau = sqrt(vec_sqnorm2(work.u));
+resid = tau / bnrm2;
+if resid < rtol
+    resids = 0;
+    return
+end
+work.Q(:, 2) = work.u;
+work.Z(:, 1) = 0;
+work.Z(:, 2) = 0;
+
+% Compute the first direction
+if isempty(coder.target)
+    work.Q(:, 1) = ILUsol(M, work.u);
+else
+    work.w = work.u;
+    [work.w, work.y1, work.y2] = MILUsolve(M, work.w, ...
+        work.y1, work.y2, nthreads);
+    work.Q(:, 1) = work.w;
+end
+
+theta = 0.0;
+rho = work.u' * work.Q(:, 1);
+sigma = 1.0;
+
+iter = int32(1);
+while rho ~= 0.0
+    work.v = crs_prodAx(A, work.Q(:, 1), work.v, nthreads);
+    sigma = work.Q(:, 1)' * work.v;
+    if sigma == 0.0
+        break
+    end
+
+    alpha = rho / sigma;
+    work.u = work.u - alpha * work.v;
+
+    % Update the quasi-residual
+    theta_1 = theta;
+    theta = sqrt(vec_sqnorm2(work.u)) / tau;
+    c2 = 1 / (1 + theta * theta);
+    tau = tau * theta * sqrt(c2);
+
+    % Update x and the true residual
+    work.Z(:, 1) = (c2 * theta_1 * theta_1) * work.Z(:, 1) + ...
+        (c2 * alpha) * work.Q(:, 1);
+    work.Z(:, 2) = (c2 * theta_1 * theta_1) * work.Z(:, 2) + ...
+        (c2 * alpha) * work.v;
+    x = x + work.Z(:, 1);
+    work.Q(:, 2) = work.Q(:, 2) - work.Z(:, 2);
+
+    resid = sqrt(vec_sqnorm2(work.Q(:, 2))) / bnrm2; % check convergence
+    resids(iter) = resid;
+
+    if verbose > 1 || verbose > 0 && mod(iter, 30) == 0
+        m2c_printf('At iteration %d, relative residual is %g.\n', iter, resid);
+    end
+
+    if resid <= rtol
+        break
+    elseif resid > 100 % diverged
+        flag = int32(-3);
+        break
+    elseif iter >= maxit
+        break
+    end
+    iter = iter + 1;
+
+    % Compute the next direction
+    if isempty(coder.target)
+        work.w = ILUsol(M, work.u);
+    else
+        work.w = work.u;
+        [work.w, work.y1, work.y2] = MILUsolve(M, work.w, ...
+            work.y1, work.y2, nthreads);
+    end
+
+    rho_1 = rho;
+    rho = work.u' * work.w;
+    work.Q(:, 1) = work.w + (rho / rho_1) * work.Q(:, 1);
+end
+
+if nargout > 3
+    resids = resids(1:iter);
+end
+
+if resid <= rtol % converged
+    flag = int32(0);
+elseif rho == 0.0 % breakdown
+    flag = int32(-1);
+elseif sigma == 0.0
+    flag = int32(-2);
+elseif flag == 0 % no convergence
+    flag = int32(1);
+end
+
+end
@@ -0,0 +1,457 @@
+/* ========================================================================== */
+/* === DGNLilupack2milu mexFunction ========================================= */
+/* ========================================================================== */
+
+/*
+    Usage:
+
+    Convert the multilevel ILU of a real nonsymmetric matrix computed by
+    DGNLilupackfactor into the structure array M used by MILUsolve (see
+    MILU_Prec). The factors are read directly from the DAMGlevelmat list
+    referenced by PREC(1).ptr, so no intermediate sparse matrices need to
+    be formed in MATLAB.
+
+    Example:
+
+    % convert the preconditioner without level schedules
+    M = DGNLilupack2milu(PREC);
+
+    % also create the row-oriented copies of L and U in M(i).Lrow and
+    % M(i).Urow, which are needed for the level schedules
+    M = DGNLilupack2milu(PREC, 1);
+
+    % also return the number of nonzeros in all the levels and in their
+    % coupling blocks E and F, as options.nnz_total and
+    % options.nnz_offdiag of MILUfactor
+    [M, nnz_total, nnz_offdiag] = DGNLilupack2milu(PREC, levelsched);
+
+    For each level, M(i).L and M(i).U are the strictly lower and upper
+    triangular parts of the unit triangular factors in CCS format, M(i).d
+    is the diagonal, M(i).doff is empty since all the pivots are 1-by-1,
+    and M(i).negE and M(i).negF are -E and -F in CRS
+    format. In the coarsest level, if the matrix was factorized as a dense
+    matrix, then M(i).U.val stores tril(L, -1) + D * U as a dense matrix.
+    The fields Llev_ptr, Llev_ind, Ulev_ptr and Ulev_ind are left empty.
+    It requires that PREC was computed with the flag COARSE_REDUCE. Only
+    PREC(1).ptr and PREC(1).param are read, so PREC may be computed by
+    DGNLilupackfactor(A,options,1) without exporting the factors.
+
+    Notice:
+
+        THIS MATERIAL IS PROVIDED AS IS, WITH ABSOLUTELY NO WARRANTY
+        EXPRESSED OR IMPLIED.  ANY USE IS AT YOUR OWN RISK.
+*/
+
+/* ========================================================================== */
+/* === Include files and prototypes ========================================= */
+/* ========================================================================== */
+
+#include "matrix.h"
+#include "mex.h"
+#include <ilupack.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *milu_names[] = {
+    "p",    "q",    "rowscal",  "colscal",  "prowscal", "qcolscal",
+    "L",    "U",    "d",        "doff",     "negE",     "negF",
+    "Lrow", "Urow", "Llev_ptr", "Llev_ind", "Ulev_ptr", "Ulev_ind"};
+static const char *ccs_names[] = {"col_ptr", "row_ind", "val", "nrows",
+                                  "ncols"};
+static const char *crs_names[] = {"row_ptr", "col_ind", "val", "nrows",
+                                  "ncols"};
+
+/* create an int32 column vector */
+static mxArray *int32_vector(mwSize n) {
+  return mxCreateNumericMatrix(n, (mwSize)1, mxINT32_CLASS, mxREAL);
+}
+
+/* create an int32 scalar */
+static mxArray *int32_scalar(integer v) {
+  mxArray *out = int32_vector((mwSize)1);
+  *(int *)mxGetData(out) = (int)v;
+  return out;
+}
+
+/* wrap the arrays of a sparse matrix into a ccs_matrix or crs_matrix */
+static mxArray *sparse_struct(const char **names, mxArray *ptr, mxArray *ind,
+                              mxArray *val, integer nrows, integer ncols) {
+  mxArray *out = mxCreateStructMatrix((mwSize)1, (mwSize)1, 5, names);
+
+  mxSetFieldByNumber(out, 0, 0, ptr);
+  mxSetFieldByNumber(out, 0, 1, ind);
+  mxSetFieldByNumber(out, 0, 2, val);
+  mxSetFieldByNumber(out, 0, 3, int32_scalar(nrows));
+  mxSetFieldByNumber(out, 0, 4, int32_scalar(ncols));
+  return out;
+}
+
+/* create an empty m-by-n sparse matrix with nnz zero values */
+static mxArray *empty_sparse(const char **names, integer m, integer n,
+                             mwSize nnz) {
+  mxArray *ptr = int32_vector((mwSize)((names == ccs_names ? n : m) + 1));
+  int *iptr = (int *)mxGetData(ptr);
+  mwSize i;
+
+  for (i = 0; i < mxGetM(ptr); i++)
+    iptr[i] = 1;
+  return sparse_struct(names, ptr, int32_vector((mwSize)0),
+                       mxCreateDoubleMatrix(nnz, (mwSize)1, mxREAL), m, n);
+}
+
+/* transpose a compressed matrix with nouter rows (or columns) and ninner
+   columns (or rows), i.e., convert between CRS and CCS. The inner indices
+   of the output are sorted if the outer indices of the input are. */
+static void transpose_compressed(integer nouter, integer ninner,
+                                 const int *ptr, const int *ind,
+                                 const double *val, int *tptr, int *tind,
+                                 double *tval) {
+  integer i, j, k;
+
+  for (i = 0; i <= ninner; i++)
+    tptr[i] = 0;
+  for (j = 0; j < ptr[nouter] - 1; j++)
+    tptr[ind[j]]++;
+  tptr[0] = 1;
+  for (i = 0; i < ninner; i++)
+    tptr[i + 1] += tptr[i];
+
+  for (i = 0; i < nouter; i++) {
+    for (j = ptr[i] - 1; j < ptr[i + 1] - 1; j++) {
+      k = tptr[ind[j] - 1] - 1;
+      tind[k] = (int)(i + 1);
+      tval[k] = val[j];
+      tptr[ind[j] - 1]++;
+    }
+  }
+
+  for (i = ninner; i > 0; i--)
+    tptr[i] = tptr[i - 1];
+  tptr[0] = 1;
+}
+
+/* transpose a ccs_matrix into a crs_matrix or vice versa */
+static mxArray *transpose_struct(const char **names, const mxArray *A,
+                                 integer nouter, integer ninner) {
+  mwSize nnz = mxGetM(mxGetFieldByNumber(A, 0, 2));
+  mxArray *ptr = int32_vector((mwSize)(ninner + 1));
+  mxArray *ind = int32_vector(nnz);
+  mxArray *val = mxCreateDoubleMatrix(nnz, (mwSize)1, mxREAL);
+
+  transpose_compressed(nouter, ninner,
+                       (int *)mxGetData(mxGetFieldByNumber(A, 0, 0)),
+                       (int *)mxGetData(mxGetFieldByNumber(A, 0, 1)),
+                       mxGetPr(mxGetFieldByNumber(A, 0, 2)),
+                       (int *)mxGetData(ptr), (int *)mxGetData(ind),
+                       mxGetPr(val));
+
+  /* nrows and ncols are swapped along with the format */
+  return sparse_struct(names, ptr, ind, val, ninner, nouter);
+}
+
+/* convert E or F of a level into a crs_matrix of -E or -F */
+static mxArray *negate_coupling(const Dmat *E) {
+  mwSize nnz = (mwSize)(E->ia[E->nr] - 1);
+  mxArray *ptr = int32_vector((mwSize)(E->nr + 1));
+  mxArray *ind = int32_vector(nnz);
+  mxArray *val = mxCreateDoubleMatrix(nnz, (mwSize)1, mxREAL);
+  int *iptr = (int *)mxGetData(ptr), *iind = (int *)mxGetData(ind);
+  double *pval = mxGetPr(val);
+  mwSize j;
+
+  for (j = 0; j <= (mwSize)E->nr; j++)
+    iptr[j] = (int)E->ia[j];
+  for (j = 0; j < nnz; j++) {
+    iind[j] = (int)E->ja[j];
+    pval[j] = -E->a[j];
+  }
+
+  return sparse_struct(crs_names, ptr, ind, val, E->nr, E->nc);
+}
+
+/* sort the indices of a compressed row or column along with its values */
+static void sort_compressed(int *ind, double *val, mwSize len) {
+  mwSize i, j;
+  int t;
+  double v;
+
+  for (i = 1; i < len; i++) {
+    t = ind[i];
+    v = val[i];
+    for (j = i; j > 0 && ind[j - 1] > t; j--) {
+      ind[j] = ind[j - 1];
+      val[j] = val[j - 1];
+    }
+    ind[j] = t;
+    val[j] = v;
+  }
+}
+
+/* convert the sparse LU factors of a level into M(i).L, M(i).U, M(i).d
+   and, if levelsched is nonzero, M(i).Lrow and M(i).Urow. Return the
+   number of nonzeros in L, U and the diagonal. */
+static mwSize convert_sparse_lu(DAMGlevelmat *current, mxArray *M,
+                                mwIndex lvl, int levelsched) {
+  integer nB = current->nB, i, j, k, uend;
+  integer *ia = current->LU.ia, *ja = current->LU.ja;
+  double *a = current->LU.a;
+  mwSize nnzL = 0, nnzU = 0;
+  mxArray *ptr, *ind, *val, *L, *Urow, *d;
+  int *iptr, *iind;
+  double *pval, *pd;
+
+  for (i = 0; i < nB; i++) {
+    /* the end of the last row of U is not stored in ja[nB] */
+    uend = (i < nB - 1) ? ja[i + 1] : current->LU.nnz + 1;
+    nnzL += (mwSize)(ia[i] - ja[i]);
+    nnzU += (mwSize)(uend - ia[i]);
+  }
+
+  /* 1. strictly lower triangular part of unit-lower L in CCS format,
+     stored in column i in ja[i]-1:ia[i]-2 */
+  ptr = int32_vector((mwSize)(nB + 1));
+  ind = int32_vector(nnzL);
+  val = mxCreateDoubleMatrix(nnzL, (mwSize)1, mxREAL);
+  iptr = (int *)mxGetData(ptr);
+  iind = (int *)mxGetData(ind);
+  pval = mxGetPr(val);
+
+  k = 0;
+  iptr[0] = 1;
+  for (i = 0; i < nB; i++) {
+    for (j = ja[i] - 1; j < ia[i] - 1; j++) {
+      if (ja[j] > nB)
+        mexErrMsgTxt("DGNLilupack2milu requires the flag COARSE_REDUCE.");
+      iind[k] = (int)ja[j];
+      pval[k++] = a[j] * a[i];
+    }
+    iptr[i + 1] = (int)(k + 1);
+    /* the row indices are sorted in place only when PREC(i).L is exported */
+    sort_compressed(iind + iptr[i] - 1, pval + iptr[i] - 1,
+                    (mwSize)(iptr[i + 1] - iptr[i]));
+  }
+  L = sparse_struct(ccs_names, ptr, ind, val, nB, nB);
+
+  /* 2. strictly upper triangular part of unit-upper U in CRS format,
+     stored in row i in ia[i]-1:ja[i+1]-2 */
+  ptr = int32_vector((mwSize)(nB + 1));
+  ind = int32_vector(nnzU);
+  val = mxCreateDoubleMatrix(nnzU, (mwSize)1, mxREAL);
+  iptr = (int *)mxGetData(ptr);
+  iind = (int *)mxGetData(ind);
+  pval = mxGetPr(val);
+
+  k = 0;
+  iptr[0] = 1;
+  for (i = 0; i < nB; i++) {
+    uend = (i < nB - 1) ? ja[i + 1] : current->LU.nnz + 1;
+    for (j = ia[i] - 1; j < uend - 1; j++) {
+      if (ja[j] > nB)
+        mexErrMsgTxt("DGNLilupack2milu requires the flag COARSE_REDUCE.");
+      iind[k] = (int)ja[j];
+      pval[k++] = a[j] * a[i];
+    }
+    iptr[i + 1] = (int)(k + 1);
+  }
+  Urow = sparse_struct(crs_names, ptr, ind, val, nB, nB);
+
+  /* 3. diagonal, stored as its reciprocal in a[0:nB-1] */
+  d = mxCreateDoubleMatrix((mwSize)nB, (mwSize)1, mxREAL);
+  pd = mxGetPr(d);
+  for (i = 0; i < nB; i++)
+    pd[i] = 1.0 / a[i];
+
+  mxSetField(M, lvl, "L", L);
+  mxSetField(M, lvl, "U", transpose_struct(ccs_names, Urow, nB, nB));
+  mxSetField(M, lvl, "d", d);
+
+  if (levelsched) {
+    mxSetField(M, lvl, "Lrow", transpose_struct(crs_names, L, nB, nB));
+    mxSetField(M, lvl, "Urow", Urow);
+  } else {
+    mxDestroyArray(Urow);
+    mxSetField(M, lvl, "Lrow", empty_sparse(crs_names, 0, 0, 0));
+    mxSetField(M, lvl, "Urow", empty_sparse(crs_names, 0, 0, 0));
+  }
+
+  return nnzL + nnzU + (mwSize)nB;
+}
+
+/* convert the dense LU factorization in the coarsest level, stored row by
+   row in a, into tril(L, -1) + D * U in M(i).U.val. Return the number of
+   nonzeros in L and U. */
+static mwSize convert_dense_lu(DAMGlevelmat *current, mxArray *M,
+                             mwIndex lvl) {
+  integer nB = current->nB, i, j;
+  double *a = current->LU.a, *LU;
+  mxArray *U;
+  mwSize nnz = 0;
+
+  U = empty_sparse(ccs_names, nB, nB, (mwSize)nB * (mwSize)nB);
+  LU = mxGetPr(mxGetField(U, 0, "val"));
+
+  for (j = 0; j < nB; j++) {
+    for (i = 0; i < j; i++)
+      LU[i + j * nB] = a[i * nB + i] * a[i * nB + j];
+    LU[j + j * nB] = a[j * nB + j];
+    for (i = j + 1; i < nB; i++)
+      LU[i + j * nB] = a[i * nB + j] / a[j * nB + j];
+  }
+  for (i = 0; i < nB * nB; i++)
+    nnz += LU[i] != 0.0;
+
+  mxSetField(M, lvl, "L", empty_sparse(ccs_names, nB, nB, 0));
+  mxSetField(M, lvl, "U", U);
+  mxSetField(M, lvl, "d", mxCreateDoubleMatrix((mwSize)0, (mwSize)1, mxREAL));
+  mxSetField(M, lvl, "Lrow", empty_sparse(crs_names, 0, 0, 0));
+  mxSetField(M, lvl, "Urow", empty_sparse(crs_names, 0, 0, 0));
+
+  return nnz;
+}
+
+/* ========================================================================== */
+/* === mexFunction ========================================================== */
+/* ========================================================================== */
+
+void mexFunction(
+    /* === Parameters ======================================================= */
+
+    int nlhs,             /* number of left-hand sides */
+    mxArray *plhs[],      /* left-hand side matrices */
+    int nrhs,             /* number of right--hand sides */
+    const mxArray *prhs[] /* right-hand side matrices */
+) {
+  DAMGlevelmat *PRE, *current;
+  DILUPACKparam *param;
+  mxArray *tmp, *M, *fout;
+  integer n, i, jstruct, k;
+  int levelsched, dense;
+  int *p, *q;
+  double *pr;
+  mwSize nnz_total = 0, nnz_offdiag = 0;
+
+  if (nrhs < 1 || nrhs > 2)
+    mexErrMsgTxt("One or two input arguments required.");
+  else if (nlhs > 3)
+    mexErrMsgTxt("Too many output arguments.");
+  else if (!mxIsStruct(prhs[0]))
+    mexErrMsgTxt("First input must be a structure.");
+
+  levelsched = nrhs > 1 && mxGetScalar(prhs[1]) != 0;
+
+  /* import pointers to the preconditioner and its parameters */
+  tmp = mxGetField(prhs[0], 0, "ptr");
+  if (tmp == NULL)
+    mexErrMsgTxt("Field PREC.ptr does not exist.");
+  memcpy(&PRE, mxGetData(tmp), (size_t)sizeof(size_t));
+  tmp = mxGetField(prhs[0], 0, "param");
+  if (tmp == NULL)
+    mexErrMsgTxt("Field PREC.param does not exist.");
+  memcpy(&param, mxGetData(tmp), (size_t)sizeof(size_t));
+
+  if (PRE->issingle)
+    mexErrMsgTxt("DGNLilupack2milu requires a double-precision PREC.");
+  if (!(param->flags & COARSE_REDUCE))
+    mexErrMsgTxt("DGNLilupack2milu requires the flag COARSE_REDUCE.");
+
+  M = mxCreateStructMatrix((mwSize)PRE->nlev, (mwSize)1,
+                           sizeof(milu_names) / sizeof(milu_names[0]),
+                           milu_names);
+  plhs[0] = M;
+
+  current = PRE;
+  for (jstruct = 0; jstruct < PRE->nlev; jstruct++) {
+    n = current->n;
+    dense = jstruct == PRE->nlev - 1 && current->LU.ja == NULL;
+
+    /* 1. row permutation p */
+    fout = int32_vector((mwSize)n);
+    p = (int *)mxGetData(fout);
+    for (i = 0; i < n; i++)
+      p[i] = (int)current->p[i];
+    mxSetField(M, jstruct, "p", fout);
+
+    /* 2. column permutation q, i.e., the inverse of invq. For a dense
+       coarsest level, the row interchanges of the dense LU factorization
+       stored in LU.ia are applied to invq instead. */
+    fout = int32_vector((mwSize)n);
+    q = (int *)mxGetData(fout);
+    if (dense) {
+      for (i = 0; i < n; i++)
+        q[i] = (int)current->invq[i];
+      for (i = 0; i < n; i++) {
+        k = current->LU.ia[i] - 1;
+        if (k != i) {
+          int t = q[i];
+          q[i] = q[k];
+          q[k] = t;
+        }
+      }
+    } else {
+      for (i = 0; i < n; i++)
+        q[current->invq[i] - 1] = (int)(i + 1);
+    }
+    mxSetField(M, jstruct, "q", fout);
+
+    /* 3. scaling vectors in the original and permuted orders */
+    fout = mxCreateDoubleMatrix((mwSize)n, (mwSize)1, mxREAL);
+    memcpy(mxGetPr(fout), current->rowscal, (size_t)n * sizeof(double));
+    mxSetField(M, jstruct, "rowscal", fout);
+
+    fout = mxCreateDoubleMatrix((mwSize)n, (mwSize)1, mxREAL);
+    memcpy(mxGetPr(fout), current->colscal, (size_t)n * sizeof(double));
+    mxSetField(M, jstruct, "colscal", fout);
+
+    fout = mxCreateDoubleMatrix((mwSize)n, (mwSize)1, mxREAL);
+    pr = mxGetPr(fout);
+    for (i = 0; i < n; i++)
+      pr[i] = current->rowscal[p[i] - 1];
+    mxSetField(M, jstruct, "prowscal", fout);
+
+    fout = mxCreateDoubleMatrix((mwSize)n, (mwSize)1, mxREAL);
+    pr = mxGetPr(fout);
+    for (i = 0; i < n; i++)
+      pr[i] = current->colscal[q[i] - 1];
+    mxSetField(M, jstruct, "qcolscal", fout);
+
+    /* 4. factors of the leading block */
+    if (dense)
+      nnz_total += convert_dense_lu(current, M, jstruct);
+    else
+      nnz_total += convert_sparse_lu(current, M, jstruct, levelsched);
+
+    /* 5. no 2-by-2 pivots in nonsymmetric matrices */
+    mxSetField(M, jstruct, "doff",
+               mxCreateDoubleMatrix((mwSize)0, (mwSize)1, mxREAL));
+
+    /* 6. coupling blocks, which are empty in the coarsest level */
+    if (jstruct < PRE->nlev - 1) {
+      mxSetField(M, jstruct, "negE", negate_coupling(&current->E));
+      mxSetField(M, jstruct, "negF", negate_coupling(&current->F));
+      nnz_offdiag += (mwSize)(current->E.ia[current->E.nr] - 1) +
+                     (mwSize)(current->F.ia[current->F.nr] - 1);
+    } else {
+      mxSetField(M, jstruct, "negE", empty_sparse(crs_names, 0, 0, 0));
+      mxSetField(M, jstruct, "negF", empty_sparse(crs_names, 0, 0, 0));
+    }
+
+    /* 7. level schedules are computed by MILUfactor */
+    mxSetField(M, jstruct, "Llev_ptr", int32_vector((mwSize)0));
+    mxSetField(M, jstruct, "Llev_ind", int32_vector((mwSize)0));
+    mxSetField(M, jstruct, "Ulev_ptr", int32_vector((mwSize)0));
+    mxSetField(M, jstruct, "Ulev_ind", int32_vector((mwSize)0));
+
+    current = current->next;
+  }
+
+  if (nlhs > 1) {
+    plhs[1] = mxCreateDoubleMatrix((mwSize)1, (mwSize)1, mxREAL);
+    *mxGetPr(plhs[1]) = (double)(nnz_total + nnz_offdiag);
+  }
+  if (nlhs > 2) {
+    plhs[2] = mxCreateDoubleMatrix((mwSize)1, (mwSize)1, mxREAL);
+    *mxGetPr(plhs[2]) = (double)nnz_offdiag;
+  }
+
+  return;
+}
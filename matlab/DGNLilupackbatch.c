@@ -0,0 +1,222 @@
+/* ========================================================================== */
+/* === DGNLilupackbatch mexFunction ========================================= */
+/* ========================================================================== */
+
+/*
+    Usage:
+
+    Factor and solve a batch of real nonsymmetric systems with ILUPACK in a
+    single call, such as the subdomain systems of a block-Jacobi method.
+    All the systems share one options structure, which is parsed only once,
+    and each preconditioner is released as soon as its system is solved.
+
+    Example:
+
+    % initialize the options from one of the matrices
+    options = DGNLilupackinit(As{1});
+
+    % solve As{k} * X{k} = Bs{k} for all k
+    [X, niter] = DGNLilupackbatch(As, Bs, options);
+
+    % solve the systems using up to nthreads threads, and return the error
+    % codes of ILUPACK instead of raising an error
+    [X, niter, info] = DGNLilupackbatch(As, Bs, options, nthreads);
+
+    As is a cell array of real square sparse matrices, and Bs is a cell
+    array of right-hand side vectors of matching sizes. X is a cell array
+    of the solutions, and niter contains the iteration counts. info(k) is
+    the error code of DGNLAMGfactor, or of DGNLAMGsolver if the
+    factorization succeeded; it is zero if As{k} was solved successfully.
+    If info is not requested, any nonzero code raises an error after all
+    the systems have been processed.
+
+    The options are those of DGNLilupackfactor and DGNLilupacksolver,
+    except that test vectors (options.tv) are not supported. The systems
+    are processed in parallel only if this file was compiled with OpenMP,
+    and nthreads should be set to 1 if the ILUPACK library in use is not
+    thread-safe.
+
+    Notice:
+
+        THIS MATERIAL IS PROVIDED AS IS, WITH ABSOLUTELY NO WARRANTY
+        EXPRESSED OR IMPLIED.  ANY USE IS AT YOUR OWN RISK.
+*/
+
+/* ========================================================================== */
+/* === Include files and prototypes ========================================= */
+/* ========================================================================== */
+
+#include "DGNLilupackparam.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* a system of the batch, with pointers into the MATLAB arrays */
+typedef struct {
+  integer n;
+  mwIndex *A_ia, *A_ja;
+  double *A_a, *b, *x;
+  integer niter, info;
+} batch_system;
+
+/* convert a MATLAB sparse matrix into a CRS matrix with 1-based indices */
+static void crs_from_ccs(const batch_system *sys, Dmat *A) {
+  integer i, j, k, n = sys->n;
+  mwSize nnz = sys->A_ia[n];
+
+  A->nr = A->nc = n;
+  A->ia = (integer *)malloc((size_t)(n + 1) * sizeof(integer));
+  A->ja = (integer *)malloc((size_t)(nnz > 0 ? nnz : 1) * sizeof(integer));
+  A->a = (double *)malloc((size_t)(nnz > 0 ? nnz : 1) * sizeof(double));
+
+  for (i = 0; i <= n; i++)
+    A->ia[i] = 0;
+  for (j = 0; j < (integer)nnz; j++)
+    A->ia[sys->A_ja[j] + 1]++;
+  for (i = 0; i < n; i++)
+    A->ia[i + 1] += A->ia[i];
+
+  for (j = 0; j < n; j++) {
+    for (k = (integer)sys->A_ia[j]; k < (integer)sys->A_ia[j + 1]; k++) {
+      i = (integer)sys->A_ja[k];
+      A->ja[A->ia[i]] = j + 1;
+      A->a[A->ia[i]++] = sys->A_a[k];
+    }
+  }
+  for (i = n; i > 0; i--)
+    A->ia[i] = A->ia[i - 1] + 1;
+  A->ia[0] = 1;
+}
+
+/* factor and solve one system, without calling the MATLAB API */
+static void solve_system(batch_system *sys, const DILUPACKparam *tmpl) {
+  Dmat A;
+  DAMGlevelmat PRE;
+  DILUPACKparam param;
+  double *rhs;
+
+  crs_from_ccs(sys, &A);
+  DGNLAMGinit(&A, &param);
+  DGNLilupackparam_copy(tmpl, &param);
+
+  sys->info = DGNLAMGfactor(&A, &PRE, &param);
+  if (sys->info == 0) {
+    /* the solver may overwrite its right-hand side */
+    rhs = (double *)malloc((size_t)(sys->n > 0 ? sys->n : 1) * sizeof(double));
+    memcpy(rhs, sys->b, (size_t)sys->n * sizeof(double));
+    memset(sys->x, 0, (size_t)sys->n * sizeof(double));
+
+    sys->info = DGNLAMGsolver(&A, &PRE, &param, rhs, sys->x);
+    sys->niter = param.ipar[26];
+    free(rhs);
+  }
+  DGNLAMGdelete(&A, &PRE, &param);
+
+  free(A.ia);
+  free(A.ja);
+  free(A.a);
+}
+
+/* ========================================================================== */
+/* === mexFunction ========================================================== */
+/* ========================================================================== */
+
+void mexFunction(
+    /* === Parameters ======================================================= */
+
+    int nlhs,             /* number of left-hand sides */
+    mxArray *plhs[],      /* left-hand side matrices */
+    int nrhs,             /* number of right--hand sides */
+    const mxArray *prhs[] /* right-hand side matrices */
+) {
+  Dmat A0;
+  DILUPACKparam tmpl;
+  batch_system *systems;
+  const mxArray *A_input, *b_input;
+  mxArray *x_output;
+  char *strings[PARAM_NSTRINGS];
+  int nstrings, nthreads = 1, failed = 0;
+  mwSize k, nsys;
+  double *pr;
+
+  if (nrhs < 3 || nrhs > 4)
+    mexErrMsgTxt("Three or four input arguments required.");
+  else if (nlhs > 3)
+    mexErrMsgTxt("Too many output arguments.");
+  else if (!mxIsCell(prhs[0]) || !mxIsCell(prhs[1]))
+    mexErrMsgTxt("First and second inputs must be cell arrays.");
+  else if (!mxIsStruct(prhs[2]))
+    mexErrMsgTxt("Third input must be a structure.");
+
+  nsys = mxGetNumberOfElements(prhs[0]);
+  if (mxGetNumberOfElements(prhs[1]) != nsys)
+    mexErrMsgTxt("The numbers of matrices and right-hand sides differ.");
+  if (nrhs > 3)
+    nthreads = (int)mxGetScalar(prhs[3]);
+  if (nthreads < 1)
+    nthreads = 1;
+
+  /* Extract the arrays of all the systems and create the solutions */
+  systems = (batch_system *)mxCalloc(nsys > 0 ? nsys : 1, sizeof(batch_system));
+  plhs[0] = mxCreateCellMatrix(nsys, (mwSize)1);
+  for (k = 0; k < nsys; k++) {
+    A_input = mxGetCell(prhs[0], k);
+    b_input = mxGetCell(prhs[1], k);
+    if (A_input == NULL || !mxIsSparse(A_input) || mxIsComplex(A_input) ||
+        mxGetM(A_input) != mxGetN(A_input))
+      mexErrMsgTxt("ILUPACK: each matrix must be real, square and sparse.");
+    if (b_input == NULL || !mxIsDouble(b_input) || mxIsComplex(b_input) ||
+        mxGetNumberOfElements(b_input) != mxGetM(A_input))
+      mexErrMsgTxt("Each right-hand side must be a real vector of the size "
+                   "of its matrix.");
+
+    systems[k].n = (integer)mxGetM(A_input);
+    systems[k].A_ia = mxGetJc(A_input);
+    systems[k].A_ja = mxGetIr(A_input);
+    systems[k].A_a = mxGetPr(A_input);
+    systems[k].b = mxGetPr(b_input);
+
+    x_output = mxCreateDoubleMatrix((mwSize)systems[k].n, (mwSize)1, mxREAL);
+    systems[k].x = mxGetPr(x_output);
+    mxSetCell(plhs[0], k, x_output);
+  }
+
+  /* Parse the options only once, into a template of the parameters */
+  A0.nr = A0.nc = nsys > 0 ? systems[0].n : 0;
+  A0.ia = A0.ja = NULL;
+  A0.a = NULL;
+  DGNLAMGinit(&A0, &tmpl);
+  DGNLilupackparam_parse(prhs[2], &tmpl, strings, &nstrings);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+#endif
+  for (k = 0; k < nsys; k++)
+    solve_system(&systems[k], &tmpl);
+
+  plhs[1] = mxCreateDoubleMatrix(nsys, (mwSize)1, mxREAL);
+  pr = mxGetPr(plhs[1]);
+  for (k = 0; k < nsys; k++)
+    pr[k] = systems[k].niter;
+
+  if (nlhs > 2) {
+    plhs[2] = mxCreateDoubleMatrix(nsys, (mwSize)1, mxREAL);
+    pr = mxGetPr(plhs[2]);
+    for (k = 0; k < nsys; k++)
+      pr[k] = systems[k].info;
+  } else {
+    for (k = 0; k < nsys; k++) {
+      if (systems[k].info) {
+        mexPrintf("ILUPACK returned error code %d for system %d.\n",
+                  (int)systems[k].info, (int)k + 1);
+        failed = 1;
+      }
+    }
+  }
+
+  DGNLilupackparam_free(strings, &nstrings);
+  mxFree(systems);
+
+  if (failed)
+    mexErrMsgTxt("ILUPACK failed for some systems of the batch.");
+}
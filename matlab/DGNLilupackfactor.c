@@ -13,6 +13,14 @@
     % for initializing parameters
     [PREC, options] = DGNLilupackfactor(A,options);
 
+    % use the options handle created by DGNLilupackparam
+    [PREC, handle] = DGNLilupackfactor(A,handle);
+
+    % export only the pointers and the permutations and scalings, but not
+    % L, D, U, E, F and A_H, for callers such as DGNLilupack2milu that read
+    % the factors through PREC(1).ptr
+    [PREC, options] = DGNLilupackfactor(A,options,1);
+
 
 
     Authors:
@@ -52,6 +60,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "DGNLilupackparam.h"
+
 #define MAX_FIELDS 100
 
 /* ========================================================================== */
@@ -70,8 +80,9 @@ void mexFunction(
   DAMGlevelmat *PRE, *current;
   SAMGlevelmat *SPRE, *scurrent;
   DILUPACKparam *param;
+  int ishandle;
   integer n, nnzU;
-  int tv_exists, tv_field;
+  int tv_exists, tv_field, ptronly;
 
   const char **fnames;
   const char *pnames[] = {
@@ -96,15 +107,17 @@ void mexFunction(
   mwIndex *A_ja, /* row indices of input matrix A */
       *A_ia;     /* column pointers of input matrix A */
 
-  if (nrhs != 2)
-    mexErrMsgTxt("Two input arguments required.");
+  if (nrhs < 2 || nrhs > 3)
+    mexErrMsgTxt("Two or three input arguments required.");
   else if (nlhs != 2)
     mexErrMsgTxt("Too many output arguments.");
-  else if (!mxIsStruct(prhs[1]))
-    mexErrMsgTxt("Second input must be a structure.");
+  else if (!mxIsStruct(prhs[1]) && !DGNLilupackparam_valid(prhs[1]))
+    mexErrMsgTxt("Second input must be a structure or an options handle.");
   else if (!mxIsNumeric(prhs[0]))
     mexErrMsgTxt("First input must be a matrix.");
 
+  ptronly = nrhs > 2 && mxGetScalar(prhs[2]) != 0;
+
   /* The first input must be a square matrix.*/
   A_input = (mxArray *)prhs[0];
   /* get size of input matrix A */
@@ -190,7 +203,13 @@ void mexFunction(
 
   /* Get second input arguments */
   options_input = (mxArray *)prhs[1];
-  nfields = mxGetNumberOfFields(options_input);
+  ishandle = DGNLilupackparam_valid(options_input);
+  if (ishandle) {
+    /* the options were parsed by DGNLilupackparam */
+    DGNLilupackparam_load(options_input, param);
+    nfields = 0;
+  } else
+    nfields = mxGetNumberOfFields(options_input);
 
   /* Allocate memory  for storing classIDflags */
   classIDflags =
@@ -334,7 +353,7 @@ void mexFunction(
       }
     }
   }
-  if (param->droptolS > 0.125 * param->droptol) {
+  if (!ishandle && param->droptolS > 0.125 * param->droptol) {
     mexPrintf("!!! ILUPACK Warning !!!\n");
     mexPrintf("`param.droptolS' is recommended to be one order of magnitude "
               "less than `param.droptol'\n");
@@ -400,7 +419,10 @@ void mexFunction(
 
   /* read a struct matrices for output */
   nlhs = 2;
-  plhs[1] = mxCreateStructMatrix((mwSize)1, (mwSize)1, nfields, fnames);
+  if (ishandle)
+    plhs[1] = mxDuplicateArray(options_input);
+  else
+    plhs[1] = mxCreateStructMatrix((mwSize)1, (mwSize)1, nfields, fnames);
   if (plhs[1] == NULL)
     mexErrMsgTxt("Could not create structure mxArray");
   options_output = plhs[1];
@@ -587,570 +609,581 @@ void mexFunction(
     /* set each field in output structure */
     mxSetFieldByNumber(PRE_output, jstruct, ifield, fout);
 
-    /* 3. field `L' */
-    ++ifield;
-    /* switched to full-matrix processing */
-    if (jstruct == PRE->nlev - 1 &&
-        ((PRE->issingle) ? scurrent->LU.ja : current->LU.ja) == NULL) {
-
-      if (PRE->issingle) {
-        fout = mxCreateDoubleMatrix((mwSize)scurrent->nB, (mwSize)scurrent->nB,
-                                    mxREAL);
-        spr = scurrent->LU.a;
-      } else {
-        fout = mxCreateDoubleMatrix((mwSize)current->nB, (mwSize)current->nB,
-                                    mxREAL);
-        pr = current->LU.a;
-      }
-      sr = mxGetPr(fout);
-
-      for (i = 0; i < ((PRE->issingle) ? scurrent->nB : current->nB); i++) {
-        /* init strict upper triangular part with zeros */
-        for (j = 0; j < i; j++) {
-          *sr++ = 0;
-        }
-        /* diagonal entry set to 1.0 */
-        *sr++ = 1.0;
-
-        /* extract diagonal entry from LU decomposition */
-        m = i * ((PRE->issingle) ? scurrent->nB : current->nB) + i;
-        dbuf = (PRE->issingle) ? (double)spr[m] : pr[m];
-
-        /* extract strict lower triangular part */
-        for (j = i + 1; j < ((PRE->issingle) ? scurrent->nB : current->nB);
-             j++) {
-          m = j * ((PRE->issingle) ? scurrent->nB : current->nB) + i;
-          if (PRE->issingle)
-            *sr++ = (double)spr[m] / dbuf;
-          else
-            *sr++ = pr[m] / dbuf;
-        } /* end for j */
-      }   /* end for i */
-
-      /* set each field in output structure */
-      mxSetFieldByNumber(PRE_output, jstruct, ifield, fout);
+    if (ptronly) {
+      /* 3.-7. fields `L', `D', `U', `E' and `F' are left empty */
+      ifield += 5;
     } else {
-      /* mexPrintf("before=%d\n",
-       * (PRE->issingle)?scurrent->LU.ja[scurrent->nB]:current->LU.ja[current->nB]);
-       * fflush(stdout); */
+      /* 3. field `L' */
+      ++ifield;
+      /* switched to full-matrix processing */
+      if (jstruct == PRE->nlev - 1 &&
+          ((PRE->issingle) ? scurrent->LU.ja : current->LU.ja) == NULL) {
 
-      if (PRE->issingle) {
-        nnzU = scurrent->LU.ja[scurrent->nB];
-        scurrent->LU.ja[scurrent->nB] = scurrent->LU.nnz + 1;
-      } else {
-        nnzU = current->LU.ja[current->nB];
-        current->LU.ja[current->nB] = current->LU.nnz + 1;
-      }
+        if (PRE->issingle) {
+          fout = mxCreateDoubleMatrix((mwSize)scurrent->nB,
+                                      (mwSize)scurrent->nB, mxREAL);
+          spr = scurrent->LU.a;
+        } else {
+          fout = mxCreateDoubleMatrix((mwSize)current->nB, (mwSize)current->nB,
+                                      mxREAL);
+          pr = current->LU.a;
+        }
+        sr = mxGetPr(fout);
 
-      /* mexPrintf("intermediate=%d\n",
-       * (PRE->issingle)?scurrent->LU.ja[scurrent->nB]:current->LU.ja[current->nB]);
-       * fflush(stdout); */
+        for (i = 0; i < ((PRE->issingle) ? scurrent->nB : current->nB); i++) {
+          /* init strict upper triangular part with zeros */
+          for (j = 0; j < i; j++) {
+            *sr++ = 0;
+          }
+          /* diagonal entry set to 1.0 */
+          *sr++ = 1.0;
 
-      if (PRE->issingle) {
-        nnz = scurrent->nB;
-        for (i = 0; i < scurrent->nB; i++)
-          nnz += scurrent->LU.ia[i] - scurrent->LU.ja[i];
-      } else {
-        nnz = current->nB;
-        for (i = 0; i < current->nB; i++)
-          nnz += current->LU.ia[i] - current->LU.ja[i];
-      }
+          /* extract diagonal entry from LU decomposition */
+          m = i * ((PRE->issingle) ? scurrent->nB : current->nB) + i;
+          dbuf = (PRE->issingle) ? (double)spr[m] : pr[m];
 
-      if (param->flags & COARSE_REDUCE) {
-        if (PRE->issingle)
-          fout = mxCreateSparse((mwSize)scurrent->nB, (mwSize)scurrent->nB, nnz,
-                                mxREAL);
-        else
-          fout = mxCreateSparse((mwSize)current->nB, (mwSize)current->nB, nnz,
-                                mxREAL);
+          /* extract strict lower triangular part */
+          for (j = i + 1; j < ((PRE->issingle) ? scurrent->nB : current->nB);
+               j++) {
+            m = j * ((PRE->issingle) ? scurrent->nB : current->nB) + i;
+            if (PRE->issingle)
+              *sr++ = (double)spr[m] / dbuf;
+            else
+              *sr++ = pr[m] / dbuf;
+          } /* end for j */
+        }   /* end for i */
+
+        /* set each field in output structure */
+        mxSetFieldByNumber(PRE_output, jstruct, ifield, fout);
       } else {
-        if (PRE->issingle)
-          fout = mxCreateSparse((mwSize)scurrent->n, (mwSize)scurrent->nB, nnz,
-                                mxREAL);
-        else
-          fout = mxCreateSparse((mwSize)current->n, (mwSize)current->nB, nnz,
-                                mxREAL);
-      }
-      /* mexPrintf("number of space requested=%d\n", nnz); fflush(stdout); */
+        /* mexPrintf("before=%d\n",
+         * (PRE->issingle)?scurrent->LU.ja[scurrent->nB]:current->LU.ja[current->nB]);
+         * fflush(stdout); */
 
-      sr = (double *)mxGetPr(fout);
-      irs = (mwIndex *)mxGetIr(fout);
-      jcs = (mwIndex *)mxGetJc(fout);
+        if (PRE->issingle) {
+          nnzU = scurrent->LU.ja[scurrent->nB];
+          scurrent->LU.ja[scurrent->nB] = scurrent->LU.nnz + 1;
+        } else {
+          nnzU = current->LU.ja[current->nB];
+          current->LU.ja[current->nB] = current->LU.nnz + 1;
+        }
 
-      k = 0;
-      cnt = 0;
-      if (PRE->issingle) {
-        for (i = 0; i < scurrent->nB; i++) {
-          /* extract diagonal entry */
-          jcs[i] = k;
-          irs[k] = i;
-          sr[k++] = 1.0 / scurrent->LU.a[i];
-          cnt++;
+        /* mexPrintf("intermediate=%d\n",
+         * (PRE->issingle)?scurrent->LU.ja[scurrent->nB]:current->LU.ja[current->nB]);
+         * fflush(stdout); */
 
-          j = scurrent->LU.ja[i] - 1;
-          jj = scurrent->LU.ia[i] - scurrent->LU.ja[i];
-          Sqsort(scurrent->LU.a + j, scurrent->LU.ja + j, istack, &jj);
+        if (PRE->issingle) {
+          nnz = scurrent->nB;
+          for (i = 0; i < scurrent->nB; i++)
+            nnz += scurrent->LU.ia[i] - scurrent->LU.ja[i];
+        } else {
+          nnz = current->nB;
+          for (i = 0; i < current->nB; i++)
+            nnz += current->LU.ia[i] - current->LU.ja[i];
+        }
 
-          /* extract strict lower triangular part */
-          for (j = scurrent->LU.ja[i] - 1; j < scurrent->LU.ia[i] - 1; j++) {
-            irs[k] = scurrent->LU.ja[j] - 1;
-            sr[k++] = scurrent->LU.a[j];
-            cnt++;
-          }
+        if (param->flags & COARSE_REDUCE) {
+          if (PRE->issingle)
+            fout = mxCreateSparse((mwSize)scurrent->nB, (mwSize)scurrent->nB,
+                                  nnz, mxREAL);
+          else
+            fout = mxCreateSparse((mwSize)current->nB, (mwSize)current->nB, nnz,
+                                  mxREAL);
+        } else {
+          if (PRE->issingle)
+            fout = mxCreateSparse((mwSize)scurrent->n, (mwSize)scurrent->nB,
+                                  nnz, mxREAL);
+          else
+            fout = mxCreateSparse((mwSize)current->n, (mwSize)current->nB, nnz,
+                                  mxREAL);
         }
-      } else { /* !PRE->issingle */
-        for (i = 0; i < current->nB; i++) {
-          /* extract diagonal entry */
-          jcs[i] = k;
-          irs[k] = i;
-          sr[k++] = 1.0 / current->LU.a[i];
-          cnt++;
+        /* mexPrintf("number of space requested=%d\n", nnz); fflush(stdout); */
 
-          j = current->LU.ja[i] - 1;
-          jj = current->LU.ia[i] - current->LU.ja[i];
-          Dqsort(current->LU.a + j, current->LU.ja + j, istack, &jj);
+        sr = (double *)mxGetPr(fout);
+        irs = (mwIndex *)mxGetIr(fout);
+        jcs = (mwIndex *)mxGetJc(fout);
 
-          /* extract strict lower triangular part */
-          for (j = current->LU.ja[i] - 1; j < current->LU.ia[i] - 1; j++) {
-            irs[k] = current->LU.ja[j] - 1;
-            sr[k++] = current->LU.a[j];
+        k = 0;
+        cnt = 0;
+        if (PRE->issingle) {
+          for (i = 0; i < scurrent->nB; i++) {
+            /* extract diagonal entry */
+            jcs[i] = k;
+            irs[k] = i;
+            sr[k++] = 1.0 / scurrent->LU.a[i];
             cnt++;
-          }
-        }
-      } /* end if-else PRE->issingle */
-      jcs[i] = k;
-
-      if (PRE->issingle)
-        scurrent->LU.ja[scurrent->nB] = nnzU;
-      else
-        current->LU.ja[current->nB] = nnzU;
 
-      /* mexPrintf("number of spaces used=%d\n", cnt); fflush(stdout); */
-      /* mexPrintf("after=%d\n",
-       * (PRE->issingle)?scurrent->LU.ja[scurrent->nB]:current->LU.ja[current->nB]);
-       * fflush(stdout); */
+            j = scurrent->LU.ja[i] - 1;
+            jj = scurrent->LU.ia[i] - scurrent->LU.ja[i];
+            Sqsort(scurrent->LU.a + j, scurrent->LU.ja + j, istack, &jj);
 
-      /* set each field in output structure */
-      mxSetFieldByNumber(PRE_output, jstruct, ifield, fout);
-    }
+            /* extract strict lower triangular part */
+            for (j = scurrent->LU.ja[i] - 1; j < scurrent->LU.ia[i] - 1; j++) {
+              irs[k] = scurrent->LU.ja[j] - 1;
+              sr[k++] = scurrent->LU.a[j];
+              cnt++;
+            }
+          }
+        } else { /* !PRE->issingle */
+          for (i = 0; i < current->nB; i++) {
+            /* extract diagonal entry */
+            jcs[i] = k;
+            irs[k] = i;
+            sr[k++] = 1.0 / current->LU.a[i];
+            cnt++;
 
-    /* 4. field `D' */
-    ++ifield;
-    /* mexPrintf("4. field `D'\n"); fflush(stdout); */
-    if (PRE->issingle) {
-      fout = mxCreateSparse((mwSize)scurrent->nB, (mwSize)scurrent->nB,
-                            (mwSize)scurrent->nB, mxREAL);
-      spr = scurrent->LU.a;
-    } else {
-      fout = mxCreateSparse((mwSize)current->nB, (mwSize)current->nB,
-                            (mwSize)current->nB, mxREAL);
-      pr = current->LU.a;
-    }
-    sr = (double *)mxGetPr(fout);
-    irs = (mwIndex *)mxGetIr(fout);
-    jcs = (mwIndex *)mxGetJc(fout);
+            j = current->LU.ja[i] - 1;
+            jj = current->LU.ia[i] - current->LU.ja[i];
+            Dqsort(current->LU.a + j, current->LU.ja + j, istack, &jj);
 
-    for (i = 0; i < ((PRE->issingle) ? scurrent->nB : current->nB); i++) {
-      jcs[i] = i;
-      irs[i] = i;
-    }
-    jcs[i] = i;
+            /* extract strict lower triangular part */
+            for (j = current->LU.ja[i] - 1; j < current->LU.ia[i] - 1; j++) {
+              irs[k] = current->LU.ja[j] - 1;
+              sr[k++] = current->LU.a[j];
+              cnt++;
+            }
+          }
+        } /* end if-else PRE->issingle */
+        jcs[i] = k;
 
-    /* switched to full-matrix processing */
-    if (jstruct == PRE->nlev - 1 &&
-        ((PRE->issingle) ? scurrent->LU.ja : current->LU.ja) == NULL) {
+        if (PRE->issingle)
+          scurrent->LU.ja[scurrent->nB] = nnzU;
+        else
+          current->LU.ja[current->nB] = nnzU;
 
-      for (i = 0; i < ((PRE->issingle) ? scurrent->nB : current->nB); i++) {
-        /* diagonal entry U(i,i) */
-        m = i * ((PRE->issingle) ? scurrent->nB : current->nB) + i;
-        dbuf = (PRE->issingle) ? (double)spr[m] : pr[m];
-        sr[i] = dbuf;
-      } /* end for i */
+        /* mexPrintf("number of spaces used=%d\n", cnt); fflush(stdout); */
+        /* mexPrintf("after=%d\n",
+         * (PRE->issingle)?scurrent->LU.ja[scurrent->nB]:current->LU.ja[current->nB]);
+         * fflush(stdout); */
 
-    } else {
-      if (PRE->issingle) {
-        for (i = 0; i < scurrent->nB; i++)
-          sr[i] = 1.0 / spr[i];
-      } else {
-        for (i = 0; i < current->nB; i++)
-          sr[i] = 1.0 / pr[i];
+        /* set each field in output structure */
+        mxSetFieldByNumber(PRE_output, jstruct, ifield, fout);
       }
-    }
-    /* set each field in output structure */
-    mxSetFieldByNumber(PRE_output, jstruct, ifield, fout);
-
-    /* 5. field `U' */
-    ++ifield;
-    /* mexPrintf("5. field `U'\n"); fflush(stdout); */
-    /* switched to full-matrix processing */
-    if (jstruct == PRE->nlev - 1 &&
-        ((PRE->issingle) ? scurrent->LU.ja : current->LU.ja) == NULL) {
 
+      /* 4. field `D' */
+      ++ifield;
+      /* mexPrintf("4. field `D'\n"); fflush(stdout); */
       if (PRE->issingle) {
-        fout = mxCreateDoubleMatrix((mwSize)scurrent->nB, (mwSize)scurrent->nB,
-                                    mxREAL);
+        fout = mxCreateSparse((mwSize)scurrent->nB, (mwSize)scurrent->nB,
+                              (mwSize)scurrent->nB, mxREAL);
         spr = scurrent->LU.a;
       } else {
-        fout = mxCreateDoubleMatrix((mwSize)current->nB, (mwSize)current->nB,
-                                    mxREAL);
+        fout = mxCreateSparse((mwSize)current->nB, (mwSize)current->nB,
+                              (mwSize)current->nB, mxREAL);
         pr = current->LU.a;
       }
-      sr = mxGetPr(fout);
+      sr = (double *)mxGetPr(fout);
+      irs = (mwIndex *)mxGetIr(fout);
+      jcs = (mwIndex *)mxGetJc(fout);
 
       for (i = 0; i < ((PRE->issingle) ? scurrent->nB : current->nB); i++) {
-        /* extract strict upper triangular part */
-        for (j = 0; j < i; j++) {
-          /* U(j,i) */
-          m = j * ((PRE->issingle) ? scurrent->nB : current->nB) + i;
-          if (PRE->issingle)
-            *sr++ = (double)spr[m];
-          else
-            *sr++ = pr[m];
-        } /* end for j */
-
-        /* diagonal entry */
-        *sr++ = 1.0;
-
-        /* init strict lower triangular part with zeros */
-        for (j = i + 1; j < ((PRE->issingle) ? scurrent->nB : current->nB);
-             j++) {
-          *sr++ = 0;
-        }
-      } /* end for i */
+        jcs[i] = i;
+        irs[i] = i;
+      }
+      jcs[i] = i;
 
-      /* set each field in output structure */
-      mxSetFieldByNumber(PRE_output, jstruct, ifield, fout);
-    } else {
-      /* fill-in upper triangular part */
-      /* mexPrintf("before=%d\n",
-       * (PRE->issingle)?scurrent->LU.ja[scurrent->nB]:current->LU.ja[current->nB]);
-       * fflush(stdout); */
-      if (PRE->issingle) {
-        nnzU = scurrent->LU.ja[scurrent->nB];
-        scurrent->LU.ja[scurrent->nB] = scurrent->LU.nnz + 1;
+      /* switched to full-matrix processing */
+      if (jstruct == PRE->nlev - 1 &&
+          ((PRE->issingle) ? scurrent->LU.ja : current->LU.ja) == NULL) {
 
-        nnz = scurrent->nB;
-        for (i = 0; i < scurrent->nB; i++)
-          nnz += scurrent->LU.ja[i + 1] - scurrent->LU.ia[i];
+        for (i = 0; i < ((PRE->issingle) ? scurrent->nB : current->nB); i++) {
+          /* diagonal entry U(i,i) */
+          m = i * ((PRE->issingle) ? scurrent->nB : current->nB) + i;
+          dbuf = (PRE->issingle) ? (double)spr[m] : pr[m];
+          sr[i] = dbuf;
+        } /* end for i */
 
-        if (param->flags & COARSE_REDUCE) {
-          fout = mxCreateSparse((mwSize)scurrent->nB, (mwSize)scurrent->nB, nnz,
-                                mxREAL);
+      } else {
+        if (PRE->issingle) {
+          for (i = 0; i < scurrent->nB; i++)
+            sr[i] = 1.0 / spr[i];
         } else {
-          fout = mxCreateSparse((mwSize)scurrent->nB, (mwSize)scurrent->n, nnz,
-                                mxREAL);
+          for (i = 0; i < current->nB; i++)
+            sr[i] = 1.0 / pr[i];
         }
-      } else { /* !PRE->issingle */
-        nnzU = current->LU.ja[current->nB];
-        current->LU.ja[current->nB] = current->LU.nnz + 1;
+      }
+      /* set each field in output structure */
+      mxSetFieldByNumber(PRE_output, jstruct, ifield, fout);
 
-        nnz = current->nB;
-        for (i = 0; i < current->nB; i++)
-          nnz += current->LU.ja[i + 1] - current->LU.ia[i];
+      /* 5. field `U' */
+      ++ifield;
+      /* mexPrintf("5. field `U'\n"); fflush(stdout); */
+      /* switched to full-matrix processing */
+      if (jstruct == PRE->nlev - 1 &&
+          ((PRE->issingle) ? scurrent->LU.ja : current->LU.ja) == NULL) {
 
-        if (param->flags & COARSE_REDUCE) {
-          fout = mxCreateSparse((mwSize)current->nB, (mwSize)current->nB, nnz,
-                                mxREAL);
+        if (PRE->issingle) {
+          fout = mxCreateDoubleMatrix((mwSize)scurrent->nB,
+                                      (mwSize)scurrent->nB, mxREAL);
+          spr = scurrent->LU.a;
         } else {
-          fout = mxCreateSparse((mwSize)current->nB, (mwSize)current->n, nnz,
-                                mxREAL);
+          fout = mxCreateDoubleMatrix((mwSize)current->nB, (mwSize)current->nB,
+                                      mxREAL);
+          pr = current->LU.a;
         }
-      } /* end if-else PRE->issingle */
-
-      /* mexPrintf("intermediate=%d\n",
-       * (PRE->issingle)?scurrent->LU.ja[scurrent->nB]:current->LU.ja[current->nB]);
-       * fflush(stdout); */
-      /* mexPrintf("number of spaces requested: %d\n",nnz);fflush(stdout); */
-
-      sr = (double *)mxGetPr(fout);
-      irs = (mwIndex *)mxGetIr(fout);
-      jcs = (mwIndex *)mxGetJc(fout);
-
-      /* each column does have a diagonal entry, shifted by one space */
-      jcs[0] = 0;
-      for (i = 1; i <= ((PRE->issingle) ? scurrent->nB : current->nB); i++)
-        jcs[i] = 1;
-
-      /* number of entries per column, shifted by one space */
-      cnt = 0;
-      if (PRE->issingle) {
-        for (i = 0; i < scurrent->nB; i++) {
-
-          j = scurrent->LU.ia[i] - 1;
-          jj = scurrent->LU.ja[i + 1] - scurrent->LU.ia[i];
-          Sqsort(scurrent->LU.a + j, scurrent->LU.ja + j, istack, &jj);
-
-          for (j = scurrent->LU.ia[i] - 1; j < scurrent->LU.ja[i + 1] - 1;
+        sr = mxGetPr(fout);
+
+        for (i = 0; i < ((PRE->issingle) ? scurrent->nB : current->nB); i++) {
+          /* extract strict upper triangular part */
+          for (j = 0; j < i; j++) {
+            /* U(j,i) */
+            m = j * ((PRE->issingle) ? scurrent->nB : current->nB) + i;
+            if (PRE->issingle)
+              *sr++ = (double)spr[m];
+            else
+              *sr++ = pr[m];
+          } /* end for j */
+
+          /* diagonal entry */
+          *sr++ = 1.0;
+
+          /* init strict lower triangular part with zeros */
+          for (j = i + 1; j < ((PRE->issingle) ? scurrent->nB : current->nB);
                j++) {
-            k = scurrent->LU.ja[j];
-            jcs[k]++;
-          }
-        }
-      } else { /* !PRE->issingle */
-        for (i = 0; i < current->nB; i++) {
-
-          j = current->LU.ia[i] - 1;
-          jj = current->LU.ja[i + 1] - current->LU.ia[i];
-          Dqsort(current->LU.a + j, current->LU.ja + j, istack, &jj);
-
-          for (j = current->LU.ia[i] - 1; j < current->LU.ja[i + 1] - 1; j++) {
-            k = current->LU.ja[j];
-            jcs[k]++;
+            *sr++ = 0;
           }
-        }
-      }
+        } /* end for i */
 
-      /* switch to pointer structure */
-      if (param->flags & COARSE_REDUCE) {
-        for (i = 0; i < ((PRE->issingle) ? scurrent->nB : current->nB); i++)
-          jcs[i + 1] += jcs[i];
+        /* set each field in output structure */
+        mxSetFieldByNumber(PRE_output, jstruct, ifield, fout);
       } else {
-        for (i = 0; i < ((PRE->issingle) ? scurrent->n : current->n); i++)
-          jcs[i + 1] += jcs[i];
-      }
-
-      for (i = 0; i < ((PRE->issingle) ? scurrent->nB : current->nB); i++) {
-        /* extract diagonal entry */
-        k = jcs[i];
-        irs[k] = i;
-        sr[k++] =
-            1.0 / ((PRE->issingle) ? scurrent->LU.a[i] : current->LU.a[i]);
-        jcs[i] = k;
-        cnt++;
-
-        /* extract upper triangular part */
+        /* fill-in upper triangular part */
+        /* mexPrintf("before=%d\n",
+         * (PRE->issingle)?scurrent->LU.ja[scurrent->nB]:current->LU.ja[current->nB]);
+         * fflush(stdout); */
         if (PRE->issingle) {
-          for (j = scurrent->LU.ia[i] - 1; j < scurrent->LU.ja[i + 1] - 1;
-               j++) {
-            l = scurrent->LU.ja[j] - 1;
-            k = jcs[l];
-            irs[k] = i;
-            sr[k++] = scurrent->LU.a[j];
-            jcs[l] = k;
-            cnt++;
+          nnzU = scurrent->LU.ja[scurrent->nB];
+          scurrent->LU.ja[scurrent->nB] = scurrent->LU.nnz + 1;
+
+          nnz = scurrent->nB;
+          for (i = 0; i < scurrent->nB; i++)
+            nnz += scurrent->LU.ja[i + 1] - scurrent->LU.ia[i];
+
+          if (param->flags & COARSE_REDUCE) {
+            fout = mxCreateSparse((mwSize)scurrent->nB, (mwSize)scurrent->nB,
+                                  nnz, mxREAL);
+          } else {
+            fout = mxCreateSparse((mwSize)scurrent->nB, (mwSize)scurrent->n,
+                                  nnz, mxREAL);
           }
         } else { /* !PRE->issingle */
-          for (j = current->LU.ia[i] - 1; j < current->LU.ja[i + 1] - 1; j++) {
-            l = current->LU.ja[j] - 1;
-            k = jcs[l];
-            irs[k] = i;
-            sr[k++] = current->LU.a[j];
-            jcs[l] = k;
-            cnt++;
+          nnzU = current->LU.ja[current->nB];
+          current->LU.ja[current->nB] = current->LU.nnz + 1;
+
+          nnz = current->nB;
+          for (i = 0; i < current->nB; i++)
+            nnz += current->LU.ja[i + 1] - current->LU.ia[i];
+
+          if (param->flags & COARSE_REDUCE) {
+            fout = mxCreateSparse((mwSize)current->nB, (mwSize)current->nB, nnz,
+                                  mxREAL);
+          } else {
+            fout = mxCreateSparse((mwSize)current->nB, (mwSize)current->n, nnz,
+                                  mxREAL);
           }
         } /* end if-else PRE->issingle */
-      }
-      /* shift pointers by one to the right */
-      if (param->flags & COARSE_REDUCE) {
-        for (i = ((PRE->issingle) ? scurrent->nB : current->nB); i > 0; i--)
-          jcs[i] = jcs[i - 1];
-      } else {
-        for (i = ((PRE->issingle) ? scurrent->n : current->n); i > 0; i--)
-          jcs[i] = jcs[i - 1];
-      }
-      jcs[0] = 0;
 
-      if (PRE->issingle)
-        scurrent->LU.ja[scurrent->nB] = nnzU;
-      else
-        current->LU.ja[current->nB] = nnzU;
-
-      /* mexPrintf("number of spaces used: %d\n",cnt);fflush(stdout); */
-      /* mexPrintf("after=%d\n",
-       * (PRE->issingle)?scurrent->LU.ja[scurrent->nB]:current->LU.ja[current->nB]);
-       * fflush(stdout); */
-
-      /* set each field in output structure */
-      mxSetFieldByNumber(PRE_output, jstruct, ifield, fout);
-    }
-
-    /* 6. field `E' */
-    ++ifield;
-    /* mexPrintf("6. field `E'\n"); fflush(stdout); */
-    if (jstruct < PRE->nlev - 1) {
-
-      if (param->flags & COARSE_REDUCE) {
-        if (PRE->issingle) {
-          nnz = scurrent->E.ia[scurrent->E.nr] - 1;
-          fout = mxCreateSparse((mwSize)scurrent->E.nr, (mwSize)scurrent->E.nc,
-                                nnz, mxREAL);
-        } else {
-          nnz = current->E.ia[current->E.nr] - 1;
-          fout = mxCreateSparse((mwSize)current->E.nr, (mwSize)current->E.nc,
-                                nnz, mxREAL);
-        }
+        /* mexPrintf("intermediate=%d\n",
+         * (PRE->issingle)?scurrent->LU.ja[scurrent->nB]:current->LU.ja[current->nB]);
+         * fflush(stdout); */
+        /* mexPrintf("number of spaces requested: %d\n",nnz);fflush(stdout); */
 
         sr = (double *)mxGetPr(fout);
         irs = (mwIndex *)mxGetIr(fout);
         jcs = (mwIndex *)mxGetJc(fout);
 
+        /* each column does have a diagonal entry, shifted by one space */
+        jcs[0] = 0;
+        for (i = 1; i <= ((PRE->issingle) ? scurrent->nB : current->nB); i++)
+          jcs[i] = 1;
+
+        /* number of entries per column, shifted by one space */
+        cnt = 0;
         if (PRE->issingle) {
-          for (i = 0; i <= scurrent->E.nc; i++)
-            jcs[i] = 0;
-          /* number of entries per column, shifted by one space */
-          for (i = 0; i < scurrent->E.nr; i++) {
+          for (i = 0; i < scurrent->nB; i++) {
 
-            j = scurrent->E.ia[i] - 1;
-            jj = scurrent->E.ia[i + 1] - scurrent->E.ia[i];
-            Sqsort(scurrent->E.a + j, scurrent->E.ja + j, istack, &jj);
+            j = scurrent->LU.ia[i] - 1;
+            jj = scurrent->LU.ja[i + 1] - scurrent->LU.ia[i];
+            Sqsort(scurrent->LU.a + j, scurrent->LU.ja + j, istack, &jj);
 
-            for (j = scurrent->E.ia[i] - 1; j < scurrent->E.ia[i + 1] - 1;
+            for (j = scurrent->LU.ia[i] - 1; j < scurrent->LU.ja[i + 1] - 1;
                  j++) {
-              k = scurrent->E.ja[j];
+              k = scurrent->LU.ja[j];
               jcs[k]++;
             }
           }
-          /* switch to pointer structure */
-          for (i = 0; i < scurrent->E.nc; i++)
-            jcs[i + 1] += jcs[i];
-
-          for (i = 0; i < scurrent->E.nr; i++) {
-            for (j = scurrent->E.ia[i] - 1; j < scurrent->E.ia[i + 1] - 1;
-                 j++) {
-              l = scurrent->E.ja[j] - 1;
-              k = jcs[l];
-              irs[k] = i;
-              sr[k++] = scurrent->E.a[j];
-              jcs[l] = k;
-            }
-          }
-          /* shift pointers by one to the right */
-          for (i = scurrent->E.nc; i > 0; i--)
-            jcs[i] = jcs[i - 1];
-          jcs[0] = 0;
         } else { /* !PRE->issingle */
-          for (i = 0; i <= current->E.nc; i++)
-            jcs[i] = 0;
-          /* number of entries per column, shifted by one space */
-          for (i = 0; i < current->E.nr; i++) {
+          for (i = 0; i < current->nB; i++) {
 
-            j = current->E.ia[i] - 1;
-            jj = current->E.ia[i + 1] - current->E.ia[i];
-            Dqsort(current->E.a + j, current->E.ja + j, istack, &jj);
+            j = current->LU.ia[i] - 1;
+            jj = current->LU.ja[i + 1] - current->LU.ia[i];
+            Dqsort(current->LU.a + j, current->LU.ja + j, istack, &jj);
 
-            for (j = current->E.ia[i] - 1; j < current->E.ia[i + 1] - 1; j++) {
-              k = current->E.ja[j];
+            for (j = current->LU.ia[i] - 1; j < current->LU.ja[i + 1] - 1;
+                 j++) {
+              k = current->LU.ja[j];
               jcs[k]++;
             }
           }
-          /* switch to pointer structure */
-          for (i = 0; i < current->E.nc; i++)
+        }
+
+        /* switch to pointer structure */
+        if (param->flags & COARSE_REDUCE) {
+          for (i = 0; i < ((PRE->issingle) ? scurrent->nB : current->nB); i++)
+            jcs[i + 1] += jcs[i];
+        } else {
+          for (i = 0; i < ((PRE->issingle) ? scurrent->n : current->n); i++)
             jcs[i + 1] += jcs[i];
+        }
+
+        for (i = 0; i < ((PRE->issingle) ? scurrent->nB : current->nB); i++) {
+          /* extract diagonal entry */
+          k = jcs[i];
+          irs[k] = i;
+          sr[k++] =
+              1.0 / ((PRE->issingle) ? scurrent->LU.a[i] : current->LU.a[i]);
+          jcs[i] = k;
+          cnt++;
 
-          for (i = 0; i < current->E.nr; i++) {
-            for (j = current->E.ia[i] - 1; j < current->E.ia[i + 1] - 1; j++) {
-              l = current->E.ja[j] - 1;
+          /* extract upper triangular part */
+          if (PRE->issingle) {
+            for (j = scurrent->LU.ia[i] - 1; j < scurrent->LU.ja[i + 1] - 1;
+                 j++) {
+              l = scurrent->LU.ja[j] - 1;
               k = jcs[l];
               irs[k] = i;
-              sr[k++] = current->E.a[j];
+              sr[k++] = scurrent->LU.a[j];
               jcs[l] = k;
+              cnt++;
             }
-          }
-          /* shift pointers by one to the right */
-          for (i = current->E.nc; i > 0; i--)
+          } else { /* !PRE->issingle */
+            for (j = current->LU.ia[i] - 1; j < current->LU.ja[i + 1] - 1;
+                 j++) {
+              l = current->LU.ja[j] - 1;
+              k = jcs[l];
+              irs[k] = i;
+              sr[k++] = current->LU.a[j];
+              jcs[l] = k;
+              cnt++;
+            }
+          } /* end if-else PRE->issingle */
+        }
+        /* shift pointers by one to the right */
+        if (param->flags & COARSE_REDUCE) {
+          for (i = ((PRE->issingle) ? scurrent->nB : current->nB); i > 0; i--)
             jcs[i] = jcs[i - 1];
-          jcs[0] = 0;
-        } /* end if-else PRE->issingle */
-      } else {
-        fout = mxCreateDoubleMatrix((mwSize)0, (mwSize)0, mxREAL);
-      }
-
-      /* set each field in output structure */
-      mxSetFieldByNumber(PRE_output, jstruct, ifield, fout);
-    }
-
-    /* 7. field `F' */
-    ++ifield;
-    /* mexPrintf("7. field `F'\n"); fflush(stdout); */
-    if (jstruct < PRE->nlev - 1) {
-
-      if (param->flags & COARSE_REDUCE) {
-        if (PRE->issingle) {
-          nnz = scurrent->F.ia[scurrent->F.nr] - 1;
-          fout = mxCreateSparse((mwSize)scurrent->F.nr, (mwSize)scurrent->F.nc,
-                                nnz, mxREAL);
         } else {
-          nnz = current->F.ia[current->F.nr] - 1;
-          fout = mxCreateSparse((mwSize)current->F.nr, (mwSize)current->F.nc,
-                                nnz, mxREAL);
+          for (i = ((PRE->issingle) ? scurrent->n : current->n); i > 0; i--)
+            jcs[i] = jcs[i - 1];
         }
+        jcs[0] = 0;
 
-        sr = (double *)mxGetPr(fout);
-        irs = (mwIndex *)mxGetIr(fout);
-        jcs = (mwIndex *)mxGetJc(fout);
+        if (PRE->issingle)
+          scurrent->LU.ja[scurrent->nB] = nnzU;
+        else
+          current->LU.ja[current->nB] = nnzU;
 
-        if (PRE->issingle) {
-          for (i = 0; i <= scurrent->F.nc; i++)
-            jcs[i] = 0;
-          /* number of entries per column, shifted by one space */
-          for (i = 0; i < scurrent->F.nr; i++) {
+        /* mexPrintf("number of spaces used: %d\n",cnt);fflush(stdout); */
+        /* mexPrintf("after=%d\n",
+         * (PRE->issingle)?scurrent->LU.ja[scurrent->nB]:current->LU.ja[current->nB]);
+         * fflush(stdout); */
 
-            j = scurrent->F.ia[i] - 1;
-            jj = scurrent->F.ia[i + 1] - scurrent->F.ia[i];
-            Sqsort(scurrent->F.a + j, scurrent->F.ja + j, istack, &jj);
+        /* set each field in output structure */
+        mxSetFieldByNumber(PRE_output, jstruct, ifield, fout);
+      }
 
-            for (j = scurrent->F.ia[i] - 1; j < scurrent->F.ia[i + 1] - 1;
-                 j++) {
-              k = scurrent->F.ja[j];
-              jcs[k]++;
-            }
+      /* 6. field `E' */
+      ++ifield;
+      /* mexPrintf("6. field `E'\n"); fflush(stdout); */
+      if (jstruct < PRE->nlev - 1) {
+
+        if (param->flags & COARSE_REDUCE) {
+          if (PRE->issingle) {
+            nnz = scurrent->E.ia[scurrent->E.nr] - 1;
+            fout = mxCreateSparse((mwSize)scurrent->E.nr,
+                                  (mwSize)scurrent->E.nc, nnz, mxREAL);
+          } else {
+            nnz = current->E.ia[current->E.nr] - 1;
+            fout = mxCreateSparse((mwSize)current->E.nr, (mwSize)current->E.nc,
+                                  nnz, mxREAL);
           }
-          /* switch to pointer structure */
-          for (i = 0; i < scurrent->F.nc; i++)
-            jcs[i + 1] += jcs[i];
 
-          for (i = 0; i < scurrent->F.nr; i++) {
-            for (j = scurrent->F.ia[i] - 1; j < scurrent->F.ia[i + 1] - 1;
-                 j++) {
-              l = scurrent->F.ja[j] - 1;
-              k = jcs[l];
-              irs[k] = i;
-              sr[k++] = scurrent->F.a[j];
-              jcs[l] = k;
+          sr = (double *)mxGetPr(fout);
+          irs = (mwIndex *)mxGetIr(fout);
+          jcs = (mwIndex *)mxGetJc(fout);
+
+          if (PRE->issingle) {
+            for (i = 0; i <= scurrent->E.nc; i++)
+              jcs[i] = 0;
+            /* number of entries per column, shifted by one space */
+            for (i = 0; i < scurrent->E.nr; i++) {
+
+              j = scurrent->E.ia[i] - 1;
+              jj = scurrent->E.ia[i + 1] - scurrent->E.ia[i];
+              Sqsort(scurrent->E.a + j, scurrent->E.ja + j, istack, &jj);
+
+              for (j = scurrent->E.ia[i] - 1; j < scurrent->E.ia[i + 1] - 1;
+                   j++) {
+                k = scurrent->E.ja[j];
+                jcs[k]++;
+              }
             }
-          }
-          /* shift pointers by one to the right */
-          for (i = scurrent->F.nc; i > 0; i--)
-            jcs[i] = jcs[i - 1];
-          jcs[0] = 0;
-        } else { /* !PRE->issingle */
-          for (i = 0; i <= current->F.nc; i++)
-            jcs[i] = 0;
-          /* number of entries per column, shifted by one space */
-          for (i = 0; i < current->F.nr; i++) {
+            /* switch to pointer structure */
+            for (i = 0; i < scurrent->E.nc; i++)
+              jcs[i + 1] += jcs[i];
+
+            for (i = 0; i < scurrent->E.nr; i++) {
+              for (j = scurrent->E.ia[i] - 1; j < scurrent->E.ia[i + 1] - 1;
+                   j++) {
+                l = scurrent->E.ja[j] - 1;
+                k = jcs[l];
+                irs[k] = i;
+                sr[k++] = scurrent->E.a[j];
+                jcs[l] = k;
+              }
+            }
+            /* shift pointers by one to the right */
+            for (i = scurrent->E.nc; i > 0; i--)
+              jcs[i] = jcs[i - 1];
+            jcs[0] = 0;
+          } else { /* !PRE->issingle */
+            for (i = 0; i <= current->E.nc; i++)
+              jcs[i] = 0;
+            /* number of entries per column, shifted by one space */
+            for (i = 0; i < current->E.nr; i++) {
+
+              j = current->E.ia[i] - 1;
+              jj = current->E.ia[i + 1] - current->E.ia[i];
+              Dqsort(current->E.a + j, current->E.ja + j, istack, &jj);
+
+              for (j = current->E.ia[i] - 1; j < current->E.ia[i + 1] - 1;
+                   j++) {
+                k = current->E.ja[j];
+                jcs[k]++;
+              }
+            }
+            /* switch to pointer structure */
+            for (i = 0; i < current->E.nc; i++)
+              jcs[i + 1] += jcs[i];
+
+            for (i = 0; i < current->E.nr; i++) {
+              for (j = current->E.ia[i] - 1; j < current->E.ia[i + 1] - 1;
+                   j++) {
+                l = current->E.ja[j] - 1;
+                k = jcs[l];
+                irs[k] = i;
+                sr[k++] = current->E.a[j];
+                jcs[l] = k;
+              }
+            }
+            /* shift pointers by one to the right */
+            for (i = current->E.nc; i > 0; i--)
+              jcs[i] = jcs[i - 1];
+            jcs[0] = 0;
+          } /* end if-else PRE->issingle */
+        } else {
+          fout = mxCreateDoubleMatrix((mwSize)0, (mwSize)0, mxREAL);
+        }
 
-            j = current->F.ia[i] - 1;
-            jj = current->F.ia[i + 1] - current->F.ia[i];
-            Dqsort(current->F.a + j, current->F.ja + j, istack, &jj);
+        /* set each field in output structure */
+        mxSetFieldByNumber(PRE_output, jstruct, ifield, fout);
+      }
 
-            for (j = current->F.ia[i] - 1; j < current->F.ia[i + 1] - 1; j++) {
-              k = current->F.ja[j];
-              jcs[k]++;
-            }
+      /* 7. field `F' */
+      ++ifield;
+      /* mexPrintf("7. field `F'\n"); fflush(stdout); */
+      if (jstruct < PRE->nlev - 1) {
+
+        if (param->flags & COARSE_REDUCE) {
+          if (PRE->issingle) {
+            nnz = scurrent->F.ia[scurrent->F.nr] - 1;
+            fout = mxCreateSparse((mwSize)scurrent->F.nr,
+                                  (mwSize)scurrent->F.nc, nnz, mxREAL);
+          } else {
+            nnz = current->F.ia[current->F.nr] - 1;
+            fout = mxCreateSparse((mwSize)current->F.nr, (mwSize)current->F.nc,
+                                  nnz, mxREAL);
           }
-          /* switch to pointer structure */
-          for (i = 0; i < current->F.nc; i++)
-            jcs[i + 1] += jcs[i];
 
-          for (i = 0; i < current->F.nr; i++) {
-            for (j = current->F.ia[i] - 1; j < current->F.ia[i + 1] - 1; j++) {
-              l = current->F.ja[j] - 1;
-              k = jcs[l];
-              irs[k] = i;
-              sr[k++] = current->F.a[j];
-              jcs[l] = k;
+          sr = (double *)mxGetPr(fout);
+          irs = (mwIndex *)mxGetIr(fout);
+          jcs = (mwIndex *)mxGetJc(fout);
+
+          if (PRE->issingle) {
+            for (i = 0; i <= scurrent->F.nc; i++)
+              jcs[i] = 0;
+            /* number of entries per column, shifted by one space */
+            for (i = 0; i < scurrent->F.nr; i++) {
+
+              j = scurrent->F.ia[i] - 1;
+              jj = scurrent->F.ia[i + 1] - scurrent->F.ia[i];
+              Sqsort(scurrent->F.a + j, scurrent->F.ja + j, istack, &jj);
+
+              for (j = scurrent->F.ia[i] - 1; j < scurrent->F.ia[i + 1] - 1;
+                   j++) {
+                k = scurrent->F.ja[j];
+                jcs[k]++;
+              }
             }
-          }
-          /* shift pointers by one to the right */
-          for (i = current->F.nc; i > 0; i--)
-            jcs[i] = jcs[i - 1];
-          jcs[0] = 0;
-        } /* end if-else PRE->issingle */
-      } else {
-        fout = mxCreateDoubleMatrix((mwSize)0, (mwSize)0, mxREAL);
+            /* switch to pointer structure */
+            for (i = 0; i < scurrent->F.nc; i++)
+              jcs[i + 1] += jcs[i];
+
+            for (i = 0; i < scurrent->F.nr; i++) {
+              for (j = scurrent->F.ia[i] - 1; j < scurrent->F.ia[i + 1] - 1;
+                   j++) {
+                l = scurrent->F.ja[j] - 1;
+                k = jcs[l];
+                irs[k] = i;
+                sr[k++] = scurrent->F.a[j];
+                jcs[l] = k;
+              }
+            }
+            /* shift pointers by one to the right */
+            for (i = scurrent->F.nc; i > 0; i--)
+              jcs[i] = jcs[i - 1];
+            jcs[0] = 0;
+          } else { /* !PRE->issingle */
+            for (i = 0; i <= current->F.nc; i++)
+              jcs[i] = 0;
+            /* number of entries per column, shifted by one space */
+            for (i = 0; i < current->F.nr; i++) {
+
+              j = current->F.ia[i] - 1;
+              jj = current->F.ia[i + 1] - current->F.ia[i];
+              Dqsort(current->F.a + j, current->F.ja + j, istack, &jj);
+
+              for (j = current->F.ia[i] - 1; j < current->F.ia[i + 1] - 1;
+                   j++) {
+                k = current->F.ja[j];
+                jcs[k]++;
+              }
+            }
+            /* switch to pointer structure */
+            for (i = 0; i < current->F.nc; i++)
+              jcs[i + 1] += jcs[i];
+
+            for (i = 0; i < current->F.nr; i++) {
+              for (j = current->F.ia[i] - 1; j < current->F.ia[i + 1] - 1;
+                   j++) {
+                l = current->F.ja[j] - 1;
+                k = jcs[l];
+                irs[k] = i;
+                sr[k++] = current->F.a[j];
+                jcs[l] = k;
+              }
+            }
+            /* shift pointers by one to the right */
+            for (i = current->F.nc; i > 0; i--)
+              jcs[i] = jcs[i - 1];
+            jcs[0] = 0;
+          } /* end if-else PRE->issingle */
+        } else {
+          fout = mxCreateDoubleMatrix((mwSize)0, (mwSize)0, mxREAL);
+        }
+        /* set each field in output structure */
+        mxSetFieldByNumber(PRE_output, jstruct, ifield, fout);
       }
-      /* set each field in output structure */
-      mxSetFieldByNumber(PRE_output, jstruct, ifield, fout);
     }
 
     /* 8. field `rowscal' */
@@ -1340,7 +1373,7 @@ void mexFunction(
     ++ifield;
     if (jstruct >= PRE->nlev - 1) {
       fout = mxCreateSparse((mwSize)0, (mwSize)0, (mwSize)0, mxREAL);
-    } else if (param->ipar[16] & DISCARD_MATRIX) {
+    } else if (ptronly || param->ipar[16] & DISCARD_MATRIX) {
       if (PRE->issingle)
         fout = mxCreateSparse((mwSize)n - scurrent->nB,
                               (mwSize)n - scurrent->nB, (mwSize)0, mxREAL);
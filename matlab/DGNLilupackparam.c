@@ -0,0 +1,124 @@
+/* ========================================================================== */
+/* === DGNLilupackparam mexFunction ========================================= */
+/* ========================================================================== */
+
+/*
+    Usage:
+
+    Parse the options of ILUPACK once into an opaque handle, which can be
+    passed to DGNLilupackfactor and DGNLilupacksolver instead of the
+    options structure. This avoids converting the structure in every call
+    when the same options are used many times.
+
+    Example:
+
+    % create the handle from the options returned by DGNLilupackinit
+    options = DGNLilupackinit(A);
+    handle = DGNLilupackparam(A, options);
+
+    [PREC, handle] = DGNLilupackfactor(A, handle);
+    [x, niter] = DGNLilupacksolver(A, PREC, handle, b, x0);
+    DGNLilupackdelete(PREC);
+
+    The handle is a uint64 array that stores the parsed options by value,
+    so it holds no pointers and needs no release. It can be copied, saved
+    and cleared like any other array, and the mex functions that accept it
+    check its header and size before reading it. Test vectors (options.tv)
+    are not supported.
+
+    Notice:
+
+        THIS MATERIAL IS PROVIDED AS IS, WITH ABSOLUTELY NO WARRANTY
+        EXPRESSED OR IMPLIED.  ANY USE IS AT YOUR OWN RISK.
+*/
+
+/* ========================================================================== */
+/* === Include files and prototypes ========================================= */
+/* ========================================================================== */
+
+#include "DGNLilupackparam.h"
+
+/* store param and its string options by value in a new options handle */
+static mxArray *create_handle(const DILUPACKparam *param) {
+  DILUPACKhandle header;
+  char **fields[PARAM_NSTRINGS];
+  mxArray *out;
+  char *data;
+  size_t len;
+  int i;
+
+  memset(&header, 0, sizeof(DILUPACKhandle));
+  header.magic = PARAM_MAGIC;
+  header.param = *param;
+  header.size = sizeof(DILUPACKhandle);
+
+  /* the strings follow the header in the order of their fields */
+  DGNLilupackparam_strings(&header.param, fields);
+  for (i = 0; i < PARAM_NSTRINGS; i++) {
+    if (*fields[i] != NULL) {
+      header.offsets[i] = header.size;
+      header.size += strlen(*fields[i]) + 1;
+    }
+  }
+
+  /* round the size up to whole 8-byte elements */
+  out = mxCreateNumericMatrix((mwSize)((header.size + 7) / 8), (mwSize)1,
+                              mxUINT64_CLASS, mxREAL);
+  data = (char *)mxGetData(out);
+
+  /* copy the strings and clear their pointers, which are not used */
+  for (i = 0; i < PARAM_NSTRINGS; i++) {
+    if (*fields[i] != NULL) {
+      len = strlen(*fields[i]) + 1;
+      memcpy(data + header.offsets[i], *fields[i], len);
+      *fields[i] = NULL;
+    }
+  }
+  memcpy(data, &header, sizeof(DILUPACKhandle));
+
+  return out;
+}
+
+/* ========================================================================== */
+/* === mexFunction ========================================================== */
+/* ========================================================================== */
+
+void mexFunction(
+    /* === Parameters ======================================================= */
+
+    int nlhs,             /* number of left-hand sides */
+    mxArray *plhs[],      /* left-hand side matrices */
+    int nrhs,             /* number of right--hand sides */
+    const mxArray *prhs[] /* right-hand side matrices */
+) {
+  Dmat A;
+  DILUPACKparam param;
+  char *strings[PARAM_NSTRINGS];
+  int nstrings;
+
+  if (nrhs != 2)
+    mexErrMsgTxt("Two input arguments required.");
+  else if (nlhs > 1)
+    mexErrMsgTxt("Too many output arguments.");
+  else if (!mxIsStruct(prhs[1]))
+    mexErrMsgTxt("Second input must be a structure.");
+  else if (!mxIsNumeric(prhs[0]) || mxGetM(prhs[0]) != mxGetN(prhs[0]))
+    mexErrMsgTxt("First input must be a square matrix.");
+
+  /* the defaults only depend on the size of A */
+  A.nc = A.nr = mxGetM(prhs[0]);
+  A.ia = A.ja = NULL;
+  A.a = NULL;
+
+  DGNLAMGinit(&A, &param);
+  DGNLilupackparam_parse(prhs[1], &param, strings, &nstrings);
+
+  if (param.droptolS > 0.125 * param.droptol) {
+    mexPrintf("!!! ILUPACK Warning !!!\n");
+    mexPrintf("`param.droptolS' is recommended to be one order of magnitude "
+              "less than `param.droptol'\n");
+  }
+
+  plhs[0] = create_handle(&param);
+  DGNLilupackparam_free(strings, &nstrings);
+}
@@ -0,0 +1,266 @@
+/* ========================================================================== */
+/* === DGNLilupackparam.h =================================================== */
+/* ========================================================================== */
+
+/*
+    Parsing of the ILUPACK options into DILUPACKparam, shared by the mex
+    functions that accept the options handle created by DGNLilupackparam
+    or that apply one options structure to many systems.
+
+    Notice:
+
+        THIS MATERIAL IS PROVIDED AS IS, WITH ABSOLUTELY NO WARRANTY
+        EXPRESSED OR IMPLIED.  ANY USE IS AT YOUR OWN RISK.
+*/
+
+#ifndef DGNLILUPACKPARAM_H
+#define DGNLILUPACKPARAM_H
+
+#include "matrix.h"
+#include "mex.h"
+#include <ilupack.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* number of string options of DILUPACKparam */
+#define PARAM_NSTRINGS 8
+
+/* flags of DILUPACKparam that can be set through the options */
+#define PARAM_FLAGS                                                            \
+  (COARSE_REDUCE | DECOUPLE_CONSTRAINTS | DECOUPLE_CONSTRAINTSHH)
+
+/* tag identifying an options handle */
+#define PARAM_MAGIC 0x494c555041434bUL
+
+/* header of the options handle created by DGNLilupackparam, which stores
+   the parsed options by value in a uint64 array. The header is followed
+   by the string options, which are located by their offsets in bytes from
+   the beginning of the handle, so the pointers in param are not used. */
+typedef struct {
+  size_t magic;
+  size_t size;
+  DILUPACKparam param;
+  size_t offsets[PARAM_NSTRINGS];
+} DILUPACKhandle;
+
+/* store the addresses of the string options of param in fields */
+static inline void DGNLilupackparam_strings(DILUPACKparam *param,
+                                            char **fields[]) {
+  fields[0] = &param->amg;
+  fields[1] = &param->presmoother;
+  fields[2] = &param->postsmoother;
+  fields[3] = &param->typecoarse;
+  fields[4] = &param->typetv;
+  fields[5] = &param->FCpart;
+  fields[6] = &param->solver;
+  fields[7] = &param->ordering;
+}
+
+/* free the strings allocated by DGNLilupackparam_parse */
+static inline void DGNLilupackparam_free(char **strings, int *nstrings) {
+  while (*nstrings > 0)
+    free(strings[--(*nstrings)]);
+}
+
+/* parse the options into param, which was initialized by DGNLAMGinit. The
+   strings are allocated with malloc and stored in strings. */
+static inline void DGNLilupackparam_parse(const mxArray *options,
+                                          DILUPACKparam *param, char **strings,
+                                          int *nstrings) {
+  int ifield, nfields = mxGetNumberOfFields(options);
+  const char *name;
+  const mxArray *tmp;
+  char *buf;
+  mwSize buflen;
+  double v;
+
+  *nstrings = 0;
+  for (ifield = 0; ifield < nfields; ifield++) {
+    name = mxGetFieldNameByNumber(options, ifield);
+    tmp = mxGetFieldByNumber(options, 0, ifield);
+
+    if (mxGetClassID(tmp) == mxCHAR_CLASS) {
+      char **field = NULL;
+
+      if (!strcmp("amg", name))
+        field = &param->amg;
+      else if (!strcmp("presmoother", name))
+        field = &param->presmoother;
+      else if (!strcmp("postsmoother", name))
+        field = &param->postsmoother;
+      else if (!strcmp("typecoarse", name))
+        field = &param->typecoarse;
+      else if (!strcmp("typetv", name))
+        field = &param->typetv;
+      else if (!strcmp("FCpart", name))
+        field = &param->FCpart;
+      else if (!strcmp("solver", name))
+        field = &param->solver;
+      else if (!strcmp("ordering", name))
+        field = &param->ordering;
+      if (field == NULL || *nstrings == PARAM_NSTRINGS)
+        continue;
+
+      buflen = mxGetM(tmp) * mxGetN(tmp) + 1;
+      buf = (char *)malloc((size_t)buflen * sizeof(char));
+      mxGetString(tmp, buf, buflen);
+      strings[(*nstrings)++] = buf;
+      *field = buf;
+
+      if (field == &param->typetv && strcmp("none", buf)) {
+        DGNLilupackparam_free(strings, nstrings);
+        mexErrMsgTxt("Test vectors are not supported with shared options.");
+      }
+      continue;
+    }
+
+    if (mxIsEmpty(tmp) || !mxIsDouble(tmp))
+      continue;
+    v = *mxGetPr(tmp);
+    if (!strcmp("elbow", name))
+      param->elbow = v;
+    else if (!strcmp("lfilS", name))
+      param->lfilS = v;
+    else if (!strcmp("lfil", name))
+      param->lfil = v;
+    else if (!strcmp("maxit", name))
+      param->maxit = v;
+    else if (!strcmp("droptolS", name))
+      param->droptolS = v;
+    else if (!strcmp("droptolc", name))
+      param->droptolc = v;
+    else if (!strcmp("droptol", name))
+      param->droptol = v;
+    else if (!strcmp("condest", name))
+      param->condest = v;
+    else if (!strcmp("restol", name))
+      param->restol = v;
+    else if (!strcmp("npresmoothing", name))
+      param->npresmoothing = v;
+    else if (!strcmp("npostmoothing", name))
+      param->npostsmoothing = v;
+    else if (!strcmp("ncoarse", name))
+      param->ncoarse = v;
+    else if (!strcmp("matching", name))
+      param->matching = v;
+    else if (!strcmp("nrestart", name))
+      param->nrestart = v;
+    else if (!strcmp("damping", name))
+      param->damping = v;
+    else if (!strcmp("contraction", name))
+      param->contraction = v;
+    else if (!strcmp("mixedprecision", name))
+      param->mixedprecision = v;
+    else if (!strcmp("coarsereduce", name)) {
+      if (v != 0.0)
+        param->flags |= COARSE_REDUCE;
+      else
+        param->flags &= ~COARSE_REDUCE;
+    } else if (!strcmp("decoupleconstraints", name)) {
+      param->flags &= ~(DECOUPLE_CONSTRAINTS | DECOUPLE_CONSTRAINTSHH);
+      if (v > 0.0)
+        param->flags |= DECOUPLE_CONSTRAINTSHH;
+      else if (v < 0.0)
+        param->flags |= DECOUPLE_CONSTRAINTS;
+    }
+  }
+}
+
+/* copy the options parsed into tmpl into param, initialized by DGNLAMGinit.
+   The strings are shared with tmpl. */
+static inline void DGNLilupackparam_copy(const DILUPACKparam *tmpl,
+                                         DILUPACKparam *param) {
+  param->amg = tmpl->amg;
+  param->presmoother = tmpl->presmoother;
+  param->postsmoother = tmpl->postsmoother;
+  param->typecoarse = tmpl->typecoarse;
+  param->typetv = tmpl->typetv;
+  param->FCpart = tmpl->FCpart;
+  param->solver = tmpl->solver;
+  param->ordering = tmpl->ordering;
+
+  param->elbow = tmpl->elbow;
+  param->lfilS = tmpl->lfilS;
+  param->lfil = tmpl->lfil;
+  param->maxit = tmpl->maxit;
+  param->droptolS = tmpl->droptolS;
+  param->droptolc = tmpl->droptolc;
+  param->droptol = tmpl->droptol;
+  param->condest = tmpl->condest;
+  param->restol = tmpl->restol;
+  param->npresmoothing = tmpl->npresmoothing;
+  param->npostsmoothing = tmpl->npostsmoothing;
+  param->ncoarse = tmpl->ncoarse;
+  param->matching = tmpl->matching;
+  param->nrestart = tmpl->nrestart;
+  param->damping = tmpl->damping;
+  param->contraction = tmpl->contraction;
+  param->mixedprecision = tmpl->mixedprecision;
+  param->flags = (param->flags & ~PARAM_FLAGS) | (tmpl->flags & PARAM_FLAGS);
+}
+
+/* return whether the array is an options handle. Only the header and the
+   string offsets within the array are read, so any array can be tested. */
+static inline int DGNLilupackparam_valid(const mxArray *input) {
+  DILUPACKhandle header;
+  const char *data;
+  size_t nbytes;
+  int i;
+
+  if (mxGetClassID(input) != mxUINT64_CLASS)
+    return 0;
+  nbytes = (size_t)mxGetNumberOfElements(input) * 8;
+  if (nbytes < sizeof(DILUPACKhandle))
+    return 0;
+
+  data = (const char *)mxGetData(input);
+  memcpy(&header, data, sizeof(DILUPACKhandle));
+  if (header.magic != PARAM_MAGIC || header.size < sizeof(DILUPACKhandle) ||
+      header.size > nbytes)
+    return 0;
+
+  /* each string must end within the handle */
+  for (i = 0; i < PARAM_NSTRINGS; i++) {
+    if (header.offsets[i] == 0)
+      continue;
+    if (header.offsets[i] < sizeof(DILUPACKhandle) ||
+        header.offsets[i] >= header.size ||
+        memchr(data + header.offsets[i], '\0',
+               header.size - header.offsets[i]) == NULL)
+      return 0;
+  }
+  return 1;
+}
+
+/* copy the options stored in a valid options handle into param. The
+   string options of param are kept if they are equal to those of the
+   handle, and are otherwise copied with MAlloc, as when they are read from
+   an options structure, since param may outlive the handle. */
+static inline void DGNLilupackparam_load(const mxArray *input,
+                                         DILUPACKparam *param) {
+  DILUPACKhandle header;
+  const char *data = (const char *)mxGetData(input);
+  char **src[PARAM_NSTRINGS], **dst[PARAM_NSTRINGS];
+  const char *str;
+  int i;
+
+  memcpy(&header, data, sizeof(DILUPACKhandle));
+  DGNLilupackparam_strings(&header.param, src);
+  DGNLilupackparam_strings(param, dst);
+
+  for (i = 0; i < PARAM_NSTRINGS; i++) {
+    if (header.offsets[i] == 0) {
+      *src[i] = *dst[i];
+      continue;
+    }
+    str = data + header.offsets[i];
+    if (*dst[i] == NULL || strcmp(*dst[i], str)) {
+      *dst[i] = (char *)MAlloc(strlen(str) + 1, "DGNLilupackparam_load");
+      strcpy(*dst[i], str);
+    }
+    *src[i] = *dst[i];
+  }
+  DGNLilupackparam_copy(&header.param, param);
+}
+
+#endif
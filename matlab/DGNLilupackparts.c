@@ -0,0 +1,434 @@
+/* ========================================================================== */
+/* === DGNLilupackparts mexFunction ========================================= */
+/* ========================================================================== */
+
+/*
+    Usage:
+
+    Factor the independent diagonal blocks of a real nonsymmetric matrix
+    with ILUPACK in a single call, such as the subdomains of a nested
+    dissection, and return the first level of each multilevel ILU. The
+    rows and columns that ILUPACK defers to its coarser levels are left to
+    the caller, which factors them together with the separators (see
+    MILUfactor).
+
+    Example:
+
+    % initialize the options from one of the matrices
+    options = DGNLilupackinit(As{1});
+
+    % factor the blocks As{k} for all k using up to nthreads threads
+    parts = DGNLilupackparts(As, options, nthreads);
+
+    % return the error codes of ILUPACK instead of raising an error
+    [parts, info] = DGNLilupackparts(As, options, nthreads);
+
+    As is a cell array of real square sparse matrices. parts is a structure
+    array with the fields p, q, rowscal, colscal, L, U and d of the first
+    level of each block. With nB = length(parts(k).d) and the scaled matrix
+    Ak = diag(rowscal) * As{k} * diag(colscal),
+
+        Ak(p(1:nB), q(1:nB)) ~ (I + L) * diag(d) * (I + U),
+
+    where L and U are sparse strictly lower and upper triangular matrices.
+    The rows p(nB+1:end) and the columns q(nB+1:end) of As{k} were
+    deferred by the inverse-based pivoting of ILUPACK. info(k) is the error
+    code of DGNLAMGfactor for As{k}. If info is not requested, any nonzero
+    code raises an error after all the blocks have been factored.
+
+    The options are those of DGNLilupackfactor, except that test vectors
+    (options.tv) are not supported, options.mixedprecision is ignored, and
+    the flag COARSE_REDUCE is always set. ILUPACK factors all the levels of
+    each block, of which only the first is returned. The blocks are
+    factored in parallel only if this file was compiled with OpenMP, and
+    nthreads should be set to 1 if the ILUPACK library in use is not
+    thread-safe.
+
+    Notice:
+
+        THIS MATERIAL IS PROVIDED AS IS, WITH ABSOLUTELY NO WARRANTY
+        EXPRESSED OR IMPLIED.  ANY USE IS AT YOUR OWN RISK.
+*/
+
+/* ========================================================================== */
+/* === Include files and prototypes ========================================= */
+/* ========================================================================== */
+
+#include "DGNLilupackparam.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+static const char *part_names[] = {"p", "q", "rowscal", "colscal",
+                                   "L", "U", "d"};
+
+/* a block of the matrix, with pointers into its MATLAB array */
+typedef struct {
+  integer n;
+  mwIndex *A_ia, *A_ja;
+  double *A_a;
+  Dmat A;
+  DAMGlevelmat PRE;
+  DILUPACKparam param;
+  integer info;
+} matrix_part;
+
+/* convert a MATLAB sparse matrix into a CRS matrix with 1-based indices */
+static void crs_from_ccs(matrix_part *part) {
+  integer i, j, k, n = part->n;
+  mwSize nnz = part->A_ia[n];
+  Dmat *A = &part->A;
+
+  A->nr = A->nc = n;
+  A->ia = (integer *)malloc((size_t)(n + 1) * sizeof(integer));
+  A->ja = (integer *)malloc((size_t)(nnz > 0 ? nnz : 1) * sizeof(integer));
+  A->a = (double *)malloc((size_t)(nnz > 0 ? nnz : 1) * sizeof(double));
+
+  for (i = 0; i <= n; i++)
+    A->ia[i] = 0;
+  for (j = 0; j < (integer)nnz; j++)
+    A->ia[part->A_ja[j] + 1]++;
+  for (i = 0; i < n; i++)
+    A->ia[i + 1] += A->ia[i];
+
+  for (j = 0; j < n; j++) {
+    for (k = (integer)part->A_ia[j]; k < (integer)part->A_ia[j + 1]; k++) {
+      i = (integer)part->A_ja[k];
+      A->ja[A->ia[i]] = j + 1;
+      A->a[A->ia[i]++] = part->A_a[k];
+    }
+  }
+  for (i = n; i > 0; i--)
+    A->ia[i] = A->ia[i - 1] + 1;
+  A->ia[0] = 1;
+}
+
+/* factor one block, without calling the MATLAB API */
+static void factor_part(matrix_part *part, const DILUPACKparam *tmpl) {
+  crs_from_ccs(part);
+  DGNLAMGinit(&part->A, &part->param);
+  DGNLilupackparam_copy(tmpl, &part->param);
+
+  /* the first level must not contain the deferred columns, and its
+     factors are returned in double precision */
+  part->param.flags |= COARSE_REDUCE;
+  part->param.mixedprecision = 0;
+
+  part->info = DGNLAMGfactor(&part->A, &part->PRE, &part->param);
+}
+
+/* sort the row indices of a sparse column along with its values */
+static void sort_column(mwIndex *ir, double *pr, mwSize len) {
+  mwSize i, j;
+  mwIndex t;
+  double v;
+
+  for (i = 1; i < len; i++) {
+    t = ir[i];
+    v = pr[i];
+    for (j = i; j > 0 && ir[j - 1] > t; j--) {
+      ir[j] = ir[j - 1];
+      pr[j] = pr[j - 1];
+    }
+    ir[j] = t;
+    pr[j] = v;
+  }
+}
+
+/* create a double column vector */
+static mxArray *double_vector(mwSize n) {
+  return mxCreateDoubleMatrix(n, (mwSize)1, mxREAL);
+}
+
+/* export the sparse LU factors of the first level into L, U and d */
+static void export_sparse_lu(const DAMGlevelmat *PRE, mxArray *parts,
+                             mwIndex k) {
+  integer nB = PRE->nB, i, j, uend;
+  integer *ia = PRE->LU.ia, *ja = PRE->LU.ja;
+  double *a = PRE->LU.a, *pr;
+  mwSize nnzL = 0, nnzU = 0, l;
+  mwIndex *jc, *ir;
+  mxArray *L, *U, *d;
+
+  for (i = 0; i < nB; i++) {
+    /* the end of the last row of U is not stored in ja[nB] */
+    uend = (i < nB - 1) ? ja[i + 1] : PRE->LU.nnz + 1;
+    nnzL += (mwSize)(ia[i] - ja[i]);
+    nnzU += (mwSize)(uend - ia[i]);
+  }
+
+  /* 1. strictly lower triangular part of unit-lower L, stored in column i
+     in ja[i]-1:ia[i]-2 */
+  L = mxCreateSparse((mwSize)nB, (mwSize)nB, nnzL > 0 ? nnzL : 1, mxREAL);
+  jc = mxGetJc(L);
+  ir = mxGetIr(L);
+  pr = mxGetPr(L);
+
+  l = 0;
+  for (i = 0; i < nB; i++) {
+    jc[i] = l;
+    for (j = ja[i] - 1; j < ia[i] - 1; j++) {
+      ir[l] = (mwIndex)(ja[j] - 1);
+      pr[l++] = a[j] * a[i];
+    }
+    sort_column(ir + jc[i], pr + jc[i], l - jc[i]);
+  }
+  jc[nB] = l;
+
+  /* 2. strictly upper triangular part of unit-upper U, stored in row i in
+     ia[i]-1:ja[i+1]-2, which is transposed into columns */
+  U = mxCreateSparse((mwSize)nB, (mwSize)nB, nnzU > 0 ? nnzU : 1, mxREAL);
+  jc = mxGetJc(U);
+  ir = mxGetIr(U);
+  pr = mxGetPr(U);
+
+  for (i = 0; i <= nB; i++)
+    jc[i] = 0;
+  for (i = 0; i < nB; i++) {
+    uend = (i < nB - 1) ? ja[i + 1] : PRE->LU.nnz + 1;
+    for (j = ia[i] - 1; j < uend - 1; j++)
+      jc[ja[j]]++;
+  }
+  for (i = 0; i < nB; i++)
+    jc[i + 1] += jc[i];
+
+  for (i = 0; i < nB; i++) {
+    uend = (i < nB - 1) ? ja[i + 1] : PRE->LU.nnz + 1;
+    for (j = ia[i] - 1; j < uend - 1; j++) {
+      l = jc[ja[j] - 1]++;
+      ir[l] = (mwIndex)i;
+      pr[l] = a[j] * a[i];
+    }
+  }
+  for (i = nB; i > 0; i--)
+    jc[i] = jc[i - 1];
+  jc[0] = 0;
+
+  /* 3. diagonal, stored as its reciprocal in a[0:nB-1] */
+  d = double_vector((mwSize)nB);
+  pr = mxGetPr(d);
+  for (i = 0; i < nB; i++)
+    pr[i] = 1.0 / a[i];
+
+  mxSetField(parts, k, "L", L);
+  mxSetField(parts, k, "U", U);
+  mxSetField(parts, k, "d", d);
+}
+
+/* export the dense LU factorization of a block that ILUPACK factored as a
+   single dense level, stored row by row in a, into L, U and d */
+static void export_dense_lu(const DAMGlevelmat *PRE, mxArray *parts,
+                            mwIndex k) {
+  integer nB = PRE->nB, i, j;
+  double *a = PRE->LU.a, *pr;
+  mwSize nnzL = 0, nnzU = 0, l;
+  mwIndex *jc, *ir;
+  mxArray *L, *U, *d;
+
+  for (i = 0; i < nB; i++) {
+    for (j = 0; j < nB; j++) {
+      if (a[i * nB + j] == 0.0 || i == j)
+        continue;
+      if (i > j)
+        nnzL++;
+      else
+        nnzU++;
+    }
+  }
+
+  /* 1. strictly lower triangular part of unit-lower L */
+  L = mxCreateSparse((mwSize)nB, (mwSize)nB, nnzL > 0 ? nnzL : 1, mxREAL);
+  jc = mxGetJc(L);
+  ir = mxGetIr(L);
+  pr = mxGetPr(L);
+  l = 0;
+  for (j = 0; j < nB; j++) {
+    jc[j] = l;
+    for (i = j + 1; i < nB; i++) {
+      if (a[i * nB + j] != 0.0) {
+        ir[l] = (mwIndex)i;
+        pr[l++] = a[i * nB + j] / a[j * nB + j];
+      }
+    }
+  }
+  jc[nB] = l;
+
+  /* 2. strictly upper triangular part of unit-upper U */
+  U = mxCreateSparse((mwSize)nB, (mwSize)nB, nnzU > 0 ? nnzU : 1, mxREAL);
+  jc = mxGetJc(U);
+  ir = mxGetIr(U);
+  pr = mxGetPr(U);
+  l = 0;
+  for (j = 0; j < nB; j++) {
+    jc[j] = l;
+    for (i = 0; i < j; i++) {
+      if (a[i * nB + j] != 0.0) {
+        ir[l] = (mwIndex)i;
+        pr[l++] = a[i * nB + j];
+      }
+    }
+  }
+  jc[nB] = l;
+
+  /* 3. diagonal D */
+  d = double_vector((mwSize)nB);
+  pr = mxGetPr(d);
+  for (i = 0; i < nB; i++)
+    pr[i] = a[i * nB + i];
+
+  mxSetField(parts, k, "L", L);
+  mxSetField(parts, k, "U", U);
+  mxSetField(parts, k, "d", d);
+}
+
+/* export the permutations, the scalings and the factors of the first
+   level of a block into parts(k) */
+static void export_part(const matrix_part *part, mxArray *parts, mwIndex k) {
+  const DAMGlevelmat *PRE = &part->PRE;
+  integer n = part->n, i, j;
+  int dense = PRE->nlev == 1 && PRE->LU.ja == NULL;
+  mxArray *fout;
+  double *pr, t;
+
+  /* 1. row permutation p */
+  fout = double_vector((mwSize)n);
+  pr = mxGetPr(fout);
+  for (i = 0; i < n; i++)
+    pr[i] = (double)PRE->p[i];
+  mxSetField(parts, k, "p", fout);
+
+  /* 2. column permutation q, i.e., the inverse of invq. For a dense level,
+     the row interchanges of the dense LU factorization stored in LU.ia
+     are applied to invq instead. */
+  fout = double_vector((mwSize)n);
+  pr = mxGetPr(fout);
+  if (dense) {
+    for (i = 0; i < n; i++)
+      pr[i] = (double)PRE->invq[i];
+    for (i = 0; i < n; i++) {
+      j = PRE->LU.ia[i] - 1;
+      if (j != i) {
+        t = pr[i];
+        pr[i] = pr[j];
+        pr[j] = t;
+      }
+    }
+  } else {
+    for (i = 0; i < n; i++)
+      pr[PRE->invq[i] - 1] = (double)(i + 1);
+  }
+  mxSetField(parts, k, "q", fout);
+
+  /* 3. scaling vectors */
+  fout = double_vector((mwSize)n);
+  memcpy(mxGetPr(fout), PRE->rowscal, (size_t)n * sizeof(double));
+  mxSetField(parts, k, "rowscal", fout);
+
+  fout = double_vector((mwSize)n);
+  memcpy(mxGetPr(fout), PRE->colscal, (size_t)n * sizeof(double));
+  mxSetField(parts, k, "colscal", fout);
+
+  /* 4. factors of the leading block */
+  if (dense)
+    export_dense_lu(PRE, parts, k);
+  else
+    export_sparse_lu(PRE, parts, k);
+}
+
+/* ========================================================================== */
+/* === mexFunction ========================================================== */
+/* ========================================================================== */
+
+void mexFunction(
+    /* === Parameters ======================================================= */
+
+    int nlhs,             /* number of left-hand sides */
+    mxArray *plhs[],      /* left-hand side matrices */
+    int nrhs,             /* number of right--hand sides */
+    const mxArray *prhs[] /* right-hand side matrices */
+) {
+  Dmat A0;
+  DILUPACKparam tmpl;
+  matrix_part *parts;
+  const mxArray *A_input;
+  char *strings[PARAM_NSTRINGS];
+  int nstrings, nthreads = 1, failed = 0;
+  mwSize k, nparts;
+  double *pr;
+
+  if (nrhs < 2 || nrhs > 3)
+    mexErrMsgTxt("Two or three input arguments required.");
+  else if (nlhs > 2)
+    mexErrMsgTxt("Too many output arguments.");
+  else if (!mxIsCell(prhs[0]))
+    mexErrMsgTxt("First input must be a cell array.");
+  else if (!mxIsStruct(prhs[1]))
+    mexErrMsgTxt("Second input must be a structure.");
+
+  nparts = mxGetNumberOfElements(prhs[0]);
+  if (nrhs > 2)
+    nthreads = (int)mxGetScalar(prhs[2]);
+  if (nthreads < 1)
+    nthreads = 1;
+
+  /* Extract the arrays of all the blocks */
+  parts = (matrix_part *)mxCalloc(nparts > 0 ? nparts : 1, sizeof(matrix_part));
+  for (k = 0; k < nparts; k++) {
+    A_input = mxGetCell(prhs[0], k);
+    if (A_input == NULL || !mxIsSparse(A_input) || mxIsComplex(A_input) ||
+        mxGetM(A_input) != mxGetN(A_input))
+      mexErrMsgTxt("ILUPACK: each matrix must be real, square and sparse.");
+
+    parts[k].n = (integer)mxGetM(A_input);
+    parts[k].A_ia = mxGetJc(A_input);
+    parts[k].A_ja = mxGetIr(A_input);
+    parts[k].A_a = mxGetPr(A_input);
+  }
+
+  /* Parse the options only once, into a template of the parameters */
+  A0.nr = A0.nc = nparts > 0 ? parts[0].n : 0;
+  A0.ia = A0.ja = NULL;
+  A0.a = NULL;
+  DGNLAMGinit(&A0, &tmpl);
+  DGNLilupackparam_parse(prhs[1], &tmpl, strings, &nstrings);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+#endif
+  for (k = 0; k < nparts; k++)
+    factor_part(&parts[k], &tmpl);
+
+  /* Export the first levels, and release the factorizations */
+  plhs[0] = mxCreateStructMatrix(nparts, (mwSize)1,
+                                 sizeof(part_names) / sizeof(part_names[0]),
+                                 part_names);
+  for (k = 0; k < nparts; k++) {
+    if (parts[k].info == 0)
+      export_part(&parts[k], plhs[0], k);
+    DGNLAMGdelete(&parts[k].A, &parts[k].PRE, &parts[k].param);
+    free(parts[k].A.ia);
+    free(parts[k].A.ja);
+    free(parts[k].A.a);
+  }
+
+  if (nlhs > 1) {
+    plhs[1] = mxCreateDoubleMatrix(nparts, (mwSize)1, mxREAL);
+    pr = mxGetPr(plhs[1]);
+    for (k = 0; k < nparts; k++)
+      pr[k] = parts[k].info;
+  } else {
+    for (k = 0; k < nparts; k++) {
+      if (parts[k].info) {
+        mexPrintf("ILUPACK returned error code %d for block %d.\n",
+                  (int)parts[k].info, (int)k + 1);
+        failed = 1;
+      }
+    }
+  }
+
+  DGNLilupackparam_free(strings, &nstrings);
+  mxFree(parts);
+
+  if (failed)
+    mexErrMsgTxt("ILUPACK failed for some blocks.");
+}
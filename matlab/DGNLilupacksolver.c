@@ -13,6 +13,10 @@
     % for initializing parameters
     [x, options] = DGNLilupacksolver(A,PREC,options, b,x0);
 
+    % use the options handle created by DGNLilupackparam, which returns
+    % the number of iteration steps instead of the options
+    [x, niter] = DGNLilupacksolver(A,PREC,handle, b,x0);
+
 
 
     Authors:
@@ -52,6 +56,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "DGNLilupackparam.h"
+
 /* ========================================================================== */
 /* === mexFunction ========================================================== */
 /* ========================================================================== */
@@ -67,6 +73,7 @@ void mexFunction(
   Dmat A;
   DAMGlevelmat *PRE;
   DILUPACKparam *param;
+  int ishandle;
   integer n;
 
   const char **fnames;
@@ -88,8 +95,8 @@ void mexFunction(
     mexErrMsgTxt("five input arguments required.");
   else if (nlhs != 2)
     mexErrMsgTxt("Too many output arguments.");
-  else if (!mxIsStruct(prhs[2]))
-    mexErrMsgTxt("Third input must be a structure.");
+  else if (!mxIsStruct(prhs[2]) && !DGNLilupackparam_valid(prhs[2]))
+    mexErrMsgTxt("Third input must be a structure or an options handle.");
   else if (!mxIsNumeric(prhs[0]))
     mexErrMsgTxt("First input must be a matrix.");
 
@@ -202,7 +209,13 @@ void mexFunction(
 
   /* Get third input argument `options' */
   options_input = (mxArray *)prhs[2];
-  nfields = mxGetNumberOfFields(options_input);
+  ishandle = DGNLilupackparam_valid(options_input);
+  if (ishandle) {
+    /* the options were parsed by DGNLilupackparam */
+    DGNLilupackparam_load(options_input, param);
+    nfields = 0;
+  } else
+    nfields = mxGetNumberOfFields(options_input);
 
   /* Allocate memory  for storing classIDflags */
   classIDflags =
@@ -356,7 +369,10 @@ void mexFunction(
 
   /* Create a struct matrices for output */
   nlhs = 2;
-  if (j == -1)
+  if (ishandle)
+    /* return the number of iteration steps instead of the options */
+    plhs[1] = mxCreateDoubleMatrix((mwSize)1, (mwSize)1, mxREAL);
+  else if (j == -1)
     plhs[1] = mxCreateStructMatrix((mwSize)1, (mwSize)1, nfields + 1, fnames);
   else
     plhs[1] = mxCreateStructMatrix((mwSize)1, (mwSize)1, nfields, fnames);
@@ -496,17 +512,22 @@ void mexFunction(
   }
 
   /* store number of iteration steps */
-  if (j == -1)
-    ifield = nfields;
-  else
-    ifield = j;
-  fout = mxCreateDoubleMatrix((mwSize)1, (mwSize)1, mxREAL);
-  pr = mxGetPr(fout);
-
-  *pr = param->ipar[26];
-
-  /* set each field in output structure */
-  mxSetFieldByNumber(options_output, (mwIndex)0, ifield, fout);
+  if (ishandle) {
+    pr = mxGetPr(options_output);
+    *pr = param->ipar[26];
+  } else {
+    if (j == -1)
+      ifield = nfields;
+    else
+      ifield = j;
+    fout = mxCreateDoubleMatrix((mwSize)1, (mwSize)1, mxREAL);
+    pr = mxGetPr(fout);
+
+    *pr = param->ipar[26];
+
+    /* set each field in output structure */
+    mxSetFieldByNumber(options_output, (mwIndex)0, ifield, fout);
+  }
 
   mxFree(fnames);
   mxFree(classIDflags);
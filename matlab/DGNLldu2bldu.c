@@ -14,6 +14,11 @@
     % for initializing parameters
     [BL,BD,BUT]=DGNLldu2bldu(L,D,UT,threshold,maxsize,tol)
 
+    % return BL, BD and BUT in the compact format of selbinvpool.h, i.e., as
+    % flat integer index and double value arrays rather than as cell arrays
+    % of structures, if compact is nonzero
+    [BL,BD,BUT]=DGNLldu2bldu(L,D,UT,threshold,maxsize,tol,compact)
+
 
     Authors:
 
@@ -51,6 +56,8 @@
 #include <ilupackmacros.h>
 #include <lapack.h>
 
+#include "selbinvpool.h"
+
 #define MAX_FIELDS 100
 #define MAX(A, B) (((A) >= (B)) ? (A) : (B))
 #define MIN(A, B) (((A) >= (B)) ? (B) : (A))
@@ -78,7 +85,7 @@ void mexFunction(
       *BUT;
   integer i, j, k, l, m, kk, ll, n, flag, nnz, p, cnt, cnti, cntj, cntij, cntu,
       cntui, cntuj, cntuij, *ia, *ja, *idxpos, *idxlst, *idxposu, *idxlstu,
-      maxsize;
+      maxsize, compact = 0;
   doubleprecision tol, threshold, *prL, *prD, *prUT, mx, val, *pr;
   size_t mrows, ncols;
   double *L_valuesR, *D_valuesR, *UT_valuesR;
@@ -89,8 +96,8 @@ void mexFunction(
       *UT_ja,    /* row indices of input matrix UT        */
       *UT_ia;    /* column pointers of input matrix UT    */
 
-  if (nrhs != 6)
-    mexErrMsgTxt("Six input arguments required.");
+  if (nrhs != 6 && nrhs != 7)
+    mexErrMsgTxt("Six or seven input arguments required.");
   else if (nlhs != 3)
     mexErrMsgTxt("wrong number of output arguments.");
   else if (!mxIsNumeric(prhs[0]))
@@ -105,6 +112,8 @@ void mexFunction(
     mexErrMsgTxt("Fifth input must be a number.");
   else if (!mxIsNumeric(prhs[5]))
     mexErrMsgTxt("Fifth input must be a number.");
+  else if (nrhs > 6 && !mxIsNumeric(prhs[6]) && !mxIsLogical(prhs[6]))
+    mexErrMsgTxt("Seventh input must be a number.");
 
   /* The first input must be a square matrix.*/
   L_input = (mxArray *)prhs[0];
@@ -204,6 +213,8 @@ void mexFunction(
     mexErrMsgTxt("Sixth argument must be number.");
   }
   tol = *mxGetPr(tol_input);
+  if (nrhs > 6)
+    compact = mxGetScalar(prhs[6]) != 0.0;
 #ifdef PRINT_INFO
   mexPrintf("DGNLldu2bldu: input parameter tol imported\n");
   fflush(stdout);
@@ -1008,23 +1019,31 @@ void mexFunction(
 
   } /* end while i<n */
 
-  dims[0] = k;
-  plhs[0] = mxCreateCellArray((mwSize)1, dims);
-  plhs[1] = mxCreateCellArray((mwSize)1, dims);
-  plhs[2] = mxCreateCellArray((mwSize)1, dims);
-  for (m = 0; m < k; m++) {
-    block_column = mxGetCell(BL, (mwIndex)m);
-    mxSetCell(plhs[0], (mwIndex)m, block_column);
-    mxSetCell(BL, (mwIndex)m, NULL);
-
-    block_column = mxGetCell(BD, (mwIndex)m);
-    mxSetCell(plhs[1], (mwIndex)m, block_column);
-    mxSetCell(BD, (mwIndex)m, NULL);
-
-    block_column = mxGetCell(BUT, (mwIndex)m);
-    mxSetCell(plhs[2], (mwIndex)m, block_column);
-    mxSetCell(BUT, (mwIndex)m, NULL);
-  } /* end for m */
+  /* return the blocks. The compact format releases the blocks of BL, BD
+     and BUT as they are stored */
+  if (compact) {
+    plhs[0] = selbinv_pool_from_cell(BL, k, n);
+    plhs[1] = selbinv_pool_from_cell(BD, k, n);
+    plhs[2] = selbinv_pool_from_cell(BUT, k, n);
+  } else {
+    dims[0] = k;
+    plhs[0] = mxCreateCellArray((mwSize)1, dims);
+    plhs[1] = mxCreateCellArray((mwSize)1, dims);
+    plhs[2] = mxCreateCellArray((mwSize)1, dims);
+    for (m = 0; m < k; m++) {
+      block_column = mxGetCell(BL, (mwIndex)m);
+      mxSetCell(plhs[0], (mwIndex)m, block_column);
+      mxSetCell(BL, (mwIndex)m, NULL);
+
+      block_column = mxGetCell(BD, (mwIndex)m);
+      mxSetCell(plhs[1], (mwIndex)m, block_column);
+      mxSetCell(BD, (mwIndex)m, NULL);
+
+      block_column = mxGetCell(BUT, (mwIndex)m);
+      mxSetCell(plhs[2], (mwIndex)m, block_column);
+      mxSetCell(BUT, (mwIndex)m, NULL);
+    } /* end for m */
+  }
 
   /* release memory */
   mxDestroyArray(BL);
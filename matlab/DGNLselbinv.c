@@ -24,6 +24,17 @@
 
     [D, BLinv,BDinv,BUTinv]=DGNLselbinv(BL,BD,BUT,perm, Deltal,Deltar)
 
+    % only compute D=diag(inv(A)), releasing each block of the selective
+    % inverse as soon as the remaining blocks no longer refer to it
+    D=DGNLselbinv(BL,BD,BUT,perm, Deltal,Deltar)
+
+    % BL, BD and BUT may also be given in the compact format returned by
+    % DGNLldu2bldu(L,D,UT,threshold,maxsize,tol,1), see selbinvpool.h.
+    % BLinv, BDinv and BUTinv are then returned in the compact format as
+    % well. The compact blocks are read and BLinv, BDinv, BUTinv are
+    % written in place, without creating a structure per block
+    [D, BLinv,BDinv,BUTinv]=DGNLselbinv(BL,BD,BUT,perm, Deltal,Deltar)
+
 
     Authors:
 
@@ -60,6 +71,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "selbinvstream.h"
+
 #define MAX_FIELDS 100
 #define MAX(A, B) (((A) >= (B)) ? (A) : (B))
 #define MIN(A, B) (((A) >= (B)) ? (B) : (A))
@@ -102,44 +115,56 @@ void mexFunction(
       *prBUTJ, *prBUTI, *prBUTL, *prBUTD, *prBLinvJ, *prBLinvI, *prBLinvL,
       *prBLinvD, *prBLinvJi, *prBLinvIi, *prBLinvLi, *prBLinvDi, *prBUTinvJ,
       *prBUTinvI, *prBUTinvL, *prBUTinvD, *prBUTinvJi, *prBUTinvIi, *prBUTinvLi,
-      *prBUTinvDi;
-  mwIndex *ja, *ia;
+      *prBUTinvDi, *BDinv_D, *BL_buff = NULL, *BUT_buff = NULL,
+      *BLinv_buff = NULL, *BUTinv_buff = NULL, *BD_pr = NULL,
+      **BLinv_val = NULL, **BDinv_val = NULL, **BUTinv_val = NULL;
+  integer *last = NULL, *expired = NULL, n_expired, BL_compact, BD_compact,
+      BUT_compact;
+  selbinv_pool BL_pool, BD_pool, BUT_pool, BLinv_pool, BDinv_pool,
+      BUTinv_pool, *BLinv_store = NULL, *BDinv_store = NULL,
+      *BUTinv_store = NULL;
+  selbinv_index_set BL_J;
+  mwIndex *ja, *ia, *BD_ia = NULL, *BD_ja = NULL;
 
   if (nrhs != 6)
     mexErrMsgTxt("Six input arguments required.");
-  else if (nlhs != 4)
+  else if (nlhs > 1 && nlhs != 4)
     mexErrMsgTxt("wrong number of output arguments.");
 
-  /* The first input must be a cell array.*/
+  /* The first input must be a cell array or compact blocks.*/
   BL = (mxArray *)prhs[0];
-  /* get size of input cell array BL */
-  nblocks = MAX(mxGetM(BL), mxGetN(BL));
+  BL_compact = selbinv_is_pool(BL);
+  if (!mxIsCell(BL) && !BL_compact) {
+    mexErrMsgTxt("First input matrix must be a cell array.");
+  }
+  /* parse BL once and get its number of blocks */
+  selbinv_pool_get(BL, &BL_pool);
+  nblocks = BL_pool.nblocks;
 #ifdef PRINT_CHECK
-  if (mxGetM(BL) != 1 && mxGetN(BL) != 1) {
+  if (!BL_compact && mxGetM(BL) != 1 && mxGetN(BL) != 1) {
     mexPrintf("!!!BL must be a 1-dim. cell array!!!\n");
     fflush(stdout);
   }
 #endif
-  if (!mxIsCell(BL)) {
-    mexErrMsgTxt("First input matrix must be a cell array.");
-  }
 #ifdef PRINT_INFO
   mexPrintf("DGNLselbinv: input parameter BL imported\n");
   fflush(stdout);
 #endif
 
-  /* The second input must be a cell array as well.*/
+  /* The second input must be a cell array or compact blocks as well.*/
   BD = (mxArray *)prhs[1];
-  if (!mxIsCell(BD)) {
+  BD_compact = selbinv_is_pool(BD);
+  if (!mxIsCell(BD) && !BD_compact) {
     mexErrMsgTxt("Second input matrix must be a cell array.");
   }
   /* get size of input matrix BD */
-  if (MAX(mxGetM(BD), mxGetN(BD)) != nblocks) {
+  selbinv_pool_get(BD, &BD_pool);
+  if (BD_pool.nblocks != nblocks) {
     mexErrMsgTxt(
         "Second input must be a cell array of same size as the first input.");
   }
 #ifdef PRINT_CHECK
-  if (mxGetM(BD) != 1 && mxGetN(BD) != 1) {
+  if (!BD_compact && mxGetM(BD) != 1 && mxGetN(BD) != 1) {
     mexPrintf("!!!BD must be a 1-dim. cell array!!!\n");
     fflush(stdout);
   }
@@ -149,15 +174,20 @@ void mexFunction(
   fflush(stdout);
 #endif
 
-  /* The third input must be a cell array.*/
+  /* The third input must be a cell array or compact blocks.*/
   BUT = (mxArray *)prhs[2];
+  BUT_compact = selbinv_is_pool(BUT);
+  if (!mxIsCell(BUT) && !BUT_compact) {
+    mexErrMsgTxt("Third input matrix must be a cell array.");
+  }
   /* get size of input matrix BUT */
-  if (MAX(mxGetM(BUT), mxGetN(BUT)) != nblocks) {
+  selbinv_pool_get(BUT, &BUT_pool);
+  if (BUT_pool.nblocks != nblocks) {
     mexErrMsgTxt(
         "Third input must be a cell array of same size as the first input.");
   }
 #ifdef PRINT_CHECK
-  if (mxGetM(BUT) != 1 && mxGetN(BUT) != 1) {
+  if (!BUT_compact && mxGetM(BUT) != 1 && mxGetN(BUT) != 1) {
     mexPrintf("!!!BUT must be a 1-dim. cell array!!!\n");
     fflush(stdout);
   }
@@ -232,14 +262,59 @@ void mexFunction(
   fflush(stdout);
 #endif
 
-  /* create output cell array BLinv, BDinv, BUTinv of length "nblocks" */
-  dims[0] = nblocks;
-  plhs[1] = mxCreateCellArray((mwSize)1, dims);
-  BLinv = plhs[1];
-  plhs[2] = mxCreateCellArray((mwSize)1, dims);
-  BDinv = plhs[2];
-  plhs[3] = mxCreateCellArray((mwSize)1, dims);
-  BUTinv = plhs[3];
+  /* create output cell array BLinv, BDinv, BUTinv of length "nblocks". If
+     only D is requested, they are temporary and their blocks are released
+     early. For compact input blocks, the values of BLinv{k}, BDinv{k},
+     BUTinv{k} are written in place into the compact output, or into plain
+     arrays if only D is requested, and BLinv_val[k], BDinv_val[k],
+     BUTinv_val[k] refer to them */
+  if (!BL_compact) {
+    dims[0] = nblocks;
+    BLinv = mxCreateCellArray((mwSize)1, dims);
+    BDinv = mxCreateCellArray((mwSize)1, dims);
+    BUTinv = mxCreateCellArray((mwSize)1, dims);
+    if (nlhs > 1) {
+      plhs[1] = BLinv;
+      plhs[2] = BDinv;
+      plhs[3] = BUTinv;
+    }
+  } else {
+    if (nlhs > 1) {
+      plhs[1] = selbinv_pool_create(&BL_pool, nblocks, n, 1, &BLinv_pool);
+      plhs[2] = selbinv_pool_create(&BL_pool, nblocks, n, 0, &BDinv_pool);
+      plhs[3] = selbinv_pool_create(&BUT_pool, nblocks, n, 1, &BUTinv_pool);
+      BLinv_store = &BLinv_pool;
+      BDinv_store = &BDinv_pool;
+      BUTinv_store = &BUTinv_pool;
+    }
+    BLinv_val = (double **)CAlloc((size_t)nblocks, sizeof(double *),
+                                  "DGNLselbinv:BLinv_val");
+    BDinv_val = (double **)CAlloc((size_t)nblocks, sizeof(double *),
+                                  "DGNLselbinv:BDinv_val");
+    BUTinv_val = (double **)CAlloc((size_t)nblocks, sizeof(double *),
+                                   "DGNLselbinv:BUTinv_val");
+    /* index sets of BLinv{i} and BUTinv{i} converted to double */
+    BLinv_buff = (double *)MAlloc((size_t)(n + 1) * sizeof(double),
+                                  "DGNLselbinv:BLinv_buff");
+    BUTinv_buff = (double *)MAlloc((size_t)(n + 1) * sizeof(double),
+                                   "DGNLselbinv:BUTinv_buff");
+  }
+  /* index sets of compact BL{k} and BUT{k} converted to double */
+  if (BL_compact)
+    BL_buff = (double *)MAlloc((size_t)(n + 1) * sizeof(double),
+                               "DGNLselbinv:BL_buff");
+  if (BUT_compact)
+    BUT_buff = (double *)MAlloc((size_t)(n + 1) * sizeof(double),
+                                "DGNLselbinv:BUT_buff");
+  /* diagonal of compact BD{k}.D */
+  if (BD_compact) {
+    BD_ia = (mwIndex *)MAlloc((size_t)(n + 1) * sizeof(mwIndex),
+                              "DGNLselbinv:BD_ia");
+    BD_ja = (mwIndex *)MAlloc((size_t)(2 * n) * sizeof(mwIndex),
+                              "DGNLselbinv:BD_ja");
+    BD_pr = (double *)MAlloc((size_t)(2 * n) * sizeof(double),
+                             "DGNLselbinv:BD_pr");
+  }
 
   /* auxiliary arrays for inverting diagonal blocks using dsytri_ */
   ipiv = (integer *)MAlloc((size_t)n * sizeof(integer), "DGNLselbinv:ipiv");
@@ -257,39 +332,51 @@ void mexFunction(
   /* inverse mapping index -> block number */
   block = (integer *)CAlloc((size_t)n, sizeof(integer), "DGNLselbinv:block");
   for (i = 0; i < nblocks; i++) {
-    BL_block = mxGetCell(BL, i);
-    if (!mxIsStruct(BL_block))
-      mexErrMsgTxt("Field BL{i} must be a structure.");
-    BL_blockJ = mxGetField(BL_block, 0, "J");
-    if (BL_blockJ == NULL)
-      mexErrMsgTxt("Field BL{i}.J does not exist.");
-    if (!mxIsNumeric(BL_blockJ))
-      mexErrMsgTxt("Field BL{i}.J must be numerical.");
-    n_size = mxGetN(BL_blockJ) * mxGetM(BL_blockJ);
+    if (BL_compact) {
+      selbinv_index_set_get(&BL_pool, i, SELBINV_J, &BL_J);
+      for (k = 0; k < (integer)BL_J.size; k++) {
+        j = selbinv_index_set_entry(&BL_J, (mwSize)k);
+        if (j < 1 || j > n)
+          mexErrMsgTxt("Index of BL{i}.J out of range.");
+        block[j - 1] = i;
+      }
+    } else {
+      BL_block = mxGetCell(BL, i);
+      if (!mxIsStruct(BL_block))
+        mexErrMsgTxt("Field BL{i} must be a structure.");
+      BL_blockJ = mxGetField(BL_block, 0, "J");
+      if (BL_blockJ == NULL)
+        mexErrMsgTxt("Field BL{i}.J does not exist.");
+      if (!mxIsNumeric(BL_blockJ))
+        mexErrMsgTxt("Field BL{i}.J must be numerical.");
+      n_size = mxGetN(BL_blockJ) * mxGetM(BL_blockJ);
 #ifdef PRINT_CHECK
-    if (mxGetM(BL_blockJ) != 1 && mxGetN(BL_blockJ) != 1) {
-      mexPrintf("!!!BL{%d}.J must be a 1-dim. array!!!\n", i + 1);
-      fflush(stdout);
-    }
+      if (mxGetM(BL_blockJ) != 1 && mxGetN(BL_blockJ) != 1) {
+        mexPrintf("!!!BL{%d}.J must be a 1-dim. array!!!\n", i + 1);
+        fflush(stdout);
+      }
 #endif
-    prBLJ = (double *)mxGetPr(BL_blockJ);
-    for (k = 0; k < n_size; k++) {
-      j = *prBLJ++;
+      prBLJ = (double *)mxGetPr(BL_blockJ);
+      for (k = 0; k < n_size; k++) {
+        j = *prBLJ++;
 /* remember that the structure stores indices from 1,...,n */
 #ifdef PRINT_CHECK
-      if (j < 1 || j > n) {
-        mexPrintf("!!!index %d=BL{%d}.J(%d) out of range!!!\n", j, i + 1,
-                  k + 1);
-        fflush(stdout);
-      }
-      if (block[j - 1] != 0) {
-        mexPrintf("!!!block[%d]=%d nonzero!!!\n", j, block[j - 1] + 1);
-        fflush(stdout);
-      }
+        if (j < 1 || j > n) {
+          mexPrintf("!!!index %d=BL{%d}.J(%d) out of range!!!\n", j, i + 1,
+                    k + 1);
+          fflush(stdout);
+        }
+        if (block[j - 1] != 0) {
+          mexPrintf("!!!block[%d]=%d nonzero!!!\n", j, block[j - 1] + 1);
+          fflush(stdout);
+        }
 #endif
-      block[j - 1] = i;
-    } /* end for k */
+        block[j - 1] = i;
+      } /* end for k */
+    }
 
+    if (BUT_compact)
+      continue;
     BUT_block = mxGetCell(BUT, i);
     if (!mxIsStruct(BUT_block))
       mexErrMsgTxt("Field BUT{i} must be a structure.");
@@ -328,162 +415,211 @@ void mexFunction(
   fflush(stdout);
 #endif
 
+  /* last block that reads each block of BLinv, BDinv, BUTinv */
+  if (nlhs < 2) {
+    last = (integer *)MAlloc((size_t)nblocks * sizeof(integer),
+                             "DGNLselbinv:last");
+    expired = (integer *)MAlloc((size_t)nblocks * sizeof(integer),
+                                "DGNLselbinv:expired");
+    selbinv_last_use(&BL_pool, &BUT_pool, nblocks, block, last);
+  }
+
   /* start selective block inversion from the back */
   k = nblocks - 1;
 
-  /* extract BL{k} */
-  BL_block = mxGetCell(BL, k);
+  /* extract BL{k}, compact blocks are read in place */
+  if (BL_compact) {
+    prBLJ = selbinv_index_set_pr(&BL_pool, k, SELBINV_J, BL_buff, &n_size);
+    prBLD = selbinv_pool_values(&BL_pool, k, SELBINV_D);
+  } else {
+    BL_block = mxGetCell(BL, k);
 
-  /* extract source BL{k}.J */
-  BL_blockJ = mxGetField(BL_block, 0, "J");
-  n_size = mxGetN(BL_blockJ) * mxGetM(BL_blockJ);
-  prBLJ = (double *)mxGetPr(BL_blockJ);
+    /* extract source BL{k}.J */
+    BL_blockJ = mxGetField(BL_block, 0, "J");
+    n_size = mxGetN(BL_blockJ) * mxGetM(BL_blockJ);
+    prBLJ = (double *)mxGetPr(BL_blockJ);
 
-  /* BL{k}.I and BL{k}.L should be empty */
+    /* BL{k}.I and BL{k}.L should be empty */
+
+    /* extract source BL{k}.D */
+    BL_blockD = mxGetField(BL_block, 0, "D");
+    if (BL_blockD == NULL)
+      mexErrMsgTxt("Field BL{k}.D does not exist.");
+    if (mxGetN(BL_blockD) != n_size || mxGetM(BL_blockD) != n_size ||
+        !mxIsNumeric(BL_blockD))
+      mexErrMsgTxt(
+          "Field BL{k}.D must be square dense matrix of same size as BL{k}.J.");
+    /* numerical values of BL{k}.D */
+    prBLD = (double *)mxGetPr(BL_blockD);
+  }
+
+  /* extract BD{k}, the diagonal of compact blocks is read from their dense
+     values */
+  if (BD_compact) {
+    if (BD_pool.ind_ptr[2 * k + 1] - BD_pool.ind_ptr[2 * k] != n_size)
+      mexErrMsgTxt("Field BD{k}.D must be of same size as BL{k}.J.");
+    selbinv_pool_pivots(&BD_pool, k, BD_ia, BD_ja, BD_pr);
+    ia = BD_ia;
+    ja = BD_ja;
+    prBDD = BD_pr;
+  } else {
+    BD_block = mxGetCell(BD, k);
+    if (!mxIsStruct(BD_block))
+      mexErrMsgTxt("Field BD{k} must be a structure.");
+
+    /* extract source BD{k}.D */
+    BD_blockD = mxGetField(BD_block, 0, "D");
+    if (BD_blockD == NULL)
+      mexErrMsgTxt("Field BD{k}.D does not exist.");
+    if (mxGetN(BD_blockD) != n_size || mxGetM(BD_blockD) != n_size ||
+        !mxIsSparse(BD_blockD))
+      mexErrMsgTxt("Field BD{k}.D must be square sparse matrix of same size "
+                   "as BL{k}.J.");
+    /* sparse representation of BD{k}.D */
+    ia = (mwIndex *)mxGetJc(BD_blockD);
+    ja = (mwIndex *)mxGetIr(BD_blockD);
+    prBDD = (double *)mxGetPr(BD_blockD);
+  }
+
+  /* extract BUT{k}, compact blocks are read in place */
+  if (BUT_compact) {
+    prBUTJ = selbinv_index_set_pr(&BUT_pool, k, SELBINV_J, BUT_buff, &n_size);
+    prBUTD = selbinv_pool_values(&BUT_pool, k, SELBINV_D);
+  } else {
+    BUT_block = mxGetCell(BUT, k);
+
+    /* extract source BUT{k}.J */
+    BUT_blockJ = mxGetField(BUT_block, 0, "J");
+    n_size = mxGetN(BUT_blockJ) * mxGetM(BUT_blockJ);
+    prBUTJ = (double *)mxGetPr(BUT_blockJ);
+
+    /* BUT{k}.I and BUT{k}.L should be empty */
+
+    /* extract source BUT{k}.D */
+    BUT_blockD = mxGetField(BUT_block, 0, "D");
+    if (BUT_blockD == NULL)
+      mexErrMsgTxt("Field BUT{k}.D does not exist.");
+    if (mxGetN(BUT_blockD) != n_size || mxGetM(BUT_blockD) != n_size ||
+        !mxIsNumeric(BUT_blockD))
+      mexErrMsgTxt("Field BUT{k}.D must be square dense matrix of same size "
+                   "as BUT{k}.J.");
+    /* numerical values of BUT{k}.D */
+    prBUTD = (double *)mxGetPr(BUT_blockD);
+  }
 
-  /* extract source BL{k}.D */
-  BL_blockD = mxGetField(BL_block, 0, "D");
-  if (BL_blockD == NULL)
-    mexErrMsgTxt("Field BL{k}.D does not exist.");
-  if (mxGetN(BL_blockD) != n_size || mxGetM(BL_blockD) != n_size ||
-      !mxIsNumeric(BL_blockD))
-    mexErrMsgTxt(
-        "Field BL{k}.D must be square dense matrix of same size as BL{k}.J.");
-  /* numerical values of BL{k}.D */
-  prBLD = (double *)mxGetPr(BL_blockD);
-
-  /* extract BD{k} */
-  BD_block = mxGetCell(BD, k);
-  if (!mxIsStruct(BD_block))
-    mexErrMsgTxt("Field BD{k} must be a structure.");
-
-  /* extract source BD{k}.D */
-  BD_blockD = mxGetField(BD_block, 0, "D");
-  if (BD_blockD == NULL)
-    mexErrMsgTxt("Field BD{k}.D does not exist.");
-  if (mxGetN(BD_blockD) != n_size || mxGetM(BD_blockD) != n_size ||
-      !mxIsSparse(BD_blockD))
-    mexErrMsgTxt(
-        "Field BD{k}.D must be square sparse matrix of same size as BL{k}.J.");
-  /* sparse representation of BD{k}.D */
-  ia = (mwIndex *)mxGetJc(BD_blockD);
-  ja = (mwIndex *)mxGetIr(BD_blockD);
-  prBDD = (double *)mxGetPr(BD_blockD);
-
-  /* extract BUT{k} */
-  BUT_block = mxGetCell(BUT, k);
-
-  /* extract source BUT{k}.J */
-  BUT_blockJ = mxGetField(BUT_block, 0, "J");
-  n_size = mxGetN(BUT_blockJ) * mxGetM(BUT_blockJ);
-  prBUTJ = (double *)mxGetPr(BUT_blockJ);
-
-  /* BUT{k}.I and BUT{k}.L should be empty */
-
-  /* extract source BUT{k}.D */
-  BUT_blockD = mxGetField(BUT_block, 0, "D");
-  if (BUT_blockD == NULL)
-    mexErrMsgTxt("Field BUT{k}.D does not exist.");
-  if (mxGetN(BUT_blockD) != n_size || mxGetM(BUT_blockD) != n_size ||
-      !mxIsNumeric(BUT_blockD))
-    mexErrMsgTxt(
-        "Field BUT{k}.D must be square dense matrix of same size as BUT{k}.J.");
-  /* numerical values of BUT{k}.D */
-  prBUTD = (double *)mxGetPr(BUT_blockD);
-
-  /* set up new block column for BLinv{k} with four elements J, I, L, D */
-  BLinv_block = mxCreateStructMatrix((mwSize)1, (mwSize)1, 4, BLnames);
-
-  /* structure element 0:  J */
-  /* create BLinv{k}.J */
-  BLinv_blockJ = mxCreateDoubleMatrix((mwSize)1, (mwSize)n_size, mxREAL);
-  /* copy data */
-  prBLinvJ = (double *)mxGetPr(BLinv_blockJ);
-  memcpy(prBLinvJ, prBLJ, (size_t)n_size * sizeof(double));
-  /* set each field in BLinv_block structure */
-  mxSetFieldByNumber(BLinv_block, (mwIndex)0, 0, BLinv_blockJ);
-
-  /* structure element 1:  I */
-  /* create empty BLinv{k}.I */
   ml_size = 0;
-  BLinv_blockI = mxCreateDoubleMatrix((mwSize)1, (mwSize)ml_size, mxREAL);
-  /* set each field in BLinv_block structure */
-  mxSetFieldByNumber(BLinv_block, (mwIndex)0, 1, BLinv_blockI);
-
-  /* structure element 2:  L */
-  /* create empty BLinv{k}.L */
-  BLinv_blockL = mxCreateDoubleMatrix((mwSize)ml_size, (mwSize)n_size, mxREAL);
-  /* set each field in BLinv_block structure */
-  mxSetFieldByNumber(BLinv_block, (mwIndex)0, 2, BLinv_blockL);
-
-  /* structure element 3:  D */
-  /* create empty sparse n_size x n_size matrix BLinv{k}.D */
-  BLinv_blockD =
-      mxCreateSparse((mwSize)n_size, (mwSize)n_size, (mwSize)0, mxREAL);
-  /* set each field in BLinv_block structure */
-  mxSetFieldByNumber(BLinv_block, (mwIndex)0, 3, BLinv_blockD);
-
-  /* set up new block column for BUTinv{k} with four elements J, I, L, D */
-  BUTinv_block = mxCreateStructMatrix((mwSize)1, (mwSize)1, 4, BLnames);
-
-  /* structure element 0:  J */
-  /* create BUTinv{k}.J */
-  BUTinv_blockJ = mxCreateDoubleMatrix((mwSize)1, (mwSize)n_size, mxREAL);
-  /* copy data */
-  prBUTinvJ = (double *)mxGetPr(BUTinv_blockJ);
-  memcpy(prBUTinvJ, prBUTJ, (size_t)n_size * sizeof(double));
-  /* set each field in BUTinv_block structure */
-  mxSetFieldByNumber(BUTinv_block, (mwIndex)0, 0, BUTinv_blockJ);
-
-  /* structure element 1:  I */
-  /* create empty BUTinv{k}.I */
   mut_size = 0;
-  BUTinv_blockI = mxCreateDoubleMatrix((mwSize)1, (mwSize)mut_size, mxREAL);
-  /* set each field in BUTinv_block structure */
-  mxSetFieldByNumber(BUTinv_block, (mwIndex)0, 1, BUTinv_blockI);
-
-  /* structure element 2:  L */
-  /* create empty BUTinv{k}.L */
-  BUTinv_blockL =
-      mxCreateDoubleMatrix((mwSize)mut_size, (mwSize)n_size, mxREAL);
-  /* set each field in BUTinv_block structure */
-  mxSetFieldByNumber(BUTinv_block, (mwIndex)0, 2, BUTinv_blockL);
-
-  /* structure element 3:  D */
-  /* create empty sparse n_size x n_size matrix BUTinv{k}.D */
-  BUTinv_blockD =
-      mxCreateSparse((mwSize)n_size, (mwSize)n_size, (mwSize)0, mxREAL);
-  /* set each field in BUTinv_block structure */
-  mxSetFieldByNumber(BUTinv_block, (mwIndex)0, 3, BUTinv_blockD);
-
-  /* set up new block column for BDinv{k} with four elements J, I, L, D */
-  BDinv_block = mxCreateStructMatrix((mwSize)1, (mwSize)1, 4, BLnames);
-
-  /* structure element 0:  J */
-  /* create BDinv{k}.J */
-  BDinv_blockJ = mxCreateDoubleMatrix((mwSize)1, (mwSize)n_size, mxREAL);
-  /* copy data from BL{k} */
-  prBDinvJ = (double *)mxGetPr(BDinv_blockJ);
-  memcpy(prBDinvJ, prBLJ, (size_t)n_size * sizeof(double));
-  /* set each field in BDinv_block structure */
-  mxSetFieldByNumber(BDinv_block, (mwIndex)0, 0, BDinv_blockJ);
-
-  /* structure element 1:  I */
-  /* create empty BDinv{k}.I */
-  BDinv_blockI = mxCreateDoubleMatrix((mwSize)1, (mwSize)0, mxREAL);
-  /* set each field in BDinv_block structure */
-  mxSetFieldByNumber(BDinv_block, (mwIndex)0, 1, BDinv_blockI);
-
-  /* structure element 2:  L */
-  /* create empty BDinv{k}.L */
-  BDinv_blockL = mxCreateDoubleMatrix((mwSize)0, (mwSize)n_size, mxREAL);
-  /* set each field in BDinv_block structure */
-  mxSetFieldByNumber(BDinv_block, (mwIndex)0, 2, BDinv_blockL);
-
-  /* structure element 3:  D */
-  /* create dense n_size x n_size matrix BDinv{k}.D */
-  BDinv_blockD = mxCreateDoubleMatrix((mwSize)n_size, (mwSize)n_size, mxREAL);
-  prBDinvD = (double *)mxGetPr(BDinv_blockD);
+  if (BL_compact) {
+    /* BLinv{k}, BUTinv{k} and BDinv{k} have the index sets of BL{k} and
+       BUT{k}. Only the values of BDinv{k}.D are computed, they are written
+       in place into the compact output or into a plain array */
+    prBLinvJ = prBLJ;
+    prBUTinvJ = prBUTJ;
+    prBDinvJ = prBLJ;
+    BLinv_val[k] = selbinv_values(BLinv_store, k, SELBINV_L, 0,
+                                  "DGNLselbinv:BLinv_val");
+    BUTinv_val[k] = selbinv_values(BUTinv_store, k, SELBINV_L, 0,
+                                   "DGNLselbinv:BUTinv_val");
+    BDinv_val[k] = selbinv_values(BDinv_store, k, SELBINV_D,
+                                  (size_t)(n_size * n_size),
+                                  "DGNLselbinv:BDinv_val");
+    BDinv_D = BDinv_val[k];
+  } else {
+    /* set up new block column for BLinv{k} with four elements J, I, L, D */
+    BLinv_block = mxCreateStructMatrix((mwSize)1, (mwSize)1, 4, BLnames);
+
+    /* structure element 0:  J */
+    /* create BLinv{k}.J */
+    BLinv_blockJ = mxCreateDoubleMatrix((mwSize)1, (mwSize)n_size, mxREAL);
+    /* copy data */
+    prBLinvJ = (double *)mxGetPr(BLinv_blockJ);
+    memcpy(prBLinvJ, prBLJ, (size_t)n_size * sizeof(double));
+    /* set each field in BLinv_block structure */
+    mxSetFieldByNumber(BLinv_block, (mwIndex)0, 0, BLinv_blockJ);
+
+    /* structure element 1:  I */
+    /* create empty BLinv{k}.I */
+    BLinv_blockI = mxCreateDoubleMatrix((mwSize)1, (mwSize)ml_size, mxREAL);
+    /* set each field in BLinv_block structure */
+    mxSetFieldByNumber(BLinv_block, (mwIndex)0, 1, BLinv_blockI);
+
+    /* structure element 2:  L */
+    /* create empty BLinv{k}.L */
+    BLinv_blockL =
+        mxCreateDoubleMatrix((mwSize)ml_size, (mwSize)n_size, mxREAL);
+    /* set each field in BLinv_block structure */
+    mxSetFieldByNumber(BLinv_block, (mwIndex)0, 2, BLinv_blockL);
+
+    /* structure element 3:  D */
+    /* create empty sparse n_size x n_size matrix BLinv{k}.D */
+    BLinv_blockD =
+        mxCreateSparse((mwSize)n_size, (mwSize)n_size, (mwSize)0, mxREAL);
+    /* set each field in BLinv_block structure */
+    mxSetFieldByNumber(BLinv_block, (mwIndex)0, 3, BLinv_blockD);
+
+    /* set up new block column for BUTinv{k} with four elements J, I, L, D */
+    BUTinv_block = mxCreateStructMatrix((mwSize)1, (mwSize)1, 4, BLnames);
+
+    /* structure element 0:  J */
+    /* create BUTinv{k}.J */
+    BUTinv_blockJ = mxCreateDoubleMatrix((mwSize)1, (mwSize)n_size, mxREAL);
+    /* copy data */
+    prBUTinvJ = (double *)mxGetPr(BUTinv_blockJ);
+    memcpy(prBUTinvJ, prBUTJ, (size_t)n_size * sizeof(double));
+    /* set each field in BUTinv_block structure */
+    mxSetFieldByNumber(BUTinv_block, (mwIndex)0, 0, BUTinv_blockJ);
+
+    /* structure element 1:  I */
+    /* create empty BUTinv{k}.I */
+    BUTinv_blockI = mxCreateDoubleMatrix((mwSize)1, (mwSize)mut_size, mxREAL);
+    /* set each field in BUTinv_block structure */
+    mxSetFieldByNumber(BUTinv_block, (mwIndex)0, 1, BUTinv_blockI);
+
+    /* structure element 2:  L */
+    /* create empty BUTinv{k}.L */
+    BUTinv_blockL =
+        mxCreateDoubleMatrix((mwSize)mut_size, (mwSize)n_size, mxREAL);
+    /* set each field in BUTinv_block structure */
+    mxSetFieldByNumber(BUTinv_block, (mwIndex)0, 2, BUTinv_blockL);
+
+    /* structure element 3:  D */
+    /* create empty sparse n_size x n_size matrix BUTinv{k}.D */
+    BUTinv_blockD =
+        mxCreateSparse((mwSize)n_size, (mwSize)n_size, (mwSize)0, mxREAL);
+    /* set each field in BUTinv_block structure */
+    mxSetFieldByNumber(BUTinv_block, (mwIndex)0, 3, BUTinv_blockD);
+
+    /* set up new block column for BDinv{k} with four elements J, I, L, D */
+    BDinv_block = mxCreateStructMatrix((mwSize)1, (mwSize)1, 4, BLnames);
+
+    /* structure element 0:  J */
+    /* create BDinv{k}.J */
+    BDinv_blockJ = mxCreateDoubleMatrix((mwSize)1, (mwSize)n_size, mxREAL);
+    /* copy data from BL{k} */
+    prBDinvJ = (double *)mxGetPr(BDinv_blockJ);
+    memcpy(prBDinvJ, prBLJ, (size_t)n_size * sizeof(double));
+    /* set each field in BDinv_block structure */
+    mxSetFieldByNumber(BDinv_block, (mwIndex)0, 0, BDinv_blockJ);
+
+    /* structure element 1:  I */
+    /* create empty BDinv{k}.I */
+    BDinv_blockI = mxCreateDoubleMatrix((mwSize)1, (mwSize)0, mxREAL);
+    /* set each field in BDinv_block structure */
+    mxSetFieldByNumber(BDinv_block, (mwIndex)0, 1, BDinv_blockI);
+
+    /* structure element 2:  L */
+    /* create empty BDinv{k}.L */
+    BDinv_blockL = mxCreateDoubleMatrix((mwSize)0, (mwSize)n_size, mxREAL);
+    /* set each field in BDinv_block structure */
+    mxSetFieldByNumber(BDinv_block, (mwIndex)0, 2, BDinv_blockL);
+
+    /* structure element 3:  D */
+    /* create dense n_size x n_size matrix BDinv{k}.D */
+    BDinv_blockD =
+        mxCreateDoubleMatrix((mwSize)n_size, (mwSize)n_size, mxREAL);
+    BDinv_D = (double *)mxGetPr(BDinv_blockD);
+  }
+  prBDinvD = BDinv_D;
   /* copy strict upper triangular part from BUT{k}.D column to row + diagonal
    * part from BD{k}.D */
   for (j = 0; j < n_size; j++) {
@@ -508,7 +644,7 @@ void mexFunction(
     prBDD++;
   } /* end for j */
 
-  prBDinvD = (double *)mxGetPr(BDinv_blockD);
+  prBDinvD = BDinv_D;
   /* copy lower triangular part from BL{k}.D column by column */
   for (j = 0; j < n_size; j++) {
     /* advance BDinv{k}.D, BL{k}.D to their strict lower triangular part of
@@ -522,7 +658,7 @@ void mexFunction(
 #ifdef PRINT_INFO
   mexPrintf("DGNLselbinv: final triangular factorization copied\n");
   fflush(stdout);
-  prBDinvD = (double *)mxGetPr(BDinv_blockD);
+  prBDinvD = BDinv_D;
   mexPrintf("        ");
   for (j = 0; j < n_size; j++)
     mexPrintf("%8d", ipiv[j]);
@@ -543,7 +679,7 @@ void mexFunction(
 #endif
 
   /* use LAPACK's dgetri_ for matrix inversion given the LDU decompositon */
-  prBDinvD = (double *)mxGetPr(BDinv_blockD);
+  prBDinvD = BDinv_D;
   j = 0;
   dgetri_(&n_size, prBDinvD, &n_size, ipiv, work, &n, &j);
   if (j < 0) {
@@ -559,7 +695,7 @@ void mexFunction(
 #ifdef PRINT_INFO
   mexPrintf("DGNLselbinv: final inverse diagonal block computed\n");
   fflush(stdout);
-  prBDinvD = (double *)mxGetPr(BDinv_blockD);
+  prBDinvD = BDinv_D;
   mexPrintf("        ");
   for (j = 0; j < n_size; j++)
     mexPrintf("%8d", (integer)prBLinvJ[j]);
@@ -577,7 +713,7 @@ void mexFunction(
   /* successively downdate "n" by the size "n_size" of the diagonal block */
   sumn = n - n_size;
   /* extract diagonal entries  */
-  prBDinvD = (double *)mxGetPr(BDinv_blockD);
+  prBDinvD = BDinv_D;
   for (j = 0; j < n_size; j++) {
     Dbuff[sumn + j] = *prBDinvD;
     /* advance to the diagonal part of column j+1 */
@@ -592,7 +728,7 @@ void mexFunction(
   fflush(stdout);
   mexPrintf("DGNLselbinv: final inverse diagonal block computed\n");
   fflush(stdout);
-  prBDinvD = (double *)mxGetPr(BDinv_blockD);
+  prBDinvD = BDinv_D;
   mexPrintf("        ");
   for (j = 0; j < n_size; j++)
     mexPrintf("%8d", (integer)prBLinvJ[j]);
@@ -607,13 +743,27 @@ void mexFunction(
   }
 #endif
 
-  /* set each field in BDinv_block structure */
-  mxSetFieldByNumber(BDinv_block, (mwIndex)0, 3, BDinv_blockD);
+  if (!BL_compact) {
+    /* set each field in BDinv_block structure */
+    mxSetFieldByNumber(BDinv_block, (mwIndex)0, 3, BDinv_blockD);
 
-  /* finally set output BLinv{k}, BDinv{k}, BUTinv{k} */
-  mxSetCell(BLinv, (mwIndex)k, BLinv_block);
-  mxSetCell(BDinv, (mwIndex)k, BDinv_block);
-  mxSetCell(BUTinv, (mwIndex)k, BUTinv_block);
+    /* finally set output BLinv{k}, BDinv{k}, BUTinv{k} */
+    mxSetCell(BLinv, (mwIndex)k, BLinv_block);
+    mxSetCell(BDinv, (mwIndex)k, BDinv_block);
+    mxSetCell(BUTinv, (mwIndex)k, BUTinv_block);
+  }
+  if (last != NULL) {
+    n_expired = selbinv_expired(&BL_pool, &BUT_pool, k, block, last, expired);
+    if (BL_compact) {
+      selbinv_release_values(BLinv_val, expired, n_expired);
+      selbinv_release_values(BDinv_val, expired, n_expired);
+      selbinv_release_values(BUTinv_val, expired, n_expired);
+    } else {
+      selbinv_release(BLinv, expired, n_expired);
+      selbinv_release(BDinv, expired, n_expired);
+      selbinv_release(BUTinv, expired, n_expired);
+    }
+  }
 
   /* advance backwards toward the top */
   k--;
@@ -621,209 +771,253 @@ void mexFunction(
   /* main loop */
   while (k >= 0) {
 
-    /* extract BL{k} */
-    BL_block = mxGetCell(BL, k);
-
-    /* 1. BL{k}.J */
-    BL_blockJ = mxGetField(BL_block, 0, "J");
-    n_size = mxGetN(BL_blockJ) * mxGetM(BL_blockJ);
-    prBLJ = (double *)mxGetPr(BL_blockJ);
-
-    /* 2. BL{k}.I */
-    BL_blockI = mxGetField(BL_block, 0, "I");
-    if (BL_blockI == NULL)
-      mexErrMsgTxt("Field BL{k}.I does not exist.");
-    ml_size = mxGetN(BL_blockI) * mxGetM(BL_blockI);
+    /* extract BL{k}, compact blocks are read in place */
+    if (BL_compact) {
+      prBLJ = selbinv_index_set_pr(&BL_pool, k, SELBINV_J, BL_buff, &n_size);
+      prBLI = selbinv_index_set_pr(&BL_pool, k, SELBINV_I, BL_buff + n_size,
+                                   &ml_size);
+      prBLL = selbinv_pool_values(&BL_pool, k, SELBINV_L);
+      prBLD = selbinv_pool_values(&BL_pool, k, SELBINV_D);
+    } else {
+      BL_block = mxGetCell(BL, k);
+
+      /* 1. BL{k}.J */
+      BL_blockJ = mxGetField(BL_block, 0, "J");
+      n_size = mxGetN(BL_blockJ) * mxGetM(BL_blockJ);
+      prBLJ = (double *)mxGetPr(BL_blockJ);
+
+      /* 2. BL{k}.I */
+      BL_blockI = mxGetField(BL_block, 0, "I");
+      if (BL_blockI == NULL)
+        mexErrMsgTxt("Field BL{k}.I does not exist.");
+      ml_size = mxGetN(BL_blockI) * mxGetM(BL_blockI);
 #ifdef PRINT_CHECK
-    if (mxGetM(BL_blockI) != 1 && mxGetN(BL_blockI) != 1) {
-      mexPrintf("!!!BL{%d}.I must be a 1-dim. array!!!\n", k + 1);
-      fflush(stdout);
-    }
+      if (mxGetM(BL_blockI) != 1 && mxGetN(BL_blockI) != 1) {
+        mexPrintf("!!!BL{%d}.I must be a 1-dim. array!!!\n", k + 1);
+        fflush(stdout);
+      }
 #endif
-    prBLI = (double *)mxGetPr(BL_blockI);
-
-    /* 3. BL{k}.L, dense rectangular matrix ass. with I,J */
-    BL_blockL = mxGetField(BL_block, 0, "L");
-    if (BL_blockL == NULL)
-      mexErrMsgTxt("Field BL{k}.L does not exist.");
-    /* numerical values of BL{k}.L */
-    prBLL = (double *)mxGetPr(BL_blockL);
-
-    /* 4. BL{k}.D, lower unit triangular matrix */
-    BL_blockD = mxGetField(BL_block, 0, "D");
-    if (BL_blockD == NULL)
-      mexErrMsgTxt("Field BL{k}.D does not exist.");
-    if (mxGetN(BL_blockD) != n_size || mxGetM(BL_blockD) != n_size ||
-        !mxIsNumeric(BL_blockD))
-      mexErrMsgTxt(
-          "Field BL{k}.D must be square dense matrix of same size as BL{k}.J.");
-    /* numerical values of BL{k}.D */
-    prBLD = (double *)mxGetPr(BL_blockD);
-
-    /* extract BD{k} */
-    BD_block = mxGetCell(BD, k);
-    if (!mxIsStruct(BD_block))
-      mexErrMsgTxt("Field BD{k} must be a structure.");
-
-    /* extract source BD{k}.D, sparse diagonal matrix */
-    BD_blockD = mxGetField(BD_block, 0, "D");
-    if (BD_blockD == NULL)
-      mexErrMsgTxt("Field BD{k}.D does not exist.");
-    if (mxGetN(BD_blockD) != n_size || mxGetM(BD_blockD) != n_size ||
-        !mxIsSparse(BD_blockD))
-      mexErrMsgTxt("Field BD{k}.D must be square sparse matrix of same size as "
-                   "BL{k}.J.");
-    /* sparse diagonal representation of BD{k}.D */
-    ia = (mwIndex *)mxGetJc(BD_blockD);
-    ja = (mwIndex *)mxGetIr(BD_blockD);
-    prBDD = (double *)mxGetPr(BD_blockD);
-
-    /* extract BUT{k} */
-    BUT_block = mxGetCell(BUT, k);
+      prBLI = (double *)mxGetPr(BL_blockI);
+
+      /* 3. BL{k}.L, dense rectangular matrix ass. with I,J */
+      BL_blockL = mxGetField(BL_block, 0, "L");
+      if (BL_blockL == NULL)
+        mexErrMsgTxt("Field BL{k}.L does not exist.");
+      /* numerical values of BL{k}.L */
+      prBLL = (double *)mxGetPr(BL_blockL);
+
+      /* 4. BL{k}.D, lower unit triangular matrix */
+      BL_blockD = mxGetField(BL_block, 0, "D");
+      if (BL_blockD == NULL)
+        mexErrMsgTxt("Field BL{k}.D does not exist.");
+      if (mxGetN(BL_blockD) != n_size || mxGetM(BL_blockD) != n_size ||
+          !mxIsNumeric(BL_blockD))
+        mexErrMsgTxt("Field BL{k}.D must be square dense matrix of same size "
+                     "as BL{k}.J.");
+      /* numerical values of BL{k}.D */
+      prBLD = (double *)mxGetPr(BL_blockD);
+    }
 
-    /* 1. BUT{k}.J, this MUST be identical to BL{k}.J */
-    BUT_blockJ = mxGetField(BUT_block, 0, "J");
-    n_size = mxGetN(BUT_blockJ) * mxGetM(BUT_blockJ);
-    prBUTJ = (double *)mxGetPr(BUT_blockJ);
+    /* extract BD{k}, the diagonal of compact blocks is read from their
+       dense values */
+    if (BD_compact) {
+      if (BD_pool.ind_ptr[2 * k + 1] - BD_pool.ind_ptr[2 * k] != n_size)
+        mexErrMsgTxt("Field BD{k}.D must be of same size as BL{k}.J.");
+      selbinv_pool_pivots(&BD_pool, k, BD_ia, BD_ja, BD_pr);
+      ia = BD_ia;
+      ja = BD_ja;
+      prBDD = BD_pr;
+    } else {
+      BD_block = mxGetCell(BD, k);
+      if (!mxIsStruct(BD_block))
+        mexErrMsgTxt("Field BD{k} must be a structure.");
+
+      /* extract source BD{k}.D, sparse diagonal matrix */
+      BD_blockD = mxGetField(BD_block, 0, "D");
+      if (BD_blockD == NULL)
+        mexErrMsgTxt("Field BD{k}.D does not exist.");
+      if (mxGetN(BD_blockD) != n_size || mxGetM(BD_blockD) != n_size ||
+          !mxIsSparse(BD_blockD))
+        mexErrMsgTxt("Field BD{k}.D must be square sparse matrix of same size "
+                     "as BL{k}.J.");
+      /* sparse diagonal representation of BD{k}.D */
+      ia = (mwIndex *)mxGetJc(BD_blockD);
+      ja = (mwIndex *)mxGetIr(BD_blockD);
+      prBDD = (double *)mxGetPr(BD_blockD);
+    }
 
-    /* 2. BUT{k}.I, this could be completely different from BL{k}.I */
-    BUT_blockI = mxGetField(BUT_block, 0, "I");
-    if (BUT_blockI == NULL)
-      mexErrMsgTxt("Field BUT{k}.I does not exist.");
-    mut_size = mxGetN(BUT_blockI) * mxGetM(BUT_blockI);
+    /* extract BUT{k}, compact blocks are read in place */
+    if (BUT_compact) {
+      prBUTJ =
+          selbinv_index_set_pr(&BUT_pool, k, SELBINV_J, BUT_buff, &n_size);
+      prBUTI = selbinv_index_set_pr(&BUT_pool, k, SELBINV_I,
+                                    BUT_buff + n_size, &mut_size);
+      prBUTL = selbinv_pool_values(&BUT_pool, k, SELBINV_L);
+      prBUTD = selbinv_pool_values(&BUT_pool, k, SELBINV_D);
+    } else {
+      BUT_block = mxGetCell(BUT, k);
+
+      /* 1. BUT{k}.J, this MUST be identical to BL{k}.J */
+      BUT_blockJ = mxGetField(BUT_block, 0, "J");
+      n_size = mxGetN(BUT_blockJ) * mxGetM(BUT_blockJ);
+      prBUTJ = (double *)mxGetPr(BUT_blockJ);
+
+      /* 2. BUT{k}.I, this could be completely different from BL{k}.I */
+      BUT_blockI = mxGetField(BUT_block, 0, "I");
+      if (BUT_blockI == NULL)
+        mexErrMsgTxt("Field BUT{k}.I does not exist.");
+      mut_size = mxGetN(BUT_blockI) * mxGetM(BUT_blockI);
 #ifdef PRINT_CHECK
-    if (mxGetM(BUT_blockI) != 1 && mxGetN(BUT_blockI) != 1) {
-      mexPrintf("!!!BUT{%d}.I must be a 1-dim. array!!!\n", k + 1);
-      fflush(stdout);
-    }
+      if (mxGetM(BUT_blockI) != 1 && mxGetN(BUT_blockI) != 1) {
+        mexPrintf("!!!BUT{%d}.I must be a 1-dim. array!!!\n", k + 1);
+        fflush(stdout);
+      }
 #endif
-    prBUTI = (double *)mxGetPr(BUT_blockI);
-
-    /* 3. BUT{k}.L, dense rectangular matrix ass. with I,J */
-    BUT_blockL = mxGetField(BUT_block, 0, "L");
-    if (BUT_blockL == NULL)
-      mexErrMsgTxt("Field BUT{k}.L does not exist.");
-    /* numerical values of BUT{k}.L */
-    prBUTL = (double *)mxGetPr(BUT_blockL);
-
-    /* 4. BUT{k}.D, lower unit triangular matrix */
-    BUT_blockD = mxGetField(BUT_block, 0, "D");
-    if (BUT_blockD == NULL)
-      mexErrMsgTxt("Field BUT{k}.D does not exist.");
-    if (mxGetN(BUT_blockD) != n_size || mxGetM(BUT_blockD) != n_size ||
-        !mxIsNumeric(BUT_blockD))
-      mexErrMsgTxt("Field BUT{k}.D must be square dense matrix of same size as "
-                   "BUT{k}.J.");
-    /* numerical values of BUT{k}.D */
-    prBUTD = (double *)mxGetPr(BUT_blockD);
-
-    /* set up new block column for BLinv{k} with four elements J, I, L, D */
-    BLinv_block = mxCreateStructMatrix((mwSize)1, (mwSize)1, 4, BLnames);
-
-    /* structure element 0:  J */
-    /* create BLinv{k}.J */
-    BLinv_blockJ = mxCreateDoubleMatrix((mwSize)1, (mwSize)n_size, mxREAL);
-    /* copy data from BL{k}.J */
-    prBLinvJ = (double *)mxGetPr(BLinv_blockJ);
-    memcpy(prBLinvJ, prBLJ, (size_t)n_size * sizeof(double));
-    /* set each field in BLinv_block structure */
-    mxSetFieldByNumber(BLinv_block, (mwIndex)0, 0, BLinv_blockJ);
-
-    /* structure element 1:  I */
-    /* create  BLinv{k}.I from BL{k}.I */
-    BLinv_blockI = mxCreateDoubleMatrix((mwSize)1, (mwSize)ml_size, mxREAL);
-    /* copy data from BL{k].I */
-    prBLinvI = (double *)mxGetPr(BLinv_blockI);
-    memcpy(prBLinvI, prBLI, (size_t)ml_size * sizeof(double));
-    /* set each field in BLinv_block structure */
-    mxSetFieldByNumber(BLinv_block, (mwIndex)0, 1, BLinv_blockI);
-
-    /* structure element 3:  D, practically not used */
-    /* create empty sparse n_size x n_size matrix BLinv{k}.D */
-    BLinv_blockD =
-        mxCreateSparse((mwSize)n_size, (mwSize)n_size, (mwSize)0, mxREAL);
-    /* set each field in BLinv_block structure */
-    mxSetFieldByNumber(BLinv_block, (mwIndex)0, 3, BLinv_blockD);
+      prBUTI = (double *)mxGetPr(BUT_blockI);
+
+      /* 3. BUT{k}.L, dense rectangular matrix ass. with I,J */
+      BUT_blockL = mxGetField(BUT_block, 0, "L");
+      if (BUT_blockL == NULL)
+        mexErrMsgTxt("Field BUT{k}.L does not exist.");
+      /* numerical values of BUT{k}.L */
+      prBUTL = (double *)mxGetPr(BUT_blockL);
+
+      /* 4. BUT{k}.D, lower unit triangular matrix */
+      BUT_blockD = mxGetField(BUT_block, 0, "D");
+      if (BUT_blockD == NULL)
+        mexErrMsgTxt("Field BUT{k}.D does not exist.");
+      if (mxGetN(BUT_blockD) != n_size || mxGetM(BUT_blockD) != n_size ||
+          !mxIsNumeric(BUT_blockD))
+        mexErrMsgTxt("Field BUT{k}.D must be square dense matrix of same size "
+                     "as BUT{k}.J.");
+      /* numerical values of BUT{k}.D */
+      prBUTD = (double *)mxGetPr(BUT_blockD);
+    }
 
-    /* structure element 2:  L */
-    /* create BLinv{k}.L */
-    BLinv_blockL =
-        mxCreateDoubleMatrix((mwSize)ml_size, (mwSize)n_size, mxREAL);
-    prBLinvL = (double *)mxGetPr(BLinv_blockL);
+    if (BL_compact) {
+      /* BLinv{k}, BUTinv{k} and BDinv{k} have the index sets of BL{k} and
+         BUT{k}, and their values L are written in place into the compact
+         output or into plain arrays */
+      prBLinvJ = prBLJ;
+      prBLinvI = prBLI;
+      prBUTinvJ = prBUTJ;
+      prBUTinvI = prBUTI;
+      prBDinvJ = prBLJ;
+      BLinv_val[k] = selbinv_values(BLinv_store, k, SELBINV_L,
+                                    (size_t)(ml_size * n_size),
+                                    "DGNLselbinv:BLinv_val");
+      BUTinv_val[k] = selbinv_values(BUTinv_store, k, SELBINV_L,
+                                     (size_t)(mut_size * n_size),
+                                     "DGNLselbinv:BUTinv_val");
+      prBLinvL = BLinv_val[k];
+      prBUTinvL = BUTinv_val[k];
+    } else {
+      /* set up new block column for BLinv{k} with four elements J, I, L, D */
+      BLinv_block = mxCreateStructMatrix((mwSize)1, (mwSize)1, 4, BLnames);
+
+      /* structure element 0:  J */
+      /* create BLinv{k}.J */
+      BLinv_blockJ = mxCreateDoubleMatrix((mwSize)1, (mwSize)n_size, mxREAL);
+      /* copy data from BL{k}.J */
+      prBLinvJ = (double *)mxGetPr(BLinv_blockJ);
+      memcpy(prBLinvJ, prBLJ, (size_t)n_size * sizeof(double));
+      /* set each field in BLinv_block structure */
+      mxSetFieldByNumber(BLinv_block, (mwIndex)0, 0, BLinv_blockJ);
+
+      /* structure element 1:  I */
+      /* create  BLinv{k}.I from BL{k}.I */
+      BLinv_blockI = mxCreateDoubleMatrix((mwSize)1, (mwSize)ml_size, mxREAL);
+      /* copy data from BL{k].I */
+      prBLinvI = (double *)mxGetPr(BLinv_blockI);
+      memcpy(prBLinvI, prBLI, (size_t)ml_size * sizeof(double));
+      /* set each field in BLinv_block structure */
+      mxSetFieldByNumber(BLinv_block, (mwIndex)0, 1, BLinv_blockI);
+
+      /* structure element 3:  D, practically not used */
+      /* create empty sparse n_size x n_size matrix BLinv{k}.D */
+      BLinv_blockD =
+          mxCreateSparse((mwSize)n_size, (mwSize)n_size, (mwSize)0, mxREAL);
+      /* set each field in BLinv_block structure */
+      mxSetFieldByNumber(BLinv_block, (mwIndex)0, 3, BLinv_blockD);
+
+      /* structure element 2:  L */
+      /* create BLinv{k}.L */
+      BLinv_blockL =
+          mxCreateDoubleMatrix((mwSize)ml_size, (mwSize)n_size, mxREAL);
+      prBLinvL = (double *)mxGetPr(BLinv_blockL);
+      /* field "L" in BLinv_block structure not yet set!!! */
+
+      /* set up new block column for BUTinv{k} with four elements J, I, L, D */
+      BUTinv_block = mxCreateStructMatrix((mwSize)1, (mwSize)1, 4, BLnames);
+
+      /* structure element 0:  J */
+      /* create BUTinv{k}.J */
+      BUTinv_blockJ = mxCreateDoubleMatrix((mwSize)1, (mwSize)n_size, mxREAL);
+      /* copy data from BUT{k}.J */
+      prBUTinvJ = (double *)mxGetPr(BUTinv_blockJ);
+      memcpy(prBUTinvJ, prBUTJ, (size_t)n_size * sizeof(double));
+      /* set each field in BUTinv_block structure */
+      mxSetFieldByNumber(BUTinv_block, (mwIndex)0, 0, BUTinv_blockJ);
+
+      /* structure element 1:  I */
+      /* create empty BUTinv{k}.I */
+      BUTinv_blockI = mxCreateDoubleMatrix((mwSize)1, (mwSize)mut_size, mxREAL);
+      /* copy data from BUT{k}.I */
+      prBUTinvI = (double *)mxGetPr(BUTinv_blockI);
+      memcpy(prBUTinvI, prBUTI, (size_t)mut_size * sizeof(double));
+      /* set each field in BUTinv_block structure */
+      mxSetFieldByNumber(BUTinv_block, (mwIndex)0, 1, BUTinv_blockI);
+
+      /* structure element 3:  D, practically not used */
+      /* create empty sparse n_size x n_size matrix BUTinv{k}.D */
+      BUTinv_blockD =
+          mxCreateSparse((mwSize)n_size, (mwSize)n_size, (mwSize)0, mxREAL);
+      /* set each field in BUTinv_block structure */
+      mxSetFieldByNumber(BUTinv_block, (mwIndex)0, 3, BUTinv_blockD);
+
+      /* structure element 2:  L */
+      /* create BUTinv{k}.L */
+      BUTinv_blockL =
+          mxCreateDoubleMatrix((mwSize)mut_size, (mwSize)n_size, mxREAL);
+      prBUTinvL = (double *)mxGetPr(BUTinv_blockL);
+      /* field "L" in BUTinv_block structure not yet set!!! */
+
+      /* set up new block column for BDinv{k} with four elements J, I, L, D */
+      BDinv_block = mxCreateStructMatrix((mwSize)1, (mwSize)1, 4, BLnames);
+
+      /* structure element 0:  J */
+      /* create BDinv{k}.J */
+      BDinv_blockJ = mxCreateDoubleMatrix((mwSize)1, (mwSize)n_size, mxREAL);
+      /* copy data from BL{k}.J */
+      prBDinvJ = (double *)mxGetPr(BDinv_blockJ);
+      memcpy(prBDinvJ, prBLJ, (size_t)n_size * sizeof(double));
+      /* set each field in BDinv_block structure */
+      mxSetFieldByNumber(BDinv_block, (mwIndex)0, 0, BDinv_blockJ);
+
+      /* structure element 1:  I, practically not used */
+      /* create empty BDinv{k}.I */
+      BDinv_blockI = mxCreateDoubleMatrix((mwSize)1, (mwSize)0, mxREAL);
+      /* set each field in BDinv_block structure */
+      mxSetFieldByNumber(BDinv_block, (mwIndex)0, 1, BDinv_blockI);
+
+      /* structure element 2:  L, practically not used */
+      /* create empty BDinv{k}.L */
+      BDinv_blockL =
+          mxCreateSparse((mwSize)0, (mwSize)n_size, (mwSize)0, mxREAL);
+      /* set each field in BDinv_block structure */
+      mxSetFieldByNumber(BDinv_block, (mwIndex)0, 2, BDinv_blockL);
+
+      /* structure element 3:  D */
+      /* create dense n_size x n_size matrix BDinv{k}.D */
+      BDinv_blockD =
+          mxCreateDoubleMatrix((mwSize)n_size, (mwSize)n_size, mxREAL);
+      /* field "D" in BDinv_block structure not yet set!!! */
+    }
     /* init with zeros */
     for (j = 0; j < ml_size * n_size; j++)
-      *prBLinvL++ = 0.0;
-    prBLinvL = (double *)mxGetPr(BLinv_blockL);
-    /* field "L" in BLinv_block structure not yet set!!! */
-
-    /* set up new block column for BUTinv{k} with four elements J, I, L, D */
-    BUTinv_block = mxCreateStructMatrix((mwSize)1, (mwSize)1, 4, BLnames);
-
-    /* structure element 0:  J */
-    /* create BUTinv{k}.J */
-    BUTinv_blockJ = mxCreateDoubleMatrix((mwSize)1, (mwSize)n_size, mxREAL);
-    /* copy data from BUT{k}.J */
-    prBUTinvJ = (double *)mxGetPr(BUTinv_blockJ);
-    memcpy(prBUTinvJ, prBUTJ, (size_t)n_size * sizeof(double));
-    /* set each field in BUTinv_block structure */
-    mxSetFieldByNumber(BUTinv_block, (mwIndex)0, 0, BUTinv_blockJ);
-
-    /* structure element 1:  I */
-    /* create empty BUTinv{k}.I */
-    BUTinv_blockI = mxCreateDoubleMatrix((mwSize)1, (mwSize)mut_size, mxREAL);
-    /* copy data from BUT{k}.I */
-    prBUTinvI = (double *)mxGetPr(BUTinv_blockI);
-    memcpy(prBUTinvI, prBUTI, (size_t)mut_size * sizeof(double));
-    /* set each field in BUTinv_block structure */
-    mxSetFieldByNumber(BUTinv_block, (mwIndex)0, 1, BUTinv_blockI);
-
-    /* structure element 3:  D, practically not used */
-    /* create empty sparse n_size x n_size matrix BUTinv{k}.D */
-    BUTinv_blockD =
-        mxCreateSparse((mwSize)n_size, (mwSize)n_size, (mwSize)0, mxREAL);
-    /* set each field in BUTinv_block structure */
-    mxSetFieldByNumber(BUTinv_block, (mwIndex)0, 3, BUTinv_blockD);
-
-    /* structure element 2:  L */
-    /* create BUTinv{k}.L */
-    BUTinv_blockL =
-        mxCreateDoubleMatrix((mwSize)mut_size, (mwSize)n_size, mxREAL);
-    prBUTinvL = (double *)mxGetPr(BUTinv_blockL);
-    /* init with zeros */
+      prBLinvL[j] = 0.0;
     for (j = 0; j < mut_size * n_size; j++)
-      *prBUTinvL++ = 0.0;
-    prBUTinvL = (double *)mxGetPr(BUTinv_blockL);
-    /* field "L" in BUTinv_block structure not yet set!!! */
-
-    /* set up new block column for BDinv{k} with four elements J, I, L, D */
-    BDinv_block = mxCreateStructMatrix((mwSize)1, (mwSize)1, 4, BLnames);
-
-    /* structure element 0:  J */
-    /* create BDinv{k}.J */
-    BDinv_blockJ = mxCreateDoubleMatrix((mwSize)1, (mwSize)n_size, mxREAL);
-    /* copy data from BL{k}.J */
-    prBDinvJ = (double *)mxGetPr(BDinv_blockJ);
-    memcpy(prBDinvJ, prBLJ, (size_t)n_size * sizeof(double));
-    /* set each field in BDinv_block structure */
-    mxSetFieldByNumber(BDinv_block, (mwIndex)0, 0, BDinv_blockJ);
-
-    /* structure element 1:  I, practically not used */
-    /* create empty BDinv{k}.I */
-    BDinv_blockI = mxCreateDoubleMatrix((mwSize)1, (mwSize)0, mxREAL);
-    /* set each field in BDinv_block structure */
-    mxSetFieldByNumber(BDinv_block, (mwIndex)0, 1, BDinv_blockI);
-
-    /* structure element 2:  L, practically not used */
-    /* create empty BDinv{k}.L */
-    BDinv_blockL = mxCreateSparse((mwSize)0, (mwSize)n_size, (mwSize)0, mxREAL);
-    /* set each field in BDinv_block structure */
-    mxSetFieldByNumber(BDinv_block, (mwIndex)0, 2, BDinv_blockL);
-
-    /* structure element 3:  D */
-    /* create dense n_size x n_size matrix BDinv{k}.D */
-    BDinv_blockD = mxCreateDoubleMatrix((mwSize)n_size, (mwSize)n_size, mxREAL);
-    prBDinvD = (double *)mxGetPr(BDinv_blockD);
-    /* field "D" in BDinv_block structure not yet set!!! */
+      prBUTinvL[j] = 0.0;
 
     /* --------------------------------------------------------------------------
      */
@@ -869,76 +1063,87 @@ void mexFunction(
           /* now BL{k}.I(l:j) are associated with block column
              BDinv{i}, BUTinv{i} */
 
-      /* extract already computed BUTinv{i}, i>k */
-      BUTinv_blocki = mxGetCell(BUTinv, (mwIndex)i);
+      /* extract already computed BUTinv{i}, BDinv{i}, i>k. For compact
+         input they have the index sets of BUT{i} and BL{i}, and their values
+         are kept in BUTinv_val[i] and BDinv_val[i] */
+      if (BL_compact) {
+        prBUTinvJi = selbinv_index_set_pr(&BUT_pool, i, SELBINV_J,
+                                          BUTinv_buff, &ni_size);
+        prBUTinvIi = selbinv_index_set_pr(&BUT_pool, i, SELBINV_I,
+                                          BUTinv_buff + ni_size, &mi_size);
+        prBUTinvLi = BUTinv_val[i];
+        prBDinvDi = BDinv_val[i];
+      } else {
+        BUTinv_blocki = mxGetCell(BUTinv, (mwIndex)i);
 #ifdef PRINT_CHECK
-      if (BUTinv_blocki == NULL) {
-        mexPrintf("!!!BUTinv{%d} does not exist!!!\n", i + 1);
-        fflush(stdout);
-      } else if (!mxIsStruct(BUTinv_blocki)) {
-        mexPrintf("!!!BUTinv{%d} must be structure!!!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BUTinv_blocki == NULL) {
+          mexPrintf("!!!BUTinv{%d} does not exist!!!\n", i + 1);
+          fflush(stdout);
+        } else if (!mxIsStruct(BUTinv_blocki)) {
+          mexPrintf("!!!BUTinv{%d} must be structure!!!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
 
-      /* BUTinv{i}.J */
-      BUTinv_blockJi = mxGetField(BUTinv_blocki, 0, "J");
+        /* BUTinv{i}.J */
+        BUTinv_blockJi = mxGetField(BUTinv_blocki, 0, "J");
 #ifdef PRINT_CHECK
-      if (BUTinv_blockJi == NULL) {
-        mexPrintf("!!!BUTinv{%d}.J does not exist!!!\n", i + 1);
-        fflush(stdout);
-      } else if (mxGetM(BUTinv_blockJi) != 1 && mxGetN(BUTinv_blockJi) != 1) {
-        mexPrintf("!!!BUTinv{%d}.J must be a 1-dim. array!!!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BUTinv_blockJi == NULL) {
+          mexPrintf("!!!BUTinv{%d}.J does not exist!!!\n", i + 1);
+          fflush(stdout);
+        } else if (mxGetM(BUTinv_blockJi) != 1 && mxGetN(BUTinv_blockJi) != 1) {
+          mexPrintf("!!!BUTinv{%d}.J must be a 1-dim. array!!!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
-      ni_size = mxGetN(BUTinv_blockJi) * mxGetM(BUTinv_blockJi);
-      prBUTinvJi = (double *)mxGetPr(BUTinv_blockJi);
+        ni_size = mxGetN(BUTinv_blockJi) * mxGetM(BUTinv_blockJi);
+        prBUTinvJi = (double *)mxGetPr(BUTinv_blockJi);
 
-      /* BUTinv{i}.I */
-      BUTinv_blockIi = mxGetField(BUTinv_blocki, 0, "I");
+        /* BUTinv{i}.I */
+        BUTinv_blockIi = mxGetField(BUTinv_blocki, 0, "I");
 #ifdef PRINT_CHECK
-      if (BUTinv_blockIi == NULL) {
-        mexPrintf("!!!BUTinv{%d}.I does not exist!!!\n", i + 1);
-        fflush(stdout);
-      } else if (mxGetM(BUTinv_blockIi) != 1 && mxGetN(BUTinv_blockIi) != 1) {
-        mexPrintf("!!!BUTinv{%d}.I must be a 1-dim. array!!!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BUTinv_blockIi == NULL) {
+          mexPrintf("!!!BUTinv{%d}.I does not exist!!!\n", i + 1);
+          fflush(stdout);
+        } else if (mxGetM(BUTinv_blockIi) != 1 && mxGetN(BUTinv_blockIi) != 1) {
+          mexPrintf("!!!BUTinv{%d}.I must be a 1-dim. array!!!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
-      mi_size = mxGetN(BUTinv_blockIi) * mxGetM(BUTinv_blockIi);
-      prBUTinvIi = (double *)mxGetPr(BUTinv_blockIi);
+        mi_size = mxGetN(BUTinv_blockIi) * mxGetM(BUTinv_blockIi);
+        prBUTinvIi = (double *)mxGetPr(BUTinv_blockIi);
 
-      /* BUTinv{i}.L */
-      BUTinv_blockLi = mxGetField(BUTinv_blocki, 0, "L");
+        /* BUTinv{i}.L */
+        BUTinv_blockLi = mxGetField(BUTinv_blocki, 0, "L");
 #ifdef PRINT_CHECK
-      if (BUTinv_blockLi == NULL) {
-        mexPrintf("!!!BUTinv{%d}.L does not exist!!!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BUTinv_blockLi == NULL) {
+          mexPrintf("!!!BUTinv{%d}.L does not exist!!!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
-      prBUTinvLi = (double *)mxGetPr(BUTinv_blockLi);
+        prBUTinvLi = (double *)mxGetPr(BUTinv_blockLi);
 
-      /* extract already computed BDinv{i}, i>k */
-      BDinv_blocki = mxGetCell(BDinv, (mwIndex)i);
+        /* extract already computed BDinv{i}, i>k */
+        BDinv_blocki = mxGetCell(BDinv, (mwIndex)i);
 #ifdef PRINT_CHECK
-      if (BDinv_blocki == NULL) {
-        mexPrintf("!!!BDinv{%d} does not exist!!!\n", i + 1);
-        fflush(stdout);
-      } else if (!mxIsStruct(BDinv_blocki)) {
-        mexPrintf("!!!BDinv{%d} must be structure!!!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BDinv_blocki == NULL) {
+          mexPrintf("!!!BDinv{%d} does not exist!!!\n", i + 1);
+          fflush(stdout);
+        } else if (!mxIsStruct(BDinv_blocki)) {
+          mexPrintf("!!!BDinv{%d} must be structure!!!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
-      /* BDinv{i}.D */
-      BDinv_blockDi = mxGetField(BDinv_blocki, 0, "D");
+        /* BDinv{i}.D */
+        BDinv_blockDi = mxGetField(BDinv_blocki, 0, "D");
 #ifdef PRINT_CHECK
-      if (BDinv_blockDi == NULL) {
-        mexPrintf("!!!BDinv{%d}.D does not exist!!!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BDinv_blockDi == NULL) {
+          mexPrintf("!!!BDinv{%d}.D does not exist!!!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
-      prBDinvDi = (double *)mxGetPr(BDinv_blockDi);
+        prBDinvDi = (double *)mxGetPr(BDinv_blockDi);
+      }
 
       /* l:j refers to continuously chosen indices of BL{k}.I(l:j) !!! */
       /* Ji, Ik and Ii may exclude some entries !!! */
@@ -1542,7 +1747,7 @@ void mexFunction(
               else { /* indices match */
 
                 /* copy current row of pr2 to BUTinv{k}.L(Ik,:) */
-                pr = (double *)mxGetPr(BUTinv_blockL) + p;
+                pr = prBUTinvL + p;
                 pr3 = pr2;
                 for (r = 0; r < n_size; r++, pr += mut_size, pr3 += t)
                   *pr -= *pr3;
@@ -2130,7 +2335,7 @@ void mexFunction(
               else { /* indices match */
 
                 /* copy current row of pr2 to BUTinv{k}.L(Ik,:) */
-                pr = (double *)mxGetPr(BUTinv_blockL) + p;
+                pr = prBUTinvL + p;
                 pr3 = pr2;
                 for (r = 0; r < n_size; r++, pr += mut_size, pr3 += tt)
                   *pr -= *pr3;
@@ -2364,55 +2569,64 @@ void mexFunction(
       }   /* end while flag */
       /* now BUTinv{k}.I(l:j) are associated with block column BLinv{i} */
 
-      /* extract already computed BLinv{i}, i>k */
-      BLinv_blocki = mxGetCell(BLinv, (mwIndex)i);
+      /* extract already computed BLinv{i}, i>k. For compact input it has
+         the index sets of BL{i} and its values are kept in BLinv_val[i] */
+      if (BL_compact) {
+        prBLinvJi = selbinv_index_set_pr(&BL_pool, i, SELBINV_J, BLinv_buff,
+                                         &ni_size);
+        prBLinvIi = selbinv_index_set_pr(&BL_pool, i, SELBINV_I,
+                                         BLinv_buff + ni_size, &mi_size);
+        prBLinvLi = BLinv_val[i];
+      } else {
+        BLinv_blocki = mxGetCell(BLinv, (mwIndex)i);
 #ifdef PRINT_CHECK
-      if (BLinv_blocki == NULL) {
-        mexPrintf("!!!BLinv{%d} does not exist!!!\n", i + 1);
-        fflush(stdout);
-      } else if (!mxIsStruct(BLinv_blocki)) {
-        mexPrintf("!!!BLinv{%d} must be structure!!!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BLinv_blocki == NULL) {
+          mexPrintf("!!!BLinv{%d} does not exist!!!\n", i + 1);
+          fflush(stdout);
+        } else if (!mxIsStruct(BLinv_blocki)) {
+          mexPrintf("!!!BLinv{%d} must be structure!!!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
 
-      /* BLinv{i}.J */
-      BLinv_blockJi = mxGetField(BLinv_blocki, 0, "J");
+        /* BLinv{i}.J */
+        BLinv_blockJi = mxGetField(BLinv_blocki, 0, "J");
 #ifdef PRINT_CHECK
-      if (BLinv_blockJi == NULL) {
-        mexPrintf("!!!BLinv{%d}.J does not exist!!!\n", i + 1);
-        fflush(stdout);
-      } else if (mxGetM(BLinv_blockJi) != 1 && mxGetN(BLinv_blockJi) != 1) {
-        mexPrintf("!!!BLinv{%d}.J must be a 1-dim. array!!!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BLinv_blockJi == NULL) {
+          mexPrintf("!!!BLinv{%d}.J does not exist!!!\n", i + 1);
+          fflush(stdout);
+        } else if (mxGetM(BLinv_blockJi) != 1 && mxGetN(BLinv_blockJi) != 1) {
+          mexPrintf("!!!BLinv{%d}.J must be a 1-dim. array!!!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
-      ni_size = mxGetN(BLinv_blockJi) * mxGetM(BLinv_blockJi);
-      prBLinvJi = (double *)mxGetPr(BLinv_blockJi);
+        ni_size = mxGetN(BLinv_blockJi) * mxGetM(BLinv_blockJi);
+        prBLinvJi = (double *)mxGetPr(BLinv_blockJi);
 
-      /* BLinv{i}.I */
-      BLinv_blockIi = mxGetField(BLinv_blocki, 0, "I");
+        /* BLinv{i}.I */
+        BLinv_blockIi = mxGetField(BLinv_blocki, 0, "I");
 #ifdef PRINT_CHECK
-      if (BLinv_blockIi == NULL) {
-        mexPrintf("!!!BLinv{%d}.I does not exist!!!\n", i + 1);
-        fflush(stdout);
-      } else if (mxGetM(BLinv_blockIi) != 1 && mxGetN(BLinv_blockIi) != 1) {
-        mexPrintf("!!!BLinv{%d}.I must be a 1-dim. array!!!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BLinv_blockIi == NULL) {
+          mexPrintf("!!!BLinv{%d}.I does not exist!!!\n", i + 1);
+          fflush(stdout);
+        } else if (mxGetM(BLinv_blockIi) != 1 && mxGetN(BLinv_blockIi) != 1) {
+          mexPrintf("!!!BLinv{%d}.I must be a 1-dim. array!!!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
-      mi_size = mxGetN(BLinv_blockIi) * mxGetM(BLinv_blockIi);
-      prBLinvIi = (double *)mxGetPr(BLinv_blockIi);
+        mi_size = mxGetN(BLinv_blockIi) * mxGetM(BLinv_blockIi);
+        prBLinvIi = (double *)mxGetPr(BLinv_blockIi);
 
-      /* BLinv{i}.L */
-      BLinv_blockLi = mxGetField(BLinv_blocki, 0, "L");
+        /* BLinv{i}.L */
+        BLinv_blockLi = mxGetField(BLinv_blocki, 0, "L");
 #ifdef PRINT_CHECK
-      if (BLinv_blockLi == NULL) {
-        mexPrintf("!!!BLinv{%d}.L does not exist!!!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BLinv_blockLi == NULL) {
+          mexPrintf("!!!BLinv{%d}.L does not exist!!!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
-      prBLinvLi = (double *)mxGetPr(BLinv_blockLi);
+        prBLinvLi = (double *)mxGetPr(BLinv_blockLi);
+      }
 
       /* l:j refers to continuously chosen indices of BUTinv{k}.I(l:j) !!! */
       /* Ji, Ik and Ii may exclude some entries !!! */
@@ -3055,55 +3269,64 @@ void mexFunction(
       }   /* end while flag */
       /* now BUT{k}.I(l:j) are associated with block column BLinv{i} */
 
-      /* extract already computed BLinv{i}, i>k */
-      BLinv_blocki = mxGetCell(BLinv, (mwIndex)i);
+      /* extract already computed BLinv{i}, i>k. For compact input it has
+         the index sets of BL{i} and its values are kept in BLinv_val[i] */
+      if (BL_compact) {
+        prBLinvJi = selbinv_index_set_pr(&BL_pool, i, SELBINV_J, BLinv_buff,
+                                         &ni_size);
+        prBLinvIi = selbinv_index_set_pr(&BL_pool, i, SELBINV_I,
+                                         BLinv_buff + ni_size, &mi_size);
+        prBLinvLi = BLinv_val[i];
+      } else {
+        BLinv_blocki = mxGetCell(BLinv, (mwIndex)i);
 #ifdef PRINT_CHECK
-      if (BLinv_blocki == NULL) {
-        mexPrintf("!!!BLinv{%d} does not exist!!!\n", i + 1);
-        fflush(stdout);
-      } else if (!mxIsStruct(BLinv_blocki)) {
-        mexPrintf("!!!BLinv{%d} must be structure!!!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BLinv_blocki == NULL) {
+          mexPrintf("!!!BLinv{%d} does not exist!!!\n", i + 1);
+          fflush(stdout);
+        } else if (!mxIsStruct(BLinv_blocki)) {
+          mexPrintf("!!!BLinv{%d} must be structure!!!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
 
-      /* BLinv{i}.J */
-      BLinv_blockJi = mxGetField(BLinv_blocki, 0, "J");
+        /* BLinv{i}.J */
+        BLinv_blockJi = mxGetField(BLinv_blocki, 0, "J");
 #ifdef PRINT_CHECK
-      if (BLinv_blockJi == NULL) {
-        mexPrintf("!!!BLinv{%d}.J does not exist!!!\n", i + 1);
-        fflush(stdout);
-      } else if (mxGetM(BLinv_blockJi) != 1 && mxGetN(BLinv_blockJi) != 1) {
-        mexPrintf("!!!BLinv{%d}.J must be a 1-dim. array!!!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BLinv_blockJi == NULL) {
+          mexPrintf("!!!BLinv{%d}.J does not exist!!!\n", i + 1);
+          fflush(stdout);
+        } else if (mxGetM(BLinv_blockJi) != 1 && mxGetN(BLinv_blockJi) != 1) {
+          mexPrintf("!!!BLinv{%d}.J must be a 1-dim. array!!!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
-      ni_size = mxGetN(BLinv_blockJi) * mxGetM(BLinv_blockJi);
-      prBLinvJi = (double *)mxGetPr(BLinv_blockJi);
+        ni_size = mxGetN(BLinv_blockJi) * mxGetM(BLinv_blockJi);
+        prBLinvJi = (double *)mxGetPr(BLinv_blockJi);
 
-      /* BLinv{i}.I */
-      BLinv_blockIi = mxGetField(BLinv_blocki, 0, "I");
+        /* BLinv{i}.I */
+        BLinv_blockIi = mxGetField(BLinv_blocki, 0, "I");
 #ifdef PRINT_CHECK
-      if (BLinv_blockIi == NULL) {
-        mexPrintf("!!!BLinv{%d}.I does not exist!!!\n", i + 1);
-        fflush(stdout);
-      } else if (mxGetM(BLinv_blockIi) != 1 && mxGetN(BLinv_blockIi) != 1) {
-        mexPrintf("!!!BLinv{%d}.I must be a 1-dim. array!!!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BLinv_blockIi == NULL) {
+          mexPrintf("!!!BLinv{%d}.I does not exist!!!\n", i + 1);
+          fflush(stdout);
+        } else if (mxGetM(BLinv_blockIi) != 1 && mxGetN(BLinv_blockIi) != 1) {
+          mexPrintf("!!!BLinv{%d}.I must be a 1-dim. array!!!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
-      mi_size = mxGetN(BLinv_blockIi) * mxGetM(BLinv_blockIi);
-      prBLinvIi = (double *)mxGetPr(BLinv_blockIi);
+        mi_size = mxGetN(BLinv_blockIi) * mxGetM(BLinv_blockIi);
+        prBLinvIi = (double *)mxGetPr(BLinv_blockIi);
 
-      /* BLinv{i}.L */
-      BLinv_blockLi = mxGetField(BLinv_blocki, 0, "L");
+        /* BLinv{i}.L */
+        BLinv_blockLi = mxGetField(BLinv_blocki, 0, "L");
 #ifdef PRINT_CHECK
-      if (BLinv_blockLi == NULL) {
-        mexPrintf("!!!BLinv{%d}.L does not exist!!!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BLinv_blockLi == NULL) {
+          mexPrintf("!!!BLinv{%d}.L does not exist!!!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
-      prBLinvLi = (double *)mxGetPr(BLinv_blockLi);
+        prBLinvLi = (double *)mxGetPr(BLinv_blockLi);
+      }
 
       /* l:j refers to continuously chosen indices of BUT{k}.I(l:j) !!! */
       /* Ji, Ik and Ii may exclude some entries !!! */
@@ -3618,7 +3841,7 @@ void mexFunction(
               else { /* indices match */
 
                 /* copy current row of pr2 to BLinv{k}.L(Ik,:) */
-                pr = (double *)mxGetPr(BLinv_blockL) + p;
+                pr = prBLinvL + p;
                 pr3 = pr2;
                 for (r = 0; r < n_size; r++, pr += ml_size, pr3 += t)
                   *pr -= *pr3;
@@ -3855,76 +4078,87 @@ void mexFunction(
       }   /* end while flag */
       /* now BLinv{k}.I(l:j) are associated with block column BUTinv{i} */
 
-      /* extract already computed BUTinv{i}, i>k */
-      BUTinv_blocki = mxGetCell(BUTinv, (mwIndex)i);
+      /* extract already computed BUTinv{i}, BDinv{i}, i>k. For compact
+         input they have the index sets of BUT{i} and BL{i}, and their values
+         are kept in BUTinv_val[i] and BDinv_val[i] */
+      if (BL_compact) {
+        prBUTinvJi = selbinv_index_set_pr(&BUT_pool, i, SELBINV_J,
+                                          BUTinv_buff, &ni_size);
+        prBUTinvIi = selbinv_index_set_pr(&BUT_pool, i, SELBINV_I,
+                                          BUTinv_buff + ni_size, &mi_size);
+        prBUTinvLi = BUTinv_val[i];
+        prBDinvDi = BDinv_val[i];
+      } else {
+        BUTinv_blocki = mxGetCell(BUTinv, (mwIndex)i);
 #ifdef PRINT_CHECK
-      if (BUTinv_blocki == NULL) {
-        mexPrintf("!!!BUTinv{%d} does not exist!!!\n", i + 1);
-        fflush(stdout);
-      } else if (!mxIsStruct(BUTinv_blocki)) {
-        mexPrintf("!!!BUTinv{%d} must be structure!!!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BUTinv_blocki == NULL) {
+          mexPrintf("!!!BUTinv{%d} does not exist!!!\n", i + 1);
+          fflush(stdout);
+        } else if (!mxIsStruct(BUTinv_blocki)) {
+          mexPrintf("!!!BUTinv{%d} must be structure!!!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
 
-      /* BUTinv{i}.J */
-      BUTinv_blockJi = mxGetField(BUTinv_blocki, 0, "J");
+        /* BUTinv{i}.J */
+        BUTinv_blockJi = mxGetField(BUTinv_blocki, 0, "J");
 #ifdef PRINT_CHECK
-      if (BUTinv_blockJi == NULL) {
-        mexPrintf("!!!BUTinv{%d}.J does not exist!!!\n", i + 1);
-        fflush(stdout);
-      } else if (mxGetM(BUTinv_blockJi) != 1 && mxGetN(BUTinv_blockJi) != 1) {
-        mexPrintf("!!!BUTinv{%d}.J must be a 1-dim. array!!!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BUTinv_blockJi == NULL) {
+          mexPrintf("!!!BUTinv{%d}.J does not exist!!!\n", i + 1);
+          fflush(stdout);
+        } else if (mxGetM(BUTinv_blockJi) != 1 && mxGetN(BUTinv_blockJi) != 1) {
+          mexPrintf("!!!BUTinv{%d}.J must be a 1-dim. array!!!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
-      ni_size = mxGetN(BUTinv_blockJi) * mxGetM(BUTinv_blockJi);
-      prBUTinvJi = (double *)mxGetPr(BUTinv_blockJi);
+        ni_size = mxGetN(BUTinv_blockJi) * mxGetM(BUTinv_blockJi);
+        prBUTinvJi = (double *)mxGetPr(BUTinv_blockJi);
 
-      /* BUTinv{i}.I */
-      BUTinv_blockIi = mxGetField(BUTinv_blocki, 0, "I");
+        /* BUTinv{i}.I */
+        BUTinv_blockIi = mxGetField(BUTinv_blocki, 0, "I");
 #ifdef PRINT_CHECK
-      if (BUTinv_blockIi == NULL) {
-        mexPrintf("!!!BUTinv{%d}.I does not exist!!!\n", i + 1);
-        fflush(stdout);
-      } else if (mxGetM(BUTinv_blockIi) != 1 && mxGetN(BUTinv_blockIi) != 1) {
-        mexPrintf("!!!BUTinv{%d}.I must be a 1-dim. array!!!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BUTinv_blockIi == NULL) {
+          mexPrintf("!!!BUTinv{%d}.I does not exist!!!\n", i + 1);
+          fflush(stdout);
+        } else if (mxGetM(BUTinv_blockIi) != 1 && mxGetN(BUTinv_blockIi) != 1) {
+          mexPrintf("!!!BUTinv{%d}.I must be a 1-dim. array!!!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
-      mi_size = mxGetN(BUTinv_blockIi) * mxGetM(BUTinv_blockIi);
-      prBUTinvIi = (double *)mxGetPr(BUTinv_blockIi);
+        mi_size = mxGetN(BUTinv_blockIi) * mxGetM(BUTinv_blockIi);
+        prBUTinvIi = (double *)mxGetPr(BUTinv_blockIi);
 
-      /* BUTinv{i}.L */
-      BUTinv_blockLi = mxGetField(BUTinv_blocki, 0, "L");
+        /* BUTinv{i}.L */
+        BUTinv_blockLi = mxGetField(BUTinv_blocki, 0, "L");
 #ifdef PRINT_CHECK
-      if (BUTinv_blockLi == NULL) {
-        mexPrintf("!!!BUTinv{%d}.L does not exist!!!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BUTinv_blockLi == NULL) {
+          mexPrintf("!!!BUTinv{%d}.L does not exist!!!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
-      prBUTinvLi = (double *)mxGetPr(BUTinv_blockLi);
+        prBUTinvLi = (double *)mxGetPr(BUTinv_blockLi);
 
-      /* extract already computed BDinv{i}, i>k */
-      BDinv_blocki = mxGetCell(BDinv, (mwIndex)i);
+        /* extract already computed BDinv{i}, i>k */
+        BDinv_blocki = mxGetCell(BDinv, (mwIndex)i);
 #ifdef PRINT_CHECK
-      if (BDinv_blocki == NULL) {
-        mexPrintf("!!!BDinv{%d} does not exist!!!\n", i + 1);
-        fflush(stdout);
-      } else if (!mxIsStruct(BDinv_blocki)) {
-        mexPrintf("!!!BDinv{%d} must be structure!!!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BDinv_blocki == NULL) {
+          mexPrintf("!!!BDinv{%d} does not exist!!!\n", i + 1);
+          fflush(stdout);
+        } else if (!mxIsStruct(BDinv_blocki)) {
+          mexPrintf("!!!BDinv{%d} must be structure!!!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
-      /* BDinv{i}.D */
-      BDinv_blockDi = mxGetField(BDinv_blocki, 0, "D");
+        /* BDinv{i}.D */
+        BDinv_blockDi = mxGetField(BDinv_blocki, 0, "D");
 #ifdef PRINT_CHECK
-      if (BDinv_blockDi == NULL) {
-        mexPrintf("!!!BDinv{%d}.D does not exist!!!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BDinv_blockDi == NULL) {
+          mexPrintf("!!!BDinv{%d}.D does not exist!!!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
-      prBDinvDi = (double *)mxGetPr(BDinv_blockDi);
+        prBDinvDi = (double *)mxGetPr(BDinv_blockDi);
+      }
 
       /* l:j refers to continuously chosen indices of BLinv{k}.I(l:j) !!! */
       /* Ji, Ik and Ii may exclude some entries !!! */
@@ -5090,7 +5324,6 @@ void mexFunction(
       mexPrintf("%8d", (integer)prBLinvJ[j]);
     mexPrintf("\n");
     fflush(stdout);
-    ml_size = mxGetN(BL_blockI) * mxGetM(BL_blockI);
     for (i = 0; i < ml_size; i++) {
       mexPrintf("%8d", (integer)prBLinvI[i]);
       for (j = 0; j < n_size; j++)
@@ -5104,7 +5337,6 @@ void mexFunction(
       mexPrintf("%8d", (integer)prBUTinvJ[j]);
     mexPrintf("\n");
     fflush(stdout);
-    mut_size = mxGetN(BUT_blockI) * mxGetM(BUT_blockI);
     for (i = 0; i < mut_size; i++) {
       mexPrintf("%8d", (integer)prBUTinvI[i]);
       for (j = 0; j < n_size; j++)
@@ -5114,15 +5346,24 @@ void mexFunction(
     }
 #endif
 
-    /* now finally set each field in BLinv_block structure */
-    mxSetFieldByNumber(BLinv_block, (mwIndex)0, 2, BLinv_blockL);
-    /* now finally set each field in BUTinv_block structure */
-    mxSetFieldByNumber(BUTinv_block, (mwIndex)0, 2, BUTinv_blockL);
-
-    /* structure element 3:  BDinv{k}.D */
-    /* create dense n_size x n_size BDinv{k}.D */
-    BDinv_blockD = mxCreateDoubleMatrix((mwSize)n_size, (mwSize)n_size, mxREAL);
-    prBDinvD = (double *)mxGetPr(BDinv_blockD);
+    if (BL_compact)
+      /* values of BDinv{k}.D in the compact output or in a plain array */
+      BDinv_D = selbinv_values(BDinv_store, k, SELBINV_D,
+                               (size_t)(n_size * n_size),
+                               "DGNLselbinv:BDinv_val");
+    else {
+      /* now finally set each field in BLinv_block structure */
+      mxSetFieldByNumber(BLinv_block, (mwIndex)0, 2, BLinv_blockL);
+      /* now finally set each field in BUTinv_block structure */
+      mxSetFieldByNumber(BUTinv_block, (mwIndex)0, 2, BUTinv_blockL);
+
+      /* structure element 3:  BDinv{k}.D */
+      /* create dense n_size x n_size BDinv{k}.D */
+      BDinv_blockD =
+          mxCreateDoubleMatrix((mwSize)n_size, (mwSize)n_size, mxREAL);
+      BDinv_D = (double *)mxGetPr(BDinv_blockD);
+    }
+    prBDinvD = BDinv_D;
     /* copy strict upper triangular part from BUT{k}.D column to row + diagonal
      * part from BD{k}.D */
     for (j = 0; j < n_size; j++) {
@@ -5147,7 +5388,7 @@ void mexFunction(
       prBDD++;
     } /* end for j */
 
-    prBDinvD = (double *)mxGetPr(BDinv_blockD);
+    prBDinvD = BDinv_D;
     /* copy lower triangular part from BL.D column by column */
     for (j = 0; j < n_size; j++) {
       /* advance BDinv{k}.D, BL{k}.D to their strict lower triangular part of
@@ -5161,7 +5402,7 @@ void mexFunction(
 #ifdef PRINT_INFO
     mexPrintf("DGNLselbinv: final lower triangular part copied\n");
     fflush(stdout);
-    prBDinvD = (double *)mxGetPr(BDinv_blockD);
+    prBDinvD = BDinv_D;
     mexPrintf("perm:   ");
     for (j = 0; j < n_size; j++)
       mexPrintf("%8d", ipiv[j]);
@@ -5182,7 +5423,7 @@ void mexFunction(
 #endif
 
     /* use LAPACK's dgetri_ for matrix inversion given the LDU decompositon */
-    prBDinvD = (double *)mxGetPr(BDinv_blockD);
+    prBDinvD = BDinv_D;
     j = 0;
     dgetri_(&n_size, prBDinvD, &n_size, ipiv, work, &n, &j);
     if (j < 0) {
@@ -5198,7 +5439,7 @@ void mexFunction(
 #ifdef PRINT_INFO
     mexPrintf("DGNLselbinv: inverse lower triangular part computed\n");
     fflush(stdout);
-    prBDinvD = (double *)mxGetPr(BDinv_blockD);
+    prBDinvD = BDinv_D;
     mexPrintf("        ");
     for (j = 0; j < n_size; j++)
       mexPrintf("%8d", (integer)prBLinvJ[j]);
@@ -5226,7 +5467,6 @@ void mexFunction(
 #endif
     alpha = -1;
     beta = 1.0;
-    mut_size = mxGetN(BUT_blockI) * mxGetM(BUT_blockI);
     if (mut_size)
       dgemm_("T", "N", &n_size, &n_size, &mut_size, &alpha, prBUTL, &mut_size,
              prBUTinvL, &mut_size, &beta, prBDinvD, &n_size, 1, 1);
@@ -5234,7 +5474,7 @@ void mexFunction(
     /* successively downdate "n" by the size "n_size" of the diagonal block */
     sumn -= n_size;
     /* extract diagonal entries  */
-    prBDinvD = (double *)mxGetPr(BDinv_blockD);
+    prBDinvD = BDinv_D;
     for (j = 0; j < n_size; j++) {
       Dbuff[sumn + j] = *prBDinvD;
       /* advance to the diagonal part of column j+1 */
@@ -5249,7 +5489,7 @@ void mexFunction(
     fflush(stdout);
     mexPrintf("DGNLselbinv: inverse diagonal block computed\n");
     fflush(stdout);
-    prBDinvD = (double *)mxGetPr(BDinv_blockD);
+    prBDinvD = BDinv_D;
     mexPrintf("        ");
     for (j = 0; j < n_size; j++)
       mexPrintf("%8d", (integer)prBLinvJ[j]);
@@ -5264,13 +5504,31 @@ void mexFunction(
     }
 #endif
 
-    /* now finally set each field in BDinv_block structure */
-    mxSetFieldByNumber(BDinv_block, (mwIndex)0, 3, BDinv_blockD);
+    if (BL_compact)
+      BDinv_val[k] = BDinv_D;
+    else {
+      /* now finally set each field in BDinv_block structure */
+      mxSetFieldByNumber(BDinv_block, (mwIndex)0, 3, BDinv_blockD);
 
-    /* finally set output BLinv{k}, BDinv{k}, BUTinv{k} */
-    mxSetCell(BLinv, (mwIndex)k, BLinv_block);
-    mxSetCell(BDinv, (mwIndex)k, BDinv_block);
-    mxSetCell(BUTinv, (mwIndex)k, BUTinv_block);
+      /* finally set output BLinv{k}, BDinv{k}, BUTinv{k} */
+      mxSetCell(BLinv, (mwIndex)k, BLinv_block);
+      mxSetCell(BDinv, (mwIndex)k, BDinv_block);
+      mxSetCell(BUTinv, (mwIndex)k, BUTinv_block);
+    }
+    /* release the blocks that are no longer needed */
+    if (last != NULL) {
+      n_expired =
+          selbinv_expired(&BL_pool, &BUT_pool, k, block, last, expired);
+      if (BL_compact) {
+        selbinv_release_values(BLinv_val, expired, n_expired);
+        selbinv_release_values(BDinv_val, expired, n_expired);
+        selbinv_release_values(BUTinv_val, expired, n_expired);
+      } else {
+        selbinv_release(BLinv, expired, n_expired);
+        selbinv_release(BDinv, expired, n_expired);
+        selbinv_release(BUTinv, expired, n_expired);
+      }
+    }
 
     k--;
   } /* end while k>=0 */
@@ -5298,6 +5556,28 @@ void mexFunction(
   free(Dbuff);
   free(gemm_buff);
   free(block);
+  if (last != NULL) {
+    free(last);
+    free(expired);
+  }
+  if (BL_compact) {
+    free(BLinv_val);
+    free(BDinv_val);
+    free(BUTinv_val);
+    free(BLinv_buff);
+    free(BUTinv_buff);
+  } else if (nlhs < 2) {
+    mxDestroyArray(BLinv);
+    mxDestroyArray(BDinv);
+    mxDestroyArray(BUTinv);
+  }
+  free(BL_buff);
+  free(BUT_buff);
+  if (BD_compact) {
+    free(BD_ia);
+    free(BD_ja);
+    free(BD_pr);
+  }
 
 #ifdef PRINT_INFO
   mexPrintf("DGNLselbinv: memory released\n");
@@ -118,25 +118,27 @@ void mexFunction(
       (double *)ReAlloc(param->dbuff, (size_t)param->ndbuff * sizeof(double),
                         "DSYMilupacksol:rhs");
 
+  /* copy and rescale right hand side in a single pass */
   rhs = param->dbuff;
-  memcpy(rhs, pr, (size_t)n * sizeof(double));
   if (PRE->issingle) {
     SPRE = (SAMGlevelmat *)PRE;
-    /* rescale right hand side */
     for (i = 0; i < n; i++) {
-      rhs[i] *= (double)SPRE->rowscal[i];
+      rhs[i] = pr[i] * (double)SPRE->rowscal[i];
     }
   } else {
-    /* rescale right hand side */
     for (i = 0; i < n; i++) {
-      rhs[i] *= PRE->rowscal[i];
+      rhs[i] = pr[i] * PRE->rowscal[i];
     }
   }
 
-  /* provide memory for the approximate solution */
-  sol = param->dbuff + n;
+  /* Create a struct matrices for output */
+  nlhs = 1;
+
+  /* compute the approximate solution directly in the output */
+  plhs[0] = mxCreateDoubleMatrix((mwSize)n, (mwSize)1, mxREAL);
+  sol = mxGetPr(plhs[0]);
   /* 3n spaces as buffer */
-  dbuff = param->dbuff + 2 * n;
+  dbuff = param->dbuff + n;
 
   DSYMAMGsol_internal(PRE, param, rhs, sol, dbuff);
 
@@ -151,12 +153,5 @@ void mexFunction(
     }
   }
 
-  /* Create a struct matrices for output */
-  nlhs = 1;
-
-  plhs[0] = mxCreateDoubleMatrix((mwSize)n, (mwSize)1, mxREAL);
-  pr = mxGetPr(plhs[0]);
-  memcpy(pr, sol, (size_t)n * sizeof(double));
-
   return;
 }
@@ -13,6 +13,11 @@
     % for initializing parameters
     [BL,BD]=DSYMldl2bldl(L,D,threshold,maxsize,tol)
 
+    % return BL and BD in the compact format of selbinvpool.h, i.e., as
+    % flat integer index and double value arrays rather than as cell arrays
+    % of structures, if compact is nonzero
+    [BL,BD]=DSYMldl2bldl(L,D,threshold,maxsize,tol,compact)
+
 
     Authors:
 
@@ -50,6 +55,8 @@
 #include <ilupackmacros.h>
 #include <lapack.h>
 
+#include "selbinvpool.h"
+
 #define MAX_FIELDS 100
 #define MAX(A, B) (((A) >= (B)) ? (A) : (B))
 #define MIN(A, B) (((A) >= (B)) ? (B) : (A))
@@ -75,7 +82,7 @@ void mexFunction(
   mxArray *L_input, *D_input, *threshold_input, *maxsize_input, *tol_input,
       *block_column, *D_matrix, *L_matrix, *block_index, *BL, *BD;
   integer i, j, k, l, m, kk, n, flag, nnz, p, cnt, cnti, cntj, cntij, *ia, *ja,
-      *idxpos, *idxlst, maxsize;
+      *idxpos, *idxlst, maxsize, compact = 0;
   doubleprecision tol, threshold, *prL, *prD, mx, val, *pr;
   size_t mrows, ncols;
   double *L_valuesR, *D_valuesR;
@@ -84,8 +91,8 @@ void mexFunction(
       *D_ja,     /* row indices of input matrix D         */
       *D_ia;     /* column pointers of input matrix D     */
 
-  if (nrhs != 5)
-    mexErrMsgTxt("Five input arguments required.");
+  if (nrhs != 5 && nrhs != 6)
+    mexErrMsgTxt("Five or six input arguments required.");
   else if (nlhs != 2)
     mexErrMsgTxt("wrong number of output arguments.");
   else if (!mxIsNumeric(prhs[0]))
@@ -98,6 +105,8 @@ void mexFunction(
     mexErrMsgTxt("Fourth input must be a number.");
   else if (!mxIsNumeric(prhs[4]))
     mexErrMsgTxt("Fifth input must be a number.");
+  else if (nrhs > 5 && !mxIsNumeric(prhs[5]) && !mxIsLogical(prhs[5]))
+    mexErrMsgTxt("Sixth input must be a number.");
 
   /* The first input must be a square matrix.*/
   L_input = (mxArray *)prhs[0];
@@ -177,6 +186,8 @@ void mexFunction(
     mexErrMsgTxt("Fourth argument must be number.");
   }
   tol = *mxGetPr(tol_input);
+  if (nrhs > 5)
+    compact = mxGetScalar(prhs[5]) != 0.0;
 #ifdef PRINT_INFO
   mexPrintf("DSYMldl2bldl: input parameter tol imported\n");
   fflush(stdout);
@@ -662,17 +673,24 @@ void mexFunction(
 
   } /* end while i<n */
 
-  dims[0] = k;
-  plhs[0] = mxCreateCellArray((mwSize)1, dims);
-  plhs[1] = mxCreateCellArray((mwSize)1, dims);
-  for (m = 0; m < k; m++) {
-    block_column = mxGetCell(BL, (mwIndex)m);
-    mxSetCell(plhs[0], (mwIndex)m, block_column);
-    mxSetCell(BL, (mwIndex)m, NULL);
-    block_column = mxGetCell(BD, (mwIndex)m);
-    mxSetCell(plhs[1], (mwIndex)m, block_column);
-    mxSetCell(BD, (mwIndex)m, NULL);
-  } /* end for m */
+  /* return the blocks. The compact format releases the blocks of BL and BD
+     as they are stored */
+  if (compact) {
+    plhs[0] = selbinv_pool_from_cell(BL, k, n);
+    plhs[1] = selbinv_pool_from_cell(BD, k, n);
+  } else {
+    dims[0] = k;
+    plhs[0] = mxCreateCellArray((mwSize)1, dims);
+    plhs[1] = mxCreateCellArray((mwSize)1, dims);
+    for (m = 0; m < k; m++) {
+      block_column = mxGetCell(BL, (mwIndex)m);
+      mxSetCell(plhs[0], (mwIndex)m, block_column);
+      mxSetCell(BL, (mwIndex)m, NULL);
+      block_column = mxGetCell(BD, (mwIndex)m);
+      mxSetCell(plhs[1], (mwIndex)m, block_column);
+      mxSetCell(BD, (mwIndex)m, NULL);
+    } /* end for m */
+  }
 
   /* release memory */
   mxDestroyArray(BL);
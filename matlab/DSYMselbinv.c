@@ -14,6 +14,17 @@
     % for initializing parameters
     [D, BLinv]=DSYMselbinv(BL,BD,perm, Delta)
 
+    % only compute D=diag(inv(A)), releasing each block of the selective
+    % inverse as soon as the remaining blocks no longer refer to it
+    D=DSYMselbinv(BL,BD,perm, Delta)
+
+    % BL and BD may also be given in the compact format returned by
+    % DSYMldl2bldl(L,D,threshold,maxsize,tol,1), see selbinvpool.h. BLinv is
+    % then returned in the compact format as well. The compact blocks are
+    % read and BLinv is written in place, without creating a structure
+    % per block
+    [D, BLinv]=DSYMselbinv(BL,BD,perm, Delta)
+
 
     Authors:
 
@@ -50,6 +61,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "selbinvstream.h"
+
 #define MAX_FIELDS 100
 #define MAX(A, B) (((A) >= (B)) ? (A) : (B))
 #define MIN(A, B) (((A) >= (B)) ? (B) : (A))
@@ -81,44 +94,52 @@ void mexFunction(
       mi_size, i_first, j_first, k_first, Ji_cont, Ik_cont, Ii_cont;
   double val, alpha, beta, *Dbuff, *work, *gemm_buff, *pr, *pr2, *pr3, *pr4,
       *prBLJ, *prBLI, *prBLL, *prBLD, *prBDD, *prBLinvJ, *prBLinvI, *prBLinvL,
-      *prBLinvD, *prBLinvJi, *prBLinvIi, *prBLinvLi, *prBLinvDi;
-  mwIndex *ja, *ia;
+      *prBLinvD, *prBLinvJi, *prBLinvIi, *prBLinvLi, *prBLinvDi, *BLinv_D,
+      *BL_buff = NULL, *BLinv_buff = NULL, *BD_pr = NULL, **BLinv_val = NULL;
+  integer *last = NULL, *expired = NULL, n_expired, BL_compact, BD_compact;
+  selbinv_pool BL_pool, BD_pool, BLinv_pool, *BLinv_store = NULL;
+  selbinv_index_set BL_J;
+  mwIndex *ja, *ia, *BD_ia = NULL, *BD_ja = NULL;
 
   if (nrhs != 4)
     mexErrMsgTxt("Four input arguments required.");
-  else if (nlhs != 2)
+  else if (nlhs > 2)
     mexErrMsgTxt("wrong number of output arguments.");
 
-  /* The first input must be a cell array.*/
+  /* The first input must be a cell array or compact blocks.*/
   BL = (mxArray *)prhs[0];
-  /* get size of input cell array BL */
-  nblocks = MAX(mxGetM(BL), mxGetN(BL));
+  BL_compact = selbinv_is_pool(BL);
+  if (!mxIsCell(BL) && !BL_compact) {
+    mexErrMsgTxt("First input matrix must be a cell array.");
+  }
+  /* parse BL once and get its number of blocks */
+  selbinv_pool_get(BL, &BL_pool);
+  nblocks = BL_pool.nblocks;
 #ifdef PRINT_CHECK
-  if (mxGetM(BL) != 1 && mxGetN(BL) != 1) {
+  if (!BL_compact && mxGetM(BL) != 1 && mxGetN(BL) != 1) {
     mexPrintf("BL must be a 1-dim. cell array!\n");
     fflush(stdout);
   }
 #endif
-  if (!mxIsCell(BL)) {
-    mexErrMsgTxt("First input matrix must be a cell array.");
-  }
 #ifdef PRINT_INFO
   mexPrintf("DSYMselbinv: input parameter BL imported\n");
   fflush(stdout);
 #endif
 
-  /* The second input must be a cell array as well.*/
+  /* The second input must be a cell array or compact blocks as well.*/
   BD = (mxArray *)prhs[1];
-  if (!mxIsCell(BD)) {
+  BD_compact = selbinv_is_pool(BD);
+  if (!mxIsCell(BD) && !BD_compact) {
     mexErrMsgTxt("Second input matrix must be a cell array.");
   }
   /* get size of input matrix BD */
-  if (MAX(mxGetM(BD), mxGetN(BD)) != nblocks) {
+  selbinv_pool_get(BD, &BD_pool);
+  if (BD_pool.nblocks != nblocks) {
     mexErrMsgTxt(
         "Second input must be a cell array of same size as the first input.");
   }
 #ifdef PRINT_CHECK
-  if (mxGetM(BD) != 1 && mxGetN(BD) != 1) {
+  if (!BD_compact && mxGetM(BD) != 1 && mxGetN(BD) != 1) {
     mexPrintf("BD must be a 1-dim. cell array!\n");
     fflush(stdout);
   }
@@ -172,10 +193,38 @@ void mexFunction(
   fflush(stdout);
 #endif
 
-  /* create output cell array BLinv of length "nblocks" */
-  dims[0] = nblocks;
-  plhs[1] = mxCreateCellArray((mwSize)1, dims);
-  BLinv = plhs[1];
+  /* create output cell array BLinv of length "nblocks". If only D is
+     requested, BLinv is temporary and its blocks are released early. For
+     compact input blocks, the values of BLinv{k} are written in place into
+     the compact output, or into plain arrays if only D is requested, and
+     BLinv_val[k] refers to them */
+  if (!BL_compact) {
+    dims[0] = nblocks;
+    BLinv = mxCreateCellArray((mwSize)1, dims);
+    if (nlhs > 1)
+      plhs[1] = BLinv;
+  } else {
+    if (nlhs > 1) {
+      plhs[1] = selbinv_pool_create(&BL_pool, nblocks, n, 1, &BLinv_pool);
+      BLinv_store = &BLinv_pool;
+    }
+    BLinv_val = (double **)CAlloc((size_t)nblocks, sizeof(double *),
+                                  "DSYMselbinv:BLinv_val");
+    /* index sets of BL{k} and BLinv{i} converted to double */
+    BL_buff = (double *)MAlloc((size_t)(n + 1) * sizeof(double),
+                               "DSYMselbinv:BL_buff");
+    BLinv_buff = (double *)MAlloc((size_t)(n + 1) * sizeof(double),
+                                  "DSYMselbinv:BLinv_buff");
+  }
+  /* 1x1 and 2x2 blocks of compact BD{k}.D */
+  if (BD_compact) {
+    BD_ia = (mwIndex *)MAlloc((size_t)(n + 1) * sizeof(mwIndex),
+                              "DSYMselbinv:BD_ia");
+    BD_ja = (mwIndex *)MAlloc((size_t)(2 * n) * sizeof(mwIndex),
+                              "DSYMselbinv:BD_ja");
+    BD_pr = (double *)MAlloc((size_t)(2 * n) * sizeof(double),
+                             "DSYMselbinv:BD_pr");
+  }
 
   /* auxiliary arrays for inverting diagonal blocks using dsytri_ */
   ipiv = (integer *)MAlloc((size_t)n * sizeof(integer), "DSYMselbinv:ipiv");
@@ -193,6 +242,16 @@ void mexFunction(
   /* inverse mapping index -> block number */
   block = (integer *)CAlloc((size_t)n, sizeof(integer), "DSYMselbinv:block");
   for (i = 0; i < nblocks; i++) {
+    if (BL_compact) {
+      selbinv_index_set_get(&BL_pool, i, SELBINV_J, &BL_J);
+      for (k = 0; k < (integer)BL_J.size; k++) {
+        j = selbinv_index_set_entry(&BL_J, (mwSize)k);
+        if (j < 1 || j > n)
+          mexErrMsgTxt("Index of BL{i}.J out of range.");
+        block[j - 1] = i;
+      }
+      continue;
+    }
     BL_block = mxGetCell(BL, i);
     if (!mxIsStruct(BL_block))
       mexErrMsgTxt("Field BL{i} must be a structure.");
@@ -234,75 +293,110 @@ void mexFunction(
   fflush(stdout);
 #endif
 
+  /* last block that reads each block of BLinv */
+  if (nlhs < 2) {
+    last = (integer *)MAlloc((size_t)nblocks * sizeof(integer),
+                             "DSYMselbinv:last");
+    expired = (integer *)MAlloc((size_t)nblocks * sizeof(integer),
+                                "DSYMselbinv:expired");
+    selbinv_last_use(&BL_pool, NULL, nblocks, block, last);
+  }
+
   /* start selective block inversion from the back */
   k = nblocks - 1;
 
-  /* extract BL{k} */
-  BL_block = mxGetCell(BL, k);
-
-  /* extract source BL{k}.J */
-  BL_blockJ = mxGetField(BL_block, 0, "J");
-  n_size = mxGetN(BL_blockJ) * mxGetM(BL_blockJ);
-  prBLJ = (double *)mxGetPr(BL_blockJ);
-  /* BL{k}.I and BL{k}.L should be empty */
-  /* extract source BL{k}.D */
-  BL_blockD = mxGetField(BL_block, 0, "D");
-  if (BL_blockD == NULL)
-    mexErrMsgTxt("Field BL{k}.D does not exist.");
-  if (mxGetN(BL_blockD) != n_size || mxGetM(BL_blockD) != n_size ||
-      !mxIsNumeric(BL_blockD))
-    mexErrMsgTxt(
-        "Field BL{k}.D must be square dense matrix of same size as BL{k}.J.");
-  /* numerical values of BL{k}.D */
-  prBLD = (double *)mxGetPr(BL_blockD);
-
-  /* extract BD{k} */
-  BD_block = mxGetCell(BD, k);
-  if (!mxIsStruct(BD_block))
-    mexErrMsgTxt("Field BD{k} must be a structure.");
-
-  /* extract source BD{k}.D */
-  BD_blockD = mxGetField(BD_block, 0, "D");
-  if (BD_blockD == NULL)
-    mexErrMsgTxt("Field BD{k}.D does not exist.");
-  if (mxGetN(BD_blockD) != n_size || mxGetM(BD_blockD) != n_size ||
-      !mxIsSparse(BD_blockD))
-    mexErrMsgTxt(
-        "Field BD{k}.D must be square sparse matrix of same size as BL{k}.J.");
-  /* sparse representation of BD{k}.D */
-  ia = (mwIndex *)mxGetJc(BD_blockD);
-  ja = (mwIndex *)mxGetIr(BD_blockD);
-  prBDD = (double *)mxGetPr(BD_blockD);
-
-  /* set up new block column for BLinv{k} with four elements J, I, L, D */
-  BLinv_block = mxCreateStructMatrix((mwSize)1, (mwSize)1, 4, BLnames);
-
-  /* structure element 0:  J */
-  /* create BLinv{k}.J */
-  BLinv_blockJ = mxCreateDoubleMatrix((mwSize)1, (mwSize)n_size, mxREAL);
-  /* copy data */
-  prBLinvJ = (double *)mxGetPr(BLinv_blockJ);
-  memcpy(prBLinvJ, prBLJ, (size_t)n_size * sizeof(double));
-  /* set each field in BLinv_block structure */
-  mxSetFieldByNumber(BLinv_block, (mwIndex)0, 0, BLinv_blockJ);
-
-  /* structure element 1:  I */
-  /* create empty BLinv{k}.I */
+  /* extract BL{k}, compact blocks are read in place */
+  if (BL_compact) {
+    prBLJ = selbinv_index_set_pr(&BL_pool, k, SELBINV_J, BL_buff, &n_size);
+    prBLD = selbinv_pool_values(&BL_pool, k, SELBINV_D);
+  } else {
+    BL_block = mxGetCell(BL, k);
+
+    /* extract source BL{k}.J */
+    BL_blockJ = mxGetField(BL_block, 0, "J");
+    n_size = mxGetN(BL_blockJ) * mxGetM(BL_blockJ);
+    prBLJ = (double *)mxGetPr(BL_blockJ);
+    /* BL{k}.I and BL{k}.L should be empty */
+    /* extract source BL{k}.D */
+    BL_blockD = mxGetField(BL_block, 0, "D");
+    if (BL_blockD == NULL)
+      mexErrMsgTxt("Field BL{k}.D does not exist.");
+    if (mxGetN(BL_blockD) != n_size || mxGetM(BL_blockD) != n_size ||
+        !mxIsNumeric(BL_blockD))
+      mexErrMsgTxt(
+          "Field BL{k}.D must be square dense matrix of same size as BL{k}.J.");
+    /* numerical values of BL{k}.D */
+    prBLD = (double *)mxGetPr(BL_blockD);
+  }
+
+  /* extract BD{k}, the 1x1 and 2x2 blocks of compact blocks are read from
+     their dense values */
+  if (BD_compact) {
+    if (BD_pool.ind_ptr[2 * k + 1] - BD_pool.ind_ptr[2 * k] != n_size)
+      mexErrMsgTxt("Field BD{k}.D must be of same size as BL{k}.J.");
+    selbinv_pool_pivots(&BD_pool, k, BD_ia, BD_ja, BD_pr);
+    ia = BD_ia;
+    ja = BD_ja;
+    prBDD = BD_pr;
+  } else {
+    BD_block = mxGetCell(BD, k);
+    if (!mxIsStruct(BD_block))
+      mexErrMsgTxt("Field BD{k} must be a structure.");
+
+    /* extract source BD{k}.D */
+    BD_blockD = mxGetField(BD_block, 0, "D");
+    if (BD_blockD == NULL)
+      mexErrMsgTxt("Field BD{k}.D does not exist.");
+    if (mxGetN(BD_blockD) != n_size || mxGetM(BD_blockD) != n_size ||
+        !mxIsSparse(BD_blockD))
+      mexErrMsgTxt("Field BD{k}.D must be square sparse matrix of same size as "
+                   "BL{k}.J.");
+    /* sparse representation of BD{k}.D */
+    ia = (mwIndex *)mxGetJc(BD_blockD);
+    ja = (mwIndex *)mxGetIr(BD_blockD);
+    prBDD = (double *)mxGetPr(BD_blockD);
+  }
+
   m_size = 0;
-  BLinv_blockI = mxCreateDoubleMatrix((mwSize)1, (mwSize)m_size, mxREAL);
-  /* set each field in BLinv_block structure */
-  mxSetFieldByNumber(BLinv_block, (mwIndex)0, 1, BLinv_blockI);
-
-  /* structure element 2:  L */
-  /* create empty BLinv{k}.L */
-  BLinv_blockL = mxCreateDoubleMatrix((mwSize)m_size, (mwSize)n_size, mxREAL);
-  /* set each field in BLinv_block structure */
-  mxSetFieldByNumber(BLinv_block, (mwIndex)0, 2, BLinv_blockL);
-
-  /* structure element 3:  D */
-  /* create dense n_size x n_size matrix BLinv{k}.D */
-  BLinv_blockD = mxCreateDoubleMatrix((mwSize)n_size, (mwSize)n_size, mxREAL);
-  prBLinvD = (double *)mxGetPr(BLinv_blockD);
+  if (BL_compact) {
+    /* BLinv{k} has the index sets of BL{k}, and its values L and D follow
+       each other in the compact output or in a plain array */
+    prBLinvJ = prBLJ;
+    BLinv_val[k] = selbinv_values(BLinv_store, k, SELBINV_L,
+                                  (size_t)(n_size * n_size),
+                                  "DSYMselbinv:BLinv_val");
+    BLinv_D = BLinv_val[k];
+  } else {
+    /* set up new block column for BLinv{k} with four elements J, I, L, D */
+    BLinv_block = mxCreateStructMatrix((mwSize)1, (mwSize)1, 4, BLnames);
+
+    /* structure element 0:  J */
+    /* create BLinv{k}.J */
+    BLinv_blockJ = mxCreateDoubleMatrix((mwSize)1, (mwSize)n_size, mxREAL);
+    /* copy data */
+    prBLinvJ = (double *)mxGetPr(BLinv_blockJ);
+    memcpy(prBLinvJ, prBLJ, (size_t)n_size * sizeof(double));
+    /* set each field in BLinv_block structure */
+    mxSetFieldByNumber(BLinv_block, (mwIndex)0, 0, BLinv_blockJ);
+
+    /* structure element 1:  I */
+    /* create empty BLinv{k}.I */
+    BLinv_blockI = mxCreateDoubleMatrix((mwSize)1, (mwSize)m_size, mxREAL);
+    /* set each field in BLinv_block structure */
+    mxSetFieldByNumber(BLinv_block, (mwIndex)0, 1, BLinv_blockI);
+
+    /* structure element 2:  L */
+    /* create empty BLinv{k}.L */
+    BLinv_blockL = mxCreateDoubleMatrix((mwSize)m_size, (mwSize)n_size, mxREAL);
+    /* set each field in BLinv_block structure */
+    mxSetFieldByNumber(BLinv_block, (mwIndex)0, 2, BLinv_blockL);
+
+    /* structure element 3:  D */
+    /* create dense n_size x n_size matrix BLinv{k}.D */
+    BLinv_blockD = mxCreateDoubleMatrix((mwSize)n_size, (mwSize)n_size, mxREAL);
+    BLinv_D = (double *)mxGetPr(BLinv_blockD);
+  }
+  prBLinvD = BLinv_D;
   /* copy lower triangular part column by column */
   for (j = 0; j < n_size; j++) {
     /* init strict upper triangular part with zeros */
@@ -367,7 +461,7 @@ void mexFunction(
 #ifdef PRINT_INFO
   mexPrintf("DSYMselbinv: final lower triangular part copied\n");
   fflush(stdout);
-  prBLinvD = (double *)mxGetPr(BLinv_blockD);
+  prBLinvD = BLinv_D;
   mexPrintf("        ");
   for (j = 0; j < n_size; j++)
     mexPrintf("%8d", ipiv[j]);
@@ -388,7 +482,7 @@ void mexFunction(
 #endif
 
   /* use LAPACK's dsytri_ for matrix inversion given the LDL^T decompositon */
-  prBLinvD = (double *)mxGetPr(BLinv_blockD);
+  prBLinvD = BLinv_D;
   j = 0;
   dsytri_("L", &n_size, prBLinvD, &n_size, ipiv, work, &j, 1);
   if (j < 0) {
@@ -404,7 +498,7 @@ void mexFunction(
 #ifdef PRINT_INFO
   mexPrintf("DSYMselbinv: final inverse lower triangular part computed\n");
   fflush(stdout);
-  prBLinvD = (double *)mxGetPr(BLinv_blockD);
+  prBLinvD = BLinv_D;
   mexPrintf("        ");
   for (j = 0; j < n_size; j++)
     mexPrintf("%8d", (integer)prBLinvJ[j]);
@@ -444,7 +538,7 @@ void mexFunction(
   fflush(stdout);
   mexPrintf("DSYMselbinv: final inverse diagonal block computed\n");
   fflush(stdout);
-  prBLinvD = (double *)mxGetPr(BLinv_blockD);
+  prBLinvD = BLinv_D;
   mexPrintf("        ");
   for (j = 0; j < n_size; j++)
     mexPrintf("%8d", (integer)prBLinvJ[j]);
@@ -459,11 +553,20 @@ void mexFunction(
   }
 #endif
 
-  /* set each field in BLinv_block structure */
-  mxSetFieldByNumber(BLinv_block, (mwIndex)0, 3, BLinv_blockD);
+  if (!BL_compact) {
+    /* set each field in BLinv_block structure */
+    mxSetFieldByNumber(BLinv_block, (mwIndex)0, 3, BLinv_blockD);
 
-  /* finally set output BLinv{k} */
-  mxSetCell(BLinv, (mwIndex)k, BLinv_block);
+    /* finally set output BLinv{k} */
+    mxSetCell(BLinv, (mwIndex)k, BLinv_block);
+  }
+  if (last != NULL) {
+    n_expired = selbinv_expired(&BL_pool, NULL, k, block, last, expired);
+    if (BL_compact)
+      selbinv_release_values(BLinv_val, expired, n_expired);
+    else
+      selbinv_release(BLinv, expired, n_expired);
+  }
 
   /* advance backwards toward the top */
   k--;
@@ -471,89 +574,119 @@ void mexFunction(
   /* main loop */
   while (k >= 0) {
 
-    /* extract BL{k} */
-    BL_block = mxGetCell(BL, k);
-
-    /* 1. BL{k}.J */
-    BL_blockJ = mxGetField(BL_block, 0, "J");
-    n_size = mxGetN(BL_blockJ) * mxGetM(BL_blockJ);
-    prBLJ = (double *)mxGetPr(BL_blockJ);
-    /* 2. BL{k}.I */
-    BL_blockI = mxGetField(BL_block, 0, "I");
-    if (BL_blockI == NULL)
-      mexErrMsgTxt("Field BL{k}.I does not exist.");
-    m_size = mxGetN(BL_blockI) * mxGetM(BL_blockI);
+    /* extract BL{k}, compact blocks are read in place */
+    if (BL_compact) {
+      prBLJ = selbinv_index_set_pr(&BL_pool, k, SELBINV_J, BL_buff, &n_size);
+      prBLI = selbinv_index_set_pr(&BL_pool, k, SELBINV_I, BL_buff + n_size,
+                                   &m_size);
+      prBLL = selbinv_pool_values(&BL_pool, k, SELBINV_L);
+      prBLD = selbinv_pool_values(&BL_pool, k, SELBINV_D);
+    } else {
+      BL_block = mxGetCell(BL, k);
+
+      /* 1. BL{k}.J */
+      BL_blockJ = mxGetField(BL_block, 0, "J");
+      n_size = mxGetN(BL_blockJ) * mxGetM(BL_blockJ);
+      prBLJ = (double *)mxGetPr(BL_blockJ);
+      /* 2. BL{k}.I */
+      BL_blockI = mxGetField(BL_block, 0, "I");
+      if (BL_blockI == NULL)
+        mexErrMsgTxt("Field BL{k}.I does not exist.");
+      m_size = mxGetN(BL_blockI) * mxGetM(BL_blockI);
 #ifdef PRINT_CHECK
-    if (mxGetM(BL_blockI) != 1 && mxGetN(BL_blockI) != 1) {
-      mexPrintf("BL{%d}.I must be a 1-dim. array!\n", k + 1);
-      fflush(stdout);
-    }
+      if (mxGetM(BL_blockI) != 1 && mxGetN(BL_blockI) != 1) {
+        mexPrintf("BL{%d}.I must be a 1-dim. array!\n", k + 1);
+        fflush(stdout);
+      }
 #endif
-    prBLI = (double *)mxGetPr(BL_blockI);
-    /* 3. BL{k}.L */
-    BL_blockL = mxGetField(BL_block, 0, "L");
-    if (BL_blockL == NULL)
-      mexErrMsgTxt("Field BL{k}.L does not exist.");
-    /* numerical values of BL{k}.L */
-    prBLL = (double *)mxGetPr(BL_blockL);
-    /* 4. BL{k}.D */
-    BL_blockD = mxGetField(BL_block, 0, "D");
-    if (BL_blockD == NULL)
-      mexErrMsgTxt("Field BL{k}.D does not exist.");
-    if (mxGetN(BL_blockD) != n_size || mxGetM(BL_blockD) != n_size ||
-        !mxIsNumeric(BL_blockD))
-      mexErrMsgTxt(
-          "Field BL{k}.D must be square dense matrix of same size as BL{k}.J.");
-    /* numerical values of BL{k}.D */
-    prBLD = (double *)mxGetPr(BL_blockD);
-
-    /* extract BD{k} */
-    BD_block = mxGetCell(BD, k);
-    if (!mxIsStruct(BD_block))
-      mexErrMsgTxt("Field BD{k} must be a structure.");
-
-    /* extract source BD{k}.D */
-    BD_blockD = mxGetField(BD_block, 0, "D");
-    if (BD_blockD == NULL)
-      mexErrMsgTxt("Field BD{k}.D does not exist.");
-    if (mxGetN(BD_blockD) != n_size || mxGetM(BD_blockD) != n_size ||
-        !mxIsSparse(BD_blockD))
-      mexErrMsgTxt("Field BD{k}.D must be square sparse matrix of same size as "
-                   "BL{k}.J.");
-    /* sparse representation of BD{k}.D */
-    ia = (mwIndex *)mxGetJc(BD_blockD);
-    ja = (mwIndex *)mxGetIr(BD_blockD);
-    prBDD = (double *)mxGetPr(BD_blockD);
-
-    /* set up new block column for BLinv{k} with four elements J, I, L, D */
-    BLinv_block = mxCreateStructMatrix((mwSize)1, (mwSize)1, 4, BLnames);
-
-    /* structure element 0:  J */
-    /* create BLinv{k}.J */
-    BLinv_blockJ = mxCreateDoubleMatrix((mwSize)1, (mwSize)n_size, mxREAL);
-    /* copy data */
-    prBLinvJ = (double *)mxGetPr(BLinv_blockJ);
-    memcpy(prBLinvJ, prBLJ, (size_t)n_size * sizeof(double));
-    /* set each field in BLinv_block structure */
-    mxSetFieldByNumber(BLinv_block, (mwIndex)0, 0, BLinv_blockJ);
+      prBLI = (double *)mxGetPr(BL_blockI);
+      /* 3. BL{k}.L */
+      BL_blockL = mxGetField(BL_block, 0, "L");
+      if (BL_blockL == NULL)
+        mexErrMsgTxt("Field BL{k}.L does not exist.");
+      /* numerical values of BL{k}.L */
+      prBLL = (double *)mxGetPr(BL_blockL);
+      /* 4. BL{k}.D */
+      BL_blockD = mxGetField(BL_block, 0, "D");
+      if (BL_blockD == NULL)
+        mexErrMsgTxt("Field BL{k}.D does not exist.");
+      if (mxGetN(BL_blockD) != n_size || mxGetM(BL_blockD) != n_size ||
+          !mxIsNumeric(BL_blockD))
+        mexErrMsgTxt("Field BL{k}.D must be square dense matrix of same size "
+                     "as BL{k}.J.");
+      /* numerical values of BL{k}.D */
+      prBLD = (double *)mxGetPr(BL_blockD);
+    }
 
-    /* structure element 1:  I */
-    /* create empty BLinv{k}.I */
-    BLinv_blockI = mxCreateDoubleMatrix((mwSize)1, (mwSize)m_size, mxREAL);
-    /* copy data */
-    prBLinvI = (double *)mxGetPr(BLinv_blockI);
-    memcpy(prBLinvI, prBLI, (size_t)m_size * sizeof(double));
-    /* set each field in BLinv_block structure */
-    mxSetFieldByNumber(BLinv_block, (mwIndex)0, 1, BLinv_blockI);
+    /* extract BD{k}, the 1x1 and 2x2 blocks of compact blocks are read
+       from their dense values */
+    if (BD_compact) {
+      if (BD_pool.ind_ptr[2 * k + 1] - BD_pool.ind_ptr[2 * k] != n_size)
+        mexErrMsgTxt("Field BD{k}.D must be of same size as BL{k}.J.");
+      selbinv_pool_pivots(&BD_pool, k, BD_ia, BD_ja, BD_pr);
+      ia = BD_ia;
+      ja = BD_ja;
+      prBDD = BD_pr;
+    } else {
+      BD_block = mxGetCell(BD, k);
+      if (!mxIsStruct(BD_block))
+        mexErrMsgTxt("Field BD{k} must be a structure.");
+
+      /* extract source BD{k}.D */
+      BD_blockD = mxGetField(BD_block, 0, "D");
+      if (BD_blockD == NULL)
+        mexErrMsgTxt("Field BD{k}.D does not exist.");
+      if (mxGetN(BD_blockD) != n_size || mxGetM(BD_blockD) != n_size ||
+          !mxIsSparse(BD_blockD))
+        mexErrMsgTxt("Field BD{k}.D must be square sparse matrix of same size "
+                     "as BL{k}.J.");
+      /* sparse representation of BD{k}.D */
+      ia = (mwIndex *)mxGetJc(BD_blockD);
+      ja = (mwIndex *)mxGetIr(BD_blockD);
+      prBDD = (double *)mxGetPr(BD_blockD);
+    }
 
-    /* structure element 2:  L */
-    /* create empty BLinv{k}.L */
-    BLinv_blockL = mxCreateDoubleMatrix((mwSize)m_size, (mwSize)n_size, mxREAL);
-    prBLinvL = (double *)mxGetPr(BLinv_blockL);
+    if (BL_compact) {
+      /* BLinv{k} has the index sets of BL{k}, and its values L and D follow
+         each other in the compact output or in a plain array */
+      prBLinvJ = prBLJ;
+      prBLinvI = prBLI;
+      BLinv_val[k] = selbinv_values(BLinv_store, k, SELBINV_L,
+                                    (size_t)((m_size + n_size) * n_size),
+                                    "DSYMselbinv:BLinv_val");
+      prBLinvL = BLinv_val[k];
+      BLinv_D = BLinv_val[k] + m_size * n_size;
+    } else {
+      /* set up new block column for BLinv{k} with four elements J, I, L, D */
+      BLinv_block = mxCreateStructMatrix((mwSize)1, (mwSize)1, 4, BLnames);
+
+      /* structure element 0:  J */
+      /* create BLinv{k}.J */
+      BLinv_blockJ = mxCreateDoubleMatrix((mwSize)1, (mwSize)n_size, mxREAL);
+      /* copy data */
+      prBLinvJ = (double *)mxGetPr(BLinv_blockJ);
+      memcpy(prBLinvJ, prBLJ, (size_t)n_size * sizeof(double));
+      /* set each field in BLinv_block structure */
+      mxSetFieldByNumber(BLinv_block, (mwIndex)0, 0, BLinv_blockJ);
+
+      /* structure element 1:  I */
+      /* create empty BLinv{k}.I */
+      BLinv_blockI = mxCreateDoubleMatrix((mwSize)1, (mwSize)m_size, mxREAL);
+      /* copy data */
+      prBLinvI = (double *)mxGetPr(BLinv_blockI);
+      memcpy(prBLinvI, prBLI, (size_t)m_size * sizeof(double));
+      /* set each field in BLinv_block structure */
+      mxSetFieldByNumber(BLinv_block, (mwIndex)0, 1, BLinv_blockI);
+
+      /* structure element 2:  L */
+      /* create empty BLinv{k}.L */
+      BLinv_blockL =
+          mxCreateDoubleMatrix((mwSize)m_size, (mwSize)n_size, mxREAL);
+      prBLinvL = (double *)mxGetPr(BLinv_blockL);
+    }
     /* init with zeros */
     for (j = 0; j < m_size * n_size; j++)
-      *prBLinvL++ = 0.0;
-    prBLinvL = (double *)mxGetPr(BLinv_blockL);
+      prBLinvL[j] = 0.0;
 
     /* scan the indices of BL{k}.I to find out which block columns are required
      */
@@ -582,65 +715,75 @@ void mexFunction(
       }   /* end while flag */
       /* now BL{k}.I(l:j) are associated with block column BLinv{i} */
 
-      /* extract already computed BLinv{i}, i>k */
-      BLinv_blocki = mxGetCell(BLinv, (mwIndex)i);
+      /* extract already computed BLinv{i}, i>k. For compact input it has
+         the index sets of BL{i} and its values are kept in BLinv_val[i] */
+      if (BL_compact) {
+        prBLinvJi = selbinv_index_set_pr(&BL_pool, i, SELBINV_J, BLinv_buff,
+                                         &ni_size);
+        prBLinvIi = selbinv_index_set_pr(&BL_pool, i, SELBINV_I,
+                                         BLinv_buff + ni_size, &mi_size);
+        prBLinvLi = BLinv_val[i];
+        prBLinvDi = BLinv_val[i] + mi_size * ni_size;
+      } else {
+        BLinv_blocki = mxGetCell(BLinv, (mwIndex)i);
 #ifdef PRINT_CHECK
-      if (BLinv_blocki == NULL) {
-        mexPrintf("BLinv{%d} does not exist!\n", i + 1);
-        fflush(stdout);
-      } else if (!mxIsStruct(BLinv_blocki)) {
-        mexPrintf("BLinv{%d} must be structure!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BLinv_blocki == NULL) {
+          mexPrintf("BLinv{%d} does not exist!\n", i + 1);
+          fflush(stdout);
+        } else if (!mxIsStruct(BLinv_blocki)) {
+          mexPrintf("BLinv{%d} must be structure!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
 
-      /* BLinv{i}.J */
-      BLinv_blockJi = mxGetField(BLinv_blocki, 0, "J");
+        /* BLinv{i}.J */
+        BLinv_blockJi = mxGetField(BLinv_blocki, 0, "J");
 #ifdef PRINT_CHECK
-      if (BLinv_blockJi == NULL) {
-        mexPrintf("BLinv{%d}.J does not exist!\n", i + 1);
-        fflush(stdout);
-      } else if (mxGetM(BLinv_blockJi) != 1 && mxGetN(BLinv_blockJi) != 1) {
-        mexPrintf("BLinv{%d}.J must be a 1-dim. array!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BLinv_blockJi == NULL) {
+          mexPrintf("BLinv{%d}.J does not exist!\n", i + 1);
+          fflush(stdout);
+        } else if (mxGetM(BLinv_blockJi) != 1 && mxGetN(BLinv_blockJi) != 1) {
+          mexPrintf("BLinv{%d}.J must be a 1-dim. array!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
-      ni_size = mxGetN(BLinv_blockJi) * mxGetM(BLinv_blockJi);
-      prBLinvJi = (double *)mxGetPr(BLinv_blockJi);
+        ni_size = mxGetN(BLinv_blockJi) * mxGetM(BLinv_blockJi);
+        prBLinvJi = (double *)mxGetPr(BLinv_blockJi);
 
-      /* BLinv{i}.I */
-      BLinv_blockIi = mxGetField(BLinv_blocki, 0, "I");
+        /* BLinv{i}.I */
+        BLinv_blockIi = mxGetField(BLinv_blocki, 0, "I");
 #ifdef PRINT_CHECK
-      if (BLinv_blockIi == NULL) {
-        mexPrintf("BLinv{%d}.I does not exist!\n", i + 1);
-        fflush(stdout);
-      } else if (mxGetM(BLinv_blockIi) != 1 && mxGetN(BLinv_blockIi) != 1) {
-        mexPrintf("BLinv{%d}.I must be a 1-dim. array!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BLinv_blockIi == NULL) {
+          mexPrintf("BLinv{%d}.I does not exist!\n", i + 1);
+          fflush(stdout);
+        } else if (mxGetM(BLinv_blockIi) != 1 && mxGetN(BLinv_blockIi) != 1) {
+          mexPrintf("BLinv{%d}.I must be a 1-dim. array!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
-      mi_size = mxGetN(BLinv_blockIi) * mxGetM(BLinv_blockIi);
-      prBLinvIi = (double *)mxGetPr(BLinv_blockIi);
+        mi_size = mxGetN(BLinv_blockIi) * mxGetM(BLinv_blockIi);
+        prBLinvIi = (double *)mxGetPr(BLinv_blockIi);
 
-      /* BLinv{i}.L */
-      BLinv_blockLi = mxGetField(BLinv_blocki, 0, "L");
+        /* BLinv{i}.L */
+        BLinv_blockLi = mxGetField(BLinv_blocki, 0, "L");
 #ifdef PRINT_CHECK
-      if (BLinv_blockLi == NULL) {
-        mexPrintf("BLinv{%d}.L does not exist!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BLinv_blockLi == NULL) {
+          mexPrintf("BLinv{%d}.L does not exist!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
-      prBLinvLi = (double *)mxGetPr(BLinv_blockLi);
+        prBLinvLi = (double *)mxGetPr(BLinv_blockLi);
 
-      /* BLinv{i}.D */
-      BLinv_blockDi = mxGetField(BLinv_blocki, 0, "D");
+        /* BLinv{i}.D */
+        BLinv_blockDi = mxGetField(BLinv_blocki, 0, "D");
 #ifdef PRINT_CHECK
-      if (BLinv_blockDi == NULL) {
-        mexPrintf("BLinv{%d}.D does not exist!\n", i + 1);
-        fflush(stdout);
-      }
+        if (BLinv_blockDi == NULL) {
+          mexPrintf("BLinv{%d}.D does not exist!\n", i + 1);
+          fflush(stdout);
+        }
 #endif
-      prBLinvDi = (double *)mxGetPr(BLinv_blockDi);
+        prBLinvDi = (double *)mxGetPr(BLinv_blockDi);
+      }
 
       /* l:j refers to continuously chosen indices !!! */
       /* Ji, Ik and Ii may exclude some entries !!! */
@@ -1242,7 +1385,7 @@ void mexFunction(
               else { /* indices match */
 
                 /* copy current row of pr2 to BLinv{k}.L(Ik,:) */
-                pr = (double *)mxGetPr(BLinv_blockL) + p;
+                pr = prBLinvL + p;
                 pr3 = pr2;
                 for (r = 0; r < n_size; r++, pr += m_size, pr3 += t)
                   *pr -= *pr3;
@@ -1978,13 +2121,17 @@ void mexFunction(
     }
 #endif
 
-    /* set each field in BLinv_block structure */
-    mxSetFieldByNumber(BLinv_block, (mwIndex)0, 2, BLinv_blockL);
+    if (!BL_compact) {
+      /* set each field in BLinv_block structure */
+      mxSetFieldByNumber(BLinv_block, (mwIndex)0, 2, BLinv_blockL);
 
-    /* structure element 3:  BLinv{k}.D */
-    /* create dense n_size x n_size BLinv{k}.D */
-    BLinv_blockD = mxCreateDoubleMatrix((mwSize)n_size, (mwSize)n_size, mxREAL);
-    prBLinvD = (double *)mxGetPr(BLinv_blockD);
+      /* structure element 3:  BLinv{k}.D */
+      /* create dense n_size x n_size BLinv{k}.D */
+      BLinv_blockD =
+          mxCreateDoubleMatrix((mwSize)n_size, (mwSize)n_size, mxREAL);
+      BLinv_D = (double *)mxGetPr(BLinv_blockD);
+    }
+    prBLinvD = BLinv_D;
     /* copy strict lower triangular par */
     for (j = 0; j < n_size; j++) {
       /* init strict upper triangular part with zeros */
@@ -2041,7 +2188,7 @@ void mexFunction(
         *prBLinvD++ = *prBLD++;
     } /* end for j */
     /* use LAPACK's dsytri_ for matrix inversion given the LDL^T decompositon */
-    prBLinvD = (double *)mxGetPr(BLinv_blockD);
+    prBLinvD = BLinv_D;
     j = 0;
     dsytri_("L", &n_size, prBLinvD, &n_size, ipiv, work, &j, 1);
     if (j < 0) {
@@ -2065,7 +2212,7 @@ void mexFunction(
       for (i = j + 1; i < n_size; i++, pr += n_size)
         *pr = *prBLinvD++;
     } /* end for j */
-    prBLinvD = (double *)mxGetPr(BLinv_blockD);
+    prBLinvD = BLinv_D;
 
     /* BLinv{k}.D = - BL{k}.L^T *BLinv{k}.L + BLinv{k}.D */
     /* call level 3 BLAS */
@@ -2097,7 +2244,7 @@ void mexFunction(
 #ifdef PRINT_INFO
     mexPrintf("DSYMselbinv: %d-th inverse diagonal block computed\n", k + 1);
     fflush(stdout);
-    prBLinvD = (double *)mxGetPr(BLinv_blockD);
+    prBLinvD = BLinv_D;
     mexPrintf("        ");
     for (j = 0; j < n_size; j++)
       mexPrintf("%8d", (integer)prBLinvJ[j]);
@@ -2112,11 +2259,21 @@ void mexFunction(
     }
 #endif
 
-    /* set each field in BLinv_block structure */
-    mxSetFieldByNumber(BLinv_block, (mwIndex)0, 3, BLinv_blockD);
+    if (!BL_compact) {
+      /* set each field in BLinv_block structure */
+      mxSetFieldByNumber(BLinv_block, (mwIndex)0, 3, BLinv_blockD);
 
-    /* finally set output BLinv{k} */
-    mxSetCell(BLinv, (mwIndex)k, BLinv_block);
+      /* finally set output BLinv{k} */
+      mxSetCell(BLinv, (mwIndex)k, BLinv_block);
+    }
+    /* release the blocks that are no longer needed */
+    if (last != NULL) {
+      n_expired = selbinv_expired(&BL_pool, NULL, k, block, last, expired);
+      if (BL_compact)
+        selbinv_release_values(BLinv_val, expired, n_expired);
+      else
+        selbinv_release(BLinv, expired, n_expired);
+    }
 
     k--;
   } /* end while k>=0 */
@@ -2143,6 +2300,21 @@ void mexFunction(
   free(Dbuff);
   free(gemm_buff);
   free(block);
+  if (last != NULL) {
+    free(last);
+    free(expired);
+  }
+  if (BL_compact) {
+    free(BLinv_val);
+    free(BL_buff);
+    free(BLinv_buff);
+  } else if (nlhs < 2)
+    mxDestroyArray(BLinv);
+  if (BD_compact) {
+    free(BD_ia);
+    free(BD_ja);
+    free(BD_pr);
+  }
 
 #ifdef PRINT_INFO
   mexPrintf("DSYMselbinv: memory released\n");
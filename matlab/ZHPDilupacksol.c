@@ -75,7 +75,7 @@ void mexFunction(
   mxArray *PRE_input, *b_input, *tmp, *fout;
   int i, j, k, l, m, ifield, nfields;
   char *pdata;
-  double *pr, *pi;
+  double *pr, *pi, rs;
   doublecomplex *dbuff, *sol, *rhs;
 
   if (nrhs != 2)
@@ -119,32 +119,22 @@ void mexFunction(
       param->dbuff, (size_t)param->ndbuff * sizeof(doublecomplex),
       "ZHPDilupacksol:rhs");
 
+  /* copy and rescale right hand side in a single pass */
   rhs = param->dbuff;
+  if (PRE->issingle)
+    SPRE = (CAMGlevelmat *)PRE;
   if (!mxIsComplex(b_input)) {
     for (i = 0; i < n; i++) {
-      rhs[i].r = pr[i];
+      rs = (PRE->issingle) ? (double)SPRE->rowscal[i].r : PRE->rowscal[i].r;
+      rhs[i].r = pr[i] * rs;
       rhs[i].i = 0;
-      ;
     }
   } else {
     pi = mxGetPi(b_input);
     for (i = 0; i < n; i++) {
-      rhs[i].r = pr[i];
-      rhs[i].i = pi[i];
-    }
-  }
-
-  /* rescale right hand side */
-  if (PRE->issingle) {
-    SPRE = (CAMGlevelmat *)PRE;
-    for (i = 0; i < n; i++) {
-      rhs[i].r = rhs[i].r * (double)SPRE->rowscal[i].r;
-      rhs[i].i = rhs[i].i * (double)SPRE->rowscal[i].r;
-    }
-  } else {
-    for (i = 0; i < n; i++) {
-      rhs[i].r = rhs[i].r * PRE->rowscal[i].r;
-      rhs[i].i = rhs[i].i * PRE->rowscal[i].r;
+      rs = (PRE->issingle) ? (double)SPRE->rowscal[i].r : PRE->rowscal[i].r;
+      rhs[i].r = pr[i] * rs;
+      rhs[i].i = pi[i] * rs;
     }
   }
 
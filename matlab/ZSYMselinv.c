@@ -12,6 +12,10 @@
     % for initializing parameters
     Linv=ZSYMselinv(L,D,p, Delta)
 
+    % compute independent subtrees of the elimination tree in parallel
+    % with up to nthreads threads, if compiled with OpenMP
+    Linv=ZSYMselinv(L,D,p, Delta, nthreads)
+
 
     Authors:
 
@@ -47,12 +51,569 @@
 #include <stdlib.h>
 #include <string.h>
 
-#define MAX_FIELDS 100
-#define MAX(A, B) (((A) >= (B)) ? (A) : (B))
-#define MIN(A, B) (((A) >= (B)) ? (B) : (A))
-#define ELBOW MAX(4.0, 2.0)
-/* #define PRINT_CHECK */
-/* #define PRINT_INFO  */
+#include "selinvtree.h"
+
+#define MAX_FIELDS 100
+#define MAX(A, B) (((A) >= (B)) ? (A) : (B))
+#define MIN(A, B) (((A) >= (B)) ? (B) : (A))
+#define ELBOW MAX(4.0, 2.0)
+/* #define PRINT_CHECK */
+/* #define PRINT_INFO  */
+
+/* compute the columns of the selected inverse in the 1x1 or 2x2 block
+   ending at column j, which only reads the columns of its ancestors in
+   the elimination tree */
+static void ZSYMselinv_block(integer j, mwIndex *L_ia, mwIndex *L_ja,
+                             double *L_valuesR, double *L_valuesI,
+                             integer flag_piL, mwIndex *D_ia, mwIndex *D_ja,
+                             double *D_valuesR, double *D_valuesI,
+                             integer flag_piD, integer *ia, integer *ja,
+                             doubleprecision *ainvr, doubleprecision *ainvi) {
+  integer k, l, m, kk, ll, mm, flag;
+  doubleprecision Djm1jm1r, Djm1jm1i, Djjm1r, Djjm1i, Djjr, Djji, detr, deti,
+      nrm;
+
+  /* 1x1 or 2x2 case ? */
+  if (j == 0)
+    flag = 0;
+  else if (D_ia[j + 1] - D_ia[j] == 1)
+    flag = 0;
+  else /* 2x2 case */
+    flag = -1;
+
+  /* 1x1 case */
+
+  if (!flag) {
+/* mexPrintf("j=%d\n",j+1);fflush(stdout); */
+
+/************ Compute  Ainv(I,j)=-Ainv(I,I)*L(I,j) ******************/
+/* recall that the entries of ainv are already initialized with 0.0 */
+/* starting position in L(j+1:n,j)*/
+#ifdef PRINT_CHECK
+    if (L_ja[L_ia[j]] != j) {
+      mexPrintf("L: mismatch (%d,%d)\n", L_ja[L_ia[j]] + 1, j + 1);
+      fflush(stdout);
+    }
+#endif
+    for (m = L_ia[j] + 1; m < L_ia[j + 1]; m++) {
+      /* column index k>j of L(k,j) */
+      k = L_ja[m];
+/* mexPrintf("(%d,%d)\n",k+1,j+1);fflush(stdout); */
+/* update Ainv(I,j) with -Ainv(I,k)*L(k,j) */
+/* 1. part: lower triangular and diagonal part of Ainv(I,k) */
+/* starting positions column of Ainv(j+1:n,j) and k of Ainv(k:n,k) */
+#ifdef PRINT_CHECK
+      if (ja[ia[j]] != j) {
+        mexPrintf("Ainv: mismatch (%d,%d)\n", ja[ia[j]] + 1, j + 1);
+        fflush(stdout);
+      }
+#endif
+      l = ia[j] + 1;
+      mm = ia[k];
+      flag = 0;
+      while (l < ia[j + 1] && mm < ia[k + 1]) {
+        /* Ainv(kk,j) */
+        kk = ja[l];
+        /* Ainv(ll,k) */
+        ll = ja[mm];
+        if (kk < ll)
+          l++;
+        else if (ll < kk)
+          mm++;
+        else { /* indices match */
+          /* store the location l of Ainv(k,j) and avoid duplicate update */
+          if (kk == k)
+            flag = l;
+          else {
+            /* Ainv(kk,j)=Ainv(kk,j)-Ainv(kk,k)*L(k,j) */
+            ainvr[l] -= ainvr[mm] * L_valuesR[m] -
+                        ((flag_piL) ? ainvi[mm] * L_valuesI[m] : 0.0);
+            ainvi[l] -= ((flag_piL) ? ainvr[mm] * L_valuesI[m] : 0.0) +
+                        ainvi[mm] * L_valuesR[m];
+            /* mexPrintf("[%d,%d,%d]\n",kk+1,k+1,j+1);fflush(stdout);
+               mexPrintf("{%8.1le+%8.1lei,%8.1le+%8.1lei,%8.1le+%8.1lei}\n",ainvr[l],ainvi[l],ainvr[mm],ainvi[mm],L_valuesR[m],L_valuesI[m]);fflush(stdout);
+            */
+          }
+          l++;
+          mm++;
+        }
+      } /* end while */
+#ifdef PRINT_CHECK
+      if (!flag) {
+        mexPrintf("Ainv: row index %d is missing in column %d\n", k + 1,
+                  j + 1);
+        fflush(stdout);
+      }
+#endif
+/* 2. part: strict upper triangular of Ainv(I,k), which is not
+ stored but contributes to Ainv(k,j). Here use Ainv(I,k)^T */
+#ifdef PRINT_CHECK
+      if (L_ja[L_ia[j]] != j) {
+        mexPrintf("L: mismatch (%d,%d)\n", L_ja[L_ia[j]] + 1, j + 1);
+        fflush(stdout);
+      }
+#endif
+      l = L_ia[j] + 1;
+      mm = ia[k];
+      while (l < L_ia[j + 1] && mm < ia[k + 1]) {
+        /* L(kk,j) */
+        kk = L_ja[l];
+        /* Ainv(ll,k) */
+        ll = ja[mm];
+        if (kk < ll)
+          l++;
+        else if (ll < kk)
+          mm++;
+        else { /* indices match */
+               /* Ainv(k,j)=Ainv(k,j)-Ainv(kk,k)^T*L(kk,j) */
+          ainvr[flag] -= ainvr[mm] * L_valuesR[l] -
+                         ((flag_piL) ? ainvi[mm] * L_valuesI[l] : 0.0);
+          ainvi[flag] -= ((flag_piL) ? ainvr[mm] * L_valuesI[l] : 0.0) +
+                         ainvi[mm] * L_valuesR[l];
+          /* mexPrintf("[%d,%d,%d]\n",ja[flag]+1,kk+1,j+1);fflush(stdout);
+             mexPrintf("{%8.1le+%8.1lei,%8.1le+%8.1lei,%8.1le+%8.1lei}\n",ainvr[flag],ainvi[flag],ainvr[mm],ainvi[mm],L_valuesR[l],L_valuesI[l]);fflush(stdout);
+          */
+          l++;
+          mm++;
+        }
+      } /* end while */
+    }   /* end for m */
+        /******** END Computation  Ainv(I,j)=-Ainv(I,I)*L(I,j) **************/
+
+    /*********** Compute Ainv(j,j)=1/D(j,j)-L(I,j)^T*Ainv(I,j) ***********/
+    mm = ia[j];
+    m = D_ia[j];
+    nrm = (flag_piD)
+              ? 1.0 / (D_valuesR[m] * D_valuesR[m] +
+                       D_valuesI[m] * D_valuesI[m])
+              : 1.0 / (D_valuesR[m] * D_valuesR[m]);
+    ainvr[mm] = D_valuesR[m] * nrm;
+    ainvi[mm] = (flag_piD) ? -D_valuesI[m] * nrm : 0.0;
+#ifdef PRINT_CHECK
+    if (ja[mm] != D_ja[m]) {
+      mexPrintf("Ainv,D: index mismatch at (%d,%d)\n", ja[mm] + 1,
+                D_ja[m] + 1);
+      fflush(stdout);
+    }
+#endif
+#ifdef PRINT_CHECK
+    if (L_ja[L_ia[j]] != j) {
+      mexPrintf("L: mismatch (%d,%d)\n", L_ja[L_ia[j]] + 1, j + 1);
+      fflush(stdout);
+    }
+#endif
+#ifdef PRINT_CHECK
+    if (ja[ia[j]] != j) {
+      mexPrintf("Ainv: mismatch (%d,%d)\n", ja[ia[j]] + 1, j + 1);
+      fflush(stdout);
+    }
+#endif
+    l = ia[j] + 1;
+    m = L_ia[j] + 1;
+    while (l < ia[j + 1] && m < L_ia[j + 1]) {
+      /* L(kk,j) */
+      kk = L_ja[m];
+      /* Ainv(ll,j) */
+      ll = ja[l];
+      if (kk < ll)
+        m++;
+      else if (ll < kk)
+        l++;
+      else { /* indices match */
+        /* Ainv(j,j)=Ainv(j,j)-L(kk,j)^T*Ainv(kk,j) */
+        ainvr[mm] -= L_valuesR[m] * ainvr[l] -
+                     ((flag_piL) ? L_valuesI[m] * ainvi[l] : 0.0);
+        ainvi[mm] -= L_valuesR[m] * ainvi[l] +
+                     ((flag_piL) ? L_valuesI[m] * ainvr[l] : 0.0);
+        m++;
+        l++;
+      }
+    } /* end while */
+    /******* END Computation Ainv(j,j)=1/D(j,j)-L(I,j)^T*Ainv(I,j) *******/
+  } else { /* 2x2 case */
+           /* mexPrintf("j=%d:%d\n",j,j+1);fflush(stdout); */
+/******** Compute  Ainv(I,j-1:j)=-Ainv(I,I)*L(I,j-1:j) **************/
+/* recall that the entries of ainv are already initialized with 0.0 */
+/* starting position in column L(j+1:n,j-1) */
+#ifdef PRINT_CHECK
+    if (L_ja[L_ia[j - 1]] != j - 1) {
+      mexPrintf("L: diagonal index mismatch at (%d,%d)\n",
+                L_ja[L_ia[j - 1]] + 1, j);
+      fflush(stdout);
+    }
+#endif
+    m = L_ia[j - 1] + 1;
+/* skip L(j,j-1) if present (which should be zero) */
+#ifdef PRINT_CHECK
+    if (L_ja[m] <= j) {
+      mexPrintf("L: L(%d,%d)=%8.1le+%8.1lei=0?\n", L_ja[m] + 1, j,
+                L_valuesR[m], L_valuesI[m]);
+      fflush(stdout);
+    }
+#endif
+    if (L_ja[m] <= j)
+      m++;
+    for (; m < L_ia[j]; m++) {
+      /* row index k of L(k,j-1) */
+      k = L_ja[m];
+/* update Ainv(I,j-1) with -Ainv(I,k)*L(k,j-1) */
+/* 1. part: lower triangular and diagonal part of Ainv(I,k) */
+/* note that the indices of Ainv(:,j-1) should start with j-1 and j */
+#ifdef PRINT_CHECK
+      if (ja[ia[j - 1]] != j - 1 || ja[ia[j - 1] + 1] != j) {
+        mexPrintf("Ainv: diagonal or sub-diagonal index mismatch at "
+                  "(%d,%d),(%d,%d)\n",
+                  ja[ia[j - 1]] + 1, j, ja[ia[j - 1] + 1] + 1, j);
+        fflush(stdout);
+      }
+#endif
+      l = ia[j - 1] + 2;
+      mm = ia[k];
+      flag = 0;
+      while (l < ia[j] && mm < ia[k + 1]) {
+        /* Ainv(kk,j-1) */
+        kk = ja[l];
+        /* Ainv(ll,k) */
+        ll = ja[mm];
+        if (kk < ll)
+          l++;
+        else if (ll < kk)
+          mm++;
+        else { /* indices match */
+          /* store the location l of Ainv(k,j) and avoid duplicate update */
+          if (kk == k)
+            flag = l;
+          else {
+            /* Ainv(kk,j-1)=Ainv(kk,j-1)-Ainv(kk,k)*L(k,j-1) */
+            ainvr[l] -= ainvr[mm] * L_valuesR[m] -
+                        ((flag_piL) ? ainvi[mm] * L_valuesI[m] : 0.0);
+            ainvi[l] -= ((flag_piL) ? ainvr[mm] * L_valuesI[m] : 0.0) +
+                        ainvi[mm] * L_valuesR[m];
+          }
+          l++;
+          mm++;
+        }
+      } /* end while */
+        /* 2. part: strict upper triangular of Ainv(I,k), which is not
+           stored but contributes to Ainv(k,j-1). Here use Ainv(I,k)^T */
+#ifdef PRINT_CHECK
+      if (L_ja[L_ia[j - 1]] != j - 1) {
+        mexPrintf("L: diagonal index mismatch at (%d,%d)\n",
+                  L_ja[L_ia[j - 1]] + 1, j);
+        fflush(stdout);
+      }
+#endif
+      l = L_ia[j - 1] + 1;
+/* skip L(j,j-1) if present (which should be zero) */
+#ifdef PRINT_CHECK
+      if (L_ja[l] <= j) {
+        mexPrintf("L: L(%d,%d)=%8.1le+%8.1lei=0??\n", L_ja[l] + 1, j,
+                  L_valuesR[l], L_valuesI[l]);
+        fflush(stdout);
+      }
+#endif
+      if (L_ja[l] <= j)
+        l++;
+      mm = ia[k];
+      while (l < L_ia[j] && mm < ia[k + 1]) {
+        /* L(kk,j-1) */
+        kk = L_ja[l];
+        /* Ainv(ll,k) */
+        ll = ja[mm];
+        if (kk < ll)
+          l++;
+        else if (ll < kk)
+          mm++;
+        else { /* indices match */
+               /* Ainv(k,j-1)=Ainv(k,j-1)-Ainv(kk,k)^T*L(kk,j-1) */
+          ainvr[flag] -= ainvr[mm] * L_valuesR[l] -
+                         ((flag_piL) ? ainvi[mm] * L_valuesI[l] : 0.0);
+          ainvi[flag] -= ((flag_piL) ? ainvr[mm] * L_valuesI[l] : 0.0) +
+                         ainvi[mm] * L_valuesR[l];
+          l++;
+          mm++;
+        }
+      } /* end while */
+    }   /* end for m */
+        /* next column, starting position in L(j+1:n,j) */
+#ifdef PRINT_CHECK
+    if (L_ja[L_ia[j]] != j) {
+      mexPrintf("L: diagonal index mismatch at (%d,%d)\n", L_ja[L_ia[j]] + 1,
+                j + 1);
+      fflush(stdout);
+    }
+#endif
+    for (m = L_ia[j] + 1; m < L_ia[j + 1]; m++) {
+      /* column index k of L(k,j) */
+      k = L_ja[m];
+/* update Ainv(I,j) with -Ainv(I,k)*L(k,j) */
+/* 1. part: lower triangular and diagonal part of Ainv(I,k) */
+/* note that the indices of Ainv(:,j) should start with j */
+#ifdef PRINT_CHECK
+      if (ja[ia[j]] != j) {
+        mexPrintf("Ainv: diagonal index mismatch at (%d,%d)\n", ja[ia[j]] + 1,
+                  j + 1);
+        fflush(stdout);
+      }
+#endif
+      l = ia[j] + 1;
+      mm = ia[k];
+      flag = 0;
+      while (l < ia[j + 1] && mm < ia[k + 1]) {
+        /* Ainv(kk,j) */
+        kk = ja[l];
+        /* Ainv(ll,k) */
+        ll = ja[mm];
+        if (kk < ll)
+          l++;
+        else if (ll < kk)
+          mm++;
+        else { /* indices match */
+          /* store the location l of Ainv(k,j) and avoid duplicate update */
+          if (kk == k)
+            flag = l;
+          else {
+            /* Ainv(kk,j)=Ainv(kk,j)-Ainv(kk,k)*L(k,j) */
+            ainvr[l] -= ainvr[mm] * L_valuesR[m] -
+                        ((flag_piL) ? ainvi[mm] * L_valuesI[m] : 0.0);
+            ainvi[l] -= ((flag_piL) ? ainvr[mm] * L_valuesI[m] : 0.0) +
+                        ainvi[mm] * L_valuesR[m];
+          }
+          l++;
+          mm++;
+        }
+      } /* end while */
+        /* 2. part: strict upper triangular of Ainv(I,k), which is not
+           stored but contributes to Ainv(k,j). Here use Ainv(I,k)^T */
+#ifdef PRINT_CHECK
+      if (L_ja[L_ia[j]] != j) {
+        mexPrintf("L: diagonal index mismatch at (%d,%d)\n",
+                  L_ja[L_ia[j]] + 1, j + 1);
+        fflush(stdout);
+      }
+#endif
+      l = L_ia[j] + 1;
+      mm = ia[k];
+      while (l < L_ia[j + 1] && mm < ia[k + 1]) {
+        /* L(kk,j) */
+        kk = L_ja[l];
+        /* Ainv(ll,k) */
+        ll = ja[mm];
+        if (kk < ll)
+          l++;
+        else if (ll < kk)
+          mm++;
+        else { /* indices match */
+          /* Ainv(k,j)=Ainv(k,j)-Ainv(kk,k)^T*L(kk,j) */
+          ainvr[flag] -= ainvr[mm] * L_valuesR[l] -
+                         ((flag_piL) ? ainvi[mm] * L_valuesI[l] : 0.0);
+          ainvi[flag] -= ((flag_piL) ? ainvr[mm] * L_valuesI[l] : 0.0) +
+                         ainvi[mm] * L_valuesR[l];
+          l++;
+          mm++;
+        }
+      } /* end while */
+    }   /* end for m */
+        /******** END Computation  Ainv(I,j)=-Ainv(I,I)*L(I,j) **************/
+
+    /* Compute
+     * Ainv(j-1:j,j-1:j)=D(j-1:j,j-1:j)^{-1}-L(I,j-1:j)^T*Ainv(I,j-1:j) */
+    /* extract D(j-1:j,j-1:j) */
+    m = D_ia[j - 1];
+#ifdef PRINT_CHECK
+    if (D_ja[m] != j - 1) {
+      mexPrintf("D: diagonal mismatch (%d,%d)\n", D_ja[m] + 1, j);
+      fflush(stdout);
+    }
+#endif
+#ifdef PRINT_CHECK
+    if (D_ja[m + 1] != j) {
+      mexPrintf("D: sub-diagonal mismatch (%d,%d)\n", D_ja[m + 1] + 1, j + 1);
+      fflush(stdout);
+    }
+#endif
+    Djm1jm1r = D_valuesR[m];
+    Djm1jm1i = (flag_piD) ? D_valuesI[m] : 0.0;
+    Djjm1r = D_valuesR[m + 1];
+    Djjm1i = (flag_piD) ? D_valuesI[m + 1] : 0.0;
+#ifdef PRINT_CHECK
+    if (D_ja[D_ia[j]] != j - 1) {
+      mexPrintf("D: super-diagonal mismatch (%d,%d)\n", D_ja[D_ia[j]] + 1, j);
+      fflush(stdout);
+    }
+#endif
+    m = D_ia[j] + 1;
+#ifdef PRINT_CHECK
+    if (D_ja[m] != j) {
+      mexPrintf("D: diagonal mismatch (%d,%d)\n", D_ja[m] + 1, j + 1);
+      fflush(stdout);
+    }
+#endif
+    Djjr = D_valuesR[m];
+    Djji = (flag_piD) ? D_valuesI[m] : 0.0;
+    /* determinant for 2x2 matrix inverse */
+    detr = Djm1jm1r * Djjr - Djm1jm1i * Djji -
+           (Djjm1r * Djjm1r - Djjm1i * Djjm1i);
+    deti = Djm1jm1r * Djji + Djm1jm1i * Djjr -
+           (Djjm1r * Djjm1i + Djjm1i * Djjm1r);
+    nrm = 1.0 / (detr * detr + deti * deti);
+    /* set Ainv(j-1:j,j-1:j) */
+    mm = ia[j - 1];
+#ifdef PRINT_CHECK
+    if (ja[mm] != j - 1) {
+      mexPrintf("ainv: mismatch (%d,%d)\n", ja[mm] + 1, j);
+      fflush(stdout);
+    }
+#endif
+#ifdef PRINT_CHECK
+    if (ja[mm + 1] != j) {
+      mexPrintf("ainv: mismatch (%d,%d)\n", ja[mm + 1] + 1, j + 1);
+      fflush(stdout);
+    }
+#endif
+    ainvr[mm] = (Djjr * detr + Djji * deti) * nrm;
+    ainvi[mm] = (-Djjr * deti + Djji * detr) * nrm;
+    ainvr[mm + 1] = -(Djjm1r * detr + Djjm1i * deti) * nrm;
+    ainvi[mm + 1] = -(-Djjm1r * deti + Djjm1i * detr) * nrm;
+    mm = ia[j];
+#ifdef PRINT_CHECK
+    if (ja[mm] != j) {
+      mexPrintf("ainv: mismatch (%d,%d)\n", ja[mm] + 1, j + 1);
+      fflush(stdout);
+    }
+#endif
+    ainvr[mm] = (Djm1jm1r * detr + Djm1jm1i * deti) * nrm;
+    ainvi[mm] = (-Djm1jm1r * deti + Djm1jm1i * detr) * nrm;
+
+    /* update Ainv(j-1,j-1) */
+    /* note that the indices of Ainv(:,j-1) should start with j-1 and j */
+    mm = ia[j - 1];
+#ifdef PRINT_CHECK
+    if (ja[ia[j - 1]] != j - 1 || ja[ia[j - 1] + 1] != j) {
+      mexPrintf("Ainv: diagonal or sub-diagonal index mismatch at "
+                "(%d,%d),(%d,%d)\n",
+                ja[ia[j - 1]] + 1, j, ja[ia[j - 1] + 1] + 1, j);
+      fflush(stdout);
+    }
+#endif
+    l = ia[j - 1] + 2;
+#ifdef PRINT_CHECK
+    if (L_ja[L_ia[j - 1]] != j - 1) {
+      mexPrintf("L: diagonal index mismatch at (%d,%d)\n",
+                L_ja[L_ia[j - 1]] + 1, j);
+      fflush(stdout);
+    }
+#endif
+    m = L_ia[j - 1] + 1;
+#ifdef PRINT_CHECK
+    if (L_ja[m] <= j) {
+      mexPrintf("L: L(%d,%d)=%8.1le+%8.1lei=0???\n", L_ja[m] + 1, j,
+                L_valuesR[m], L_valuesI[m]);
+      fflush(stdout);
+    }
+#endif
+    if (L_ja[m] <= j)
+      m++;
+    while (l < ia[j] && m < L_ia[j]) {
+      /* L(kk,j-1) */
+      kk = L_ja[m];
+      /* Ainv(ll,j-1) */
+      ll = ja[l];
+      if (kk < ll)
+        m++;
+      else if (ll < kk)
+        l++;
+      else { /* indices match */
+        /* Ainv(j-1,j-1)=Ainv(j-1,j-1)-L(kk,j-1)^T*Ainv(kk,j-1) */
+        ainvr[mm] -= L_valuesR[m] * ainvr[l] -
+                     ((flag_piL) ? L_valuesI[m] * ainvi[l] : 0.0);
+        ainvi[mm] -= L_valuesR[m] * ainvi[l] +
+                     ((flag_piL) ? L_valuesI[m] * ainvr[l] : 0.0);
+        m++;
+        l++;
+      }
+    } /* end while */
+
+    /* update Ainv(j,j-1) */
+    mm = ia[j - 1] + 1;
+#ifdef PRINT_CHECK
+    if (ja[ia[j - 1]] != j - 1 || ja[ia[j - 1] + 1] != j) {
+      mexPrintf("Ainv: diagonal or sub-diagonal index mismatch at "
+                "(%d,%d),(%d,%d)\n",
+                ja[ia[j - 1]] + 1, j, ja[ia[j - 1] + 1] + 1, j);
+      fflush(stdout);
+    }
+#endif
+    l = ia[j - 1] + 2;
+#ifdef PRINT_CHECK
+    if (L_ja[L_ia[j]] != j) {
+      mexPrintf("L: diagonal index mismatch at (%d,%d)\n", L_ja[L_ia[j]] + 1,
+                j + 1);
+      fflush(stdout);
+    }
+#endif
+    m = L_ia[j] + 1;
+    while (l < ia[j] && m < L_ia[j + 1]) {
+      /* L(kk,j) */
+      kk = L_ja[m];
+      /* Ainv(ll,j-1) */
+      ll = ja[l];
+      if (kk < ll)
+        m++;
+      else if (ll < kk)
+        l++;
+      else { /* indices match */
+        /* Ainv(j,j-1)=Ainv(j,j-1)-L(kk,j)^T*Ainv(kk,j-1) */
+        ainvr[mm] -= L_valuesR[m] * ainvr[l] -
+                     ((flag_piL) ? L_valuesI[m] * ainvi[l] : 0.0);
+        ainvi[mm] -= L_valuesR[m] * ainvi[l] +
+                     ((flag_piL) ? L_valuesI[m] * ainvr[l] : 0.0);
+        m++;
+        l++;
+      }
+    } /* end while */
+
+    /* update Ainv(j,j) */
+    mm = ia[j];
+#ifdef PRINT_CHECK
+    if (ja[ia[j]] != j) {
+      mexPrintf("Ainv: diagonal index mismatch at (%d,%d)\n", ja[ia[j]] + 1,
+                j);
+      fflush(stdout);
+    }
+#endif
+    l = ia[j] + 1;
+#ifdef PRINT_CHECK
+    if (L_ja[L_ia[j]] != j) {
+      mexPrintf("L: diagonal index mismatch at (%d,%d)\n", L_ja[L_ia[j]] + 1,
+                j + 1);
+      fflush(stdout);
+    }
+#endif
+    m = L_ia[j] + 1;
+    while (l < ia[j + 1] && m < L_ia[j + 1]) {
+      /* L(kk,j) */
+      kk = L_ja[m];
+      /* Ainv(ll,j) */
+      ll = ja[l];
+      if (kk < ll)
+        m++;
+      else if (ll < kk)
+        l++;
+      else { /* indices match */
+        /* Ainv(j,j)=Ainv(j,j)-L(kk,j)^T*Ainv(kk,j) */
+        ainvr[mm] -= L_valuesR[m] * ainvr[l] -
+                     ((flag_piL) ? L_valuesI[m] * ainvi[l] : 0.0);
+        ainvi[mm] -= L_valuesR[m] * ainvi[l] +
+                     ((flag_piL) ? L_valuesI[m] * ainvr[l] : 0.0);
+        m++;
+        l++;
+      }
+    } /* end while */
+      /* END Computation
+       * Ainv(j-1:j,j-1:j)=D(j,j)^{-1}-L(I,j-1:j)^T*Ainv(I,j-1:j) */
+  } /* end if-else */
+}
 
 /* ========================================================================== */
 /* === mexFunction ========================================================== */
@@ -67,10 +628,12 @@ void mexFunction(
     const mxArray *prhs[] /* right-hand side matrices */
     ) {
   mxArray *L_input, *D_input, *p_input, *Delta_input;
-  integer i, j, k, l, m, kk, ll, mm, n, flag, nnz, *ia, *ja, *p, *invp, ierr,
+  integer i, j, k, l, m, kk, mm, n, flag, nnz, *ia, *ja, *p, *invp, ierr,
       *ibuff, flag_piL, flag_piD;
   doubleprecision *ainvr, *ainvi, Djm1jm1r, Djm1jm1i, Djjm1r, Djjm1i, Djjr,
       Djji, detr, deti, nrm;
+  integer *order, *sub_ptr, nsub, s, s1, ss, t;
+  int nthreads = 1;
   size_t mrows, ncols;
   double *Ainv_valuesR, *L_valuesR, *D_valuesR, *p_valuesR, *Delta_valuesR;
   double *Ainv_valuesI, *L_valuesI, *D_valuesI;
@@ -81,8 +644,8 @@ void mexFunction(
       *D_ja,        /* row indices of input matrix D         */
       *D_ia;        /* column pointers of input matrix D     */
 
-  if (nrhs != 4)
-    mexErrMsgTxt("Four input arguments required.");
+  if (nrhs < 4 || nrhs > 5)
+    mexErrMsgTxt("Four or five input arguments required.");
   else if (nlhs != 1)
     mexErrMsgTxt("wrong number of output arguments.");
   else if (!mxIsNumeric(prhs[0]))
@@ -489,6 +1052,12 @@ void mexFunction(
   }
 #endif
 
+  /* number of threads for the subtrees of the elimination tree */
+  if (nrhs > 4)
+    nthreads = (int)mxGetScalar(prhs[4]);
+  if (nthreads < 1)
+    nthreads = 1;
+
   /* start from the right corner */
   j = n - 1;
 
@@ -593,560 +1162,28 @@ void mexFunction(
     j -= 2;
   }
 
-  while (j >= 0) {
-#ifdef PRINT_CHECK
-    for (m = 0; m < n; m++) {
-      if (ibuff[m] != 0)
-        mexPrintf("ibuff dirty at position %d\n", m + 1);
-      fflush(stdout);
-    }
-#endif
-
-    /* 1x1 or 2x2 case ? */
-    if (j == 0)
-      flag = 0;
-    else if (D_ia[j + 1] - D_ia[j] == 1)
-      flag = 0;
-    else /* 2x2 case */
-      flag = -1;
-
-    /* 1x1 case */
-
-    if (!flag) {
-/* mexPrintf("j=%d\n",j+1);fflush(stdout); */
-
-/************ Compute  Ainv(I,j)=-Ainv(I,I)*L(I,j) ******************/
-/* recall that the entries of ainv are already initialized with 0.0 */
-/* starting position in L(j+1:n,j)*/
-#ifdef PRINT_CHECK
-      if (L_ja[L_ia[j]] != j) {
-        mexPrintf("L: mismatch (%d,%d)\n", L_ja[L_ia[j]] + 1, j + 1);
-        fflush(stdout);
-      }
-#endif
-      for (m = L_ia[j] + 1; m < L_ia[j + 1]; m++) {
-        /* column index k>j of L(k,j) */
-        k = L_ja[m];
-/* mexPrintf("(%d,%d)\n",k+1,j+1);fflush(stdout); */
-/* update Ainv(I,j) with -Ainv(I,k)*L(k,j) */
-/* 1. part: lower triangular and diagonal part of Ainv(I,k) */
-/* starting positions column of Ainv(j+1:n,j) and k of Ainv(k:n,k) */
-#ifdef PRINT_CHECK
-        if (ja[ia[j]] != j) {
-          mexPrintf("Ainv: mismatch (%d,%d)\n", ja[ia[j]] + 1, j + 1);
-          fflush(stdout);
-        }
-#endif
-        l = ia[j] + 1;
-        mm = ia[k];
-        flag = 0;
-        while (l < ia[j + 1] && mm < ia[k + 1]) {
-          /* Ainv(kk,j) */
-          kk = ja[l];
-          /* Ainv(ll,k) */
-          ll = ja[mm];
-          if (kk < ll)
-            l++;
-          else if (ll < kk)
-            mm++;
-          else { /* indices match */
-            /* store the location l of Ainv(k,j) and avoid duplicate update */
-            if (kk == k)
-              flag = l;
-            else {
-              /* Ainv(kk,j)=Ainv(kk,j)-Ainv(kk,k)*L(k,j) */
-              ainvr[l] -= ainvr[mm] * L_valuesR[m] -
-                          ((flag_piL) ? ainvi[mm] * L_valuesI[m] : 0.0);
-              ainvi[l] -= ((flag_piL) ? ainvr[mm] * L_valuesI[m] : 0.0) +
-                          ainvi[mm] * L_valuesR[m];
-              /* mexPrintf("[%d,%d,%d]\n",kk+1,k+1,j+1);fflush(stdout);
-                 mexPrintf("{%8.1le+%8.1lei,%8.1le+%8.1lei,%8.1le+%8.1lei}\n",ainvr[l],ainvi[l],ainvr[mm],ainvi[mm],L_valuesR[m],L_valuesI[m]);fflush(stdout);
-              */
-            }
-            l++;
-            mm++;
-          }
-        } /* end while */
-#ifdef PRINT_CHECK
-        if (!flag) {
-          mexPrintf("Ainv: row index %d is missing in column %d\n", k + 1,
-                    j + 1);
-          fflush(stdout);
-        }
-#endif
-/* 2. part: strict upper triangular of Ainv(I,k), which is not
-   stored but contributes to Ainv(k,j). Here use Ainv(I,k)^T */
-#ifdef PRINT_CHECK
-        if (L_ja[L_ia[j]] != j) {
-          mexPrintf("L: mismatch (%d,%d)\n", L_ja[L_ia[j]] + 1, j + 1);
-          fflush(stdout);
-        }
-#endif
-        l = L_ia[j] + 1;
-        mm = ia[k];
-        while (l < L_ia[j + 1] && mm < ia[k + 1]) {
-          /* L(kk,j) */
-          kk = L_ja[l];
-          /* Ainv(ll,k) */
-          ll = ja[mm];
-          if (kk < ll)
-            l++;
-          else if (ll < kk)
-            mm++;
-          else { /* indices match */
-                 /* Ainv(k,j)=Ainv(k,j)-Ainv(kk,k)^T*L(kk,j) */
-            ainvr[flag] -= ainvr[mm] * L_valuesR[l] -
-                           ((flag_piL) ? ainvi[mm] * L_valuesI[l] : 0.0);
-            ainvi[flag] -= ((flag_piL) ? ainvr[mm] * L_valuesI[l] : 0.0) +
-                           ainvi[mm] * L_valuesR[l];
-            /* mexPrintf("[%d,%d,%d]\n",ja[flag]+1,kk+1,j+1);fflush(stdout);
-               mexPrintf("{%8.1le+%8.1lei,%8.1le+%8.1lei,%8.1le+%8.1lei}\n",ainvr[flag],ainvi[flag],ainvr[mm],ainvi[mm],L_valuesR[l],L_valuesI[l]);fflush(stdout);
-            */
-            l++;
-            mm++;
-          }
-        } /* end while */
-      }   /* end for m */
-          /******** END Computation  Ainv(I,j)=-Ainv(I,I)*L(I,j) **************/
-
-      /*********** Compute Ainv(j,j)=1/D(j,j)-L(I,j)^T*Ainv(I,j) ***********/
-      mm = ia[j];
-      m = D_ia[j];
-      nrm = (flag_piD)
-                ? 1.0 / (D_valuesR[m] * D_valuesR[m] +
-                         D_valuesI[m] * D_valuesI[m])
-                : 1.0 / (D_valuesR[m] * D_valuesR[m]);
-      ainvr[mm] = D_valuesR[m] * nrm;
-      ainvi[mm] = (flag_piD) ? -D_valuesI[m] * nrm : 0.0;
-#ifdef PRINT_CHECK
-      if (ja[mm] != D_ja[m]) {
-        mexPrintf("Ainv,D: index mismatch at (%d,%d)\n", ja[mm] + 1,
-                  D_ja[m] + 1);
-        fflush(stdout);
-      }
-#endif
-#ifdef PRINT_CHECK
-      if (L_ja[L_ia[j]] != j) {
-        mexPrintf("L: mismatch (%d,%d)\n", L_ja[L_ia[j]] + 1, j + 1);
-        fflush(stdout);
-      }
-#endif
-#ifdef PRINT_CHECK
-      if (ja[ia[j]] != j) {
-        mexPrintf("Ainv: mismatch (%d,%d)\n", ja[ia[j]] + 1, j + 1);
-        fflush(stdout);
-      }
-#endif
-      l = ia[j] + 1;
-      m = L_ia[j] + 1;
-      while (l < ia[j + 1] && m < L_ia[j + 1]) {
-        /* L(kk,j) */
-        kk = L_ja[m];
-        /* Ainv(ll,j) */
-        ll = ja[l];
-        if (kk < ll)
-          m++;
-        else if (ll < kk)
-          l++;
-        else { /* indices match */
-          /* Ainv(j,j)=Ainv(j,j)-L(kk,j)^T*Ainv(kk,j) */
-          ainvr[mm] -= L_valuesR[m] * ainvr[l] -
-                       ((flag_piL) ? L_valuesI[m] * ainvi[l] : 0.0);
-          ainvi[mm] -= L_valuesR[m] * ainvi[l] +
-                       ((flag_piL) ? L_valuesI[m] * ainvr[l] : 0.0);
-          m++;
-          l++;
-        }
-      } /* end while */
-      /******* END Computation Ainv(j,j)=1/D(j,j)-L(I,j)^T*Ainv(I,j) *******/
-
-      j = j - 1;
-    } else { /* 2x2 case */
-             /* mexPrintf("j=%d:%d\n",j,j+1);fflush(stdout); */
-/******** Compute  Ainv(I,j-1:j)=-Ainv(I,I)*L(I,j-1:j) **************/
-/* recall that the entries of ainv are already initialized with 0.0 */
-/* starting position in column L(j+1:n,j-1) */
-#ifdef PRINT_CHECK
-      if (L_ja[L_ia[j - 1]] != j - 1) {
-        mexPrintf("L: diagonal index mismatch at (%d,%d)\n",
-                  L_ja[L_ia[j - 1]] + 1, j);
-        fflush(stdout);
-      }
-#endif
-      m = L_ia[j - 1] + 1;
-/* skip L(j,j-1) if present (which should be zero) */
-#ifdef PRINT_CHECK
-      if (L_ja[m] <= j) {
-        mexPrintf("L: L(%d,%d)=%8.1le+%8.1lei=0?\n", L_ja[m] + 1, j,
-                  L_valuesR[m], L_valuesI[m]);
-        fflush(stdout);
-      }
-#endif
-      if (L_ja[m] <= j)
-        m++;
-      for (; m < L_ia[j]; m++) {
-        /* row index k of L(k,j-1) */
-        k = L_ja[m];
-/* update Ainv(I,j-1) with -Ainv(I,k)*L(k,j-1) */
-/* 1. part: lower triangular and diagonal part of Ainv(I,k) */
-/* note that the indices of Ainv(:,j-1) should start with j-1 and j */
-#ifdef PRINT_CHECK
-        if (ja[ia[j - 1]] != j - 1 || ja[ia[j - 1] + 1] != j) {
-          mexPrintf("Ainv: diagonal or sub-diagonal index mismatch at "
-                    "(%d,%d),(%d,%d)\n",
-                    ja[ia[j - 1]] + 1, j, ja[ia[j - 1] + 1] + 1, j);
-          fflush(stdout);
-        }
-#endif
-        l = ia[j - 1] + 2;
-        mm = ia[k];
-        flag = 0;
-        while (l < ia[j] && mm < ia[k + 1]) {
-          /* Ainv(kk,j-1) */
-          kk = ja[l];
-          /* Ainv(ll,k) */
-          ll = ja[mm];
-          if (kk < ll)
-            l++;
-          else if (ll < kk)
-            mm++;
-          else { /* indices match */
-            /* store the location l of Ainv(k,j) and avoid duplicate update */
-            if (kk == k)
-              flag = l;
-            else {
-              /* Ainv(kk,j-1)=Ainv(kk,j-1)-Ainv(kk,k)*L(k,j-1) */
-              ainvr[l] -= ainvr[mm] * L_valuesR[m] -
-                          ((flag_piL) ? ainvi[mm] * L_valuesI[m] : 0.0);
-              ainvi[l] -= ((flag_piL) ? ainvr[mm] * L_valuesI[m] : 0.0) +
-                          ainvi[mm] * L_valuesR[m];
-            }
-            l++;
-            mm++;
-          }
-        } /* end while */
-          /* 2. part: strict upper triangular of Ainv(I,k), which is not
-             stored but contributes to Ainv(k,j-1). Here use Ainv(I,k)^T */
-#ifdef PRINT_CHECK
-        if (L_ja[L_ia[j - 1]] != j - 1) {
-          mexPrintf("L: diagonal index mismatch at (%d,%d)\n",
-                    L_ja[L_ia[j - 1]] + 1, j);
-          fflush(stdout);
-        }
-#endif
-        l = L_ia[j - 1] + 1;
-/* skip L(j,j-1) if present (which should be zero) */
-#ifdef PRINT_CHECK
-        if (L_ja[l] <= j) {
-          mexPrintf("L: L(%d,%d)=%8.1le+%8.1lei=0??\n", L_ja[l] + 1, j,
-                    L_valuesR[l], L_valuesI[l]);
-          fflush(stdout);
-        }
-#endif
-        if (L_ja[l] <= j)
-          l++;
-        mm = ia[k];
-        while (l < L_ia[j] && mm < ia[k + 1]) {
-          /* L(kk,j-1) */
-          kk = L_ja[l];
-          /* Ainv(ll,k) */
-          ll = ja[mm];
-          if (kk < ll)
-            l++;
-          else if (ll < kk)
-            mm++;
-          else { /* indices match */
-                 /* Ainv(k,j-1)=Ainv(k,j-1)-Ainv(kk,k)^T*L(kk,j-1) */
-            ainvr[flag] -= ainvr[mm] * L_valuesR[l] -
-                           ((flag_piL) ? ainvi[mm] * L_valuesI[l] : 0.0);
-            ainvi[flag] -= ((flag_piL) ? ainvr[mm] * L_valuesI[l] : 0.0) +
-                           ainvi[mm] * L_valuesR[l];
-            l++;
-            mm++;
-          }
-        } /* end while */
-      }   /* end for m */
-          /* next column, starting position in L(j+1:n,j) */
-#ifdef PRINT_CHECK
-      if (L_ja[L_ia[j]] != j) {
-        mexPrintf("L: diagonal index mismatch at (%d,%d)\n", L_ja[L_ia[j]] + 1,
-                  j + 1);
-        fflush(stdout);
-      }
-#endif
-      for (m = L_ia[j] + 1; m < L_ia[j + 1]; m++) {
-        /* column index k of L(k,j) */
-        k = L_ja[m];
-/* update Ainv(I,j) with -Ainv(I,k)*L(k,j) */
-/* 1. part: lower triangular and diagonal part of Ainv(I,k) */
-/* note that the indices of Ainv(:,j) should start with j */
-#ifdef PRINT_CHECK
-        if (ja[ia[j]] != j) {
-          mexPrintf("Ainv: diagonal index mismatch at (%d,%d)\n", ja[ia[j]] + 1,
-                    j + 1);
-          fflush(stdout);
-        }
-#endif
-        l = ia[j] + 1;
-        mm = ia[k];
-        flag = 0;
-        while (l < ia[j + 1] && mm < ia[k + 1]) {
-          /* Ainv(kk,j) */
-          kk = ja[l];
-          /* Ainv(ll,k) */
-          ll = ja[mm];
-          if (kk < ll)
-            l++;
-          else if (ll < kk)
-            mm++;
-          else { /* indices match */
-            /* store the location l of Ainv(k,j) and avoid duplicate update */
-            if (kk == k)
-              flag = l;
-            else {
-              /* Ainv(kk,j)=Ainv(kk,j)-Ainv(kk,k)*L(k,j) */
-              ainvr[l] -= ainvr[mm] * L_valuesR[m] -
-                          ((flag_piL) ? ainvi[mm] * L_valuesI[m] : 0.0);
-              ainvi[l] -= ((flag_piL) ? ainvr[mm] * L_valuesI[m] : 0.0) +
-                          ainvi[mm] * L_valuesR[m];
-            }
-            l++;
-            mm++;
-          }
-        } /* end while */
-          /* 2. part: strict upper triangular of Ainv(I,k), which is not
-             stored but contributes to Ainv(k,j). Here use Ainv(I,k)^T */
-#ifdef PRINT_CHECK
-        if (L_ja[L_ia[j]] != j) {
-          mexPrintf("L: diagonal index mismatch at (%d,%d)\n",
-                    L_ja[L_ia[j]] + 1, j + 1);
-          fflush(stdout);
-        }
-#endif
-        l = L_ia[j] + 1;
-        mm = ia[k];
-        while (l < L_ia[j + 1] && mm < ia[k + 1]) {
-          /* L(kk,j) */
-          kk = L_ja[l];
-          /* Ainv(ll,k) */
-          ll = ja[mm];
-          if (kk < ll)
-            l++;
-          else if (ll < kk)
-            mm++;
-          else { /* indices match */
-            /* Ainv(k,j)=Ainv(k,j)-Ainv(kk,k)^T*L(kk,j) */
-            ainvr[flag] -= ainvr[mm] * L_valuesR[l] -
-                           ((flag_piL) ? ainvi[mm] * L_valuesI[l] : 0.0);
-            ainvi[flag] -= ((flag_piL) ? ainvr[mm] * L_valuesI[l] : 0.0) +
-                           ainvi[mm] * L_valuesR[l];
-            l++;
-            mm++;
-          }
-        } /* end while */
-      }   /* end for m */
-          /******** END Computation  Ainv(I,j)=-Ainv(I,I)*L(I,j) **************/
-
-      /* Compute
-       * Ainv(j-1:j,j-1:j)=D(j-1:j,j-1:j)^{-1}-L(I,j-1:j)^T*Ainv(I,j-1:j) */
-      /* extract D(j-1:j,j-1:j) */
-      m = D_ia[j - 1];
-#ifdef PRINT_CHECK
-      if (D_ja[m] != j - 1) {
-        mexPrintf("D: diagonal mismatch (%d,%d)\n", D_ja[m] + 1, j);
-        fflush(stdout);
-      }
-#endif
-#ifdef PRINT_CHECK
-      if (D_ja[m + 1] != j) {
-        mexPrintf("D: sub-diagonal mismatch (%d,%d)\n", D_ja[m + 1] + 1, j + 1);
-        fflush(stdout);
-      }
-#endif
-      Djm1jm1r = D_valuesR[m];
-      Djm1jm1i = (flag_piD) ? D_valuesI[m] : 0.0;
-      Djjm1r = D_valuesR[m + 1];
-      Djjm1i = (flag_piD) ? D_valuesI[m + 1] : 0.0;
-#ifdef PRINT_CHECK
-      if (D_ja[D_ia[j]] != j - 1) {
-        mexPrintf("D: super-diagonal mismatch (%d,%d)\n", D_ja[D_ia[j]] + 1, j);
-        fflush(stdout);
-      }
-#endif
-      m = D_ia[j] + 1;
-#ifdef PRINT_CHECK
-      if (D_ja[m] != j) {
-        mexPrintf("D: diagonal mismatch (%d,%d)\n", D_ja[m] + 1, j + 1);
-        fflush(stdout);
-      }
-#endif
-      Djjr = D_valuesR[m];
-      Djji = (flag_piD) ? D_valuesI[m] : 0.0;
-      /* determinant for 2x2 matrix inverse */
-      detr = Djm1jm1r * Djjr - Djm1jm1i * Djji -
-             (Djjm1r * Djjm1r - Djjm1i * Djjm1i);
-      deti = Djm1jm1r * Djji + Djm1jm1i * Djjr -
-             (Djjm1r * Djjm1i + Djjm1i * Djjm1r);
-      nrm = 1.0 / (detr * detr + deti * deti);
-      /* set Ainv(j-1:j,j-1:j) */
-      mm = ia[j - 1];
-#ifdef PRINT_CHECK
-      if (ja[mm] != j - 1) {
-        mexPrintf("ainv: mismatch (%d,%d)\n", ja[mm] + 1, j);
-        fflush(stdout);
-      }
-#endif
-#ifdef PRINT_CHECK
-      if (ja[mm + 1] != j) {
-        mexPrintf("ainv: mismatch (%d,%d)\n", ja[mm + 1] + 1, j + 1);
-        fflush(stdout);
-      }
-#endif
-      ainvr[mm] = (Djjr * detr + Djji * deti) * nrm;
-      ainvi[mm] = (-Djjr * deti + Djji * detr) * nrm;
-      ainvr[mm + 1] = -(Djjm1r * detr + Djjm1i * deti) * nrm;
-      ainvi[mm + 1] = -(-Djjm1r * deti + Djjm1i * detr) * nrm;
-      mm = ia[j];
-#ifdef PRINT_CHECK
-      if (ja[mm] != j) {
-        mexPrintf("ainv: mismatch (%d,%d)\n", ja[mm] + 1, j + 1);
-        fflush(stdout);
-      }
-#endif
-      ainvr[mm] = (Djm1jm1r * detr + Djm1jm1i * deti) * nrm;
-      ainvi[mm] = (-Djm1jm1r * deti + Djm1jm1i * detr) * nrm;
-
-      /* update Ainv(j-1,j-1) */
-      /* note that the indices of Ainv(:,j-1) should start with j-1 and j */
-      mm = ia[j - 1];
-#ifdef PRINT_CHECK
-      if (ja[ia[j - 1]] != j - 1 || ja[ia[j - 1] + 1] != j) {
-        mexPrintf("Ainv: diagonal or sub-diagonal index mismatch at "
-                  "(%d,%d),(%d,%d)\n",
-                  ja[ia[j - 1]] + 1, j, ja[ia[j - 1] + 1] + 1, j);
-        fflush(stdout);
-      }
-#endif
-      l = ia[j - 1] + 2;
-#ifdef PRINT_CHECK
-      if (L_ja[L_ia[j - 1]] != j - 1) {
-        mexPrintf("L: diagonal index mismatch at (%d,%d)\n",
-                  L_ja[L_ia[j - 1]] + 1, j);
-        fflush(stdout);
-      }
-#endif
-      m = L_ia[j - 1] + 1;
-#ifdef PRINT_CHECK
-      if (L_ja[m] <= j) {
-        mexPrintf("L: L(%d,%d)=%8.1le+%8.1lei=0???\n", L_ja[m] + 1, j,
-                  L_valuesR[m], L_valuesI[m]);
-        fflush(stdout);
-      }
-#endif
-      if (L_ja[m] <= j)
-        m++;
-      while (l < ia[j] && m < L_ia[j]) {
-        /* L(kk,j-1) */
-        kk = L_ja[m];
-        /* Ainv(ll,j-1) */
-        ll = ja[l];
-        if (kk < ll)
-          m++;
-        else if (ll < kk)
-          l++;
-        else { /* indices match */
-          /* Ainv(j-1,j-1)=Ainv(j-1,j-1)-L(kk,j-1)^T*Ainv(kk,j-1) */
-          ainvr[mm] -= L_valuesR[m] * ainvr[l] -
-                       ((flag_piL) ? L_valuesI[m] * ainvi[l] : 0.0);
-          ainvi[mm] -= L_valuesR[m] * ainvi[l] +
-                       ((flag_piL) ? L_valuesI[m] * ainvr[l] : 0.0);
-          m++;
-          l++;
-        }
-      } /* end while */
-
-      /* update Ainv(j,j-1) */
-      mm = ia[j - 1] + 1;
-#ifdef PRINT_CHECK
-      if (ja[ia[j - 1]] != j - 1 || ja[ia[j - 1] + 1] != j) {
-        mexPrintf("Ainv: diagonal or sub-diagonal index mismatch at "
-                  "(%d,%d),(%d,%d)\n",
-                  ja[ia[j - 1]] + 1, j, ja[ia[j - 1] + 1] + 1, j);
-        fflush(stdout);
-      }
-#endif
-      l = ia[j - 1] + 2;
-#ifdef PRINT_CHECK
-      if (L_ja[L_ia[j]] != j) {
-        mexPrintf("L: diagonal index mismatch at (%d,%d)\n", L_ja[L_ia[j]] + 1,
-                  j + 1);
-        fflush(stdout);
-      }
-#endif
-      m = L_ia[j] + 1;
-      while (l < ia[j] && m < L_ia[j + 1]) {
-        /* L(kk,j) */
-        kk = L_ja[m];
-        /* Ainv(ll,j-1) */
-        ll = ja[l];
-        if (kk < ll)
-          m++;
-        else if (ll < kk)
-          l++;
-        else { /* indices match */
-          /* Ainv(j,j-1)=Ainv(j,j-1)-L(kk,j)^T*Ainv(kk,j-1) */
-          ainvr[mm] -= L_valuesR[m] * ainvr[l] -
-                       ((flag_piL) ? L_valuesI[m] * ainvi[l] : 0.0);
-          ainvi[mm] -= L_valuesR[m] * ainvi[l] +
-                       ((flag_piL) ? L_valuesI[m] * ainvr[l] : 0.0);
-          m++;
-          l++;
-        }
-      } /* end while */
-
-      /* update Ainv(j,j) */
-      mm = ia[j];
-#ifdef PRINT_CHECK
-      if (ja[ia[j]] != j) {
-        mexPrintf("Ainv: diagonal index mismatch at (%d,%d)\n", ja[ia[j]] + 1,
-                  j);
-        fflush(stdout);
-      }
-#endif
-      l = ia[j] + 1;
-#ifdef PRINT_CHECK
-      if (L_ja[L_ia[j]] != j) {
-        mexPrintf("L: diagonal index mismatch at (%d,%d)\n", L_ja[L_ia[j]] + 1,
-                  j + 1);
-        fflush(stdout);
-      }
+  /* continue with the remaining blocks by the elimination tree, the top
+     of which is processed sequentially and the subtrees below it in parallel */
+  order = (integer *)MAlloc((size_t)(n > 0 ? n : 1) * sizeof(integer),
+                            "ZSYMselinv:order");
+  sub_ptr = (integer *)MAlloc((size_t)(n + 1) * sizeof(integer),
+                              "ZSYMselinv:sub_ptr");
+  nsub = selinv_subtrees(n, L_ia, L_ja, NULL, NULL, D_ia, nthreads, order,
+                         sub_ptr);
+  for (s = 0; s < nsub; s = s1) {
+    s1 = s ? nsub : 1;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)             \
+    if (s > 0) private(t)
 #endif
-      m = L_ia[j] + 1;
-      while (l < ia[j + 1] && m < L_ia[j + 1]) {
-        /* L(kk,j) */
-        kk = L_ja[m];
-        /* Ainv(ll,j) */
-        ll = ja[l];
-        if (kk < ll)
-          m++;
-        else if (ll < kk)
-          l++;
-        else { /* indices match */
-          /* Ainv(j,j)=Ainv(j,j)-L(kk,j)^T*Ainv(kk,j) */
-          ainvr[mm] -= L_valuesR[m] * ainvr[l] -
-                       ((flag_piL) ? L_valuesI[m] * ainvi[l] : 0.0);
-          ainvi[mm] -= L_valuesR[m] * ainvi[l] +
-                       ((flag_piL) ? L_valuesI[m] * ainvr[l] : 0.0);
-          m++;
-          l++;
-        }
-      } /* end while */
-        /* END Computation
-         * Ainv(j-1:j,j-1:j)=D(j,j)^{-1}-L(I,j-1:j)^T*Ainv(I,j-1:j) */
-
-      j = j - 2;
-    } /* end if-else */
-  }   /* end while i */
+    for (ss = s; ss < s1; ss++)
+      for (t = sub_ptr[ss]; t < sub_ptr[ss + 1]; t++)
+        ZSYMselinv_block(order[t], L_ia, L_ja, L_valuesR, L_valuesI, flag_piL,
+                         D_ia, D_ja, D_valuesR, D_valuesI, flag_piD, ia, ja,
+                         ainvr, ainvi);
+  }
+  free(order);
+  free(sub_ptr);
 #ifdef PRINT_INFO
   mexPrintf("ZSYMselinv: numerical values structure inserted\n");
   fflush(stdout);
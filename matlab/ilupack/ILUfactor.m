@@ -1,4 +1,4 @@
-function [PREC, options] = ILUfactor(A, options)
+function [PREC, options] = ILUfactor(A, options, ptronly)
 % [PREC, options] = ILUfactor(A, options)
 % [PREC, options] = ILUfactor(A)
 %
@@ -67,9 +67,28 @@ function [PREC, options] = ILUfactor(A, options)
 %             PREC(l).isblock     block structured ILU
 %
 % options     updated parameters
+%
+% [PREC, param] = ILUfactor(A, param) uses the handle of the options
+% created by `ILUparam' for a real nonsymmetric matrix A, which avoids
+% converting the options. In this case PREC(l).A_H is not rescaled.
+%
+% [PREC, options] = ILUfactor(A, options, 1) leaves PREC(l).L, PREC(l).D,
+% PREC(l).U, PREC(l).E, PREC(l).F and PREC(l).A_H empty for a real
+% nonsymmetric matrix A, for callers that read the factors through
+% PREC(1).ptr, such as `DGNLilupack2milu'. PREC can still be passed to
+% `ILUsol' and `ILUdelete'.
 
+if nargin < 3
+    ptronly = 0;
+end
 if nargin < 2
     options = ILUinit(A);
+elseif isa(options, 'uint64')
+    if ~isreal(A)
+        error('the handle created by ILUparam requires a real matrix');
+    end
+    [PREC, options] = DGNLilupackfactor(A, options, ptronly);
+    return;
 end
 
 % make sure that shifted system and A have same type
@@ -157,7 +176,7 @@ end
 
 if nargin == 1
     options = ILUinit(A);
-elseif nargin == 2
+elseif nargin >= 2
     if isfield(options, 'isdefinite')
         if isfield(options, 'ind')
             if min(options.ind) < 0
@@ -437,7 +456,7 @@ if myoptions.isreal
             end % for i
         end % if
     else
-        [PREC, myoptions] = DGNLilupackfactor(A, myoptions);
+        [PREC, myoptions] = DGNLilupackfactor(A, myoptions, ptronly);
         if ~strcmp(myoptions.amg, 'ilu')
             for i = 1:length(PREC) - 1
                 n = size(PREC(i).A_H, 1);
@@ -0,0 +1,39 @@
+function param = ILUparam(A, options)
+% param = ILUparam(A, options)
+% param = ILUparam(A)
+%
+% create an opaque handle of the options of ILUPACK for a real
+% nonsymmetric nxn matrix A, which can be passed to `ILUfactor' and
+% `ILUsolver' instead of `options'. The options are converted only once,
+% which saves time when many systems are solved with the same options.
+%
+% input
+% -----
+% A         nxn real matrix
+% options   parameters. If `options' is not passed then the default options
+%           from `ILUinit' will be used. Test vectors (options.typetv) are
+%           not supported.
+%
+% output
+% ------
+% param     uint64 array that stores the parsed parameters by value. It
+%           holds no pointers, so it needs no release, and it can be copied
+%           and saved like any other array.
+%
+% ------------------------------------------------------------------------
+%
+% Example:
+%
+%    param = ILUparam(A, ILUinit(A));
+%    PREC = ILUfactor(A, param);
+%    [x, niter] = ILUsolver(A, PREC, param, b);
+%    PREC = ILUdelete(PREC);
+
+if ~isreal(A)
+    error('ILUparam only supports real matrices');
+end
+if nargin < 2
+    options = ILUinit(A);
+end
+
+param = DGNLilupackparam(A, options);
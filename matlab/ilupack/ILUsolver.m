@@ -6,11 +6,35 @@ function [x, options] = ILUsolver(A, PREC, options, b, x0)
 %
 % Solves Ax=b using ILUPACK preconditioner PREC according to the given options
 %
+% [x, niter] = ILUsolver(A, PREC, param, b, x0)
+% [x, niter] = ILUsolver(A, PREC, param, b)
+%
+% uses the handle of the options created by `ILUparam', which avoids
+% converting the options in every call, and returns the numbers of
+% iteration steps instead of the options
+%
 
 if ~isfield(PREC(1), 'param') || ~isfield(PREC(1), 'ptr')
     error('ILUsolver cannot be applied');
 end % if
 
+if nargin >= 4 && isa(options, 'uint64')
+    if ~isreal(A) || ~isreal(b) || ~PREC(1).isreal || PREC(1).issymmetric
+        error('the handle created by ILUparam requires real nonsymmetric systems');
+    end
+    if nargin < 5
+        x0 = zeros(size(b));
+    end
+    x = zeros(size(b));
+    niter = zeros(1, size(b, 2));
+    for i = 1:size(b, 2)
+        [x(:, i), niter(i)] = DGNLilupacksolver(A, PREC, options, ...
+            full(b(:, i)), full(x0(:, i)));
+    end % for i
+    options = niter;
+    return;
+end % if
+
 if nargin == 3
     % [x, options] = ILUsolver(A, PREC, b)
     % shift parameter
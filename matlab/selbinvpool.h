@@ -0,0 +1,405 @@
+/* ========================================================================== */
+/* === selbinvpool.h ======================================================== */
+/* ========================================================================== */
+
+/*
+    Compact storage of the block columns exchanged by DSYMldl2bldl,
+    DGNLldu2bldu, DSYMselbinv and DGNLselbinv.
+
+    Instead of a cell array of structures with the fields J, I, L and D, the
+    blocks B{1},...,B{nblocks} are stored in a single structure with the
+    fields
+
+      ind      int32 vector (int64 if n>=2^31) of the index sets
+               B{1}.J, B{1}.I, B{2}.J, B{2}.I, ...
+      ind_ptr  int64 vector of length 2*nblocks+1 such that
+               B{k}.J=ind(ind_ptr(2*k-1):ind_ptr(2*k)-1) and
+               B{k}.I=ind(ind_ptr(2*k):ind_ptr(2*k+1)-1)
+      val      double vector of the dense matrices
+               B{1}.L(:), B{1}.D(:), B{2}.L(:), B{2}.D(:), ...
+      val_ptr  int64 vector of length 2*nblocks+1 such that B{k}.L and B{k}.D
+               are val(val_ptr(2*k-1):val_ptr(2*k)-1) and
+               val(val_ptr(2*k):val_ptr(2*k+1)-1), of size |I|x|J| and
+               |J|x|J|
+
+    Fields that a block does not have, such as BD{k}.I and BD{k}.L, are
+    stored as empty, and the sparse diagonal blocks BD{k}.D are stored as
+    dense matrices. The offsets are 64-bit since the values of all the
+    blocks may exceed 2^31 entries even if the indices do not.
+
+    The blocks in either format are parsed once by selbinv_pool_get, and
+    the resulting selbinv_pool is passed to the other functions, so that
+    the fields are not looked up again for each block. The selbinv kernels
+    read and write the values L and D of compact blocks in place through
+    val_ptr, and only convert the index sets to double.
+
+    Notice:
+
+        THIS MATERIAL IS PROVIDED AS IS, WITH ABSOLUTELY NO WARRANTY
+        EXPRESSED OR IMPLIED.  ANY USE IS AT YOUR OWN RISK.
+*/
+
+#ifndef SELBINVPOOL_H
+#define SELBINVPOOL_H
+
+#include "matrix.h"
+#include "mex.h"
+#include <ilupack.h>
+#include <stdint.h>
+#include <string.h>
+
+/* index sets of a block */
+#define SELBINV_J 0
+#define SELBINV_I 1
+/* values of a block */
+#define SELBINV_L 0
+#define SELBINV_D 1
+
+/* the arrays of a compact block structure, or the cell array of the
+   blocks if they are not compact */
+typedef struct {
+  const mxArray *cell; /* cell array, or NULL if compact */
+  integer nblocks;
+  int32_t *ind32; /* index pool, if stored as int32 */
+  int64_t *ind64; /* index pool, if stored as int64 */
+  int64_t *ind_ptr, *val_ptr;
+  double *val;
+} selbinv_pool;
+
+/* an index set J or I of a block, stored in either format */
+typedef struct {
+  mwSize size;
+  const double *pr;
+  const int32_t *ind32;
+  const int64_t *ind64;
+} selbinv_index_set;
+
+/* return nonzero if B is a compact block structure rather than a cell
+   array */
+static inline int selbinv_is_pool(const mxArray *B) {
+  return mxIsStruct(B) && mxGetField(B, 0, "ind_ptr") != NULL;
+}
+
+/* parse the blocks B, given as cell array or as compact block structure,
+   into P. The offsets of a compact block structure are validated, so that
+   its blocks can be accessed without further checks. */
+static inline void selbinv_pool_get(const mxArray *B, selbinv_pool *P) {
+  const mxArray *ind, *ind_ptr, *val, *val_ptr;
+  mwSize nptr;
+  integer k;
+  int64_t m_size, n_size;
+
+  P->ind32 = NULL;
+  P->ind64 = NULL;
+  P->ind_ptr = NULL;
+  P->val_ptr = NULL;
+  P->val = NULL;
+  if (mxIsCell(B)) {
+    P->cell = B;
+    P->nblocks = (integer)mxGetNumberOfElements(B);
+    return;
+  }
+
+  ind = mxGetField(B, 0, "ind");
+  ind_ptr = mxGetField(B, 0, "ind_ptr");
+  val = mxGetField(B, 0, "val");
+  val_ptr = mxGetField(B, 0, "val_ptr");
+  if (ind == NULL || ind_ptr == NULL || val == NULL || val_ptr == NULL)
+    mexErrMsgTxt("Compact blocks must have the fields ind, ind_ptr, val and "
+                 "val_ptr.");
+  if ((mxGetClassID(ind) != mxINT32_CLASS &&
+       mxGetClassID(ind) != mxINT64_CLASS) ||
+      mxGetClassID(ind_ptr) != mxINT64_CLASS ||
+      mxGetClassID(val_ptr) != mxINT64_CLASS || !mxIsDouble(val) ||
+      mxIsComplex(val) || mxIsSparse(val))
+    mexErrMsgTxt("Compact blocks must have integer fields ind, ind_ptr and "
+                 "val_ptr and a real field val.");
+  nptr = mxGetNumberOfElements(ind_ptr);
+  if (nptr % 2 != 1 || mxGetNumberOfElements(val_ptr) != nptr)
+    mexErrMsgTxt("Fields ind_ptr and val_ptr of compact blocks must have "
+                 "2*nblocks+1 entries.");
+
+  P->cell = NULL;
+  P->nblocks = (integer)(nptr / 2);
+  if (mxGetClassID(ind) == mxINT32_CLASS)
+    P->ind32 = (int32_t *)mxGetData(ind);
+  else
+    P->ind64 = (int64_t *)mxGetData(ind);
+  P->ind_ptr = (int64_t *)mxGetData(ind_ptr);
+  P->val_ptr = (int64_t *)mxGetData(val_ptr);
+  P->val = mxGetPr(val);
+
+  /* the offsets must start from 1, be nondecreasing, stay within ind and
+     val, and give L and D the sizes |I|x|J| and |J|x|J| */
+  if (P->ind_ptr[0] != 1 || P->val_ptr[0] != 1)
+    mexErrMsgTxt("Offsets of compact blocks must start from 1.");
+  for (k = 0; k < P->nblocks; k++) {
+    n_size = P->ind_ptr[2 * k + 1] - P->ind_ptr[2 * k];
+    m_size = P->ind_ptr[2 * k + 2] - P->ind_ptr[2 * k + 1];
+    if (n_size < 0 || m_size < 0)
+      mexErrMsgTxt("Offsets of compact blocks must be nondecreasing.");
+    if (P->val_ptr[2 * k + 1] - P->val_ptr[2 * k] != m_size * n_size ||
+        P->val_ptr[2 * k + 2] - P->val_ptr[2 * k + 1] != n_size * n_size)
+      mexErrMsgTxt("Values of compact blocks do not match their index sets.");
+  }
+  if (P->ind_ptr[nptr - 1] - 1 > (int64_t)mxGetNumberOfElements(ind) ||
+      P->val_ptr[nptr - 1] - 1 > (int64_t)mxGetNumberOfElements(val))
+    mexErrMsgTxt("Compact blocks exceed their fields ind and val.");
+}
+
+/* extract the index set J or I of block k of the blocks P in either
+   format. A missing index set is returned as empty. */
+static inline void selbinv_index_set_get(const selbinv_pool *P, integer k,
+                                         int set, selbinv_index_set *S) {
+  const mxArray *B_index;
+  int64_t first;
+
+  S->pr = NULL;
+  S->ind32 = NULL;
+  S->ind64 = NULL;
+  if (P->cell == NULL) {
+    first = P->ind_ptr[2 * k + set] - 1;
+    S->size = (mwSize)(P->ind_ptr[2 * k + set + 1] - 1 - first);
+    if (P->ind32 != NULL)
+      S->ind32 = P->ind32 + first;
+    else
+      S->ind64 = P->ind64 + first;
+  } else {
+    B_index = mxGetField(mxGetCell(P->cell, (mwIndex)k), 0, set ? "I" : "J");
+    S->size = B_index == NULL ? 0 : mxGetNumberOfElements(B_index);
+    if (B_index != NULL)
+      S->pr = mxGetPr(B_index);
+  }
+}
+
+/* entry l of an index set, counted from 0. The indices start from 1. */
+static inline integer selbinv_index_set_entry(const selbinv_index_set *S,
+                                              mwSize l) {
+  if (S->pr != NULL)
+    return (integer)S->pr[l];
+  else if (S->ind32 != NULL)
+    return (integer)S->ind32[l];
+  return (integer)S->ind64[l];
+}
+
+/* the index set J or I of block k of the blocks P in either format as
+   double vector, the format read by the selbinv kernels. A compact index
+   set is converted into buf followed by a zero, which no index matches
+   when the kernels scan one entry past the end of the index set, so buf
+   must hold its size plus one entries. The indices of the cell format are
+   returned in place. The size of the index set is returned in size. */
+static inline double *selbinv_index_set_pr(const selbinv_pool *P, integer k,
+                                           int set, double *buf,
+                                           integer *size) {
+  selbinv_index_set S;
+  mwSize l;
+
+  selbinv_index_set_get(P, k, set, &S);
+  *size = (integer)S.size;
+  if (S.pr != NULL)
+    return (double *)S.pr;
+  for (l = 0; l < S.size; l++)
+    buf[l] = (double)selbinv_index_set_entry(&S, l);
+  buf[S.size] = 0.0;
+  return buf;
+}
+
+/* the dense values L or D of block k of the compact blocks P, which the
+   selbinv kernels read and write in place */
+static inline double *selbinv_pool_values(const selbinv_pool *P, integer k,
+                                          int set) {
+  return P->val + P->val_ptr[2 * k + set] - 1;
+}
+
+/* sparse block diagonal part of the dense D of block k of the compact
+   blocks P with 1x1 and 2x2 blocks, like BD{k}.D in the cell format,
+   keeping the zero entries of its 2x2 blocks. The compressed columns are
+   stored in ia, ja and pr, of size |J|+1, 2|J| and 2|J|. */
+static inline void selbinv_pool_pivots(const selbinv_pool *P, integer k,
+                                       mwIndex *ia, mwIndex *ja, double *pr) {
+  mwSize i, j, l, n_size;
+  const double *prD;
+
+  n_size = (mwSize)(P->ind_ptr[2 * k + 1] - P->ind_ptr[2 * k]);
+  prD = selbinv_pool_values(P, k, SELBINV_D);
+  /* 2x2 blocks are those with a nonzero off-diagonal entry */
+  l = 0;
+  for (j = 0; j < n_size; j++) {
+    ia[j] = l;
+    if (j + 1 < n_size && (prD[j + 1 + j * n_size] != 0.0 ||
+                           prD[j + (j + 1) * n_size] != 0.0)) {
+      for (i = j; i < j + 2; i++) {
+        ja[l] = i;
+        pr[l++] = prD[i + j * n_size];
+      }
+      ia[j + 1] = l;
+      for (i = j; i < j + 2; i++) {
+        ja[l] = i;
+        pr[l++] = prD[i + (j + 1) * n_size];
+      }
+      j++;
+    } else {
+      ja[l] = j;
+      pr[l++] = prD[j + j * n_size];
+    }
+  }
+  ia[n_size] = l;
+}
+
+/* create a compact block structure for nblocks blocks with indices up to n,
+   where block k has the index sets J and I of the blocks B (either
+   format), or an empty I if with_I is zero. The index sets are copied from
+   B, the values are initialized with zeros, and P refers to the arrays of
+   the structure. */
+static inline mxArray *selbinv_pool_create(const selbinv_pool *B,
+                                           integer nblocks, integer n,
+                                           int with_I, selbinv_pool *P) {
+  const char *names[] = {"ind", "ind_ptr", "val", "val_ptr"};
+  mxArray *Bpool, *field;
+  selbinv_index_set J, I;
+  integer k;
+  int64_t nind = 0, nval = 0, first;
+  mwSize l;
+  int set;
+
+  Bpool = mxCreateStructMatrix((mwSize)1, (mwSize)1, 4, names);
+  field = mxCreateNumericMatrix((mwSize)(2 * nblocks + 1), (mwSize)1,
+                                mxINT64_CLASS, mxREAL);
+  P->ind_ptr = (int64_t *)mxGetData(field);
+  mxSetFieldByNumber(Bpool, (mwIndex)0, 1, field);
+  field = mxCreateNumericMatrix((mwSize)(2 * nblocks + 1), (mwSize)1,
+                                mxINT64_CLASS, mxREAL);
+  P->val_ptr = (int64_t *)mxGetData(field);
+  mxSetFieldByNumber(Bpool, (mwIndex)0, 3, field);
+
+  /* offsets of the index sets and of the values of each block */
+  P->ind_ptr[0] = P->val_ptr[0] = 1;
+  for (k = 0; k < nblocks; k++) {
+    selbinv_index_set_get(B, k, SELBINV_J, &J);
+    I.size = 0;
+    if (with_I)
+      selbinv_index_set_get(B, k, SELBINV_I, &I);
+    P->ind_ptr[2 * k + 1] = P->ind_ptr[2 * k] + (int64_t)J.size;
+    P->ind_ptr[2 * k + 2] = P->ind_ptr[2 * k + 1] + (int64_t)I.size;
+    P->val_ptr[2 * k + 1] = P->val_ptr[2 * k] + (int64_t)(I.size * J.size);
+    P->val_ptr[2 * k + 2] = P->val_ptr[2 * k + 1] + (int64_t)(J.size * J.size);
+  }
+  nind = P->ind_ptr[2 * nblocks] - 1;
+  nval = P->val_ptr[2 * nblocks] - 1;
+
+  field = mxCreateNumericMatrix((mwSize)nind, (mwSize)1,
+                                (int64_t)n < ((int64_t)1 << 31) ? mxINT32_CLASS
+                                                                : mxINT64_CLASS,
+                                mxREAL);
+  P->ind32 = NULL;
+  P->ind64 = NULL;
+  if (mxGetClassID(field) == mxINT32_CLASS)
+    P->ind32 = (int32_t *)mxGetData(field);
+  else
+    P->ind64 = (int64_t *)mxGetData(field);
+  mxSetFieldByNumber(Bpool, (mwIndex)0, 0, field);
+  field = mxCreateDoubleMatrix((mwSize)nval, (mwSize)1, mxREAL);
+  P->val = mxGetPr(field);
+  mxSetFieldByNumber(Bpool, (mwIndex)0, 2, field);
+  P->cell = NULL;
+  P->nblocks = nblocks;
+
+  /* copy the index sets, so that only the values remain to be filled */
+  for (k = 0; k < nblocks; k++) {
+    for (set = SELBINV_J; set <= (with_I ? SELBINV_I : SELBINV_J); set++) {
+      selbinv_index_set_get(B, k, set, &J);
+      first = P->ind_ptr[2 * k + set] - 1;
+      for (l = 0; l < J.size; l++) {
+        if (P->ind32 != NULL)
+          P->ind32[first + l] = (int32_t)selbinv_index_set_entry(&J, l);
+        else
+          P->ind64[first + l] = (int64_t)selbinv_index_set_entry(&J, l);
+      }
+    }
+  }
+
+  return Bpool;
+}
+
+/* store the structure Bk (cell format) as block k of the compact block
+   structure P created by selbinv_pool_create. Missing fields are treated
+   as empty, and a sparse D is stored as dense matrix. */
+static inline void selbinv_pool_store(selbinv_pool *P, integer k,
+                                      const mxArray *Bk) {
+  const mxArray *field;
+  mwSize i, j, l, n_size;
+  mwIndex *ia, *ja;
+  int64_t first, size;
+  double *pr, *prD;
+  int set;
+
+  /* index sets J and I */
+  for (set = SELBINV_J; set <= SELBINV_I; set++) {
+    field = mxGetField(Bk, 0, set ? "I" : "J");
+    first = P->ind_ptr[2 * k + set] - 1;
+    size = P->ind_ptr[2 * k + set + 1] - 1 - first;
+    if ((field == NULL ? 0 : (int64_t)mxGetNumberOfElements(field)) != size)
+      mexErrMsgTxt("Block does not match the layout of the compact blocks.");
+    if (size == 0)
+      continue;
+    pr = mxGetPr(field);
+    for (l = 0; l < (mwSize)size; l++) {
+      if (P->ind32 != NULL)
+        P->ind32[first + l] = (int32_t)pr[l];
+      else
+        P->ind64[first + l] = (int64_t)pr[l];
+    }
+  }
+  n_size = (mwSize)(P->ind_ptr[2 * k + 1] - P->ind_ptr[2 * k]);
+
+  /* dense L, which is empty if the block has no index set I */
+  field = mxGetField(Bk, 0, "L");
+  size = P->val_ptr[2 * k + 1] - P->val_ptr[2 * k];
+  if (size > 0) {
+    if (field == NULL || mxIsSparse(field) ||
+        (int64_t)mxGetNumberOfElements(field) != size)
+      mexErrMsgTxt("Block does not match the layout of the compact blocks.");
+    memcpy(P->val + P->val_ptr[2 * k] - 1, mxGetPr(field),
+           (size_t)size * sizeof(double));
+  }
+
+  /* dense or sparse D */
+  field = mxGetField(Bk, 0, "D");
+  if (field == NULL || mxGetM(field) != n_size || mxGetN(field) != n_size)
+    mexErrMsgTxt("Block does not match the layout of the compact blocks.");
+  prD = P->val + P->val_ptr[2 * k + 1] - 1;
+  pr = mxGetPr(field);
+  if (!mxIsSparse(field))
+    memcpy(prD, pr, (size_t)(n_size * n_size) * sizeof(double));
+  else {
+    ia = mxGetJc(field);
+    ja = mxGetIr(field);
+    for (l = 0; l < n_size * n_size; l++)
+      prD[l] = 0.0;
+    for (j = 0; j < n_size; j++)
+      for (i = ia[j]; i < ia[j + 1]; i++)
+        prD[ja[i] + j * n_size] = pr[i];
+  }
+}
+
+/* convert the first nblocks blocks of the cell array B with indices up to
+   n into a compact block structure, releasing each block of B once it has
+   been stored */
+static inline mxArray *selbinv_pool_from_cell(mxArray *B, integer nblocks,
+                                              integer n) {
+  selbinv_pool B_pool, P;
+  mxArray *Bpool;
+  integer k;
+
+  selbinv_pool_get(B, &B_pool);
+  Bpool = selbinv_pool_create(&B_pool, nblocks, n, 1, &P);
+  for (k = 0; k < nblocks; k++) {
+    selbinv_pool_store(&P, k, mxGetCell(B, (mwIndex)k));
+    mxDestroyArray(mxGetCell(B, (mwIndex)k));
+    mxSetCell(B, (mwIndex)k, NULL);
+  }
+
+  return Bpool;
+}
+
+#endif
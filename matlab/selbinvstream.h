@@ -0,0 +1,145 @@
+/* ========================================================================== */
+/* === selbinvstream.h ====================================================== */
+/* ========================================================================== */
+
+/*
+    Lifetime of the blocks of the selective block inverse, shared by the
+    *selbinv mex functions when only the diagonal of the inverse is
+    returned.
+
+    The blocks are computed from the back, and block k only reads the
+    blocks of the inverse associated with its index sets BL{k}.I (and
+    BUT{k}.I). Hence, block i can be released as soon as the block with
+    the smallest number referring to it has been computed, so that only
+    the blocks still referred to by the remaining blocks are kept. The
+    blocks are either structures in a cell array or, for compact input
+    blocks (see selbinvpool.h), plain arrays of their values.
+
+    Notice:
+
+        THIS MATERIAL IS PROVIDED AS IS, WITH ABSOLUTELY NO WARRANTY
+        EXPRESSED OR IMPLIED.  ANY USE IS AT YOUR OWN RISK.
+*/
+
+#ifndef SELBINVSTREAM_H
+#define SELBINVSTREAM_H
+
+#include "matrix.h"
+#include "mex.h"
+#include <ilupack.h>
+#include <stdlib.h>
+
+#include "selbinvpool.h"
+
+/* mark of the blocks that have been released */
+#define SELBINV_RELEASED (-2)
+
+/* compute the last block last[i]<i that reads block i, or -1 if there is
+   none, from the index sets I of the blocks BL and optionally BUT (parsed
+   by selbinv_pool_get). block maps each index to its block number. */
+static inline void selbinv_last_use(const selbinv_pool *BL,
+                                    const selbinv_pool *BUT, integer nblocks,
+                                    const integer *block, integer *last) {
+  integer i, k;
+  const selbinv_pool *B;
+  selbinv_index_set I;
+  mwSize l;
+  int pass;
+
+  for (i = 0; i < nblocks; i++)
+    last[i] = -1;
+
+  /* the first block referring to block i is the last one computed */
+  for (k = 0; k < nblocks; k++) {
+    for (pass = 0; pass < 2; pass++) {
+      B = pass ? BUT : BL;
+      if (B == NULL)
+        continue;
+      selbinv_index_set_get(B, k, SELBINV_I, &I);
+      for (l = 0; l < I.size; l++) {
+        i = block[selbinv_index_set_entry(&I, l) - 1];
+        if (i > k && last[i] < 0)
+          last[i] = k;
+      } /* end for l */
+    }   /* end for pass */
+  }     /* end for k */
+}
+
+/* store in list the blocks that are no longer needed once block k has been
+   computed, i.e., block k itself if no block reads it, and the blocks
+   referred to by BL{k}.I and BUT{k}.I for which k is the last block. These
+   blocks are marked as released in last, and their number is returned. */
+static inline integer selbinv_expired(const selbinv_pool *BL,
+                                      const selbinv_pool *BUT, integer k,
+                                      const integer *block, integer *last,
+                                      integer *list) {
+  integer i, cnt = 0;
+  const selbinv_pool *B;
+  selbinv_index_set I;
+  mwSize l;
+  int pass;
+
+  if (last[k] == -1) {
+    last[k] = SELBINV_RELEASED;
+    list[cnt++] = k;
+  }
+  for (pass = 0; pass < 2; pass++) {
+    B = pass ? BUT : BL;
+    if (B == NULL)
+      continue;
+    selbinv_index_set_get(B, k, SELBINV_I, &I);
+    for (l = 0; l < I.size; l++) {
+      i = block[selbinv_index_set_entry(&I, l) - 1];
+      if (last[i] == k) {
+        last[i] = SELBINV_RELEASED;
+        list[cnt++] = i;
+      }
+    } /* end for l */
+  }   /* end for pass */
+
+  return cnt;
+}
+
+/* release the blocks list[0:cnt-1] of the cell array Binv */
+static inline void selbinv_release(mxArray *Binv, const integer *list,
+                                   integer cnt) {
+  integer l;
+  mxArray *Binv_block;
+
+  for (l = 0; l < cnt; l++) {
+    Binv_block = mxGetCell(Binv, (mwIndex)list[l]);
+    if (Binv_block != NULL) {
+      mxDestroyArray(Binv_block);
+      mxSetCell(Binv, (mwIndex)list[l], NULL);
+    }
+  } /* end for l */
+}
+
+/* values L or D (set SELBINV_L or SELBINV_D) of block k of the inverse,
+   which are written in place into the compact output P, or into a plain
+   array of size entries if P is NULL. Plain arrays are released by
+   selbinv_release_values, and NULL is returned if size is zero. */
+static inline double *selbinv_values(const selbinv_pool *P, integer k,
+                                     int set, size_t size, char *name) {
+  if (P != NULL)
+    return selbinv_pool_values(P, k, set);
+  if (size == 0)
+    return NULL;
+  return (double *)MAlloc(size * sizeof(double), name);
+}
+
+/* release the values val[list[0:cnt-1]] of the blocks of the inverse that
+   are kept as plain arrays */
+static inline void selbinv_release_values(double **val, const integer *list,
+                                          integer cnt) {
+  integer l;
+
+  for (l = 0; l < cnt; l++) {
+    if (val[list[l]] != NULL) {
+      free(val[list[l]]);
+      val[list[l]] = NULL;
+    }
+  } /* end for l */
+}
+
+#endif
@@ -0,0 +1,204 @@
+/* ========================================================================== */
+/* === selinvtree.h ========================================================= */
+/* ========================================================================== */
+
+/*
+    Schedule of the tree-parallel selected inversion, shared by the *selinv
+    mex functions.
+
+    The selected inverse is computed backwards by blocks of one or two
+    columns (the 1x1 and 2x2 pivots of D), and each block only reads the
+    blocks in the sparsity pattern of its columns of the factors. Those
+    blocks are ancestors of the block in the elimination tree of the
+    symmetrized pattern, so disjoint subtrees can be processed
+    concurrently once their common ancestors are done.
+
+    selinv_subtrees splits the tree into a top part, which contains the
+    blocks whose subtrees are too large to balance the load among the
+    threads, and the subtrees below it. Within each part, the blocks are
+    listed by their last columns in decreasing order, so that ancestors
+    come first.
+
+    Notice:
+
+        THIS MATERIAL IS PROVIDED AS IS, WITH ABSOLUTELY NO WARRANTY
+        EXPRESSED OR IMPLIED.  ANY USE IS AT YOUR OWN RISK.
+*/
+
+#ifndef SELINVTREE_H
+#define SELINVTREE_H
+
+#include "matrix.h"
+#include "mex.h"
+#include <ilupack.h>
+#include <stdlib.h>
+
+/* number of subtrees per thread, which allows dynamic load balancing */
+#define SELINV_SUBTREES_PER_THREAD 4
+
+/* Compute the schedule of the blocks of an nxn factorization, where
+   (A_ia,A_ja) and optionally (B_ia,B_ja) are the lower triangular patterns
+   of the factors in CCS format (e.g., L and U^T), and D_ia is the column
+   pointer of the block diagonal D, whose 2x2 pivots have two entries per
+   column. The block containing column n-1 is excluded, since the callers
+   start from it.
+
+   On return, the blocks of part s are order[sub_ptr[s]:sub_ptr[s+1]-1],
+   where part 0 is the top of the tree and parts 1 to nsub-1 are the
+   subtrees below it. order and sub_ptr must have room for n and n+1
+   entries, and nsub is returned. */
+static inline integer selinv_subtrees(integer n, const mwIndex *A_ia,
+                                      const mwIndex *A_ja, const mwIndex *B_ia,
+                                      const mwIndex *B_ja, const mwIndex *D_ia,
+                                      int nthreads, integer *order,
+                                      integer *sub_ptr) {
+  integer i, j, k, b, r, next, nsub, last, *blk, *ptr, *adj, *parent,
+      *ancestor;
+  mwIndex m;
+  double *weight, total, thresh;
+  const mwIndex *P_ia, *P_ja;
+  int pass;
+
+  blk = (integer *)MAlloc((size_t)(n > 0 ? n : 1) * sizeof(integer),
+                          "selinv_subtrees:blk");
+  ptr = (integer *)MAlloc((size_t)(n + 1) * sizeof(integer),
+                          "selinv_subtrees:ptr");
+  parent = (integer *)MAlloc((size_t)(n > 0 ? n : 1) * sizeof(integer),
+                             "selinv_subtrees:parent");
+  ancestor = (integer *)MAlloc((size_t)(n > 0 ? n : 1) * sizeof(integer),
+                               "selinv_subtrees:ancestor");
+  weight = (double *)MAlloc((size_t)(n > 0 ? n : 1) * sizeof(double),
+                            "selinv_subtrees:weight");
+
+  /* blk[i] is the first column of the block containing column i */
+  i = 0;
+  while (i < n) {
+    blk[i] = i;
+    if (D_ia[i + 1] - D_ia[i] == 1 || i == n - 1)
+      i++;
+    else {
+      blk[i + 1] = i;
+      i += 2;
+    }
+  }
+
+  /* lists of the blocks coupled to each block from below, i.e., the rows of
+     the block pattern of the strictly lower triangular parts. The cost of a
+     block is estimated by the squares of its column counts. */
+  for (i = 0; i <= n; i++)
+    ptr[i] = 0;
+  for (j = 0; j < n; j++)
+    weight[j] = 0.0;
+  for (pass = 0; pass < 2; pass++) {
+    P_ia = pass ? B_ia : A_ia;
+    P_ja = pass ? B_ja : A_ja;
+    if (P_ia == NULL)
+      continue;
+    for (j = 0; j < n; j++) {
+      weight[blk[j]] +=
+          (double)(P_ia[j + 1] - P_ia[j]) * (double)(P_ia[j + 1] - P_ia[j]);
+      for (m = P_ia[j]; m < P_ia[j + 1]; m++) {
+        k = (integer)P_ja[m];
+        if (blk[k] != blk[j])
+          ptr[blk[k] + 1]++;
+      }
+    }
+  }
+  for (i = 0; i < n; i++)
+    ptr[i + 1] += ptr[i];
+  adj = (integer *)MAlloc((size_t)(ptr[n] > 0 ? ptr[n] : 1) * sizeof(integer),
+                          "selinv_subtrees:adj");
+  for (pass = 0; pass < 2; pass++) {
+    P_ia = pass ? B_ia : A_ia;
+    P_ja = pass ? B_ja : A_ja;
+    if (P_ia == NULL)
+      continue;
+    for (j = 0; j < n; j++) {
+      for (m = P_ia[j]; m < P_ia[j + 1]; m++) {
+        k = (integer)P_ja[m];
+        if (blk[k] != blk[j])
+          adj[ptr[blk[k]]++] = blk[j];
+      }
+    }
+  }
+  for (i = n; i > 0; i--)
+    ptr[i] = ptr[i - 1];
+  ptr[0] = 0;
+
+  /* elimination tree of the blocks (Liu's algorithm with path compression).
+     Only the entries of the first columns of the blocks are used. */
+  for (b = 0; b < n; b++) {
+    if (blk[b] != b)
+      continue;
+    parent[b] = -1;
+    ancestor[b] = -1;
+    for (m = ptr[b]; m < (mwIndex)ptr[b + 1]; m++) {
+      for (r = adj[m]; r != -1 && r < b; r = next) {
+        next = ancestor[r];
+        ancestor[r] = b;
+        if (next == -1)
+          parent[r] = b;
+      }
+    }
+  }
+
+  /* weights of the subtrees, accumulated from the children to the parents,
+     which have larger indices */
+  total = 0.0;
+  for (b = 0; b < n; b++) {
+    if (blk[b] != b)
+      continue;
+    if (parent[b] >= 0)
+      weight[parent[b]] += weight[b];
+    else
+      total += weight[b];
+  }
+
+  /* the blocks with heavy subtrees form the top part. Since the weights
+     increase towards the roots, the top part is closed under ancestors.
+     The subtree number of each block is stored in ancestor. */
+  thresh = total / (double)(SELINV_SUBTREES_PER_THREAD * nthreads);
+  last = n > 0 ? blk[n - 1] : 0;
+  nsub = 1;
+  for (b = n - 1; b >= 0; b--) {
+    if (blk[b] != b)
+      continue;
+    if (nthreads <= 1 || weight[b] > thresh || b == last)
+      ancestor[b] = 0;
+    else if (parent[b] < 0 || ancestor[parent[b]] == 0)
+      ancestor[b] = nsub++;
+    else
+      ancestor[b] = ancestor[parent[b]];
+  }
+
+  /* list the blocks of each part by their last columns in decreasing
+     order, excluding the block containing column n-1 */
+  for (i = 0; i <= nsub; i++)
+    sub_ptr[i] = 0;
+  for (b = 0; b < last; b++)
+    if (blk[b] == b)
+      sub_ptr[ancestor[b] + 1]++;
+  for (i = 0; i < nsub; i++)
+    sub_ptr[i + 1] += sub_ptr[i];
+  for (i = last - 1; i >= 0; i--) {
+    b = blk[i];
+    if (b != i)
+      continue;
+    /* last column of the block */
+    order[sub_ptr[ancestor[b]]++] = (b + 1 < n && blk[b + 1] == b) ? b + 1 : b;
+  }
+  for (i = nsub; i > 0; i--)
+    sub_ptr[i] = sub_ptr[i - 1];
+  sub_ptr[0] = 0;
+
+  free(adj);
+  free(blk);
+  free(ptr);
+  free(parent);
+  free(ancestor);
+  free(weight);
+
+  return nsub;
+}
+
+#endif
@@ -0,0 +1,264 @@
+function [x, flag, iter, resids, times, work] = pcgMILU(varargin)
+% pcgMILU Preconditioned conjugate gradient with MILU as preconditioner
+%
+%    x = pcgMILU(A, b) solves a sparse symmetric positive definite linear
+%    system using ILUPACK's multilevel incomplete LDL' factorization as the
+%    preconditioner. Matrix A can be in MATLAB's built-in sparse format or
+%    in CRS format created using crs_matrix.
+%
+%    x = pcgMILU(rowptr, colind, vals, b) takes a matrix in the CRS
+%    format instead of MATLAB's built-in sparse format.
+%
+%    x = pcgMILU(A, b, rtol)
+%    x = pcgMILU(rowptr, colind, vals, b, rtol)
+%    specifies the relative tolerance and the maximum number of iterations.
+%    If rtol is [], it will use the default value 1.e-6.
+%
+%    x = pcgMILU(A, b, rtol, maxit)
+%    x = pcgMILU(rowptr, colind, vals, b, rtol, maxit)
+%    specifies the maximum number of iterations. If maxit is [], it
+%    will use the default value 500.
+%
+%    x = pcgMILU(A, b, rtol, maxiter, x0)
+%    x = pcgMILU(rowptr, colind, vals, b, rtol, maxiter, x0)
+%    takes an initial guess for x in x0. Use [] to preserve the default
+%    initial solution (all zeros).
+%
+%    x = pcgMILU(A, b, ..., 'name', value, ...)
+%    x = pcgMILU(rowptr, colind, vals, b, ..., 'name', value, ...)
+%    allows omitting none or some of the positional arguments rtol,
+%    maxiter and x0 and specifying these and other parameters in the form
+%    'param1_name', param1_value, 'param2_name', param2_value, and so on.
+%    The parameter names are not case sensitive. Available parameters and
+%    their default values (enclosed by '[' and ']') are as follows:
+%
+%   'rtol' [1.e-6]:   Relative tolerance for converegnce
+%
+%   'maxiter' [500]:  Maximum number of iterations
+%
+%   'x0' [all-zeros]: Initial guess vector
+%
+%   'verb' [1]:  Verbosity level.
+%          0 - silent
+%          1 - iteration info every 30 iterations
+%          2 - iteration info for all iterations
+%
+%   'ordering' ['amd']: Reorderings based on |A|+|A|'.
+%          'amd'    - Approximate Minimum Degree
+%          'metisn' - METIS multilevel nested dissection by NODES
+%          'metise' - METIS multilevel nested dissection by EDGES
+%          'rcm'    - Reverse Cuthill-McKee
+%          'mmd'    - Minimum Degree
+%          'amf'    - Approximate Minimum Fill
+%          ''       - no reordering
+%
+%   'condest'  [5]: Bound for the inverse triangular factors from the ILU
+%   Smaller values lead to more levels but potentiall fewer fills. Recommended
+%   value is between 3 and 10.
+%
+%   'droptol' [0.001]: Threshold for dropping small entries during the
+%    computation of the ILU factorization.
+%
+%   'droptols' [droptol*0.1]: Threshold for dropping small entries from the
+%    Schur complement. Recommended value is one order smaller than droptol.
+%
+%   'nthreads' [1]: Maximal number of threads to use in the matrix-vector
+%    products and in the level-scheduled triangular solves of MILU
+%
+%   'work' [none]: Workspace of the Krylov solver returned by a previous
+%    call. Reusing it in repeated solves of the same size avoids
+%    reallocating the buffers of PCG.
+%
+%    [x, flag] = pcgMILU(...) returns a convergence flag.
+%    flag  0 - solution found to tolerance
+%          1 - no convergence given max_it
+%         -1 - breakdown: rho = 0
+%         -2 - breakdown: p'*A*p <= 0, i.e., A or the preconditioner is
+%              not positive definite
+%         -3 - divergence (relative tolerance > 100)
+%
+%    [x, flag, iter] = pcgMILU(...) returns the iteration count.
+%
+%    [x, flag, iter, resids] = pcgMILU(...) returns the relative
+%    residual in 2-norm at each iteration.
+%
+%    [x, flag, iter, resids, times] = pcgMILU(...) returns the setup
+%    time (times(1)) and solve time (times(2)) in seconds.
+%
+%    [x, flag, iter, resids, times, work] = pcgMILU(...) returns the
+%    workspace of the Krylov solver, to be passed back using 'work'.
+%
+%  See also bicgstabMILU, gmresMILU
+
+if nargin == 0
+    help pcgMILU
+    return;
+end
+
+if issparse(varargin{1})
+    A = crs_matrix(varargin{1});
+    next_index = 2;
+elseif isstruct(varargin{1})
+    A = varargin{1};
+    next_index = 2;
+else
+    A = crs_matrix(varargin{1}, varargin{2}, varargin{3});
+    next_index = 4;
+end
+
+if nargin < next_index
+    error('The right hand-side must be specified');
+else
+    b = varargin{next_index};
+end
+
+% Initialize default arguments
+verbose = int32(1);
+rtol = 1.e-6;
+maxit = int32(500);
+x0 = cast([], class(b));
+nthreads = int32(1);
+work = [];
+
+params_start = nargin;
+for i = next_index+1:nargin
+    if ischar(varargin{i})
+        params_start = i;
+        break
+    end
+end
+
+% Process positional arguments
+if params_start >= next_index + 1 && ~isempty(varargin{next_index+1})
+    rtol = double(varargin{next_index+1});
+end
+
+if params_start >= next_index + 2 && ~isempty(varargin{next_index+2})
+    maxit = int32(varargin{next_index+2});
+end
+
+if params_start >= next_index + 3 && ~isempty(varargin{next_index+3})
+    x0 = varargin{next_index+3};
+end
+
+% Process argument-value pairs to update arguments
+options = struct('ordering', 'amd', 'droptol', 0.001, 'condest', 5, ...
+    'issymmetric', 1, 'isdefinite', 1);
+for i = params_start:2:length(varargin)-1
+    switch lower(varargin{i})
+        case {'maxit', 'maxiter'}
+            maxit = int32(varargin{i+1});
+        case 'x0'
+            x0 = varargin{i+1};
+        case {'rtol', 'reltol'}
+            rtol = varargin{i+1};
+        case {'verb', 'verbose'}
+            verbose = int32(varargin{i+1});
+        case 'nthreads'
+            nthreads = int32(varargin{i+1});
+        case 'work'
+            work = varargin{i+1};
+        case 'ordering'
+            options.ordering = varargin{i+1};
+        case 'droptol'
+            options.droptol = double(varargin{i+1});
+        case 'condest'
+            options.condest = double(varargin{i+1});
+            if options.condest <= 1 || options.condest >= 20
+                warning('Recommended value for condest is between 3 and 10.\n');
+            end
+        case 'droptols'
+            options.droptolS = double(varargin{i+1});
+        otherwise
+            error('Unknown tuning parameter "%s"', varargin{i});
+    end
+end
+
+if ~isfield(options, 'droptolS')
+    options.droptolS = options.droptol * 0.1;
+end
+
+% Compute level schedules for multithreaded triangular solves
+options.levelsched = nthreads > 1;
+
+compiled = exist(['pcgMILU_kernel.' mexext], 'file');
+
+if verbose
+    fprintf(1, 'Performing symmetric positive definite (SPD) ILU factorization...\n');
+end
+
+% Perform ILU factorization
+times = zeros(2, 1);
+tic;
+if compiled
+    [M, newoptions] = MILUfactor(varargin{1:next_index-1}, options);
+else
+    [~, newoptions, M] = MILUfactor(varargin{1:next_index-1}, options);
+end
+times(1) = toc;
+
+if verbose
+    if newoptions.elbow < 1
+        warning('The number of fills is about %.1f%% of original matrix. You may want to decrease droptol to %g.\n', ...
+            newoptions.elbow*100, options.droptol*0.1);
+    else
+        fprintf(1, 'The number of fills is about %.1f%% of original matrix.\n', ...
+            newoptions.elbow*100);
+    end
+    fprintf(1, 'Finished ILU factorization in %.1f seconds \n', times(1));
+end
+
+if verbose
+    fprintf(1, 'Starting Krylov solver ...\n');
+end
+
+tic;
+if isempty(work)
+    [x, flag, iter, resids, work] = pcgMILU_kernel(A, b, M, ...
+        rtol, maxit, x0, verbose, nthreads);
+else
+    [x, flag, iter, resids, work] = pcgMILU_kernel(A, b, M, ...
+        rtol, maxit, x0, verbose, nthreads, work);
+end
+
+times(2) = toc;
+
+if verbose
+    if flag == 0
+        fprintf(1, 'Finished solve in %d iterations and %.1f seconds.\n', iter, times(2));
+    elseif flag == -3
+        fprintf(1, 'PCG diverged after %d iterations and %.1f seconds.\n', iter, times(2));
+    else
+        fprintf(1, 'PCG failed to converge after %d iterations and %.1f seconds.\n', iter, times(2));
+    end
+end
+
+if ~compiled
+    M = ILUdelete(M); %#ok<NASGU>
+end
+
+end
+
+function test %#ok<DEFNU>
+%!test
+%!shared A, b, rtol
+%! A = delsq(numgrid('S', 50));
+%! b = A * ones(size(A, 1), 1);
+%! rtol = 1.e-8;
+%!
+%! [x, flag, iter, resids] = pcgMILU(A, b, rtol, 100);
+%! assert(flag == 0)
+%! assert(norm(b - A*x) <= rtol * norm(b))
+
+%!test
+%! [x, flag, iter, resids] = pcgMILU(A, b, 'rtol', rtol, ...
+%!         'maxit', 100, 'nthreads', 2);
+%! assert(norm(b - A*x) <= rtol * norm(b))
+
+%!test
+%! [x, flag, iter, resids, times, work] = pcgMILU(A, b, 'rtol', rtol, ...
+%!         'maxit', 100);
+%! [x, flag, iter, resids] = pcgMILU(A, 2 * b, 'rtol', rtol, ...
+%!         'maxit', 100, 'work', work);
+%! assert(norm(2 * b - A*x) <= 2 * rtol * norm(b))
+end
@@ -1,5 +1,12 @@
 function build_milu(varargin)
 % Build ILUPACK
+%
+% The mex functions of ILUPACK in matlab/ are built by the makefiles. The
+% compiled kernels in kernel/, such as MILUsolve and gmresMILU_MGS, are
+% generated by m2c from their M files, which requires MATLAB Coder. No
+% generated C code of the kernels is kept in the repository, so without
+% MATLAB Coder only the mex functions of ILUPACK are built, and gmresMILU,
+% pcgMILU and sqmrMILU use the uncompiled kernels.
 
 if ~exist('OCTAVE_VERSION', 'builtin') || nargin >= 1 && isequal(varargin{1}, '-matlab')
     fprintf(1, 'Building for MATLAB with MUMPS...\n')
@@ -12,15 +19,65 @@ else
     LIBDIR = [miluroot, '/lib/GNU64'];
 end
 
+if ~exist('OCTAVE_VERSION', 'builtin') && ~license('test', 'MATLAB_Coder')
+    warning('build_milu:NoCoder', ['MATLAB Coder is not available, so ', ...
+        'the compiled kernels are not built.']);
+    return;
+end
+
+m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
+    ['-L', LIBDIR], '-lilupack', 'MILU_levelsched');
 m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
     ['-L', LIBDIR], '-lilupack', 'MILUsolve');
+m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
+    ['-L', LIBDIR], '-lilupack', 'MILUsolve_block');
+m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
+    ['-L', LIBDIR], '-lilupack', 'MILUsolve_prodAx');
+m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
+    ['-L', LIBDIR], '-lilupack', 'MILUsolve_transpose');
+m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
+    ['-L', LIBDIR], '-lilupack', 'Krylov_createWork');
 m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
     ['-L', LIBDIR], '-lilupack', 'gmresMILU_HO');
 m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
     ['-L', LIBDIR], '-lilupack', 'gmresMILU_MGS');
 m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
     ['-L', LIBDIR], '-lilupack', 'gmresMILU_CGS');
+m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
+    ['-L', LIBDIR], '-lilupack', 'gmresMILU_PIPE');
+m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
+    ['-L', LIBDIR], '-lilupack', 'gmresMILU_SSTEP');
+m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
+    ['-L', LIBDIR], '-lilupack', 'gmresMILU_block');
+m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
+    ['-L', LIBDIR], '-lilupack', 'gmresMILU_adjoint');
 m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
     ['-L', LIBDIR], '-lilupack', 'bicgstabMILU_kernel');
+m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
+    ['-L', LIBDIR], '-lilupack', 'pcgMILU_kernel');
+m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
+    ['-L', LIBDIR], '-lilupack', 'sqmrMILU_kernel');
+
+% Kernels for single-precision MILU factors
+m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
+    ['-L', LIBDIR], '-lilupack', 'MILUsolve_mixed');
+m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
+    ['-L', LIBDIR], '-lilupack', 'gmresMILU_HO_mixed');
+m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
+    ['-L', LIBDIR], '-lilupack', 'gmresMILU_MGS_mixed');
+m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
+    ['-L', LIBDIR], '-lilupack', 'gmresMILU_CGS_mixed');
+m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
+    ['-L', LIBDIR], '-lilupack', 'gmresMILU_PIPE_mixed');
+m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
+    ['-L', LIBDIR], '-lilupack', 'gmresMILU_SSTEP_mixed');
+m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
+    ['-L', LIBDIR], '-lilupack', 'gmresMILU_block_mixed');
+
+% Kernels for complex MILU factors
+m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
+    ['-L', LIBDIR], '-lilupack', 'MILUsolve_complex');
+m2c('-mex', '-omp', '-O3', varargin{:}, ['-I', miluroot, '/include'], ...
+    ['-L', LIBDIR], '-lilupack', 'gmresMILU_MGS_complex');
 
 end